@@ -0,0 +1,70 @@
+/*
+ * display_driver.h
+ *
+ *  Created on: Dec 7, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef DISPLAY_DRIVER_H_
+#define DISPLAY_DRIVER_H_
+
+#include <stdint.h>
+#include "i2c_driver_hal.h"
+
+/*
+ * Planificador de escrituras de texto en la OLED.
+ * Los menús escriben sobre un cuadro en RAM (display_SetString) tantas veces como
+ * quieran; display_Process compara ese cuadro con la copia de lo que ya tiene la
+ * pantalla y, como máximo frameRate veces por segundo, envía sólo las columnas que
+ * cambiaron. Así el tráfico I2C queda acotado sin importar qué tan seguido se
+ * repinten las opciones (parpadeos, cambios de selección, etc.).
+ *
+ * - Necesita el SysTick corriendo a 1 ms (systick_GetTicks).
+ * - Cada grupo de columnas se envía con oled_Blit (una ventana, un buffer).
+ * - Sólo administra lo que se escribe por este driver: las zonas que pinta otro
+ *   driver (por ejemplo el medidor de afinación) no se tocan mientras nadie
+ *   escriba texto encima.
+ */
+
+#define DISPLAY_WIDTH			128		// Columnas de la pantalla
+#define DISPLAY_PAGES			8		// Páginas de la pantalla (8 filas c/u)
+#define DISPLAY_LETTER_WIDTH	6		// Columnas de cada letra (5 de la letra + 1 de separación)
+#define DISPLAY_MERGE_GAP		4		// Columnas sin cambios que se envían igual para no abrir otra ventana
+#define DISPLAY_DEFAULT_FPS		20		// Cuadros por segundo si no se configura frameRate
+
+
+/* Estadísticas del planificador */
+typedef struct
+{
+	uint32_t	requests;		// Llamados a display_SetString
+	uint32_t	redundant;		// Llamados que no cambiaron nada del cuadro
+	uint32_t	frames;			// Cuadros enviados a la pantalla
+	uint32_t	windows;		// Ventanas (grupos de columnas) enviadas
+	uint32_t	bytesSent;		// Bytes de datos enviados
+	uint32_t	errors;			// Cuadros que no se pudieron enviar completos
+} Display_Stats_t;
+
+
+/* Handler del planificador */
+typedef struct
+{
+	I2C_Handler_t	*ptrHandlerI2C;		// I2C de la pantalla OLED
+	uint8_t			frameRate;			// Máximo de cuadros por segundo (0 -> DISPLAY_DEFAULT_FPS)
+	uint16_t		framePeriod_ms;		// Tiempo mínimo entre cuadros (lo calcula display_Config)
+	uint64_t		lastFrameTick;		// Tick del SysTick del último cuadro enviado
+	uint8_t			dirtyPages;			// Bit p en 1 -> la página p tiene cambios por enviar
+	Display_Stats_t	stats;				// Estadísticas
+	uint8_t			frame[DISPLAY_PAGES * DISPLAY_WIDTH];	// Cuadro que piden los menús
+	uint8_t			sent[DISPLAY_PAGES * DISPLAY_WIDTH];	// Lo último que se envió a la pantalla
+} Display_Handler_t;
+
+
+/* Funciones públicas del planificador */
+void display_Config(Display_Handler_t *ptrDisplay);
+void display_SetString(Display_Handler_t *ptrDisplay, uint8_t *string, uint8_t display_mode, uint8_t length, uint8_t start_column, uint8_t start_page);
+void display_Clear(Display_Handler_t *ptrDisplay);
+uint8_t display_Process(Display_Handler_t *ptrDisplay);
+uint8_t display_Flush(Display_Handler_t *ptrDisplay);
+
+
+#endif /* DISPLAY_DRIVER_H_ */
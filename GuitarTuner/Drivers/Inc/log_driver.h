@@ -0,0 +1,141 @@
+/*
+ * log_driver.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef LOG_DRIVER_H_
+#define LOG_DRIVER_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "usart_driver_hal.h"
+#include "stream_driver.h"
+#include "log_messages.h"
+
+/*
+ * Log diferido: en el punto del programa donde ocurre el evento sólo se guarda un
+ * registro binario en un buffer circular de la RAM (unas decenas de ciclos, sin
+ * formatear texto ni esperar al USART), y log_Process lo envía después desde el
+ * loop principal.
+ *
+ * Cada registro son palabras de 32 bits:
+ *
+ *   [id:u16][argc:u16] [tiempo_ms:u32] [arg0] ... [argN]
+ *
+ * - id es el número del mensaje en log_messages.h, así el texto no ocupa el buffer ni el USART.
+ * - Los argumentos se guardan en crudo: los enteros tal cual y los float con sus bits.
+ * - Si el buffer está lleno el registro se pierde y se cuenta en stats.dropped.
+ *
+ * Salidas de log_Process:
+ *   LOG_OUTPUT_TEXT:   el registro se formatea en el micro con el texto de log_messages.h
+ *   LOG_OUTPUT_BINARY: el registro sale en una trama STREAM_FRAME_LOG y el texto lo pone
+ *                      el PC (Tools/log_decoder), que lee el mismo log_messages.h.
+ *                      Con LOG_TEXT_FORMATS = 0 los textos ni siquiera quedan en la flash.
+ *   LOG_OUTPUT_OFF:    los registros se descartan (el buffer se sigue vaciando)
+ *
+ * Los mensajes de texto que el programa escribe directo en el USART no pasan por el
+ * buffer, así que antes de uno de ellos se llama log_Flush para conservar el orden.
+ *
+ * Uso:
+ *   LOG1(&tunerLog, LOG_AFLOJA_CLAVIJA, diferencia);
+ */
+
+#ifndef LOG_TEXT_FORMATS
+#define LOG_TEXT_FORMATS	1		// 0 -> los textos sólo existen en el PC (salida binaria)
+#endif
+
+#define LOG_BUFFER_WORDS	256		// Potencia de 2
+#define LOG_BUFFER_MASK		(LOG_BUFFER_WORDS - 1)
+#define LOG_MAX_ARGS		3
+#define LOG_HEADER_WORDS	2		// id/argc + tiempo
+#define LOG_RECORD_WORDS	(LOG_HEADER_WORDS + LOG_MAX_ARGS)
+#define LOG_PROCESS_RECORDS	4		// Registros máximos que envía cada llamado a log_Process
+#define LOG_TEXT_SIZE		96		// Línea de texto más larga (LOG_OUTPUT_TEXT)
+
+/* Identificadores de los mensajes, en el orden de log_messages.h */
+#define LOG_MSG_ENUM(name, text)	name,
+enum
+{
+	LOG_MESSAGES(LOG_MSG_ENUM)
+	LOG_MESSAGE_COUNT
+};
+#undef LOG_MSG_ENUM
+
+/* Salida del log */
+enum
+{
+	LOG_OUTPUT_OFF = 0,
+	LOG_OUTPUT_TEXT,
+	LOG_OUTPUT_BINARY
+};
+
+
+/* Contadores del log */
+typedef struct
+{
+	uint32_t	records;		// Registros guardados
+	uint32_t	dropped;		// Registros perdidos porque el buffer estaba lleno
+	uint32_t	sent;			// Registros enviados por log_Process
+} Log_Stats_t;
+
+
+/* Handler del log */
+typedef struct
+{
+	USART_Handler_t		*ptrUsartHandler;	// Puerto de la salida de texto
+	Stream_Handler_t	*ptrStream;			// Stream de la salida binaria
+	uint8_t				output;				// LOG_OUTPUT_OFF / TEXT / BINARY (se puede cambiar en cualquier momento)
+	Log_Stats_t			stats;
+	uint32_t			buffer[LOG_BUFFER_WORDS];
+	volatile uint16_t	head;				// Siguiente palabra a escribir (log_Record)
+	volatile uint16_t	tail;				// Siguiente palabra a leer (log_Process)
+} Log_Handler_t;
+
+
+/* Funciones públicas del log */
+void log_Config(Log_Handler_t *ptrLog);
+void log_Record(Log_Handler_t *ptrLog, uint16_t id, uint8_t argc, uint32_t arg0, uint32_t arg1, uint32_t arg2);
+void log_Process(Log_Handler_t *ptrLog);
+void log_Flush(Log_Handler_t *ptrLog);
+const char *log_GetFormat(uint16_t id);
+
+
+/* Los argumentos viajan como 32 bits crudos: los float se copian bit a bit */
+static inline uint32_t log_arg_float(float value){
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static inline uint32_t log_arg_int(int32_t value){
+	return (uint32_t)value;
+}
+
+static inline uint32_t log_arg_uint(uint32_t value){
+	return value;
+}
+
+/* Se usan los tipos base como en format_Put; un tipo que no está es un error de compilación */
+#define LOG_ARG(value) _Generic((value),		\
+		float:				log_arg_float,		\
+		double:				log_arg_float,		\
+		signed char:		log_arg_int,		\
+		short:				log_arg_int,		\
+		int:				log_arg_int,		\
+		long:				log_arg_int,		\
+		char:				log_arg_uint,		\
+		unsigned char:		log_arg_uint,		\
+		unsigned short:		log_arg_uint,		\
+		unsigned int:		log_arg_uint,		\
+		unsigned long:		log_arg_uint		\
+	)(value)
+
+#define LOG0(ptrLog, id)				log_Record((ptrLog), (id), 0, 0, 0, 0)
+#define LOG1(ptrLog, id, a)				log_Record((ptrLog), (id), 1, LOG_ARG(a), 0, 0)
+#define LOG2(ptrLog, id, a, b)			log_Record((ptrLog), (id), 2, LOG_ARG(a), LOG_ARG(b), 0)
+#define LOG3(ptrLog, id, a, b, c)		log_Record((ptrLog), (id), 3, LOG_ARG(a), LOG_ARG(b), LOG_ARG(c))
+
+
+#endif /* LOG_DRIVER_H_ */
@@ -0,0 +1,33 @@
+/*
+ * log_messages.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef LOG_MESSAGES_H_
+#define LOG_MESSAGES_H_
+
+/*
+ * Mensajes del log diferido. Cada entrada tiene el identificador y el formato del mensaje:
+ * - El identificador es el número de la entrada en esta lista (0, 1, 2, ...), así que
+ *   los mensajes nuevos se agregan al final para no cambiar los números de los anteriores.
+ * - El formato acepta %d, %u, %x, %f (2 decimales), %c y %%; cada % consume un
+ *   argumento de 32 bits (máximo LOG_MAX_ARGS).
+ *
+ * El decodificador del PC (Tools/log_decoder) lee esta misma lista para convertir
+ * los identificadores de las tramas binarias en texto.
+ */
+#define LOG_MESSAGES(LOG_MSG)																\
+	LOG_MSG(LOG_FFT_ERROR,			"FFT no inicializada correctamente (estado %d)")		\
+	LOG_MSG(LOG_CUERDA_E2,			"Afinando la cuerda N°6 (E2) - detectada %f Hz")		\
+	LOG_MSG(LOG_CUERDA_A2,			"Afinando la cuerda N°5 (A2) - detectada %f Hz")		\
+	LOG_MSG(LOG_CUERDA_D3,			"Afinando la cuerda N°4 (D3) - detectada %f Hz")		\
+	LOG_MSG(LOG_CUERDA_G3,			"Afinando la cuerda N°3 (G3) - detectada %f Hz")		\
+	LOG_MSG(LOG_CUERDA_B3,			"Afinando la cuerda N°2 (B3) - detectada %f Hz")		\
+	LOG_MSG(LOG_CUERDA_E4,			"Afinando la cuerda N°1 (E4) - detectada %f Hz")		\
+	LOG_MSG(LOG_APRIETA_CLAVIJA,	"Aprieta la clavija (diferencia %f Hz)")				\
+	LOG_MSG(LOG_AFLOJA_CLAVIJA,		"Afloja la clavija (diferencia %f Hz)")					\
+	LOG_MSG(LOG_CUERDA_AFINADA,		"¡La cuerda esta afinada! (diferencia %f Hz)")
+
+#endif /* LOG_MESSAGES_H_ */
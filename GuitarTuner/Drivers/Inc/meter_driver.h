@@ -0,0 +1,54 @@
+/*
+ * meter_driver.h
+ *
+ *  Created on: Dec 6, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef METER_DRIVER_H_
+#define METER_DRIVER_H_
+
+#include <stdint.h>
+#include "i2c_driver_hal.h"
+
+/*
+ * Medidor (aguja + barra) que muestra en la OLED la desviación en cents de la
+ * cuerda que se está afinando. El driver guarda una copia de lo último que se
+ * envió a la pantalla, y en cada actualización sólo envía las columnas que
+ * cambiaron, así un movimiento de la aguja cuesta unas decenas de bytes por I2C
+ * en lugar de redibujar toda la figura.
+ *
+ * La copia se guarda columna por columna, así cada grupo de columnas que cambió se
+ * envía tal cual con oled_Blit en direccionamiento vertical (una ventana, un buffer).
+ */
+
+#define METER_MAX_WIDTH		128		// Columnas máximas del medidor
+#define METER_MAX_PAGES		4		// Páginas (8 filas c/u) máximas del medidor
+#define METER_TICK_CENTS	10		// Separación (en cents) de las marcas de la escala
+#define METER_MERGE_GAP		4		// Columnas sin cambios que se envían igual para no abrir otra ventana
+
+
+/* Handler del medidor */
+typedef struct
+{
+	I2C_Handler_t	*ptrHandlerI2C;		// I2C de la pantalla OLED
+	uint8_t			startColumn;		// Primera columna que ocupa el medidor
+	uint8_t			width;				// Número de columnas (máximo METER_MAX_WIDTH)
+	uint8_t			startPage;			// Primera página que ocupa el medidor
+	uint8_t			pages;				// Número de páginas (máximo METER_MAX_PAGES)
+	uint8_t			rangeCents;			// Desviación (en cents) que corresponde a cada extremo
+	uint8_t			tickSpacing;		// Columnas entre marcas de la escala (lo calcula meter_Config)
+	uint8_t			needleColumn;		// Posición actual de la aguja
+	uint8_t			flagValid;			// 0 -> la pantalla no coincide con la copia y se redibuja todo
+	uint32_t		bytesSent;			// Bytes de datos enviados por el medidor (estadística)
+	uint8_t			shadow[METER_MAX_PAGES * METER_MAX_WIDTH];	// Lo último que se envió, columna por columna
+} Meter_Handler_t;
+
+
+/* Funciones públicas del medidor */
+void meter_Config(Meter_Handler_t *ptrMeter);
+void meter_Invalidate(Meter_Handler_t *ptrMeter);
+uint8_t meter_Update(Meter_Handler_t *ptrMeter, float cents);
+
+
+#endif /* METER_DRIVER_H_ */
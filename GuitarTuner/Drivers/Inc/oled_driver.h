@@ -58,6 +58,14 @@ enum{
 	INVERSE_DISPLAY
 };
 
+/* Orden de los bytes del bitmap que recibe oled_Blit */
+enum{
+	OLED_BLIT_ROWS = 0,		// Página por página (cada página: columna por columna) -> direccionamiento horizontal
+	OLED_BLIT_COLUMNS		// Columna por columna (cada columna: página por página) -> direccionamiento vertical
+};
+
+#define OLED_MAX_STRING_LENGTH	21	// Letras que caben en una página (128 / 6)
+
 /* ===== FUNCIONES PÚBLICAS DEL DRIVER OLED ===== */
 /* Funciones para el manejo de la comunicación I2C con la OLED
  * - Incluye funciones para envío de comandos.
@@ -66,8 +74,8 @@ enum{
  */
 void oled_startComunication(I2C_Handler_t *ptrHandlerI2C);
 void oled_stopComunication(I2C_Handler_t *ptrHandlerI2C);
-void oled_sendCommand(I2C_Handler_t *ptrHandlerI2C, uint8_t *command, uint16_t length);
-void oled_sendData(I2C_Handler_t *ptrHandlerI2C, uint8_t *data, uint16_t length);
+uint8_t oled_sendCommand(I2C_Handler_t *ptrHandlerI2C, uint8_t *command, uint16_t length);
+uint8_t oled_sendData(I2C_Handler_t *ptrHandlerI2C, uint8_t *data, uint16_t length);
 void oled_onDisplay(I2C_Handler_t *ptrHandlerI2C);
 void oled_offDisplay(I2C_Handler_t *ptrHandlerI2C);
 void oled_Config(I2C_Handler_t *ptrHandlerI2C);
@@ -85,6 +93,7 @@ void oled_setNormalDisplay(I2C_Handler_t *ptrHandlerI2C);
 void oled_setString(I2C_Handler_t *ptrHandlerI2C, uint8_t *string, uint8_t display_mode, uint8_t length, uint8_t start_column, uint8_t start_page);
 void setLetter(uint8_t letter, uint8_t *letterArray);
 void oled_clearDisplay(I2C_Handler_t *ptrHandlerI2C);
+uint8_t oled_Blit(I2C_Handler_t *ptrHandlerI2C, uint8_t *bitmap, uint8_t layout, uint8_t start_column, uint8_t width, uint8_t start_page, uint8_t pages);
 
 
 #endif /* OLED_DRIVER_H_ */
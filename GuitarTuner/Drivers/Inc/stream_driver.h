@@ -0,0 +1,102 @@
+/*
+ * stream_driver.h
+ *
+ *  Created on: Dec 10, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef STREAM_DRIVER_H_
+#define STREAM_DRIVER_H_
+
+#include <stdint.h>
+#include "usart_driver_hal.h"
+
+/*
+ * Envío de datos de depuración por el USART en tramas binarias, en lugar de
+ * formatear cada valor con sprintf. Cada trama es:
+ *
+ *   0x00 + COBS([tipo:1][secuencia:1][datos:N][CRC16:2]) + 0x00
+ *
+ * - Todos los valores van en little-endian (el orden nativo del Cortex-M4).
+ * - El CRC es CRC-16/CCITT-FALSE (polinomio 0x1021, inicio 0xFFFF) sobre tipo, secuencia y datos.
+ * - COBS elimina los 0x00 de la trama, así el 0x00 sólo aparece como delimitador y el
+ *   receptor se puede sincronizar en cualquier momento, aunque por el mismo puerto
+ *   lleguen también los mensajes de texto. El 0x00 inicial separa la trama del texto
+ *   anterior, y el texto queda como una trama que no pasa el CRC y se descarta.
+ * - La secuencia es independiente para cada tipo, y permite al receptor contar las tramas perdidas.
+ *
+ * Datos de cada tipo:
+ *   STREAM_FRAME_ADC:      [fs:f32][n:u16][muestras:n x u16]
+ *   STREAM_FRAME_SPECTRUM: [resolucion:f32][primerBin:u16][n:u16][formato:u8][escala:f32][bins:n x u16]
+ *                          q15 -> bin = magnitud / escala * 32767;  f16 -> bin = magnitud en half float (escala = 1)
+ *   STREAM_FRAME_PITCH:    [frecuencia:f32][cents:f32][nota:u8][afinado:u8]
+ *   STREAM_FRAME_LOG:      [id:u16][argc:u16][tiempo_ms:u32][args:argc x u32]   (registro de log_driver)
+ *
+ * El receptor para el PC está en Tools/spectrum_receiver, y el de los registros del
+ * log en Tools/log_decoder.
+ */
+
+#define STREAM_MAX_ADC_SAMPLES		1024	// Muestras máximas de una trama de ADC
+#define STREAM_MAX_SPECTRUM_BINS	512		// Bins máximos de una trama de espectro
+#define STREAM_MAX_PAYLOAD			(4 + 2 + 2 * STREAM_MAX_ADC_SAMPLES)	// La trama de ADC es la más grande
+#define STREAM_DEFAULT_BINS			256		// Por defecto se envían los bins hasta fs/4
+
+/* Tipos de trama */
+enum
+{
+	STREAM_FRAME_ADC = 0x01,
+	STREAM_FRAME_SPECTRUM,
+	STREAM_FRAME_PITCH,
+	STREAM_FRAME_LOG
+};
+
+#define STREAM_FRAME_TYPES	4
+
+/* Formato de los bins del espectro */
+enum
+{
+	STREAM_FORMAT_Q15 = 0,
+	STREAM_FORMAT_F16
+};
+
+enum
+{
+	STREAM_DISABLE = 0,
+	STREAM_ENABLE
+};
+
+
+/* Contadores del stream */
+typedef struct
+{
+	uint32_t	frames;			// Tramas enviadas
+	uint32_t	bytesSent;		// Bytes enviados por el USART (ya codificados)
+	uint32_t	skipped;		// Tramas que no se enviaron por el diezmado
+} Stream_Stats_t;
+
+
+/* Handler del stream */
+typedef struct
+{
+	USART_Handler_t	*ptrUsartHandler;	// Puerto por el que salen las tramas
+	uint8_t			enable;				// STREAM_ENABLE / STREAM_DISABLE (se puede cambiar en cualquier momento)
+	uint8_t			spectrumFormat;		// STREAM_FORMAT_Q15 / STREAM_FORMAT_F16
+	uint16_t		maxBins;			// Bins del espectro que se envían (0 -> STREAM_DEFAULT_BINS)
+	uint8_t			decimationADC;		// Se envía 1 de cada N tramas de ADC (0 -> no se envían)
+	uint8_t			decimationSpectrum;	// Se envía 1 de cada N espectros (0 -> no se envían)
+	uint8_t			decimationPitch;	// Se envía 1 de cada N estimaciones de pitch (0 -> no se envían)
+	uint8_t			count[STREAM_FRAME_TYPES];		// Contador del diezmado de cada tipo
+	uint8_t			sequence[STREAM_FRAME_TYPES];	// Número de secuencia de cada tipo
+	Stream_Stats_t	stats;
+} Stream_Handler_t;
+
+
+/* Funciones públicas del stream */
+void stream_Config(Stream_Handler_t *ptrStream);
+uint8_t stream_SendADC(Stream_Handler_t *ptrStream, float *samples, uint16_t length, float sampleRate);
+uint8_t stream_SendSpectrum(Stream_Handler_t *ptrStream, float *magnitude, uint16_t length, float resolution);
+uint8_t stream_SendPitch(Stream_Handler_t *ptrStream, float frequency, float cents, uint8_t note, uint8_t tuned);
+uint8_t stream_SendLog(Stream_Handler_t *ptrStream, const uint32_t *record, uint8_t words);
+
+
+#endif /* STREAM_DRIVER_H_ */
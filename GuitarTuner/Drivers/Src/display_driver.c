@@ -0,0 +1,210 @@
+/*
+ * display_driver.c
+ *
+ *  Created on: Dec 7, 2023
+ *      Author: sgaviriav
+ */
+
+// Importando librerías necesarias
+#include <stdint.h>
+#include <string.h>
+#include "display_driver.h"
+#include "oled_driver.h"
+#include "systick_driver_hal.h"
+
+/* === Headers for private functions === */
+static uint8_t display_send_columns(Display_Handler_t *ptrDisplay, uint8_t page, uint8_t firstColumn, uint8_t lastColumn);
+static uint8_t display_send_page(Display_Handler_t *ptrDisplay, uint8_t page);
+
+
+/*
+ * Función para cargar la configuración del planificador.
+ * Calcula el periodo mínimo entre cuadros y deja las copias en blanco,
+ * por lo que se debe llamar después de limpiar la pantalla.
+ */
+void display_Config(Display_Handler_t *ptrDisplay){
+
+	/* 1. Periodo mínimo entre cuadros */
+	if(ptrDisplay->frameRate == 0){
+		ptrDisplay->frameRate = DISPLAY_DEFAULT_FPS;
+	}
+	ptrDisplay->framePeriod_ms = 1000 / ptrDisplay->frameRate;
+
+	/* 2. La pantalla arranca limpia y sin cambios pendientes */
+	memset(ptrDisplay->frame, 0, sizeof(ptrDisplay->frame));
+	memset(ptrDisplay->sent, 0, sizeof(ptrDisplay->sent));
+	memset(&ptrDisplay->stats, 0, sizeof(ptrDisplay->stats));
+	ptrDisplay->dirtyPages = 0;
+	ptrDisplay->lastFrameTick = systick_GetTicks();
+}
+
+
+/*
+ * Escribe una palabra en el cuadro (no en la pantalla). Mismos parámetros que
+ * oled_setString. Si el contenido no cambia, la llamada no genera tráfico I2C.
+ */
+void display_SetString(Display_Handler_t *ptrDisplay, uint8_t *string, uint8_t display_mode, uint8_t length, uint8_t start_column, uint8_t start_page){
+
+	uint8_t letterArray[DISPLAY_LETTER_WIDTH];
+	uint8_t flagChanged = 0;
+	uint16_t column = start_column;
+
+	ptrDisplay->stats.requests++;
+
+	if(start_page >= DISPLAY_PAGES){
+		return;
+	}
+
+	/* 1. Dibujamos letra por letra en la página, recortando en el borde derecho */
+	uint8_t *ptrPage = &ptrDisplay->frame[start_page * DISPLAY_WIDTH];
+
+	for(uint8_t i = 0; (i < length) && (column < DISPLAY_WIDTH); i++){
+
+		memset(letterArray, 0, sizeof(letterArray));
+		setLetter(string[i], letterArray);
+
+		for(uint8_t x = 0; (x < DISPLAY_LETTER_WIDTH) && (column < DISPLAY_WIDTH); x++, column++){
+			uint8_t data = (display_mode == INVERSE_DISPLAY) ? (uint8_t)~letterArray[x] : letterArray[x];
+			if(ptrPage[column] != data){
+				ptrPage[column] = data;
+				flagChanged = 1;
+			}
+		}
+	}
+
+	/* 2. Marcamos la página sólo si algo cambió */
+	if(flagChanged){
+		ptrDisplay->dirtyPages |= (1 << start_page);
+	}
+	else{
+		ptrDisplay->stats.redundant++;
+	}
+}
+
+
+/*
+ * Limpia la pantalla de inmediato (incluye lo que hayan pintado otros drivers)
+ * y descarta los cambios pendientes del cuadro.
+ */
+void display_Clear(Display_Handler_t *ptrDisplay){
+
+	oled_clearDisplay(ptrDisplay->ptrHandlerI2C);
+
+	memset(ptrDisplay->frame, 0, sizeof(ptrDisplay->frame));
+	memset(ptrDisplay->sent, 0, sizeof(ptrDisplay->sent));
+	ptrDisplay->dirtyPages = 0;
+}
+
+
+/*
+ * Función para llamar en los loops de la aplicación.
+ * Envía un cuadro sólo si hay cambios y ya pasó el periodo mínimo desde el anterior.
+ * Devuelve I2C_OK o el código de error del I2C.
+ */
+uint8_t display_Process(Display_Handler_t *ptrDisplay){
+
+	if(ptrDisplay->dirtyPages == 0){
+		return I2C_OK;
+	}
+	if((systick_GetTicks() - ptrDisplay->lastFrameTick) < ptrDisplay->framePeriod_ms){
+		return I2C_OK;
+	}
+	return display_Flush(ptrDisplay);
+}
+
+
+/*
+ * Envía ya mismo los cambios pendientes, sin esperar el periodo entre cuadros
+ * (por ejemplo, antes de un delay bloqueante).
+ * Devuelve I2C_OK o el primer código de error del I2C.
+ */
+uint8_t display_Flush(Display_Handler_t *ptrDisplay){
+
+	uint8_t auxError = I2C_OK;
+	uint8_t auxStatus = I2C_OK;
+
+	if(ptrDisplay->dirtyPages == 0){
+		return I2C_OK;
+	}
+
+	/* Las páginas que fallen quedan marcadas para el siguiente cuadro */
+	for(uint8_t page = 0; page < DISPLAY_PAGES; page++){
+		if(ptrDisplay->dirtyPages & (1 << page)){
+			auxStatus = display_send_page(ptrDisplay, page);
+			if(auxStatus == I2C_OK){
+				ptrDisplay->dirtyPages &= ~(1 << page);
+			}
+			else if(auxError == I2C_OK){
+				auxError = auxStatus;
+			}
+		}
+	}
+
+	ptrDisplay->lastFrameTick = systick_GetTicks();
+	ptrDisplay->stats.frames++;
+	if(auxError != I2C_OK){
+		ptrDisplay->stats.errors++;
+	}
+
+	return auxError;
+}
+
+
+/*
+ * Compara una página del cuadro con la copia y envía los grupos de columnas que cambiaron.
+ * Grupos separados por pocas columnas iguales se envían juntos en una sola ventana.
+ */
+static uint8_t display_send_page(Display_Handler_t *ptrDisplay, uint8_t page){
+
+	uint8_t *ptrFrame = &ptrDisplay->frame[page * DISPLAY_WIDTH];
+	uint8_t *ptrSent = &ptrDisplay->sent[page * DISPLAY_WIDTH];
+	int16_t firstDirty = -1;
+	int16_t lastDirty = -1;
+	uint8_t auxError = I2C_OK;
+	uint8_t auxStatus = I2C_OK;
+
+	for(uint8_t column = 0; column < DISPLAY_WIDTH; column++){
+		if(ptrFrame[column] != ptrSent[column]){
+			/* Si el grupo anterior está lejos, lo enviamos y empezamos uno nuevo */
+			if((firstDirty >= 0) && ((column - lastDirty) > DISPLAY_MERGE_GAP)){
+				auxStatus = display_send_columns(ptrDisplay, page, firstDirty, lastDirty);
+				auxError = (auxError == I2C_OK) ? auxStatus : auxError;
+				firstDirty = -1;
+			}
+			if(firstDirty < 0){
+				firstDirty = column;
+			}
+			lastDirty = column;
+		}
+	}
+
+	/* Enviamos el último grupo pendiente */
+	if(firstDirty >= 0){
+		auxStatus = display_send_columns(ptrDisplay, page, firstDirty, lastDirty);
+		auxError = (auxError == I2C_OK) ? auxStatus : auxError;
+	}
+
+	return auxError;
+}
+
+
+/*
+ * Envía las columnas [firstColumn, lastColumn] de una página y actualiza la copia
+ * sólo si la escritura fue correcta
+ */
+static uint8_t display_send_columns(Display_Handler_t *ptrDisplay, uint8_t page, uint8_t firstColumn, uint8_t lastColumn){
+
+	uint8_t length = lastColumn - firstColumn + 1;
+	uint16_t index = page * DISPLAY_WIDTH + firstColumn;
+	uint8_t auxError = I2C_OK;
+
+	/* Ventana de una página: los datos salen directamente desde el cuadro */
+	auxError = oled_Blit(ptrDisplay->ptrHandlerI2C, &ptrDisplay->frame[index], OLED_BLIT_ROWS,
+						 firstColumn, length, page, 1);
+	if(auxError == I2C_OK){
+		memcpy(&ptrDisplay->sent[index], &ptrDisplay->frame[index], length);
+		ptrDisplay->stats.windows++;
+		ptrDisplay->stats.bytesSent += length;
+	}
+	return auxError;
+}
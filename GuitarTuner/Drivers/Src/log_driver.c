@@ -0,0 +1,239 @@
+/*
+ * log_driver.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+// Importando librerías necesarias
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "systick_driver_hal.h"
+#include "format_driver_hal.h"
+#include "log_driver.h"
+
+#if LOG_TEXT_FORMATS
+/* Textos de los mensajes, en el orden de los identificadores */
+#define LOG_MSG_TEXT(name, text)	text,
+static const char *const logFormats[LOG_MESSAGE_COUNT] = {
+	LOG_MESSAGES(LOG_MSG_TEXT)
+};
+#undef LOG_MSG_TEXT
+#endif
+
+/* === Headers for private functions === */
+static void log_write_text(Log_Handler_t *ptrLog, const uint32_t *record);
+
+
+/*
+ * Función para cargar la configuración del log: vacía el buffer y los contadores
+ */
+void log_Config(Log_Handler_t *ptrLog){
+
+	ptrLog->head = 0;
+	ptrLog->tail = 0;
+	ptrLog->stats.records = 0;
+	ptrLog->stats.dropped = 0;
+	ptrLog->stats.sent = 0;
+
+	if(ptrLog->output > LOG_OUTPUT_BINARY){
+		ptrLog->output = LOG_OUTPUT_TEXT;
+	}
+}
+
+
+/*
+ * Guarda un registro en el buffer circular. Se puede llamar desde el main y desde
+ * las interrupciones: la reserva del espacio se hace con las interrupciones apagadas
+ * (son pocas instrucciones), así dos registros nunca quedan mezclados.
+ */
+void log_Record(Log_Handler_t *ptrLog, uint16_t id, uint8_t argc, uint32_t arg0, uint32_t arg1, uint32_t arg2){
+
+	if(argc > LOG_MAX_ARGS){
+		argc = LOG_MAX_ARGS;
+	}
+	uint16_t words = LOG_HEADER_WORDS + argc;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	/* 1. Espacio libre (una palabra queda siempre vacía para distinguir lleno de vacío) */
+	uint16_t head = ptrLog->head;
+	uint16_t space = (ptrLog->tail - head - 1) & LOG_BUFFER_MASK;
+	if(space < words){
+		ptrLog->stats.dropped++;
+		__set_PRIMASK(primask);
+		return;
+	}
+
+	/* 2. Encabezado y argumentos, en crudo */
+	ptrLog->buffer[head] = (uint32_t)id | ((uint32_t)argc << 16);
+	ptrLog->buffer[(head + 1) & LOG_BUFFER_MASK] = systick_GetTicks32();
+	if(argc > 0){
+		ptrLog->buffer[(head + 2) & LOG_BUFFER_MASK] = arg0;
+	}
+	if(argc > 1){
+		ptrLog->buffer[(head + 3) & LOG_BUFFER_MASK] = arg1;
+	}
+	if(argc > 2){
+		ptrLog->buffer[(head + 4) & LOG_BUFFER_MASK] = arg2;
+	}
+
+	/* 3. El registro queda visible para log_Process sólo cuando está completo */
+	ptrLog->head = (head + words) & LOG_BUFFER_MASK;
+	ptrLog->stats.records++;
+
+	__set_PRIMASK(primask);
+}
+
+
+/*
+ * Se llama en el loop principal: envía como máximo LOG_PROCESS_RECORDS registros
+ * por llamado, para no demorar el resto del loop
+ */
+void log_Process(Log_Handler_t *ptrLog){
+
+	uint32_t record[LOG_RECORD_WORDS];
+
+	for(uint8_t count = 0; (count < LOG_PROCESS_RECORDS) && (ptrLog->tail != ptrLog->head); count++){
+
+		/* 1. Copiamos el registro del buffer circular (el productor sólo mueve head) */
+		uint16_t tail = ptrLog->tail;
+		record[0] = ptrLog->buffer[tail];
+		uint8_t argc = (uint8_t)(record[0] >> 16);
+		if(argc > LOG_MAX_ARGS){
+			argc = LOG_MAX_ARGS;
+		}
+		uint8_t words = LOG_HEADER_WORDS + argc;
+		for(uint8_t i = 1; i < words; i++){
+			record[i] = ptrLog->buffer[(tail + i) & LOG_BUFFER_MASK];
+		}
+		ptrLog->tail = (tail + words) & LOG_BUFFER_MASK;
+
+		/* 2. Lo enviamos según la salida escogida */
+		switch(ptrLog->output){
+		case LOG_OUTPUT_TEXT:
+			log_write_text(ptrLog, record);
+			break;
+		case LOG_OUTPUT_BINARY:
+			if(ptrLog->ptrStream != NULL){
+				stream_SendLog(ptrLog->ptrStream, record, words);
+			}
+			break;
+		default:
+			continue;
+		}
+		ptrLog->stats.sent++;
+	}
+}
+
+
+/*
+ * Envía todos los registros pendientes (por ejemplo, antes de escribir un mensaje de
+ * texto directo en el USART, para que los mensajes salgan en orden)
+ */
+void log_Flush(Log_Handler_t *ptrLog){
+	while(ptrLog->tail != ptrLog->head){
+		log_Process(ptrLog);
+	}
+}
+
+
+/*
+ * Texto de un mensaje (NULL si no existe o si los textos no están en la flash)
+ */
+const char *log_GetFormat(uint16_t id){
+#if LOG_TEXT_FORMATS
+	if(id < LOG_MESSAGE_COUNT){
+		return logFormats[id];
+	}
+#else
+	(void)id;
+#endif
+	return NULL;
+}
+
+
+/*
+ * Formatea un registro con el texto de su mensaje y lo escribe en el USART.
+ * Cada % del texto toma el siguiente argumento; los argumentos que falten se toman como 0.
+ */
+static void log_write_text(Log_Handler_t *ptrLog, const uint32_t *record){
+
+	char line[LOG_TEXT_SIZE];
+	Format_Writer_t writer;
+	uint16_t id = (uint16_t)(record[0] & 0xFFFF);
+	uint8_t argc = (uint8_t)(record[0] >> 16);
+	uint8_t argIndex = 0;
+	const char *ptrFormat = log_GetFormat(id);
+
+	format_InitBuffer(&writer, line, sizeof(line));
+
+	/* 1. Sin el texto en la flash sólo se puede escribir el identificador */
+	if(ptrFormat == NULL){
+		format_String(&writer, "log #");
+		format_Uint(&writer, id, 0, FORMAT_PAD_SPACE);
+		for(uint8_t i = 0; i < argc; i++){
+			format_String(&writer, " 0x");
+			format_Hex(&writer, record[LOG_HEADER_WORDS + i], 8);
+		}
+	}
+
+	/* 2. Reemplazamos cada especificador por su argumento */
+	while((ptrFormat != NULL) && (*ptrFormat != '\0')){
+
+		if((*ptrFormat != '%') || (ptrFormat[1] == '\0')){
+			format_Char(&writer, *ptrFormat++);
+			continue;
+		}
+		ptrFormat++;
+		if(*ptrFormat == '%'){
+			format_Char(&writer, '%');
+			ptrFormat++;
+			continue;
+		}
+
+		uint32_t value = (argIndex < argc) ? record[LOG_HEADER_WORDS + argIndex] : 0;
+		argIndex++;
+
+		switch(*ptrFormat++){
+		case 'd':
+			format_Int(&writer, (int32_t)value, 0, FORMAT_PAD_SPACE);
+			break;
+		case 'u':
+			format_Uint(&writer, value, 0, FORMAT_PAD_SPACE);
+			break;
+		case 'x':
+		{
+			uint8_t digits = 1;
+			while((digits < 8) && (value >> (4 * digits))){
+				digits++;
+			}
+			format_Hex(&writer, value, digits);
+			break;
+		}
+		case 'c':
+			format_Char(&writer, (char)value);
+			break;
+		case 'f':
+		{
+			float number;
+			memcpy(&number, &value, sizeof(number));
+			format_Float(&writer, number, FORMAT_DEFAULT_DECIMALS);
+			break;
+		}
+		default:
+			format_Char(&writer, '?');
+			break;
+		}
+	}
+
+	/* 3. Fin de línea, como los mensajes de texto del programa */
+	format_String(&writer, " \r\n");
+	if(writer.flagOverflow){
+		/* La línea se cortó: al menos termina en un fin de línea */
+		line[sizeof(line) - 3] = '\r';
+		line[sizeof(line) - 2] = '\n';
+	}
+	usart_WriteBuffer(ptrLog->ptrUsartHandler, (uint8_t *)line, writer.length);
+}
@@ -0,0 +1,198 @@
+/*
+ * meter_driver.c
+ *
+ *  Created on: Dec 6, 2023
+ *      Author: sgaviriav
+ */
+
+// Importando librerías necesarias
+#include <stdint.h>
+#include <string.h>
+#include "meter_driver.h"
+#include "oled_driver.h"
+
+/* Cuadro nuevo del medidor, columna por columna (mismo orden que la copia) */
+static uint8_t auxFrame[METER_MAX_PAGES * METER_MAX_WIDTH];
+
+/* === Headers for private functions === */
+static uint32_t meter_column_mask(Meter_Handler_t *ptrMeter, uint8_t column, uint8_t needle);
+static uint8_t meter_send_columns(Meter_Handler_t *ptrMeter, uint8_t firstColumn, uint8_t lastColumn);
+
+
+/*
+ * Función para cargar la configuración del medidor.
+ * Limita el tamaño al máximo permitido y calcula la separación de la escala.
+ */
+void meter_Config(Meter_Handler_t *ptrMeter){
+
+	/* 1. Verificamos los límites del área del medidor */
+	if(ptrMeter->width > METER_MAX_WIDTH){
+		ptrMeter->width = METER_MAX_WIDTH;
+	}
+	if(ptrMeter->width < 8){
+		ptrMeter->width = 8;
+	}
+	if(ptrMeter->pages > METER_MAX_PAGES){
+		ptrMeter->pages = METER_MAX_PAGES;
+	}
+	if(ptrMeter->pages == 0){
+		ptrMeter->pages = 1;
+	}
+	if(ptrMeter->rangeCents == 0){
+		ptrMeter->rangeCents = 50;
+	}
+
+	/* 2. Columnas entre cada marca de la escala (cada METER_TICK_CENTS cents) */
+	ptrMeter->tickSpacing = ((ptrMeter->width/2 - 2) * METER_TICK_CENTS) / ptrMeter->rangeCents;
+
+	/* 3. La aguja inicia en el centro y el primer update dibuja todo */
+	ptrMeter->needleColumn = ptrMeter->width/2;
+	ptrMeter->bytesSent = 0;
+	meter_Invalidate(ptrMeter);
+}
+
+
+/*
+ * Indica que la pantalla ya no coincide con la copia del medidor (por ejemplo,
+ * después de oled_clearDisplay), de modo que el siguiente update lo redibuja completo
+ */
+void meter_Invalidate(Meter_Handler_t *ptrMeter){
+	ptrMeter->flagValid = 0;
+}
+
+
+/*
+ * Calcula los píxeles de una columna del medidor (bit r -> fila r, fila 0 arriba):
+ * - Línea base en la última fila
+ * - Marcas de la escala, y una marca más larga en el centro (afinado)
+ * - Barra desde el centro hasta la aguja
+ * - Aguja de dos columnas de ancho
+ */
+static uint32_t meter_column_mask(Meter_Handler_t *ptrMeter, uint8_t column, uint8_t needle){
+
+	uint8_t rows = ptrMeter->pages * 8;
+	uint8_t center = ptrMeter->width/2;
+	uint8_t distance = (column > center) ? (column - center) : (center - column);
+	uint32_t fullMask = (rows == 32) ? 0xFFFFFFFF : ((1UL << rows) - 1);
+	uint32_t mask = 0;
+
+	/* Línea base */
+	mask |= (1UL << (rows - 1));
+
+	/* Marca central (arriba y abajo) y marcas de la escala */
+	if(column == center){
+		mask |= 0b11;
+		mask |= (0b111111UL << (rows - 6)) & fullMask;
+	}
+	else if((ptrMeter->tickSpacing != 0) && ((distance % ptrMeter->tickSpacing) == 0)){
+		mask |= (0b111UL << (rows - 3));
+	}
+
+	/* Barra entre el centro y la aguja */
+	if(((column >= center) && (column <= needle)) || ((column <= center) && (column >= needle))){
+		mask |= (0b111UL << (rows - 4));
+	}
+
+	/* Aguja */
+	if((column == needle) || (column == (needle + 1))){
+		mask |= (fullMask >> 1);
+	}
+
+	return mask;
+}
+
+
+/*
+ * Envía a la OLED las columnas [firstColumn, lastColumn] del cuadro nuevo.
+ * El cuadro está columna por columna, así que el grupo es un bloque contiguo
+ * que se envía en direccionamiento vertical sin reordenar
+ */
+static uint8_t meter_send_columns(Meter_Handler_t *ptrMeter, uint8_t firstColumn, uint8_t lastColumn){
+
+	uint8_t length = lastColumn - firstColumn + 1;
+	uint16_t index = firstColumn * ptrMeter->pages;
+	uint16_t size = length * ptrMeter->pages;
+	uint8_t auxError = I2C_OK;
+
+	/* 1. Una ventana y un solo bloque de datos */
+	auxError = oled_Blit(ptrMeter->ptrHandlerI2C, &auxFrame[index], OLED_BLIT_COLUMNS,
+						 ptrMeter->startColumn + firstColumn, length, ptrMeter->startPage, ptrMeter->pages);
+
+	/* 2. Actualizamos la copia sólo si la escritura fue correcta */
+	if(auxError == I2C_OK){
+		memcpy(&ptrMeter->shadow[index], &auxFrame[index], size);
+		ptrMeter->bytesSent += size;
+	}
+	return auxError;
+}
+
+
+/*
+ * Función para actualizar el medidor con la desviación actual (en cents).
+ * Compara el cuadro nuevo con la copia de lo que tiene la pantalla y sólo
+ * envía los grupos de columnas que cambiaron.
+ * Devuelve I2C_OK o el código de error del I2C.
+ */
+uint8_t meter_Update(Meter_Handler_t *ptrMeter, float cents){
+
+	uint8_t center = ptrMeter->width/2;
+	int16_t auxNeedle = 0;
+	int16_t firstDirty = -1;
+	int16_t lastDirty = -1;
+	uint8_t auxError = I2C_OK;
+	uint8_t auxStatus = I2C_OK;
+
+	/* 1. Convertimos la desviación en la columna de la aguja */
+	if(cents > ptrMeter->rangeCents){
+		cents = ptrMeter->rangeCents;
+	}
+	else if(cents < -ptrMeter->rangeCents){
+		cents = -ptrMeter->rangeCents;
+	}
+	auxNeedle = center + (int16_t)((cents * (center - 2)) / ptrMeter->rangeCents);
+
+	/* Si la aguja no se movió y la pantalla está al día, no hay nada que enviar */
+	if(ptrMeter->flagValid && (auxNeedle == ptrMeter->needleColumn)){
+		return I2C_OK;
+	}
+	ptrMeter->needleColumn = (uint8_t)auxNeedle;
+
+	/* 2. Dibujamos el cuadro nuevo y buscamos los grupos de columnas que cambiaron */
+	for(uint8_t column = 0; column < ptrMeter->width; column++){
+
+		uint32_t mask = meter_column_mask(ptrMeter, column, ptrMeter->needleColumn);
+		uint8_t flagDirty = !ptrMeter->flagValid;
+
+		for(uint8_t page = 0; page < ptrMeter->pages; page++){
+			uint16_t index = column * ptrMeter->pages + page;
+			auxFrame[index] = (uint8_t)(mask >> (8 * page));
+			if(auxFrame[index] != ptrMeter->shadow[index]){
+				flagDirty = 1;
+			}
+		}
+
+		if(flagDirty){
+			/* Si el grupo anterior está lejos, lo enviamos y empezamos uno nuevo */
+			if((firstDirty >= 0) && ((column - lastDirty) > METER_MERGE_GAP)){
+				auxStatus = meter_send_columns(ptrMeter, firstDirty, lastDirty);
+				auxError = (auxStatus != I2C_OK) ? auxStatus : auxError;
+				firstDirty = -1;
+			}
+			if(firstDirty < 0){
+				firstDirty = column;
+			}
+			lastDirty = column;
+		}
+	}
+
+	/* 3. Enviamos el último grupo pendiente */
+	if(firstDirty >= 0){
+		auxStatus = meter_send_columns(ptrMeter, firstDirty, lastDirty);
+		auxError = (auxStatus != I2C_OK) ? auxStatus : auxError;
+	}
+
+	/* La copia sólo es confiable si todas las escrituras salieron bien */
+	ptrMeter->flagValid = (auxError == I2C_OK);
+
+	return auxError;
+}
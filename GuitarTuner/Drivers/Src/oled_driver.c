@@ -10,60 +10,27 @@
 #include "oled_driver.h"
 #include "i2c_driver_hal.h"
 
+/* Modo de direccionamiento que tiene cargado la pantalla (evita reenviar el comando 0x20) */
+static uint8_t oledAddressingMode = HORIZONTAL_ADDRESSING;
+
 
 /*
- * Función para enviar un  comando (configuración) a la pantalla
+ * Función para enviar un  comando (configuración) a la pantalla.
+ * La transacción completa (start, dirección, byte de control, comandos y stop)
+ * la realiza el driver I2C con tiempos de espera acotados y reintentos.
+ * Devuelve I2C_OK o el código de error del I2C.
  */
-void oled_sendCommand(I2C_Handler_t *ptrHandlerI2C, uint8_t *command, uint16_t length){
-
-	/* 1. Generamos la condición de "Start" */
-	i2c_StartTransaction(ptrHandlerI2C);
-
-	/* 2. Enviamos la dirección del esclavo y la indicación de ESCRIBIR */
-	i2c_SendSlaveAddressRW(ptrHandlerI2C, ptrHandlerI2C->slaveAddress, OLED_WRITE);
-
-	/* 3. Enviamos la dirección de memoria que deseamos escribir */
-	i2c_SendMemoryAddress(ptrHandlerI2C, CONTROL_BYTE_COMMAND);
-
-	/* 4. Enviamos el valor que deseamos escribir en el registro seleccionado */
-	for(uint16_t i = 0; i < length; i++){
-		i2c_SendDataByte(ptrHandlerI2C, command[i]);
-//		if(i < length){
-//			i2c_SendDataByte(ptrHandlerI2C, CONTROL_BYTE_COMMAND);
-//		}
-	}
-
-	/* 5. Generamos la condición Stop, para que el slave se detenga después de 1 byte */
-	i2c_StopTransaction(ptrHandlerI2C);
-
+uint8_t oled_sendCommand(I2C_Handler_t *ptrHandlerI2C, uint8_t *command, uint16_t length){
+	return i2c_WriteBuffer(ptrHandlerI2C, CONTROL_BYTE_COMMAND, command, length);
 }
 
 
 /*
- * Función para enviar un dato a la memoria de la pantalla GDDRAM (Graphic Display Data RAM)
+ * Función para enviar un dato a la memoria de la pantalla GDDRAM (Graphic Display Data RAM).
+ * Devuelve I2C_OK o el código de error del I2C.
  */
-void oled_sendData(I2C_Handler_t *ptrHandlerI2C, uint8_t *data, uint16_t length){
-
-	/* 1. Generamos la condición de "Start" */
-	i2c_StartTransaction(ptrHandlerI2C);
-
-	/* 2. Enviamos la dirección del esclavo y la indicación de ESCRIBIR */
-	i2c_SendSlaveAddressRW(ptrHandlerI2C, ptrHandlerI2C->slaveAddress, OLED_WRITE);
-
-	/* 3. Enviamos la dirección de memoria que deseamos escribir */
-	i2c_SendMemoryAddress(ptrHandlerI2C, CONTROL_BYTE_DATA);
-
-	/* 4. Enviamos el valor que deseamos escribir en el registro seleccionado */
-	for(uint16_t i = 0; i < length; i++){
-		i2c_SendDataByte(ptrHandlerI2C, data[i]);
-//		if(i < length){
-//			i2c_SendDataByte(ptrHandlerI2C, CONTROL_BYTE_DATA);
-//		}
-	}
-
-	/* 5. Generamos la condición Stop, para que el slave se detenga después de 1 byte */
-	i2c_StopTransaction(ptrHandlerI2C);
-
+uint8_t oled_sendData(I2C_Handler_t *ptrHandlerI2C, uint8_t *data, uint16_t length){
+	return i2c_WriteBuffer(ptrHandlerI2C, CONTROL_BYTE_DATA, data, length);
 }
 
 
@@ -564,58 +531,92 @@ void setLetter(uint8_t letter, uint8_t *letterArray){
 
 
 /*
- * Función para escribir una palabra en un segmento específico de la pantalla
+ * Función para escribir una palabra en un segmento específico de la pantalla.
+ * La palabra completa se arma en un buffer y se envía con una sola ventana.
  */
 void oled_setString(I2C_Handler_t *ptrHandlerI2C, uint8_t *string, uint8_t display_mode, uint8_t length, uint8_t start_column, uint8_t start_page){
 
-	/* Ubicamos el area donde se escribirá la palabra
-	 * - Una letra ocupa 5 columnas (5 páginas -> 8 bits por página)
-	 */
-	uint8_t array[6] = 	{0x21,start_column, (start_column+(6*length)-1),
-			0x22, start_page, start_page};
-	oled_sendCommand(ptrHandlerI2C, array, 6);
-
-	/*
-	 * Escribimos el string letra por letra
-	 */
+	/* Una letra ocupa 6 columnas de una página (5 de la letra + 1 de separación) */
+	uint8_t bitmap[6 * OLED_MAX_STRING_LENGTH] = {0};
 	uint8_t letterArray[6];
 
-	if(display_mode == NORMAL_DISPLAY){
+	if(length > OLED_MAX_STRING_LENGTH){
+		length = OLED_MAX_STRING_LENGTH;
+	}
+
+	/* Armamos el string letra por letra */
+	for(uint8_t i = 0; i < length; i++){
 		letterArray[5] = 0x00;
-		uint8_t i = 0;
-		while( i < length){
-			setLetter(string[i], letterArray);
-			oled_sendData(ptrHandlerI2C, letterArray, 6);
-			i++;
+		setLetter(string[i], letterArray);
+		for(uint8_t x = 0; x < 6; x++){
+			bitmap[(6 * i) + x] = (display_mode == INVERSE_DISPLAY) ? (uint8_t)~letterArray[x] : letterArray[x];
 		}
 	}
-	else if(display_mode == INVERSE_DISPLAY){
-		letterArray[5] = 0xFF;
-		uint8_t i = 0;
-		while( i < length){
-			setLetter(string[i], letterArray);
-			for(uint8_t x = 0; x < 6; x++){
-				letterArray[x-1] = ~letterArray[x-1];
-			}
-			oled_sendData(ptrHandlerI2C, letterArray, 6);
-			i++;
-		}
+
+	oled_Blit(ptrHandlerI2C, bitmap, OLED_BLIT_ROWS, start_column, 6 * length, start_page, 1);
+}
+
+
+/*
+ * Función para pintar un bitmap en un rectángulo de la pantalla (width columnas x pages páginas).
+ * Escoge el direccionamiento según el orden del bitmap (OLED_BLIT_ROWS -> horizontal,
+ * OLED_BLIT_COLUMNS -> vertical), de modo que el buffer se envía tal cual, en una sola
+ * transacción de datos. El cambio de modo y la ventana van juntos en una transacción de comandos,
+ * y el modo sólo se envía cuando cambia.
+ * Devuelve I2C_OK o el código de error del I2C.
+ */
+uint8_t oled_Blit(I2C_Handler_t *ptrHandlerI2C, uint8_t *bitmap, uint8_t layout, uint8_t start_column, uint8_t width, uint8_t start_page, uint8_t pages){
+
+	uint8_t array[8] = {0};
+	uint8_t index = 0;
+	uint8_t auxMode = (layout == OLED_BLIT_COLUMNS) ? VERTICAL_ADDRESSING : HORIZONTAL_ADDRESSING;
+	uint8_t auxError = I2C_OK;
+
+	if((width == 0) || (pages == 0)){
+		return I2C_OK;
+	}
+
+	/* 1. Con una sola página o una sola columna ambos modos recorren igual la ventana,
+	 * así que conservamos el modo actual (si no es el de páginas)
+	 */
+	if(((pages == 1) || (width == 1)) && (oledAddressingMode != PAGE_ADDRESSING)){
+		auxMode = oledAddressingMode;
+	}
+	if(auxMode != oledAddressingMode){
+		array[index++] = 0x20;
+		array[index++] = auxMode;
+	}
+
+	/* 2. Ventana del rectángulo */
+	array[index++] = 0x21;
+	array[index++] = start_column;
+	array[index++] = start_column + width - 1;
+	array[index++] = 0x22;
+	array[index++] = start_page;
+	array[index++] = start_page + pages - 1;
+
+	auxError = oled_sendCommand(ptrHandlerI2C, array, index);
+	if(auxError != I2C_OK){
+		return auxError;
 	}
+	oledAddressingMode = auxMode;
 
+	/* 3. Enviamos el bitmap completo */
+	return oled_sendData(ptrHandlerI2C, bitmap, (uint16_t)width * pages);
 }
 
+
 /*
  * Función para limpiar toda la pantalla OLED
  */
 void oled_clearDisplay(I2C_Handler_t *ptrHandlerI2C){
 
-	/* Establecemos los límites de las columnas y páginas de la pantalla */
-	oled_setColumn(ptrHandlerI2C, 0, 127);
-	oled_setPage(ptrHandlerI2C, 0, 7);
-
-	/* Pintamos todos los píxeles de negro (All -> 0x00) */
+	/* Pintamos todos los píxeles de negro (All -> 0x00) en una ventana de toda la pantalla.
+	 * Con el buffer en ceros el orden no importa, así que usamos el modo que ya esté cargado
+	 */
 	uint8_t array[1024] = {0};
-	oled_sendData(ptrHandlerI2C, array, 1024);
+	oled_Blit(ptrHandlerI2C, array, (oledAddressingMode == VERTICAL_ADDRESSING) ? OLED_BLIT_COLUMNS : OLED_BLIT_ROWS,
+			  0, 128, 0, 8);
 
 	/* Ubicamos el puntero al inicio de la primera columna y la primera página */
 	array[0] = 0x40;
@@ -655,6 +656,7 @@ void oled_Config(I2C_Handler_t *ptrHandlerI2C){
 
 	/* 2. Se envía la configuración por I2C */
 	oled_sendCommand(ptrHandlerI2C, buffer, 30);
+	oledAddressingMode = HORIZONTAL_ADDRESSING;
 }
 
 
@@ -667,7 +669,9 @@ void oled_setAddressingMode(I2C_Handler_t *ptrHandlerI2C, uint8_t mode){
 	uint8_t array[2] = {0};
 	array[0] = 0x20;
 	array[1] = mode;
-	oled_sendCommand(ptrHandlerI2C, array, 2);
+	if(oled_sendCommand(ptrHandlerI2C, array, 2) == I2C_OK){
+		oledAddressingMode = mode;
+	}
 }
 
 
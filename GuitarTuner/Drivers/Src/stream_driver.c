@@ -0,0 +1,379 @@
+/*
+ * stream_driver.c
+ *
+ *  Created on: Dec 10, 2023
+ *      Author: sgaviriav
+ */
+
+// Importando librerías necesarias
+#include <stdint.h>
+#include <string.h>
+#include "stream_driver.h"
+
+#define STREAM_HEADER_SIZE	2		// Tipo + secuencia
+#define STREAM_CRC_SIZE		2
+#define STREAM_COBS_BLOCK	254		// Bytes máximos sin ceros en un bloque COBS
+
+/* Trama antes de codificar: [tipo][secuencia][datos][CRC] */
+static uint8_t frameBuffer[STREAM_HEADER_SIZE + STREAM_MAX_PAYLOAD + STREAM_CRC_SIZE];
+
+/* Tabla del CRC-16/CCITT-FALSE (polinomio 0x1021), un byte por paso */
+static const uint16_t crc16Table[256] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/* === Headers for private functions === */
+static uint8_t stream_decimate(Stream_Handler_t *ptrStream, uint8_t frameType, uint8_t decimation);
+static uint8_t stream_send_frame(Stream_Handler_t *ptrStream, uint8_t frameType, uint16_t payloadLength);
+static uint16_t stream_crc16(uint8_t *data, uint16_t length);
+static uint32_t stream_write_cobs(USART_Handler_t *ptrUsartHandler, uint8_t *data, uint16_t length);
+static uint16_t stream_float_to_half(float value);
+static uint8_t *stream_put_u16(uint8_t *ptrBuffer, uint16_t value);
+static uint8_t *stream_put_float(uint8_t *ptrBuffer, float value);
+
+
+/*
+ * Función para cargar la configuración del stream.
+ * Reinicia secuencias, diezmado y contadores.
+ */
+void stream_Config(Stream_Handler_t *ptrStream){
+
+	if((ptrStream->maxBins == 0) || (ptrStream->maxBins > STREAM_MAX_SPECTRUM_BINS)){
+		ptrStream->maxBins = STREAM_DEFAULT_BINS;
+	}
+	if(ptrStream->spectrumFormat > STREAM_FORMAT_F16){
+		ptrStream->spectrumFormat = STREAM_FORMAT_Q15;
+	}
+
+	memset(ptrStream->count, 0, sizeof(ptrStream->count));
+	memset(ptrStream->sequence, 0, sizeof(ptrStream->sequence));
+	memset(&ptrStream->stats, 0, sizeof(Stream_Stats_t));
+}
+
+
+/*
+ * Envía un bloque de muestras del ADC (ya convertidas a float por el callback del ADC).
+ * Se debe llamar antes de la FFT, porque arm_rfft_fast_f32 modifica el arreglo de entrada.
+ * Retorna 1 si la trama se envió.
+ */
+uint8_t stream_SendADC(Stream_Handler_t *ptrStream, float *samples, uint16_t length, float sampleRate){
+
+	if(!stream_decimate(ptrStream, STREAM_FRAME_ADC, ptrStream->decimationADC)){
+		return 0;
+	}
+	if(length > STREAM_MAX_ADC_SAMPLES){
+		length = STREAM_MAX_ADC_SAMPLES;
+	}
+
+	/* 1. Encabezado de los datos */
+	uint8_t *ptrPayload = &frameBuffer[STREAM_HEADER_SIZE];
+	ptrPayload = stream_put_float(ptrPayload, sampleRate);
+	ptrPayload = stream_put_u16(ptrPayload, length);
+
+	/* 2. Las muestras del ADC son de 12 bits: viajan como enteros de 16 bits */
+	for(uint16_t i = 0; i < length; i++){
+		ptrPayload = stream_put_u16(ptrPayload, (uint16_t)samples[i]);
+	}
+
+	return stream_send_frame(ptrStream, STREAM_FRAME_ADC, ptrPayload - &frameBuffer[STREAM_HEADER_SIZE]);
+}
+
+
+/*
+ * Envía la magnitud del espectro (desde el bin 0), limitada a maxBins.
+ * En q15 cada bin se normaliza con el máximo de los bins enviados, que viaja como escala.
+ * Retorna 1 si la trama se envió.
+ */
+uint8_t stream_SendSpectrum(Stream_Handler_t *ptrStream, float *magnitude, uint16_t length, float resolution){
+
+	if(!stream_decimate(ptrStream, STREAM_FRAME_SPECTRUM, ptrStream->decimationSpectrum)){
+		return 0;
+	}
+	if(length > ptrStream->maxBins){
+		length = ptrStream->maxBins;
+	}
+
+	/* 1. Escala de los bins */
+	float scale = 1.0f;
+	if(ptrStream->spectrumFormat == STREAM_FORMAT_Q15){
+		scale = 0.0f;
+		for(uint16_t i = 0; i < length; i++){
+			if(magnitude[i] > scale){
+				scale = magnitude[i];
+			}
+		}
+		if(scale <= 0.0f){
+			scale = 1.0f;
+		}
+	}
+
+	/* 2. Encabezado de los datos */
+	uint8_t *ptrPayload = &frameBuffer[STREAM_HEADER_SIZE];
+	ptrPayload = stream_put_float(ptrPayload, resolution);
+	ptrPayload = stream_put_u16(ptrPayload, 0);
+	ptrPayload = stream_put_u16(ptrPayload, length);
+	*ptrPayload++ = ptrStream->spectrumFormat;
+	ptrPayload = stream_put_float(ptrPayload, scale);
+
+	/* 3. Bins empaquetados en 16 bits */
+	if(ptrStream->spectrumFormat == STREAM_FORMAT_Q15){
+		float factor = 32767.0f / scale;
+		for(uint16_t i = 0; i < length; i++){
+			float value = magnitude[i] * factor;
+			ptrPayload = stream_put_u16(ptrPayload, (value > 0.0f) ? (uint16_t)(value + 0.5f) : 0);
+		}
+	}
+	else{
+		for(uint16_t i = 0; i < length; i++){
+			ptrPayload = stream_put_u16(ptrPayload, stream_float_to_half(magnitude[i]));
+		}
+	}
+
+	return stream_send_frame(ptrStream, STREAM_FRAME_SPECTRUM, ptrPayload - &frameBuffer[STREAM_HEADER_SIZE]);
+}
+
+
+/*
+ * Envía la frecuencia detectada, la desviación en cents y la cuerda que se está afinando.
+ * Retorna 1 si la trama se envió.
+ */
+uint8_t stream_SendPitch(Stream_Handler_t *ptrStream, float frequency, float cents, uint8_t note, uint8_t tuned){
+
+	if(!stream_decimate(ptrStream, STREAM_FRAME_PITCH, ptrStream->decimationPitch)){
+		return 0;
+	}
+
+	uint8_t *ptrPayload = &frameBuffer[STREAM_HEADER_SIZE];
+	ptrPayload = stream_put_float(ptrPayload, frequency);
+	ptrPayload = stream_put_float(ptrPayload, cents);
+	*ptrPayload++ = note;
+	*ptrPayload++ = tuned;
+
+	return stream_send_frame(ptrStream, STREAM_FRAME_PITCH, ptrPayload - &frameBuffer[STREAM_HEADER_SIZE]);
+}
+
+
+/*
+ * Envía un registro del log diferido (palabras de 32 bits ya armadas por log_driver).
+ * Los registros no se diezman ni dependen de 'enable': la salida la decide el log.
+ * Retorna 1 si la trama se envió.
+ */
+uint8_t stream_SendLog(Stream_Handler_t *ptrStream, const uint32_t *record, uint8_t words){
+
+	if((words * sizeof(uint32_t)) > STREAM_MAX_PAYLOAD){
+		return 0;
+	}
+
+	/* Las palabras ya están en little-endian en la memoria del Cortex-M4 */
+	memcpy(&frameBuffer[STREAM_HEADER_SIZE], record, words * sizeof(uint32_t));
+
+	return stream_send_frame(ptrStream, STREAM_FRAME_LOG, words * sizeof(uint32_t));
+}
+
+
+/*
+ * Decide si la trama de este tipo se envía: el stream debe estar activo y
+ * se envía 1 de cada 'decimation' tramas (0 -> el tipo está apagado)
+ */
+static uint8_t stream_decimate(Stream_Handler_t *ptrStream, uint8_t frameType, uint8_t decimation){
+
+	if((ptrStream->enable != STREAM_ENABLE) || (decimation == 0)){
+		return 0;
+	}
+
+	uint8_t index = frameType - STREAM_FRAME_ADC;
+	ptrStream->count[index]++;
+	if(ptrStream->count[index] < decimation){
+		ptrStream->stats.skipped++;
+		return 0;
+	}
+	ptrStream->count[index] = 0;
+	return 1;
+}
+
+
+/*
+ * Completa la trama que ya tiene los datos en frameBuffer (encabezado y CRC),
+ * y la envía codificada con COBS seguida del delimitador
+ */
+static uint8_t stream_send_frame(Stream_Handler_t *ptrStream, uint8_t frameType, uint16_t payloadLength){
+
+	/* 1. Encabezado */
+	uint8_t index = frameType - STREAM_FRAME_ADC;
+	frameBuffer[0] = frameType;
+	frameBuffer[1] = ptrStream->sequence[index]++;
+
+	/* 2. CRC de encabezado y datos */
+	uint16_t length = STREAM_HEADER_SIZE + payloadLength;
+	uint16_t crc = stream_crc16(frameBuffer, length);
+	stream_put_u16(&frameBuffer[length], crc);
+	length += STREAM_CRC_SIZE;
+
+	/* 3. Codificamos y enviamos */
+	ptrStream->stats.bytesSent += stream_write_cobs(ptrStream->ptrUsartHandler, frameBuffer, length);
+	ptrStream->stats.frames++;
+
+	return 1;
+}
+
+
+/*
+ * CRC-16/CCITT-FALSE por tabla
+ */
+static uint16_t stream_crc16(uint8_t *data, uint16_t length){
+
+	uint16_t crc = 0xFFFF;
+	for(uint16_t i = 0; i < length; i++){
+		crc = (crc << 8) ^ crc16Table[((crc >> 8) ^ data[i]) & 0xFF];
+	}
+	return crc;
+}
+
+
+/*
+ * Codifica con COBS directamente hacia el buffer de transmisión del USART, sin un
+ * segundo buffer: por cada bloque se escribe el byte de código y luego los datos
+ * del bloque tal cual están en la trama (los ceros no se envían).
+ * Retorna el número de bytes escritos, incluidos los delimitadores.
+ */
+static uint32_t stream_write_cobs(USART_Handler_t *ptrUsartHandler, uint8_t *data, uint16_t length){
+
+	uint32_t written = 0;
+	uint16_t position = 0;
+	uint8_t code = 0;
+
+	/* 0. Delimitador inicial: separa la trama del texto que se haya enviado antes */
+	written += usart_WriteBuffer(ptrUsartHandler, &code, 1);
+
+	while(1){
+
+		/* 1. Bloque de bytes distintos de cero (máximo 254) */
+		uint16_t run = 0;
+		while(((position + run) < length) && (data[position + run] != 0) && (run < STREAM_COBS_BLOCK)){
+			run++;
+		}
+
+		/* 2. Código (distancia al siguiente cero) y datos del bloque */
+		code = run + 1;
+		written += usart_WriteBuffer(ptrUsartHandler, &code, 1);
+		if(run){
+			written += usart_WriteBuffer(ptrUsartHandler, &data[position], run);
+		}
+		position += run;
+
+		/* 3. Un bloque completo no reemplaza ningún cero; si no, saltamos el cero */
+		if(position >= length){
+			break;
+		}
+		if(run < STREAM_COBS_BLOCK){
+			position++;
+			if(position >= length){
+				/* La trama termina en cero: se codifica como un bloque vacío */
+				code = 1;
+				written += usart_WriteBuffer(ptrUsartHandler, &code, 1);
+				break;
+			}
+		}
+	}
+
+	/* 4. Delimitador de la trama */
+	code = 0;
+	written += usart_WriteBuffer(ptrUsartHandler, &code, 1);
+
+	return written;
+}
+
+
+/*
+ * Convierte un float a half float (IEEE 754 de 16 bits), redondeando al más cercano.
+ * Los valores fuera de rango se saturan al máximo (65504) en lugar de volverse infinito.
+ */
+static uint16_t stream_float_to_half(float value){
+
+	uint32_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+
+	uint16_t sign = (bits >> 16) & 0x8000;
+	int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+	uint32_t mantissa = bits & 0x007FFFFF;
+
+	/* 1. NaN e infinito */
+	if(((bits >> 23) & 0xFF) == 0xFF){
+		return sign | 0x7C00 | (mantissa ? 0x0200 : 0);
+	}
+
+	/* 2. Muy grande: saturamos */
+	if(exponent >= 31){
+		return sign | 0x7BFF;
+	}
+
+	/* 3. Muy pequeño: subnormal o cero */
+	if(exponent <= 0){
+		if(exponent < -10){
+			return sign;
+		}
+		mantissa |= 0x00800000;
+		uint8_t shift = 14 - exponent;
+		uint16_t half = mantissa >> shift;
+		if((mantissa >> (shift - 1)) & 1){
+			half++;
+		}
+		return sign | half;
+	}
+
+	/* 4. Normal: el acarreo del redondeo pasa al exponente sin problema */
+	uint16_t half = (uint16_t)((exponent << 10) | (mantissa >> 13));
+	if(mantissa & 0x00001000){
+		half++;
+	}
+	if(half > 0x7BFF){
+		half = 0x7BFF;
+	}
+	return sign | half;
+}
+
+
+/*
+ * Escriben un valor en little-endian y retornan la siguiente posición libre
+ */
+static uint8_t *stream_put_u16(uint8_t *ptrBuffer, uint16_t value){
+	ptrBuffer[0] = value & 0xFF;
+	ptrBuffer[1] = (value >> 8) & 0xFF;
+	return ptrBuffer + 2;
+}
+
+static uint8_t *stream_put_float(uint8_t *ptrBuffer, float value){
+	memcpy(ptrBuffer, &value, sizeof(float));
+	return ptrBuffer + sizeof(float);
+}
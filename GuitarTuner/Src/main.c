@@ -18,30 +18,42 @@
 // IMPORTACIÓN DE LIBRERÍAS NECESARIAS
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <math.h>
 #include "arm_math.h"
 
 #include "stm32f4xx.h"
 #include "stm32_assert.h"
 #include "systick_driver_hal.h"
+#include "swtimer_driver_hal.h"
+#include "scheduler_driver_hal.h"
+#include "profiler_driver_hal.h"
 #include "gpio_driver_hal.h"
 #include "timer_driver_hal.h"
-#include "exti_driver_hal.h"
 #include "adc_driver_hal.h"
 #include "usart_driver_hal.h"
 #include "pwm_driver_hal.h"
 #include "i2c_driver_hal.h"
+#include "format_driver_hal.h"
+#include "shell_driver_hal.h"
+#include "capture_driver_hal.h"
+#include "encoder_driver_hal.h"
+#include "input_driver_hal.h"
+#include "pll_driver_hal.h"
 
 #include "microphone_driver.h"
 #include "oled_driver.h"
+#include "meter_driver.h"
+#include "display_driver.h"
+#include "stream_driver.h"
+#include "log_driver.h"
 
 /* ===== CONSTANTES ===== */
-#define	MCU_CLOCK_16_MHz	16000000
 #define LENGTH				1
 
 /* ===== LED DE ESTADO ===== */
 GPIO_Handler_t userLed = {0}; //Led de estado PinA5
-Timer_Handler_t blinkTimer = {0};
+uint16_t blinkTimer = SWTIMER_INVALID;	// Timer por software del blinky (libera el TIM2)
 
 
 /* ===== SYSTICK ===== */
@@ -56,6 +68,66 @@ GPIO_Handler_t pinRx = {0};
 uint8_t usart2DataReceived = 0;
 char	bufferMsg[64] = {0};
 
+/* Tramas binarias de depuración (ADC, espectro y pitch) por el mismo USART.
+ * Se activan y desactivan enviando 'b' por la terminal
+ */
+Stream_Handler_t tunerStream = {0};
+
+/* Intérprete de comandos: las líneas que empiezan con ':' (por ejemplo ":fs 4000")
+ * cambian los parámetros del DSP sin reprogramar. El resto de teclas sigue yendo a los menús
+ */
+Shell_Handler_t tunerShell = {0};
+
+/* Log diferido: los mensajes de la afinación se guardan como registros binarios y se
+ * envían desde el loop principal (en texto, o en tramas con ":log bin")
+ */
+Log_Handler_t tunerLog = {0};
+
+/* Tareas de fondo del planificador cooperativo. Los menús y la afinación siguen en el
+ * main, y mientras esperan (teclas, capturas, pausas) llaman sched_Yield o sched_Delay_ms,
+ * que ejecutan estas tareas y duermen el procesador cuando no hay trabajo
+ */
+Sched_Task_t taskDisplay = {0};		// Envía a la OLED los cambios (cada 10 ms, limitado por frameRate)
+Sched_Task_t taskShell = {0};		// Ejecuta los comandos: la despierta la recepción del USART
+Sched_Task_t taskLog = {0};			// Envía los mensajes pendientes del log (cada 10 ms)
+
+#define EVENT_SHELL_RX		(1UL << 0)	// Llegaron caracteres del shell
+
+/* Secciones que se miden con el contador de ciclos (":prof" muestra la tabla) */
+enum
+{
+	PROF_PROCESAMIENTO = 0,		// procesamientoFFT completo
+	PROF_FFT,					// arm_rfft_fast_init_f32 + arm_rfft_fast_f32
+	PROF_MAGNITUD,				// Magnitud y máximos del espectro
+	PROF_STREAM,				// Tramas de espectro y pitch (escritura en el USART)
+	PROF_OLED,					// display_Process
+	PROF_LOG,					// log_Process
+	PROF_SECCIONES
+};
+
+const char *const nombresProf[PROF_SECCIONES] = {"procesamiento", "fft", "magnitud", "stream", "oled", "log"};
+
+/* Tiempos de la interrupción del ADC (":adc" muestra los histogramas). El periodo entre
+ * conversiones da el jitter del muestreo y la frecuencia de muestreo medida
+ */
+Prof_Histogram_t adcPeriodo = {0};		// Ciclos entre dos llamados de adc_CompleteCallback
+Prof_Histogram_t adcDuracion = {0};		// Ciclos dentro de adc_CompleteCallback
+
+#define ADC_PERIODO_BIN		16		// Ciclos por bin del periodo (1 us con el HSI)
+#define ADC_DURACION_BIN	32		// Ciclos por bin de la duración
+
+/* Calibración de la frecuencia de muestreo: la frecuencia real se mide con el periodo
+ * promedio entre conversiones (contador de ciclos), con todos los disparos perdidos o
+ * conversiones de más incluidos. Se guarda junto con el periodo del PWM con que se midió,
+ * y si el periodo cambia se vuelve a medir en la primera captura (o con ":cal")
+ */
+#define CAL_MIN_MUESTRAS	256		// Intervalos mínimos para aceptar una medición
+
+float32_t	frec_calibrada = 0;			// Frecuencia medida (Hz)
+float32_t	escala_calibracion = 1.0f;	// frec_calibrada / frec_muestreo de la última medición
+uint16_t	periodo_calibrado = 0;		// Periodo del PWM de la medición (0 -> sin calibrar)
+uint32_t	muestras_calibracion = 0;	// Intervalos usados en la medición
+
 
 /* ===== MICRÓFONO ===== */
 
@@ -64,21 +136,39 @@ ADC_Config_t sensores[LENGTH] = {0}; // Array de sensores
 ADC_Config_t sensor1 = {0};
 uint16_t	count_ADC_Data = 0; // Contador de la cantidad de datos que lleva el arreglo ADC_Data[512]
 uint8_t		flagStop = 0;	// Detiene las conversiones ADC cuando finalice las 512 conversiones
+uint8_t		flagCapturando = 0;	// 1 -> hay una captura en curso (el shell deja los comandos para después)
 
 // PWM para generar la frecuencia de muestreo
 PWM_Handler_t pwmHandler = {0};
 
+/* Fuente de la frecuencia de la cuerda. La captura de entrada mide el periodo de la
+ * señal cuadrada (micrófono + comparador en PA1, TIM5_CH2) sin ADC ni FFT, y sirve para
+ * señales limpias de una sola cuerda; la FFT es la fuente por defecto
+ */
+enum
+{
+	FUENTE_FFT = 0,
+	FUENTE_CAPTURA
+};
+
+uint8_t fuentePitch = FUENTE_FFT;
+Capture_Handler_t pitchCapture = {0};
+GPIO_Handler_t pinCapture = {0};
+
+#define CAPTURA_TIEMPO_MAX		500		// ms máximos esperando una medición confiable
+#define CAPTURA_CONFIANZA_MIN	50		// Confianza mínima (0 - 100) para aceptar la medición
+
 // Código de los videos del classroom
 /* Elementos para el procesamiento de una señal */
 #define 	ADC_DataSize 1024	// Tamaño del arreglo de datos
 uint16_t 	fftSize = ADC_DataSize;		// Tamaño del arreglo de los valores obtenidos de la transformada
 float32_t 	frec_muestreo; //frecuencia de muestreo -> 3kHz
-float32_t	factor_correccion;
-float32_t	frec_corregida;
+float32_t	frec_corregida;	// Frecuencia de muestreo real (la calibrada, o la nominal escalada)
 float32_t	frec_real;
 float32_t	frec_real_magnitud;
 float32_t 	frec_prom;
 float32_t 	resolucion_FFT;
+float32_t	tolerancia_bins = 1.0f;	// Tolerancia para considerar la cuerda afinada, en intervalos de la FFT
 
 float32_t	fft_reales[ADC_DataSize/2];
 float32_t 	fft_magnitud[ADC_DataSize/2];
@@ -128,7 +218,7 @@ arm_status statusInitFFT = ARM_MATH_ARGUMENT_ERROR;
 
 /* ===== COMUNICACIÓN I2C PARA OLED ===== */
 // Handlers necesarios para I2C
-Timer_Handler_t blinkString = {0};
+uint16_t blinkString = SWTIMER_INVALID;	// Timer por software del parpadeo del menú (libera el TIM5)
 GPIO_Handler_t pinSCL_I2C = {0};
 GPIO_Handler_t pinSDA_I2C = {0};
 I2C_Handler_t i2c_handler = {0};
@@ -141,9 +231,6 @@ uint8_t flagMenu1 = 0;
 uint8_t flagMenu2 = 0;
 uint8_t flagMenu = 0;
 uint8_t flagLetterM = 0;
-uint8_t opAnim = 0;
-uint8_t flagAnim = 0;
-uint8_t countAnim = 0;
 
 /* Variables para definir el área de escritura de cada letra */
 uint8_t E4_Col = 0;
@@ -159,21 +246,29 @@ uint8_t A2_Page = 0;
 uint8_t E2_Col = 0;
 uint8_t E2_Page = 0;
 
-/* Array para figura mostrada durante el proceso de afinación */
-uint8_t array_figura[104] = {0};
+/* Medidor de la desviación (cents) mostrado durante el proceso de afinación */
+Meter_Handler_t tunerMeter = {0};
+float32_t cents_desviacion = 0;
+
+/* Planificador de las escrituras de texto en la OLED (limita la tasa de refresco) */
+Display_Handler_t oledDisplay = {0};
 
 /* ===== ENCODER ===== */
 // Handlers para los pines del encoder
-GPIO_Handler_t encoderClk = {0}; // Pin PC8 (Canal 8 del EXTI)
-GPIO_Handler_t data = {0};	// Pin PB2
-GPIO_Handler_t sw = {0};	// Pin PA0 (Canal 0 del EXTI)
+GPIO_Handler_t encoderClk = {0}; // Pin PB6 (TIM4_CH1)
+GPIO_Handler_t data = {0};	// Pin PB7 (TIM4_CH2)
+GPIO_Handler_t sw = {0};	// Pin PA0 (entrada, activo en alto)
 
-/* Definición de los EXTI para las interrupciones externas del encoder */
-EXTI_Config_t exti0 = {0};	// Definimos el EXTI del Switch (estructura -> "objeto")
-EXTI_Config_t exti8 = {0};	// Definimos el EXTI del Encoder (estructura -> "objeto")
+/* El TIM4 en modo encoder cuenta los pasos por hardware (sin interrupciones) */
+Encoder_Handler_t menuEncoder = {0};
 
-/* Definicón de la variable para leer la entrada del Data del Encoder */
-uint8_t readData = 0;
+/* Entradas de los menús: el switch (con antirrebote) y el encoder se muestrean cada 5 ms
+ * y llegan como eventos a una cola, que evaluate() vacía desde el main
+ */
+#define BOTON_SWITCH	0		// Índice del switch en botonesMenu
+
+Input_Button_t botonesMenu[1] = {0};
+Input_Handler_t menuInput = {0};
 
 /* Definición de variables contadoras para el switch
  * y los desplazamientos del encoder
@@ -183,26 +278,60 @@ uint8_t contadorMenu0 = MODO_AUTOMATICO;
 uint8_t contadorMenu1 = E4;
 uint8_t contadorMenu2 = RESPUESTA_AUTO_SI;
 
-/* Definición de las banderas */
-uint8_t flagMode = 0;		// Bandera del EXTI del Switch. Se asigna 0 para indicar que se inicializa en Modo Resolución
-uint8_t flagData = 0;		// Bandera del EXTI del Encoder.
-
 
 
 /* ===== HEADERS DE LAS FUNCIONES DEL MAIN ===== */
 void configPeripherals(void);
 void configParameters(void);
 void procesamientoFFT(float32_t *array);
+void medirFrecuencia(void);
+void terminarCaptura(void);
 void seleccionRango(float32_t frecuencia);
 void verificarFrecuencia(float32_t numero);
 void seleccionModo(void);
 void seleccionAutomatica(void);
 void seleccionManual(void);
 void evaluate(void);
-void animacionApretar(void);
-void animacionAflojar(void);
+void entrarMenu(uint8_t menu);
+uint8_t moverOpcion(uint8_t opcion, int16_t pasos, uint8_t minimo, uint8_t maximo);
+float32_t calcularCents(float32_t frec_medida, float32_t frec_objetivo);
 void mensajeAfinado(void);
 void muestraNota(uint8_t nota_cuerda);
+uint32_t relojTimerPWM(void);
+void actualizarParametrosDSP(void);
+uint8_t calibrarMuestreo(void);
+void aplicarCalibracion(void);
+void parpadeoMenu(uint8_t newState);
+void blinkLed_Callback(void *context);
+void blinkString_Callback(void *context);
+void tareaDisplay(Sched_Task_t *ptrTask, uint32_t events);
+void tareaShell(Sched_Task_t *ptrTask, uint32_t events);
+void tareaLog(Sched_Task_t *ptrTask, uint32_t events);
+
+/* Comandos del shell */
+uint8_t cmdAdc(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+uint8_t cmdCal(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+uint8_t cmdFft(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+uint8_t cmdFs(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+uint8_t cmdLog(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+uint8_t cmdPitch(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+uint8_t cmdProf(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+uint8_t cmdStatus(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+uint8_t cmdTol(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+
+/* Tabla de comandos, ordenada alfabéticamente (el shell la recorre con búsqueda binaria) */
+const Shell_Command_t tunerCommands[] = {
+		{"adc",		cmdAdc,				"adc [reset] -> jitter y duracion de la interrupcion del ADC"},
+		{"cal",		cmdCal,				"cal [reset] -> mide la frecuencia de muestreo real con la ultima captura"},
+		{"fft",		cmdFft,				"fft [256|512|1024] -> tamano de la FFT"},
+		{"fs",		cmdFs,				"fs [Hz] -> frecuencia de muestreo nominal"},
+		{"help",	shell_CommandHelp,	"lista los comandos"},
+		{"log",		cmdLog,				"log [text|bin|off] -> salida del log"},
+		{"pitch",	cmdPitch,			"pitch [fft|cap] -> fuente de la frecuencia de la cuerda"},
+		{"prof",	cmdProf,			"prof [reset] -> ciclos de cada seccion medida"},
+		{"status",	cmdStatus,			"parametros actuales y contadores"},
+		{"tol",		cmdTol,				"tol [intervalos] -> tolerancia de afinacion"},
+};
 
 
 /*
@@ -222,13 +351,7 @@ int main(void){
 	sensores[0] = sensor1;
 
 	/* ===== DEFINICIÓN DE VARIABLES ===== */
-	frec_muestreo = MCU_CLOCK_16_MHz / (pwmHandler.config.periodo * pwmHandler.config.prescaler);	// Valor para la frecuencia de muestreo
-
-	factor_correccion = (0.00101 * (frec_muestreo/1000)) + 0.0612; // Factor de corrección de la frecuecnia -> x/1000 Porque se obtuvo a partir de kHz
-
-	frec_corregida = frec_muestreo * (1 - factor_correccion);	// Frecuencia corregida (Aproximación a la Real)
-
-	resolucion_FFT = frec_corregida/ADC_DataSize;	// Resolución de la transformada -> Distancia entre cada intervalo de frecuencia
+	actualizarParametrosDSP();	// Frecuencia de muestreo y resolución de la FFT
 
 
 	/* Cargamos la configuración de los sensores en la función Multicanal del ADC */
@@ -243,23 +366,28 @@ int main(void){
 	/* Limpiamos la pantalla primero */
 	oled_clearDisplay(&i2c_handler);
 
+	/* Cargamos la configuración del planificador de la pantalla */
+	display_Config(&oledDisplay);
+
 	/* Delay para tener tiempo de ver por la terminal */
-	systick_Delay_ms(SYSTICK_3s);
+	sched_Delay_ms(SYSTICK_3s);
 
 	usart_WriteMsg(&commSerial, "-> Presione 't' para probar USART \r\n");
 	usart_WriteMsg(&commSerial, "-> Presione '1' para iniciar el programa \n\r");
+	usart_WriteMsg(&commSerial, "-> Presione 'b' para activar/desactivar las tramas binarias \n\r");
+	usart_WriteMsg(&commSerial, "-> Escriba ':help' y Enter para ver los comandos \n\r");
 
 	/* Pintamos la interfaz del menú inicial */
 	uint8_t bufferString[64] = {0};
 
-	sprintf((char *)bufferString, "BIENVENIDO A");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 12, 28, 1);
+	format_Copy((char *)bufferString, sizeof(bufferString), "BIENVENIDO A");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 12, 28, 1);
 
-	sprintf((char *)bufferString, "GUITAR TUNER");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 12, 28, 3);
+	format_Copy((char *)bufferString, sizeof(bufferString), "GUITAR TUNER");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 12, 28, 3);
 
-	sprintf((char *)bufferString, "EMPEZAR");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 7, 43, 5);
+	format_Copy((char *)bufferString, sizeof(bufferString), "EMPEZAR");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 7, 43, 5);
 
 
 	/* Loop forever*/
@@ -267,20 +395,26 @@ int main(void){
 
 		/* Parpadeo de la opción seleccionada */
 		if(flagMenuInicial && (contadorSwitch == MODO_MENU_INICIAL)){
-			timer_SetState(&blinkString, TIMER_ON);
+			parpadeoMenu(TIMER_ON);
 			uint8_t bufferString[64] = {0};
 			if(flagBlinkString == 0){
-				sprintf((char *)bufferString, "EMPEZAR");
-				oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 7, 43, 5);
+				format_Copy((char *)bufferString, sizeof(bufferString), "EMPEZAR");
+				display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 7, 43, 5);
 			}
 			else if(flagBlinkString == 1){
-				sprintf((char *)bufferString, "EMPEZAR");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 7, 43, 5);
+				format_Copy((char *)bufferString, sizeof(bufferString), "EMPEZAR");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 7, 43, 5);
 			}
 			flagMenuInicial ^= 1;
 			flagBlinkString ^= 1;
 		}
 
+		/* Ejecutamos las tareas de fondo (OLED, shell, log), o dormimos hasta la siguiente interrupción */
+		sched_Yield();
+
+		/* Eventos del switch y del encoder */
+		evaluate();
+
 
 		/* Prueba del USART */
 		if (usart2DataReceived == 't'){
@@ -291,11 +425,10 @@ int main(void){
 		/* Iniciamos el programa */
 		if ((usart2DataReceived == '1') || (contadorSwitch == MODO_MENU_0)){
 
-			timer_SetState(&blinkString, TIMER_OFF);
+			parpadeoMenu(TIMER_OFF);
 
 			flagMenuInicial = 0;
 			flagBlinkString = 0;
-			opAnim = 0;
 			flagMenu0 = 1;
 			contadorMenu0 = 1;
 			usart2DataReceived = '\0';
@@ -325,6 +458,7 @@ int main(void){
 
 			stopPwmSignal(&pwmHandler);
 
+			log_Flush(&tunerLog);
 			usart_WriteMsg(&commSerial, "\r\n");
 			usart_WriteMsg(&commSerial, "Pausando conversiones. \r\n");
 			usart_WriteMsg(&commSerial, "Presione '1' para reiniciar la ejecución \n\r");
@@ -397,10 +531,7 @@ void configParameters(void){
 	flagMenu = 0;
 	flagLetterM = 0;
 
-	opAnim = 0;
 	flagBlinkString = 0;
-	flagAnim = 0;
-	countAnim = 0;
 
 
 	/* Definimos los valores de las variables que controlan la muestra del Menu 1 en la OLED */
@@ -417,38 +548,7 @@ void configParameters(void){
 	E2_Col 	= 58;		// Cuerda 6
 	E2_Page = 7;
 
-	/* Figura para mostrar durante la afinación */
-	/**/array_figura[0]  = 0b00000000; /**/array_figura[51] = 0b00000000;  /**/array_figura[26] = 0b00000000;
-	array_figura[79]  = 0b11111110; /**/array_figura[52] = 0b00000000; array_figura[27] = 0b00000000; array_figura[1] = 0b00000000;
-	array_figura[80]  = 0b11111110; array_figura[53] = 0b00000000; array_figura[28] = 0b00000000; array_figura[2] = 0b00000000;
-	array_figura[81]  = 0b11111110; array_figura[54] = 0b00000000; array_figura[29] = 0b00000000; array_figura[3] = 0b00000000;
-	array_figura[82]  = 0b00000000; array_figura[55] = 0b00000000; array_figura[30] = 0b00000000; array_figura[4] = 0b00000000;
-	array_figura[83]  = 0b11111111; array_figura[56] = 0b00000000; array_figura[31] = 0b00000000; array_figura[5] = 0b00000000;
-	array_figura[84]  = 0b11111111; array_figura[57] = 0b11111110; array_figura[32] = 0b00000000; array_figura[6] = 0b00000000;
-	array_figura[85]  = 0b11111111; array_figura[58] = 0b11111110; array_figura[33] = 0b00000000; array_figura[7] = 0b00000000;
-	array_figura[86]  = 0b00000000; array_figura[59] = 0b11111110; array_figura[34] = 0b00000000; array_figura[8] = 0b00000000;
-	array_figura[87]  = 0b11111111; array_figura[60] = 0b00000000; array_figura[35] = 0b11111111; array_figura[9] = 0b11111111;
-	array_figura[88] = 0b11111111; array_figura[61] = 0b11111111; array_figura[36] = 0b11111111; array_figura[10] = 0b11111111;
-	array_figura[89] = 0b11111111; array_figura[62] = 0b11111111; array_figura[37] = 0b11111111; array_figura[11] = 0b11111111;
-	array_figura[90] = 0b00000000; array_figura[63] = 0b11111111; array_figura[38] = 0b00000000; array_figura[12] = 0b00000000;
-	array_figura[91] = 0b11111111; array_figura[64] = 0b00000000; array_figura[39] = 0b11111110; array_figura[13] = 0b00000000;
-	array_figura[92] = 0b11111111; array_figura[65] = 0b11111111; array_figura[40] = 0b11111110; array_figura[14] = 0b00000000;
-	array_figura[93] = 0b11111111; array_figura[66] = 0b11111111; array_figura[41] = 0b11111110; array_figura[15] = 0b00000000;
-	array_figura[94] = 0b00000000; array_figura[67] = 0b11111111; array_figura[42] = 0b00000000; array_figura[16] = 0b00000000;
-	array_figura[95] = 0b11111111; array_figura[68] = 0b00000000; array_figura[43] = 0b11000000; array_figura[17] = 0b00000000;
-	array_figura[96] = 0b11111111; array_figura[69] = 0b11111111; array_figura[44] = 0b11000000; array_figura[18] = 0b00000000;
-	array_figura[97] = 0b11111111; array_figura[70] = 0b11111111; array_figura[45] = 0b11000000; array_figura[19] = 0b00000000;
-	array_figura[98] = 0b00000000; array_figura[71] = 0b11111111; array_figura[46] = 0b00000000; array_figura[20] = 0b00000000;
-	array_figura[99] = 0b11111111; array_figura[72] = 0b00000000; array_figura[47] = 0b00000000; array_figura[21] = 0b00000000;
-	array_figura[100] = 0b11111111; array_figura[73] = 0b11100000; array_figura[48] = 0b00000000; array_figura[2] = 0b00000000;
-	array_figura[101] = 0b11111111; array_figura[74] = 0b11100000; array_figura[49] = 0b00000000; array_figura[23] = 0b00000000;
-	array_figura[102] = 0b00000000; array_figura[75] = 0b11100000; array_figura[50] = 0b00000000; array_figura[24] = 0b00000000;
-	/**/array_figura[103] = 0b00000000; array_figura[76] = 0b00000000;							   /**/array_figura[25] = 0b00000000;
-	/**/array_figura[78] = 0b00000000; /**/array_figura[77] = 0b00000000;
-
-
-	/* Banderas y contadores del EXTI */
-	flagData = 0;
+	/* Contadores del switch y de los menús */
 	contadorSwitch = MODO_MENU_INICIAL;
 	contadorMenu0 = MODO_AUTOMATICO;
 	contadorMenu1 = E4;
@@ -529,31 +629,14 @@ void configPeripherals(void){
 
 
 	// 2. ===== TIMERS =====
-	/* Configurando el Timer del Blinky*/
-	blinkTimer.pTIMx								= TIM2;
-	blinkTimer.TIMx_Config.TIMx_Prescaler			= 16000;	// Genera incrementos de 1 ms
-	blinkTimer.TIMx_Config.TIMx_Period				= 500;		// De la mano con el pre-scaler, determina cuando se dispara una interrupción (500 ms)
-	blinkTimer.TIMx_Config.TIMx_mode				= TIMER_UP_COUNTER;	// El Timer cuante ascendente
-	blinkTimer.TIMx_Config.TIMx_InterruptEnable		= TIMER_INT_ENABLE;	// Se activa la interrupción
-
-	/* Cargamos la configuración del Timer */
-	timer_Config(&blinkTimer);
-
-	/* Encendemos el Timer */
-	timer_SetState(&blinkTimer, TIMER_ON);
-
-	/* Configurando el Timer para el parpadeo de la opción actual disponible para seleccionar en el menu*/
-	blinkString.pTIMx								= TIM5;
-	blinkString.TIMx_Config.TIMx_Prescaler			= 16000;	// Genera incrementos de 1 ms
-	blinkString.TIMx_Config.TIMx_Period				= 1000;		// De la mano con el pre-scaler, determina cuando se dispara una interrupción (500 ms)
-	blinkString.TIMx_Config.TIMx_mode				= TIMER_UP_COUNTER;	// El Timer cuante ascendente
-	blinkString.TIMx_Config.TIMx_InterruptEnable	= TIMER_INT_ENABLE;	// Se activa la interrupción
-
-	/* Cargamos la configuración del Timer */
-	timer_Config(&blinkString);
+	/* El blinky y el parpadeo del menú son timers por software sobre el SysTick (1 ms),
+	 * así el TIM2 y el TIM5 quedan libres. El blinky arranca de una vez (500 ms);
+	 * el parpadeo del menú (1000 ms) se enciende con parpadeoMenu()
+	 */
+	blinkTimer = swtimer_Start(500, SWTIMER_PERIODIC, blinkLed_Callback, &userLed);
 
-	/* Apagamos el Timer del parpadeo de opción de OLED */
-	timer_SetState(&blinkString, TIMER_OFF);
+	/* Apagamos el parpadeo de opción de OLED */
+	parpadeoMenu(TIMER_OFF);
 
 
 	// 4. ===== USARTS =====
@@ -565,6 +648,8 @@ void configPeripherals(void){
 	commSerial.USART_Config.stopbits		= USART_STOPBIT_1;
 	commSerial.USART_Config.mode			= USART_MODE_RXTX;
 	commSerial.USART_Config.enableIntRX		= USART_RX_INTERRUP_ENABLE;
+	commSerial.USART_Config.enableDMA		= USART_DMA_RXTX;			// Los mensajes salen por DMA y los comandos llegan por tramas
+	commSerial.USART_Config.txPolicy		= USART_TX_POLICY_BLOCK;	// Las instrucciones al usuario no se pueden perder
 
 	/* Cargamos la configuración de USART */
 	usart_Config(&commSerial);
@@ -575,6 +660,56 @@ void configPeripherals(void){
 	 */
 	usart_WriteChar(&commSerial, '\0');
 
+	/* Configurando las tramas de depuración (arrancan apagadas) */
+	tunerStream.ptrUsartHandler		= &commSerial;
+	tunerStream.enable				= STREAM_DISABLE;
+	tunerStream.spectrumFormat		= STREAM_FORMAT_Q15;
+	tunerStream.maxBins				= 256;		// Hasta fs/4, donde están todas las cuerdas
+	tunerStream.decimationADC		= 4;		// 2 kB por trama: sólo 1 de cada 4 capturas
+	tunerStream.decimationSpectrum	= 1;
+	tunerStream.decimationPitch		= 1;
+
+	/* Cargamos la configuración del stream */
+	stream_Config(&tunerStream);
+
+	/* Configurando el shell (las respuestas salen por el mismo USART) */
+	tunerShell.ptrUsartHandler		= &commSerial;
+	tunerShell.ptrCommands			= tunerCommands;
+	tunerShell.numCommands			= sizeof(tunerCommands) / sizeof(tunerCommands[0]);
+	tunerShell.startChar			= ':';
+
+	/* Cargamos la configuración del shell */
+	shell_Config(&tunerShell);
+
+	/* Configurando el log diferido (en texto, como los demás mensajes) */
+	tunerLog.ptrUsartHandler		= &commSerial;
+	tunerLog.ptrStream				= &tunerStream;
+	tunerLog.output					= LOG_OUTPUT_TEXT;
+
+	/* Cargamos la configuración del log */
+	log_Config(&tunerLog);
+
+	/* Encendemos el contador de ciclos del profiler (los us salen del HCLK configurado en el RCC) */
+	prof_Init(nombresProf, PROF_SECCIONES);
+
+	/* Configurando las tareas de fondo. La del shell es la de mayor prioridad, para que
+	 * los comandos respondan aunque la OLED o el log tengan trabajo pendiente
+	 */
+	taskShell.function		= tareaShell;
+	taskShell.priority		= SCHED_PRIORITY_HIGH;
+	taskShell.period		= 0;
+	sched_AddTask(&taskShell);
+
+	taskDisplay.function	= tareaDisplay;
+	taskDisplay.priority	= SCHED_PRIORITY_NORMAL;
+	taskDisplay.period		= 10;
+	sched_AddTask(&taskDisplay);
+
+	taskLog.function		= tareaLog;
+	taskLog.priority		= SCHED_PRIORITY_LOW;
+	taskLog.period			= 10;
+	sched_AddTask(&taskLog);
+
 
 	// 5. ===== PWM =====
 	/* Configurando el PWM */
@@ -598,37 +733,72 @@ void configPeripherals(void){
 
 
 	// 7. ===== ENCODER =====
-	/* Pin del Encoder Clock */
-	encoderClk.pGPIOx							= GPIOC;
-	encoderClk.pinConfig.GPIO_PinNumber			= PIN_8;
-	encoderClk.pinConfig.GPIO_PinMode			= GPIO_MODE_IN;
+	/* Pin del Encoder Clock -> TIM4_CH1 (AF2) */
+	encoderClk.pGPIOx							= GPIOB;
+	encoderClk.pinConfig.GPIO_PinNumber			= PIN_6;
+	encoderClk.pinConfig.GPIO_PinMode			= GPIO_MODE_ALTFN;
+	encoderClk.pinConfig.GPIO_PinAltFunMode		= AF2;
+	encoderClk.pinConfig.GPIO_PinPuPdControl	= GPIO_PUPDR_PULLUP;
 
 	/* Pin del Switch */
 	sw.pGPIOx							= GPIOA;
 	sw.pinConfig.GPIO_PinNumber			= PIN_0;
 	sw.pinConfig.GPIO_PinMode			= GPIO_MODE_IN;
 
-	/* Pin de la salida de datos del encoder */
+	/* Pin de la salida de datos del encoder -> TIM4_CH2 (AF2) */
 	data.pGPIOx							= GPIOB;
-	data.pinConfig.GPIO_PinNumber		= PIN_2;
-	data.pinConfig.GPIO_PinMode			= GPIO_MODE_IN;
+	data.pinConfig.GPIO_PinNumber		= PIN_7;
+	data.pinConfig.GPIO_PinMode			= GPIO_MODE_ALTFN;
+	data.pinConfig.GPIO_PinAltFunMode	= AF2;
+	data.pinConfig.GPIO_PinPuPdControl	= GPIO_PUPDR_PULLUP;
 
 	/* Se cargan las configuraciones de los respectivos pines */
 	gpio_Config(&encoderClk);
 	gpio_Config(&sw);
 	gpio_Config(&data);
 
+	/* Decodificación en cuadratura por el TIM4: 4 cuentas por detent, filtro de 8 muestras
+	 * a fDTS/8 contra los rebotes, y x3 cuando se gira a más de 15 pasos/s
+	 */
+	menuEncoder.ptrTIMx					= TIM4;
+	menuEncoder.config.filter			= 0x0B;
+	menuEncoder.config.direction		= ENCODER_DIRECTION_NORMAL;
+	menuEncoder.config.countsPerStep	= 4;
+	menuEncoder.config.accelThreshold	= 15;
+	menuEncoder.config.accelMultiplier	= 3;
+
+	/* Cargamos la configuración del encoder (queda contando) */
+	encoder_Config(&menuEncoder);
+
 
 	// 8. ===== I2C =====
 	/* Configuramos el I2C */
 	i2c_handler.ptrI2Cx				= I2C1;
 	i2c_handler.slaveAddress		= OLED_ADDRESS;
 	i2c_handler.modeI2C				= I2C_MODE_FM;
+	i2c_handler.timeout_us			= I2C_DEFAULT_TIMEOUT_us;
+	i2c_handler.ptrPinSCL			= &pinSCL_I2C;	// Pines para recuperar el bus si la OLED lo bloquea
+	i2c_handler.ptrPinSDA			= &pinSDA_I2C;
 
 
 	/* Cargamos la configuración del I2C */
 	i2c_Config(&i2c_handler);
 
+	/* Configuramos el medidor de afinación (páginas 3 y 4, casi todo el ancho) */
+	tunerMeter.ptrHandlerI2C		= &i2c_handler;
+	tunerMeter.startColumn			= 4;
+	tunerMeter.width				= 120;
+	tunerMeter.startPage			= 3;
+	tunerMeter.pages				= 2;
+	tunerMeter.rangeCents			= 50;
+
+	/* Cargamos la configuración del medidor */
+	meter_Config(&tunerMeter);
+
+	/* Configuramos el planificador de la pantalla (display_Config se llama con la pantalla limpia) */
+	oledDisplay.ptrHandlerI2C		= &i2c_handler;
+	oledDisplay.frameRate			= 20;
+
 	// 9. ===== SYSTICK =====
 	/* Configuramos el Systick */
 	systick.pSystick						= SYSTICK;
@@ -642,25 +812,115 @@ void configPeripherals(void){
 	systick_SetState(&systick, SYSTICK_ON);
 
 
-	// ===== EXTI's =====
-	/* Condigurando EXTI0 */
-	exti0.pGPIOHandler				= &sw;
-	exti0.edgeType					= EXTERNAL_INTERRUPT_RISING_EDGE;	/* Configurando el pin del cristal1 (7-segmentos) */
+	// 10. ===== CAPTURA DE ENTRADA =====
+	/* PA1 -> TIM5_CH2 (AF2), con la salida del comparador del micrófono */
+	pinCapture.pGPIOx							= GPIOA;
+	pinCapture.pinConfig.GPIO_PinNumber			= PIN_1;
+	pinCapture.pinConfig.GPIO_PinMode			= GPIO_MODE_ALTFN;
+	pinCapture.pinConfig.GPIO_PinAltFunMode		= AF2;
+	pinCapture.pinConfig.GPIO_PinPuPdControl	= GPIO_PUPDR_NOTHING;
+	pinCapture.pinConfig.GPIO_PinOutputSpeed	= GPIO_OSPEED_FAST;
+
+	/* Cargamos la configuración */
+	gpio_Config(&pinCapture);
 
-	/* Cargamos la configuración del EXTI */
-	exti_Config(&exti0);
+	/* Flancos de subida contados a 16 MHz, entre 60 Hz y 400 Hz (E2 - E4 con margen).
+	 * El filtro digital (8 muestras a fDTS/8) quita los rebotes del comparador
+	 */
+	pitchCapture.ptrTIMx				= TIM5;
+	pitchCapture.config.channel			= CAPTURE_CHANNEL_2;
+	pitchCapture.config.edge			= CAPTURE_EDGE_RISING;
+	pitchCapture.config.edgeDivider		= CAPTURE_DIV_1;
+	pitchCapture.config.filter			= 0x0B;
+	pitchCapture.config.prescaler		= 1;
+	pitchCapture.config.minFrequency	= 60.0f;
+	pitchCapture.config.maxFrequency	= 400.0f;
+	pitchCapture.config.alpha			= 0.3f;
+	pitchCapture.config.maxSpread		= 0.05f;	// 5 % entre el periodo mayor y el menor de la ventana
+
+	/* Cargamos la configuración y la encendemos (el DMA la llena sin interrupciones) */
+	capture_Config(&pitchCapture);
+	capture_Start(&pitchCapture);
+
+
+	// 11. ===== ENTRADAS =====
+	/* El switch ya no usa el EXTI: se muestrea cada 5 ms y cambia de estado después de
+	 * 4 muestras iguales (20 ms), así los rebotes no saltan varios menús. Los menús sólo
+	 * usan el CLICK: sin doble click (llega apenas se suelta) ni pulsación larga
+	 */
+	botonesMenu[BOTON_SWITCH].pGPIOHandler				= &sw;
+	botonesMenu[BOTON_SWITCH].config.activeLevel		= GPIO_PIN_SET;
+	botonesMenu[BOTON_SWITCH].config.longPressTime		= 0;
+	botonesMenu[BOTON_SWITCH].config.doubleClickTime	= 0;
 
-	/* Condigurando EXTI8 */
-	exti8.pGPIOHandler				= &encoderClk;
-	exti8.edgeType					= EXTERNAL_INTERRUPT_RISING_EDGE;
+	menuInput.ptrButtons	= botonesMenu;
+	menuInput.numButtons	= 1;
+	menuInput.ptrEncoder	= &menuEncoder;
+	menuInput.samplePeriod	= 5;
 
-	/* Cargamos la configuración del EXTI */
-	exti_Config(&exti8);
+	/* Cargamos la configuración (el muestreo corre en un timer por software) */
+	input_Config(&menuInput);
 
 
 }	// Fin de la configuración de los periféricos
 
 
+/*
+ * Mide la frecuencia de la cuerda con la fuente seleccionada y la deja en frec_prom:
+ * una captura del ADC con su FFT, o el periodo de la captura de entrada
+ */
+void medirFrecuencia(void){
+
+	/* Mientras se espera la captura siguen la OLED y el log, pero el shell no ejecuta
+	 * comandos (":fft" y ":fs" cambian la captura en curso)
+	 */
+	flagCapturando = 1;
+
+	/* 1. Captura de entrada: se descarta lo anterior y se espera una ventana confiable */
+	if(fuentePitch == FUENTE_CAPTURA){
+		uint32_t inicio = systick_GetTicks32();
+
+		capture_Restart(&pitchCapture);
+		do{
+			sched_Yield();
+			capture_Process(&pitchCapture);
+		} while((capture_GetConfidence(&pitchCapture) < CAPTURA_CONFIANZA_MIN) &&
+				((systick_GetTicks32() - inicio) < CAPTURA_TIEMPO_MAX));
+		terminarCaptura();
+
+		/* Sin señal confiable la frecuencia queda en 0 (ninguna cuerda) */
+		frec_prom = (capture_GetConfidence(&pitchCapture) >= CAPTURA_CONFIANZA_MIN) ? capture_GetFrequency(&pitchCapture) : 0.0f;
+		stream_SendPitch(&tunerStream, frec_prom, cents_desviacion, nota_cuerda, flagAfinado);
+		usart2DataReceived = '\0';
+		return;
+	}
+
+	/* 2. FFT: una captura completa del ADC y su procesamiento */
+	startPwmSignal(&pwmHandler);
+
+	// Detecta la finalización de una conversión ADC
+	while(!flagStop){
+		sched_Yield();
+	}
+	flagStop = 0;
+	terminarCaptura();
+
+	// Se procesan los datos de la conversión ADC
+	procesamientoFFT(ADC_Data1);
+}
+
+
+/*
+ * Fin de la captura: los comandos que llegaron mientras tanto se ejecutan ahora
+ */
+void terminarCaptura(void){
+	flagCapturando = 0;
+	if(tunerShell.rxTail != tunerShell.rxHead){
+		sched_PostEvent(&taskShell, EVENT_SHELL_RX);
+	}
+}
+
+
 /* Función para realizar el cálculo de la FFT para cada sensor */
 void procesamientoFFT(float32_t *array){
 
@@ -670,7 +930,18 @@ void procesamientoFFT(float32_t *array){
 	float32_t   maxValue_r = 0;
 	uint32_t 	maxIndex_r = 0;
 
+	PROF_BEGIN(PROF_PROCESAMIENTO);
+
+	/* La primera captura con un periodo nuevo calibra la frecuencia de muestreo */
+	if(periodo_calibrado != pwmHandler.config.periodo){
+		calibrarMuestreo();
+	}
+
+	/* Enviamos la captura antes de la FFT, que modifica el arreglo de entrada */
+	stream_SendADC(&tunerStream, array, fftSize, frec_corregida);
+
 	/* Inicializamos la funcion de la transformada */
+	PROF_BEGIN(PROF_FFT);
 	statusInitFFT = arm_rfft_fast_init_f32(&config_Rfft_fast_f32, fftSize);
 
 
@@ -679,63 +950,62 @@ void procesamientoFFT(float32_t *array){
 		arm_rfft_fast_f32(&config_Rfft_fast_f32, array, transformedSignal, ifftFlag);
 	}
 	else{
-		usart_WriteMsg(&commSerial, "FFT no inicializada correctamente\n\r");
+		LOG1(&tunerLog, LOG_FFT_ERROR, (int)statusInitFFT);
 	}
+	PROF_END(PROF_FFT);
 
 	/* Calculamos la magnitud de los resultados obtenidos gracias a la transformada,
 	 * dado su caracter complejo
 	 */
 	// Limpiamos las primeras dos posiciones, pues no nos dan información de la frecuencia
+	PROF_BEGIN(PROF_MAGNITUD);
 
 	transformedSignal[0] = 0;
 	transformedSignal[1] = 0;
 
-	for(uint16_t i = 0; i < ADC_DataSize/2; i++){
+	for(uint16_t i = 0; i < fftSize/2; i++){
 		fft_reales[i] = transformedSignal[i*2];
 	}
 
 	maxValue_r = 0;
 	maxIndex_r = 0;
-	arm_max_f32(fft_reales, ADC_DataSize/2, &maxValue_r, &maxIndex_r);
+	arm_max_f32(fft_reales, fftSize/2, &maxValue_r, &maxIndex_r);
 
 	frec_real = (maxIndex_r * resolucion_FFT);
 
-//	usart_WriteMsg(&commSerial, "\r\n");
-//	sprintf(bufferMsg, "Frecuencia (Con max): %.4f Hz\r\n", frec_real);
-//	usart_WriteMsg(&commSerial, bufferMsg);
-
 
 	/* Obtenemos el valor máximo de la magnitud de los complejos, para hallar la frecuencia dominante */
-	arm_cmplx_mag_f32(transformedSignal, fft_magnitud, ADC_DataSize/2);
+	arm_cmplx_mag_f32(transformedSignal, fft_magnitud, fftSize/2);
 
 	maxValue = 0;
 	maxIndex = 0;
-	arm_max_f32(fft_magnitud, ADC_DataSize/2, &maxValue, &maxIndex);
+	arm_max_f32(fft_magnitud, fftSize/2, &maxValue, &maxIndex);
 
 	frec_real_magnitud = (maxIndex * resolucion_FFT);
 
-//	usart_WriteMsg(&commSerial, "\r\n");
-//	sprintf(bufferMsg, "Frecuencia (Con magnitud): %.4f Hz\r\n", frec_real_magnitud);
-//	usart_WriteMsg(&commSerial, bufferMsg);
-
 	/* Obtenemos el promedio de las dos transformadas obtenidas */
 	float32_t result_fft[2] = {frec_real_magnitud, frec_real_magnitud};
 
 	arm_mean_f32(result_fft, 2, &frec_prom);
 
 	frec_prom = frec_real_magnitud;
+	PROF_END(PROF_MAGNITUD);
 
-//	usart_WriteMsg(&commSerial, "\r\n");
-//	sprintf(bufferMsg, "Frecuencia (Promedio): %.4f Hz\r\n", frec_prom);
-//	usart_WriteMsg(&commSerial, bufferMsg);
+	/* Enviamos el espectro y la frecuencia detectada en tramas binarias (en lugar de sprintf) */
+	PROF_BEGIN(PROF_STREAM);
+	stream_SendSpectrum(&tunerStream, fft_magnitud, fftSize/2, resolucion_FFT);
+	stream_SendPitch(&tunerStream, frec_prom, cents_desviacion, nota_cuerda, flagAfinado);
+	PROF_END(PROF_STREAM);
 
 	/* Limpiamos el arreglo original */
-	for(uint16_t i = 0; i < (ADC_DataSize-1); i++){
+	for(uint16_t i = 0; i < (fftSize-1); i++){
 		array[i] = 0;
 	}
 
 	usart2DataReceived = '\0';
 
+	PROF_END(PROF_PROCESAMIENTO);
+
 } // Fin FFT
 
 
@@ -747,27 +1017,27 @@ void seleccionRango(float32_t frecuencia){
 
 	if(LIM_INFERIOR_E2 < frecuencia && frecuencia <= LIM_SUPERIOR_E2){
 		nota_cuerda = E2;	// Levantamos una bandera que permite determinar la cuerda específica
-		usart_WriteMsg(&commSerial, "Afinando la cuerda N°6 (E2) \r\n");
+		LOG1(&tunerLog, LOG_CUERDA_E2, frecuencia);
 	}
 	else if(LIM_INFERIOR_A2 < frecuencia && frecuencia <= LIM_SUPERIOR_A2){
 		nota_cuerda = A2;
-		usart_WriteMsg(&commSerial, "Afinando la cuerda N°5 (A2) \r\n");
+		LOG1(&tunerLog, LOG_CUERDA_A2, frecuencia);
 	}
 	else if(LIM_INFERIOR_D3 < frecuencia && frecuencia <= LIM_SUPERIOR_D3){
 		nota_cuerda = D3;
-		usart_WriteMsg(&commSerial, "Afinando la cuerda N°4 (D3) \r\n");
+		LOG1(&tunerLog, LOG_CUERDA_D3, frecuencia);
 	}
 	else if(LIM_INFERIOR_G3 < frecuencia && frecuencia <= LIM_SUPERIOR_G3){
 		nota_cuerda = G3;
-		usart_WriteMsg(&commSerial, "Afinando la cuerda N°3 (G3) \r\n");
+		LOG1(&tunerLog, LOG_CUERDA_G3, frecuencia);
 	}
 	else if(LIM_INFERIOR_B3 < frecuencia && frecuencia <= LIM_SUPERIOR_B3){
 		nota_cuerda = B3;
-		usart_WriteMsg(&commSerial, "Afinando la cuerda N°2 (B3) \r\n");
+		LOG1(&tunerLog, LOG_CUERDA_B3, frecuencia);
 	}
 	else if(LIM_INFERIOR_E4 < frecuencia && frecuencia < LIM_SUPERIOR_E4){
 		nota_cuerda = E4;
-		usart_WriteMsg(&commSerial, "Afinando la cuerda N°1 (E4) \r\n");
+		LOG1(&tunerLog, LOG_CUERDA_E4, frecuencia);
 	}
 	else{
 		nota_cuerda = 0;
@@ -781,44 +1051,32 @@ void seleccionRango(float32_t frecuencia){
  * Función para verificar si un número es negativo
  */
 void verificarFrecuencia(float32_t numero){
-	if(numero < -(resolucion_FFT)){
+	if(numero < -(tolerancia_bins * resolucion_FFT)){
 		if(!flagApretarClav){
-			usart_WriteMsg(&commSerial, "Aprieta la clavija \n\r");
+			LOG1(&tunerLog, LOG_APRIETA_CLAVIJA, numero);
 
 			/* Mensaje inicial */
 			uint8_t bufferString[64] = {0};
-			sprintf((char *)bufferString, "APRIETE");
-			oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 7, 16, 5);
-			sprintf((char *)bufferString, "LA CLAVIJA");
-			oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 10, 16, 6);
-			flagAnim = 1;
-			opAnim = 1;
-			countAnim = 0;
-
-			/* Encendemos el Timer */
-			timer_SetState(&blinkString, TIMER_ON);
+			format_Copy((char *)bufferString, sizeof(bufferString), "APRIETE");
+			display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 7, 16, 5);
+			format_Copy((char *)bufferString, sizeof(bufferString), "LA CLAVIJA");
+			display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 10, 16, 6);
 
 			flagApretarClav = 1;
 			flagAflojarClav = 0;
 		}
 
 	}
-	else if(numero > (resolucion_FFT)){
+	else if(numero > (tolerancia_bins * resolucion_FFT)){
 		if(!flagAflojarClav){
-			usart_WriteMsg(&commSerial, "Afloja la clavija \n\r");
+			LOG1(&tunerLog, LOG_AFLOJA_CLAVIJA, numero);
 
 			/* Mensaje inicial */
 			uint8_t bufferString[64] = {0};
-			sprintf((char *)bufferString, "AFLOJE");
-			oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 6, 16, 5);
-			sprintf((char *)bufferString, "LA CLAVIJA");
-			oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 10, 16, 6);
-			flagAnim = 1;
-			opAnim = 1;
-			countAnim = 0;
-
-			/* Encendemos el Timer */
-			timer_SetState(&blinkString, TIMER_ON);
+			format_Copy((char *)bufferString, sizeof(bufferString), "AFLOJE ");	// El espacio borra la última letra de "APRIETE"
+			display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 7, 16, 5);
+			format_Copy((char *)bufferString, sizeof(bufferString), "LA CLAVIJA");
+			display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 10, 16, 6);
 
 			flagAflojarClav = 1;
 			flagApretarClav = 0;
@@ -830,10 +1088,7 @@ void verificarFrecuencia(float32_t numero){
 		flagAflojarClav = 0;
 		flagApretarClav = 0;
 
-		usart_WriteMsg(&commSerial, "¡La cuerda esta afinada! \n\r");
-
-		/* Detenemos las animaciones */
-		timer_SetState(&blinkString, TIMER_OFF);
+		LOG1(&tunerLog, LOG_CUERDA_AFINADA, numero);
 
 		/* Imprimimos en la OLED el mensaje de finalización */
 		mensajeAfinado();
@@ -849,37 +1104,31 @@ void seleccionAutomatica(void){
 
 	usart_WriteMsg(&commSerial, "Modo automático seleccionado \n\r");
 
-	oled_clearDisplay(&i2c_handler);
+	display_Clear(&oledDisplay);
 	uint8_t bufferString[64] = {0};
 
-	timer_SetState(&blinkString, TIMER_ON);
-	contadorSwitch = MODO_MENU_AUTOMATICO;
+	parpadeoMenu(TIMER_ON);
+	entrarMenu(MODO_MENU_AUTOMATICO);
 
 	// While de verificación hasta que el sistema detecta la cuerda adecuada
 	while(!flagNotaCuerda){
 
 		/* Pintamos la interfaz de las instrucciones */
-		oled_clearDisplay(&i2c_handler);
-		sprintf((char *)bufferString, "TOQUE LA CUERDA");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 15, 19, 3);
+		display_Clear(&oledDisplay);
+		format_Copy((char *)bufferString, sizeof(bufferString), "TOQUE LA CUERDA");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 15, 19, 3);
 
 		/* Mandamos las instrucciones por USART */
 		usart_WriteMsg(&commSerial, "Por favor, toque la cuerda \n\r");
 
-		// Espera 1 segundo para que el usuario toque la cuerda
-		systick_Delay_ms(SYSTICK_2s);
+		/* Enviamos lo pendiente antes de la espera */
+		display_Flush(&oledDisplay);
 
-		startPwmSignal(&pwmHandler);
-
-		// Detecta la finalización de una conversión ADC
-		while(!flagStop){
-			__NOP();
-		}
-		flagStop = 0;
+		// Espera 1 segundo para que el usuario toque la cuerda
+		sched_Delay_ms(SYSTICK_2s);
 
-		// Se procesan los datos de la conversión ADC
-		procesamientoFFT(ADC_Data1);
-		frec_prom = frec_prom;
+		// Se mide la frecuencia con la fuente seleccionada (FFT o captura, ":pitch")
+		medirFrecuencia();
 
 		// Se verifica el rango y se asigna un valor a nota_cuerda según el caso
 		if(!nota_cuerda){
@@ -890,7 +1139,10 @@ void seleccionAutomatica(void){
 		muestraNota(nota_cuerda);
 
 		usart2DataReceived = '\0';
-		contadorSwitch = MODO_MENU_AUTOMATICO;
+		entrarMenu(MODO_MENU_AUTOMATICO);
+
+		/* Los mensajes del log salen antes de la pregunta */
+		log_Flush(&tunerLog);
 
 		usart_WriteMsg(&commSerial, "¿La cuerda seleccionada es correcta? \r\n");
 		usart_WriteMsg(&commSerial, "Oprima 'y' o 'n' \n\r");
@@ -898,37 +1150,40 @@ void seleccionAutomatica(void){
 		// Esperamos a recibir una respuesta del usuario
 		while(!usart2DataReceived && (contadorSwitch == MODO_MENU_AUTOMATICO)){
 
+			/* Las tareas de fondo (OLED, shell, log) siguen mientras se espera una tecla */
+			sched_Yield();
+
 			/* Evalúa las interrupciones del ENCODER */
 			evaluate();
 
 			/* Animación de parpadeo de las opciones */
 			if(flagMenu2 && (contadorMenu2 == RESPUESTA_AUTO_SI)){
-				sprintf((char *)bufferString, "NO");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 2, 76, 5);
+				format_Copy((char *)bufferString, sizeof(bufferString), "NO");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 2, 76, 5);
 
 				if(flagBlinkString == 0){
-					sprintf((char *)bufferString, "SI");
-					oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 2, 40, 5);
+					format_Copy((char *)bufferString, sizeof(bufferString), "SI");
+					display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 2, 40, 5);
 				}
 				else if(flagBlinkString == 1){
-					sprintf((char *)bufferString, "SI");
-					oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 2, 40, 5);
+					format_Copy((char *)bufferString, sizeof(bufferString), "SI");
+					display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 2, 40, 5);
 				}
 				flagMenu2 ^= 1;
 				flagBlinkString ^= 1;
 			}
 
 			if(flagMenu2 && (contadorMenu2 == RESPUESTA_AUTO_NO)){
-				sprintf((char *)bufferString, "SI");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 2, 40, 5);
+				format_Copy((char *)bufferString, sizeof(bufferString), "SI");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 2, 40, 5);
 
 				if(flagBlinkString == 0){
-					sprintf((char *)bufferString, "NO");
-					oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 2, 76, 5);
+					format_Copy((char *)bufferString, sizeof(bufferString), "NO");
+					display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 2, 76, 5);
 				}
 				else if(flagBlinkString == 1){
-					sprintf((char *)bufferString, "NO");
-					oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 2, 76, 5);;
+					format_Copy((char *)bufferString, sizeof(bufferString), "NO");
+					display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 2, 76, 5);;
 				}
 				flagMenu2 ^= 1;
 				flagBlinkString ^= 1;
@@ -951,7 +1206,8 @@ void seleccionAutomatica(void){
 	flagBlinkString = 0;
 
 	/* Limpiamos la OLED */
-	oled_clearDisplay(&i2c_handler);
+	display_Clear(&oledDisplay);
+	meter_Invalidate(&tunerMeter);
 
 	// Pasamos a la afinación de la cuerda seleccionada
 	while(!flagAfinado){
@@ -991,28 +1247,17 @@ void seleccionAutomatica(void){
 		// Verifica si la frecuencia actual está por encima o por debajo de la frecuencia a afinar
 		verificarFrecuencia(dif_frecuencias);
 
-		/* Corremos la animación correspondiente */
-		if(flagApretarClav && flagAnim){
-			/* Cargamos la animación para indicar al usuario que debe apretar la clavija */
-			animacionApretar();
-		}
-		else if(flagAflojarClav && flagAnim){
-			/* Cargamos la animación para indicar al usuario que debe aflojar la clavija */
-			animacionAflojar();
+		/* Movemos la aguja del medidor (sólo se envían las columnas que cambian) */
+		if(!flagAfinado){
+			cents_desviacion = calcularCents(frec_prom, frec_prom + dif_frecuencias);
+			meter_Update(&tunerMeter, cents_desviacion);
 		}
 
 
 	//	systick_Delay_ms(1000);
 		if(!flagAfinado){
-			startPwmSignal(&pwmHandler);
-			// Detecta la finalización de una conversión ADC
-			while(!flagStop){
-				__NOP();
-			}
-			flagStop = 0;
-
-			procesamientoFFT(ADC_Data1);
-			frec_prom = frec_prom;
+			// Se mide la frecuencia con la fuente seleccionada (FFT o captura, ":pitch")
+			medirFrecuencia();
 		}
 
 		// Pausa de emergencia
@@ -1020,6 +1265,7 @@ void seleccionAutomatica(void){
 
 			stopPwmSignal(&pwmHandler);
 
+			log_Flush(&tunerLog);
 			usart_WriteMsg(&commSerial, "\r\n");
 			usart_WriteMsg(&commSerial, "Pausando conversiones. \r\n");
 			usart_WriteMsg(&commSerial, "Presione '1' para reiniciar la ejecución \n\r");
@@ -1033,20 +1279,19 @@ void seleccionAutomatica(void){
 	dif_frecuencias = 0;
 	nota_cuerda = 0;
 
-	flagAnim = 0;
-	opAnim = 0;
-	countAnim = 0;
-
 	flagModoActual = MODO_AUTOMATICO;
 
-	timer_SetState(&blinkString, TIMER_OFF);
+	parpadeoMenu(TIMER_OFF);
 
 	usart2DataReceived = '\0';
 
+	log_Flush(&tunerLog);
 	usart_WriteMsg(&commSerial, "-> Presione '1' para cambiar de modo \r\n");
 	usart_WriteMsg(&commSerial, "-> Presione '2' para reiniciar la afinación en el modo actual \n\r");
 
-	systick_Delay_ms(SYSTICK_2s);
+	/* Enviamos lo pendiente antes de la espera */
+	display_Flush(&oledDisplay);
+	sched_Delay_ms(SYSTICK_2s);
 
 } // Fin seleccionAutomatica()
 
@@ -1056,35 +1301,35 @@ void seleccionAutomatica(void){
  */
 void seleccionManual(void){
 
-	contadorSwitch = MODO_MENU_1;
+	entrarMenu(MODO_MENU_1);
 	contadorMenu1 = E4;
 
 	/* Limpiamos la pantalla primero */
-	oled_clearDisplay(&i2c_handler);
+	display_Clear(&oledDisplay);
 
 	/* Pintamos la interfaz del menú principal 1 */
 	uint8_t bufferString[64] = {0};
 
-	sprintf((char *)bufferString, "SELECCIONE LA CUERDA");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 20, 4, 0);
+	format_Copy((char *)bufferString, sizeof(bufferString), "SELECCIONE LA CUERDA");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 20, 4, 0);
 
-	sprintf((char *)bufferString, "CUERDA-1 E4");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, E4_Col, E4_Page);
+	format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-1 E4");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, E4_Col, E4_Page);
 
-	sprintf((char *)bufferString, "B3 CUERDA-2");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, B3_Col, B3_Page);
+	format_Copy((char *)bufferString, sizeof(bufferString), "B3 CUERDA-2");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, B3_Col, B3_Page);
 
-	sprintf((char *)bufferString, "CUERDA-3 G3");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, G3_Col, G3_Page);
+	format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-3 G3");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, G3_Col, G3_Page);
 
-	sprintf((char *)bufferString, "D3 CUERDA-4");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, D3_Col, D3_Page);
+	format_Copy((char *)bufferString, sizeof(bufferString), "D3 CUERDA-4");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, D3_Col, D3_Page);
 
-	sprintf((char *)bufferString, "CUERDA-5 A2");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, A2_Col, A2_Page);
+	format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-5 A2");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, A2_Col, A2_Page);
 
-	sprintf((char *)bufferString, "E2 CUERDA-6");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, E2_Col, E2_Page);
+	format_Copy((char *)bufferString, sizeof(bufferString), "E2 CUERDA-6");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, E2_Col, E2_Page);
 
 	/* Imprimimos las instrucciones por comunicación serial */
 	usart_WriteMsg(&commSerial, "Modo manual seleccionado \n\r");
@@ -1097,16 +1342,19 @@ void seleccionManual(void){
 	usart_WriteMsg(&commSerial, "'6' -> Cuerda 6 (E2) \r\n");
 
 	usart2DataReceived = '\0';
-	contadorSwitch = MODO_MENU_1;
+	entrarMenu(MODO_MENU_1);
 	contadorMenu1 = E4;
 	flagBlinkString = 0;
 	flagMenu1 = 0;
 
-	timer_SetState(&blinkString, TIMER_ON);
+	parpadeoMenu(TIMER_ON);
 
 	/* Esperamos que el usuario seleccione una opción */
 	while(!usart2DataReceived && (contadorSwitch == MODO_MENU_1)){
 
+		/* Las tareas de fondo (OLED, shell, log) siguen mientras se espera una tecla */
+		sched_Yield();
+
 		/* Evalúa las interrupciones del ENCODER */
 		evaluate();
 
@@ -1114,16 +1362,16 @@ void seleccionManual(void){
 		case E4:{
 			/* Parpadeo de la opción seleccionada */
 			if(flagMenu1){
-				sprintf((char *)bufferString, "B3 CUERDA-2");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, B3_Col, B3_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "B3 CUERDA-2");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, B3_Col, B3_Page);
 
 				if(flagBlinkString == 0){
-					sprintf((char *)bufferString, "CUERDA-1 E4");
-					oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 11, E4_Col, E4_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-1 E4");
+					display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 11, E4_Col, E4_Page);
 				}
 				else if(flagBlinkString == 1){
-					sprintf((char *)bufferString, "CUERDA-1 E4");
-					oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, E4_Col, E4_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-1 E4");
+					display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, E4_Col, E4_Page);
 				}
 				flagMenu1 ^= 1;
 				flagBlinkString ^= 1;
@@ -1134,18 +1382,18 @@ void seleccionManual(void){
 		case B3:{
 			/* Parpadeo de la opción seleccionada */
 			if(flagMenu1){
-				sprintf((char *)bufferString, "CUERDA-1 E4");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, E4_Col, E4_Page);
-				sprintf((char *)bufferString, "CUERDA-3 G3");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, G3_Col, G3_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-1 E4");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, E4_Col, E4_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-3 G3");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, G3_Col, G3_Page);
 
 				if(flagBlinkString == 0){
-					sprintf((char *)bufferString, "B3 CUERDA-2");
-					oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 11, B3_Col, B3_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "B3 CUERDA-2");
+					display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 11, B3_Col, B3_Page);
 				}
 				else if(flagBlinkString == 1){
-					sprintf((char *)bufferString, "B3 CUERDA-2");
-					oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, B3_Col, B3_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "B3 CUERDA-2");
+					display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, B3_Col, B3_Page);
 				}
 				flagMenu1 ^= 1;
 				flagBlinkString ^= 1;
@@ -1156,18 +1404,18 @@ void seleccionManual(void){
 		case G3: {
 			/* Parpadeo de la opción seleccionada */
 			if(flagMenu1){
-				sprintf((char *)bufferString, "B3 CUERDA-2");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, B3_Col, B3_Page);
-				sprintf((char *)bufferString, "D3 CUERDA-4");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, D3_Col, D3_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "B3 CUERDA-2");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, B3_Col, B3_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "D3 CUERDA-4");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, D3_Col, D3_Page);
 
 				if(flagBlinkString == 0){
-					sprintf((char *)bufferString, "CUERDA-3 G3");
-					oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 11, G3_Col, G3_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-3 G3");
+					display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 11, G3_Col, G3_Page);
 				}
 				else if(flagBlinkString == 1){
-					sprintf((char *)bufferString, "CUERDA-3 G3");
-					oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, G3_Col, G3_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-3 G3");
+					display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, G3_Col, G3_Page);
 				}
 				flagMenu1 ^= 1;
 				flagBlinkString ^= 1;
@@ -1178,18 +1426,18 @@ void seleccionManual(void){
 		case D3: {
 			/* Parpadeo de la opción seleccionada */
 			if(flagMenu1){
-				sprintf((char *)bufferString, "CUERDA-3 G3");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, G3_Col, G3_Page);
-				sprintf((char *)bufferString, "CUERDA-5 A2");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, A2_Col, A2_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-3 G3");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, G3_Col, G3_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-5 A2");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, A2_Col, A2_Page);
 
 				if(flagBlinkString == 0){
-					sprintf((char *)bufferString, "D3 CUERDA-4");
-					oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 11, D3_Col, D3_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "D3 CUERDA-4");
+					display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 11, D3_Col, D3_Page);
 				}
 				else if(flagBlinkString == 1){
-					sprintf((char *)bufferString, "D3 CUERDA-4");
-					oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, D3_Col, D3_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "D3 CUERDA-4");
+					display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, D3_Col, D3_Page);
 				}
 				flagMenu1 ^= 1;
 				flagBlinkString ^= 1;
@@ -1200,18 +1448,18 @@ void seleccionManual(void){
 		case A2: {
 			/* Parpadeo de la opción seleccionada */
 			if(flagMenu1){
-				sprintf((char *)bufferString, "D3 CUERDA-4");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, D3_Col, D3_Page);
-				sprintf((char *)bufferString, "E2 CUERDA-6");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, E2_Col, E2_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "D3 CUERDA-4");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, D3_Col, D3_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "E2 CUERDA-6");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, E2_Col, E2_Page);
 
 				if(flagBlinkString == 0){
-					sprintf((char *)bufferString, "CUERDA-5 A2");
-					oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 11, A2_Col, A2_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-5 A2");
+					display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 11, A2_Col, A2_Page);
 				}
 				else if(flagBlinkString == 1){
-					sprintf((char *)bufferString, "CUERDA-5 A2");
-					oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, A2_Col, A2_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-5 A2");
+					display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, A2_Col, A2_Page);
 				}
 				flagMenu1 ^= 1;
 				flagBlinkString ^= 1;
@@ -1222,16 +1470,16 @@ void seleccionManual(void){
 		case E2: {
 			/* Parpadeo de la opción seleccionada */
 			if(flagMenu1){
-				sprintf((char *)bufferString, "CUERDA-5 A2");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, A2_Col, A2_Page);
+				format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA-5 A2");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, A2_Col, A2_Page);
 
 				if(flagBlinkString == 0){
-					sprintf((char *)bufferString, "E2 CUERDA-6");
-					oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 11, E2_Col, E2_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "E2 CUERDA-6");
+					display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 11, E2_Col, E2_Page);
 				}
 				else if(flagBlinkString == 1){
-					sprintf((char *)bufferString, "E2 CUERDA-6");
-					oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 11, E2_Col, E2_Page);
+					format_Copy((char *)bufferString, sizeof(bufferString), "E2 CUERDA-6");
+					display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 11, E2_Col, E2_Page);
 				}
 				flagMenu1 ^= 1;
 				flagBlinkString ^= 1;
@@ -1242,7 +1490,7 @@ void seleccionManual(void){
 		} // Switch-case
 	} // While
 
-	timer_SetState(&blinkString, TIMER_OFF);
+	parpadeoMenu(TIMER_OFF);
 
 	if(usart2DataReceived){
 		selecManual = usart2DataReceived;
@@ -1307,29 +1555,23 @@ void seleccionManual(void){
 	usart2DataReceived = '\0';
 
 	/* Limpiamos la pantalla primero */
-	oled_clearDisplay(&i2c_handler);
+	display_Clear(&oledDisplay);
 
 	/* Pintamos la interfaz de las instrucciones */
-	sprintf((char *)bufferString, "TOQUE LA CUERDA");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 15, 19, 3);
+	format_Copy((char *)bufferString, sizeof(bufferString), "TOQUE LA CUERDA");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 15, 19, 3);
 
 	/* Enviamos las instrucciones por USART */
 	usart_WriteMsg(&commSerial, "Por favor, toque la cuerda \n\r");
 
-	systick_Delay_ms(SYSTICK_2s);
+	/* Enviamos lo pendiente antes de la espera */
+	display_Flush(&oledDisplay);
+	sched_Delay_ms(SYSTICK_2s);
 
 	muestraNota(nota_cuerda);
 
-	startPwmSignal(&pwmHandler);
-	// Detecta la finalización de una conversión ADC
-	while(!flagStop){
-		__NOP();
-	}
-	flagStop = 0;
-
-	// Se procesan los datos obtenidos por el micrófono
-	procesamientoFFT(ADC_Data1);
-	frec_prom = frec_prom;
+	// Se mide la frecuencia con la fuente seleccionada (FFT o captura, ":pitch")
+	medirFrecuencia();
 
 	flagAfinado = 0;
 
@@ -1371,30 +1613,19 @@ void seleccionManual(void){
 		// Verifica si la frecuencia actual está por encima o por debajo de la frecuencia a afinar
 		verificarFrecuencia(dif_frecuencias);
 
+		/* Calculamos la desviación en cents antes de limpiar la diferencia */
+		cents_desviacion = calcularCents(frec_prom, frec_prom + dif_frecuencias);
+
 		/* Limpiamos la variable para evitar errores */
 		dif_frecuencias = 0;
 
 		if(!flagAfinado){
 
-			/* Corremos la animación correspondiente */
-			if(flagApretarClav && flagAnim){
-				/* Cargamos la animación para indicar al usuario que debe apretar la clavija */
-				animacionApretar();
-			}
-			else if(flagAflojarClav && flagAnim){
-				/* Cargamos la animación para indicar al usuario que debe aflojar la clavija */
-				animacionAflojar();
-			}
-
-			startPwmSignal(&pwmHandler);
-			// Detecta la finalización de una conversión ADC
-			while(!flagStop){
-				__NOP();
-			}
-			flagStop = 0;
+			/* Movemos la aguja del medidor (sólo se envían las columnas que cambian) */
+			meter_Update(&tunerMeter, cents_desviacion);
 
-			procesamientoFFT(ADC_Data1);
-			frec_prom = frec_prom;
+			// Se mide la frecuencia con la fuente seleccionada (FFT o captura, ":pitch")
+			medirFrecuencia();
 		}
 
 		// Pausa de emergencia
@@ -1402,6 +1633,7 @@ void seleccionManual(void){
 
 			stopPwmSignal(&pwmHandler);
 
+			log_Flush(&tunerLog);
 			usart_WriteMsg(&commSerial, "\r\n");
 			usart_WriteMsg(&commSerial, "Pausando conversiones. \r\n");
 			usart_WriteMsg(&commSerial, "Presione '1' para reiniciar la ejecución \n\r");
@@ -1414,18 +1646,17 @@ void seleccionManual(void){
 	dif_frecuencias = 0;
 	nota_cuerda = 0;
 
-	flagAnim = 0;
-	opAnim = 0;
-	countAnim = 0;
-
 	flagModoActual = MODO_MANUAL;
 
 	usart2DataReceived = '\0';
 
+	log_Flush(&tunerLog);
 	usart_WriteMsg(&commSerial, "-> Presione '1' para cambiar de modo \r\n");
 	usart_WriteMsg(&commSerial, "-> Presione '2' para reiniciar la afinación en el modo actual \n\r");
 
-	systick_Delay_ms(SYSTICK_2s);
+	/* Enviamos lo pendiente antes de la espera */
+	display_Flush(&oledDisplay);
+	sched_Delay_ms(SYSTICK_2s);
 }
 
 /*
@@ -1434,21 +1665,21 @@ void seleccionManual(void){
 void seleccionModo(void){
 
 	/* Limpiamos la pantalla */
-	oled_clearDisplay(&i2c_handler);
+	display_Clear(&oledDisplay);
 
 	/* Pintamos la interfaz del menú principal 1 */
 	uint8_t bufferString[64] = {0};
 
-	sprintf((char *)bufferString, "SELECCIONE UN MODO");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 18, 10, 1);
+	format_Copy((char *)bufferString, sizeof(bufferString), "SELECCIONE UN MODO");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 18, 10, 1);
 
-	sprintf((char *)bufferString, "AUTOMATICO");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 10, 34, 4);
+	format_Copy((char *)bufferString, sizeof(bufferString), "AUTOMATICO");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 10, 34, 4);
 
-	sprintf((char *)bufferString, "MANUAL");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 6, 46, 6);
+	format_Copy((char *)bufferString, sizeof(bufferString), "MANUAL");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 6, 46, 6);
 
-	timer_SetState(&blinkString, TIMER_ON);
+	parpadeoMenu(TIMER_ON);
 
 	/* Escribimos en la terminal serial */
 	usart2DataReceived = '\0';
@@ -1457,25 +1688,28 @@ void seleccionModo(void){
 	usart_WriteMsg(&commSerial, "Presiona A -> Seleccion Automatico \r\n");
 	usart_WriteMsg(&commSerial, "Presiona M -> Seleccion Manual \n\r");
 
-	contadorSwitch = MODO_MENU_0;
+	entrarMenu(MODO_MENU_0);
 	contadorMenu0 = MODO_AUTOMATICO;
 
 	while(!usart2DataReceived && (contadorSwitch == MODO_MENU_0)){
 
+		/* Las tareas de fondo (OLED, shell, log) siguen mientras se espera una tecla */
+		sched_Yield();
+
 		/* Parpadeo de la opción seleccionada */
 		if(flagMenu0 && (contadorSwitch == MODO_MENU_0) && (contadorMenu0 == MODO_AUTOMATICO)){
 			uint8_t bufferString[64] = {0};
 
-			sprintf((char *)bufferString, "MANUAL");
-			oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 6, 46, 6);
+			format_Copy((char *)bufferString, sizeof(bufferString), "MANUAL");
+			display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 6, 46, 6);
 
 			if(flagBlinkString == 0){
-				sprintf((char *)bufferString, "AUTOMATICO");
-				oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 10, 34, 4);
+				format_Copy((char *)bufferString, sizeof(bufferString), "AUTOMATICO");
+				display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 10, 34, 4);
 			}
 			else if(flagBlinkString == 1){
-				sprintf((char *)bufferString, "AUTOMATICO");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 10, 34, 4);
+				format_Copy((char *)bufferString, sizeof(bufferString), "AUTOMATICO");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 10, 34, 4);
 			}
 			flagMenu0 ^= 1;
 			flagBlinkString ^= 1;
@@ -1484,25 +1718,26 @@ void seleccionModo(void){
 		if(flagMenu0 && (contadorSwitch == MODO_MENU_0) && (contadorMenu0 == MODO_MANUAL)){
 			uint8_t bufferString[64] = {0};
 
-			sprintf((char *)bufferString, "AUTOMATICO");
-			oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 10, 34, 4);
+			format_Copy((char *)bufferString, sizeof(bufferString), "AUTOMATICO");
+			display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 10, 34, 4);
 
 			if(flagBlinkString == 0){
-				sprintf((char *)bufferString, "MANUAL");
-				oled_setString(&i2c_handler, bufferString, INVERSE_DISPLAY, 6, 46, 6);
+				format_Copy((char *)bufferString, sizeof(bufferString), "MANUAL");
+				display_SetString(&oledDisplay, bufferString, INVERSE_DISPLAY, 6, 46, 6);
 			}
 			else if(flagBlinkString == 1){
-				sprintf((char *)bufferString, "MANUAL");
-				oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 6, 46, 6);
+				format_Copy((char *)bufferString, sizeof(bufferString), "MANUAL");
+				display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 6, 46, 6);
 			}
 			flagMenu0 ^= 1;
 			flagBlinkString ^= 1;
 		}
 
 		evaluate();
+
 	}
 
-	timer_SetState(&blinkString, TIMER_OFF);
+	parpadeoMenu(TIMER_OFF);
 
 	if(usart2DataReceived == 'A' || ((contadorMenu0 == MODO_AUTOMATICO) && (contadorSwitch == MODO_MENU_1))){
 		flagModoActual = MODO_AUTOMATICO;
@@ -1522,259 +1757,610 @@ void seleccionModo(void){
 
 }
 
-// Animación para indicar que hay que apretar la clavija
-void animacionApretar(void){
+/*
+ * Desviación en cents entre la frecuencia medida y la frecuencia objetivo
+ * (100 cents = 1 semitono). Negativo -> la cuerda está por debajo.
+ */
+float32_t calcularCents(float32_t frec_medida, float32_t frec_objetivo){
+	if((frec_medida <= 0) || (frec_objetivo <= 0)){
+		return 0;
+	}
+	return 1200.0f * log2f(frec_medida / frec_objetivo);
+}
+
+
+// Mensaje de que terminó la afinación
+void mensajeAfinado(void){
+
+	/* Reemplazamos sólo el texto de las instrucciones; los espacios borran
+	 * las letras que sobran de "APRIETE"/"LA CLAVIJA"
+	 */
+	uint8_t bufferString[64] = {0};
+	format_Copy((char *)bufferString, sizeof(bufferString), "CUERDA ");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 7, 16, 5);
+	format_Copy((char *)bufferString, sizeof(bufferString), "AFINADA   ");
+	display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 10, 16, 6);
+
+	/* La aguja queda en el centro del medidor */
+	meter_Update(&tunerMeter, 0);
+}
+
+
+// Muestra cuál nota estamos afinando actualmente
+void muestraNota(uint8_t nota_cuerda){
+
+	/* Limpiamos la pantalla primero */
+	display_Clear(&oledDisplay);
 
-	/* Configuramos la zona donde deseamos pintar la animación */
-	uint8_t array[6] = 	{0x21, 84, 109, 0x22, 3, 6};
-	oled_sendCommand(&i2c_handler, array, 6);
+	/* La pantalla quedó en blanco: el medidor se redibuja completo en el siguiente update */
+	meter_Invalidate(&tunerMeter);
 
-	/* Matriz de 0b00000000 */
-	uint8_t array_zeros[78] = {0};
+	/* Identificamos la cuerda que se está afinando, para mostrar el mensaje en la OLED */
+	uint8_t bufferString[64] = {0};
+	switch(nota_cuerda){
+	case E4: {
+		format_Copy((char *)bufferString, sizeof(bufferString), "AFINANDO CUERDA-1");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 17, 13, 0);
 
-	switch(countAnim){
-	case 0:{
-		oled_sendData(&i2c_handler, array_figura, 104);
-		uint8_t array[6] = 	{0x21, 84, 109, 0x22, 3, 5};
-		oled_sendCommand(&i2c_handler, array, 6);
-		oled_sendData(&i2c_handler, array_zeros, 78);
+		format_Copy((char *)bufferString, sizeof(bufferString), "NOTA: E4");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 8, 16, 2);
 		break;
 	}
-	case 1:{
-		oled_sendData(&i2c_handler, array_figura, 104);
+	case B3: {
+		format_Copy((char *)bufferString, sizeof(bufferString), "AFINANDO CUERDA-2");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 17, 13, 0);
 
-		uint8_t array[6] = 	{0x21, 84, 109, 0x22, 3, 4};
-		oled_sendCommand(&i2c_handler, array, 6);
-		oled_sendData(&i2c_handler, array_zeros, 52);
+		format_Copy((char *)bufferString, sizeof(bufferString), "NOTA: B3");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 8, 16, 2);
 		break;
 	}
-	case 2:{
-		oled_sendData(&i2c_handler, array_figura, 104);
+	case G3: {
+		format_Copy((char *)bufferString, sizeof(bufferString), "AFINANDO CUERDA-3");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 17, 13, 0);
 
-		uint8_t array[6] = 	{0x21, 84, 109, 0x22, 3, 3};
-		oled_sendCommand(&i2c_handler, array, 6);
-		oled_sendData(&i2c_handler, array_zeros, 26);
+		format_Copy((char *)bufferString, sizeof(bufferString), "NOTA: G3");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 8, 16, 2);
 		break;
 	}
-	case 3: {
-		oled_sendData(&i2c_handler, array_figura, 104);
+	case D3: {
+		format_Copy((char *)bufferString, sizeof(bufferString), "AFINANDO CUERDA-4");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 17, 13, 0);
+
+		format_Copy((char *)bufferString, sizeof(bufferString), "NOTA: D3");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 8, 16, 2);
 		break;
 	}
+	case A2: {
+		format_Copy((char *)bufferString, sizeof(bufferString), "AFINANDO CUERDA-5");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 17, 13, 0);
+
+		format_Copy((char *)bufferString, sizeof(bufferString), "NOTA: A2");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 8, 16, 2);
+		break;
 	}
+	case E2: {
+		format_Copy((char *)bufferString, sizeof(bufferString), "AFINANDO CUERDA-6");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 17, 13, 0);
 
-	flagAnim ^= 1;
+		format_Copy((char *)bufferString, sizeof(bufferString), "NOTA: E2");
+		display_SetString(&oledDisplay, bufferString, NORMAL_DISPLAY, 8, 16, 2);
+		break;
+	}
+	}
 }
 
-// Animación para indicar que hay que aflojar la clavija
-void animacionAflojar(void){
+// Función para atender los eventos del switch y del encoder (cambian el menú y la opción)
+void evaluate(void){
 
-	/* Configuramos el área para la animación */
-	uint8_t array[6] = 	{0x21, 84, 109, 0x22, 3, 6};
-	oled_sendCommand(&i2c_handler, array, 6);
+	Input_Event_t evento;
 
-	/* Matriz de 0b00000000 */
-	uint8_t array_zeros[78] = {0};
+	while(input_GetEvent(&menuInput, &evento)){
 
-	switch(countAnim){
-	case 3:{
-		oled_sendData(&i2c_handler, array_figura, 104);
-		uint8_t array[6] = 	{0x21, 84, 109, 0x22, 3, 5};
-		oled_sendCommand(&i2c_handler, array, 6);
-		oled_sendData(&i2c_handler, array_zeros, 78);
-		break;
-	}
-	case 2:{
-		oled_sendData(&i2c_handler, array_figura, 104);
+		switch(evento.type){
 
-		uint8_t array[6] = 	{0x21, 84, 109, 0x22, 3, 4};
-		oled_sendCommand(&i2c_handler, array, 6);
-		oled_sendData(&i2c_handler, array_zeros, 52);
-		break;
-	}
-	case 1:{
-		oled_sendData(&i2c_handler, array_figura, 104);
+		// Click del switch: pasa al siguiente menú
+		case INPUT_EVENT_CLICK: {
+			contadorSwitch++;
 
-		uint8_t array[6] = 	{0x21, 84, 109, 0x22, 3, 3};
-		oled_sendCommand(&i2c_handler, array, 6);
-		oled_sendData(&i2c_handler, array_zeros, 26);
-		break;
+			if(contadorSwitch > MODO_MENU_AFINANDO){
+				contadorSwitch = MODO_MENU_0;
+			}
+			break;
+		}
+
+		// Pasos del encoder: positivos en sentido horario
+		case INPUT_EVENT_ROTATE: {
+
+			// Menu para seleccionar afinación manual o automática
+			if(contadorSwitch == MODO_MENU_0){
+				contadorMenu0 = moverOpcion(contadorMenu0, evento.value, MODO_AUTOMATICO, MODO_MANUAL);
+			}
+
+			// Menu para seleccionar la cuerda a afinar
+			else if(contadorSwitch == MODO_MENU_1){
+				contadorMenu1 = moverOpcion(contadorMenu1, evento.value, E4, E2);
+			}
+
+			// Menu para interactuar con el afinador en modo automático
+			else if(contadorSwitch == MODO_MENU_AUTOMATICO){
+				contadorMenu2 = moverOpcion(contadorMenu2, evento.value, RESPUESTA_AUTO_SI, RESPUESTA_AUTO_NO);
+			}
+			break;
+		}
+
+		default: {
+			__NOP();
+			break;
+		}
+		}
 	}
-	case 0: {
-		oled_sendData(&i2c_handler, array_figura, 104);
-		break;
+
+} // Fin Función evaluate()
+
+
+/*
+ * Entra a un menú. Los clicks y giros que siguen en la cola eran para el menú anterior
+ * (o llegaron durante una medición), así que se descartan para que no cambien el nuevo
+ */
+void entrarMenu(uint8_t menu){
+
+	contadorSwitch = menu;
+	input_Flush(&menuInput);
+}
+
+
+/*
+ * Mueve la opción de un menú los pasos indicados, sin salirse de los extremos
+ */
+uint8_t moverOpcion(uint8_t opcion, int16_t pasos, uint8_t minimo, uint8_t maximo){
+
+	int16_t nuevaOpcion = (int16_t)opcion + pasos;
+
+	if(nuevaOpcion < (int16_t)minimo){
+		return minimo;
 	}
+	if(nuevaOpcion > (int16_t)maximo){
+		return maximo;
 	}
+	return (uint8_t)nuevaOpcion;
+}
 
-	flagAnim ^= 1;
+
+/*
+ * Reloj de entrada del TIM3 (PWM que dispara el ADC), que está en el APB1: si el
+ * prescaler del APB1 no es 1, los timers cuentan al doble del PCLK1
+ * (16 MHz con el HSI, 100 MHz con pll_Config_100MHz)
+ */
+uint32_t relojTimerPWM(void){
+
+	uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+	uint32_t pclk1 = pll_GetPclk1();
+
+	if(ppre1 >= 4){
+		return 2 * pclk1;
+	}
+	return pclk1;
 }
 
 
-// Mensaje de que terminó la afinación
-void mensajeAfinado(void){
+/*
+ * Calcula la frecuencia de muestreo (nominal y corregida) y la resolución de la FFT
+ * a partir del periodo del PWM y del tamaño actual de la FFT
+ */
+void actualizarParametrosDSP(void){
 
-	/* Limpiamos la OLED */
-	oled_clearDisplay(&i2c_handler);
+	frec_muestreo = relojTimerPWM() / (pwmHandler.config.periodo * pwmHandler.config.prescaler);	// Valor para la frecuencia de muestreo
 
-	/* Mensaje inicial */
-	uint8_t bufferString[64] = {0};
-	sprintf((char *)bufferString, "CUERDA");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 6, 16, 5);
-	sprintf((char *)bufferString, "AFINADA");
-	oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 7, 16, 6);
-	flagAnim = 0;
-	opAnim = 0;
-	countAnim = 0;
-
-	/* Cargamos la configuración de la zona donde queremos hacer la figura */
-	uint8_t array[6] = 	{0x21, 84, 109, 0x22, 3, 6};
-	oled_sendCommand(&i2c_handler, array, 6);
-
-	/* Pintamos la figura */
-	oled_sendData(&i2c_handler, array_figura, 104);
+	/* Los bins del periodo quedan centrados en el periodo nominal (en ciclos del procesador).
+	 * Los intervalos de más de 4 periodos son las pausas entre capturas, que no cuentan
+	 * (hasta 3 disparos perdidos seguidos sí entran en la medición)
+	 */
+	uint32_t periodoNominal = (uint32_t)(((float)prof_GetFrequency() / frec_muestreo) + 0.5f);
+	prof_HistConfig(&adcPeriodo, periodoNominal - ((PROF_HIST_BINS / 2) * ADC_PERIODO_BIN), ADC_PERIODO_BIN, 4 * periodoNominal);
+	prof_HistConfig(&adcDuracion, 0, ADC_DURACION_BIN, 0);
+
+	aplicarCalibracion();
 }
 
 
-// Muestra cuál nota estamos afinando actualmente
-void muestraNota(uint8_t nota_cuerda){
+/*
+ * Mide la frecuencia de muestreo real con los intervalos entre conversiones guardados
+ * desde el último cambio de periodo: ciclos por segundo / ciclos promedio por muestra.
+ * Retorna 0 si todavía no hay suficientes muestras (no cambia la calibración).
+ */
+uint8_t calibrarMuestreo(void){
 
-	/* Limpiamos la pantalla primero */
-	oled_clearDisplay(&i2c_handler);
+	float periodoMedio = prof_HistGetMean(&adcPeriodo);
 
-	/* Identificamos la cuerda que se está afinando, para mostrar el mensaje en la OLED */
-	uint8_t bufferString[64] = {0};
-	switch(nota_cuerda){
-	case E4: {
-		sprintf((char *)bufferString, "AFINANDO CUERDA-1");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 17, 13, 0);
+	if((adcPeriodo.count < CAL_MIN_MUESTRAS) || (periodoMedio <= 0.0f)){
+		return 0;
+	}
 
-		sprintf((char *)bufferString, "NOTA: E4");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 8, 16, 2);
-		break;
+	frec_calibrada = (float)prof_GetFrequency() / periodoMedio;
+	escala_calibracion = frec_calibrada / frec_muestreo;
+	periodo_calibrado = pwmHandler.config.periodo;
+	muestras_calibracion = adcPeriodo.count;
+
+	aplicarCalibracion();
+	return 1;
+}
+
+
+/*
+ * Frecuencia real y resolución de la FFT: la medida si es del periodo actual, o la
+ * nominal escalada con la última medición mientras se mide el periodo nuevo
+ */
+void aplicarCalibracion(void){
+
+	if((periodo_calibrado != 0) && (periodo_calibrado == pwmHandler.config.periodo)){
+		frec_corregida = frec_calibrada;
+	}
+	else{
+		frec_corregida = frec_muestreo * escala_calibracion;
 	}
-	case B3: {
-		sprintf((char *)bufferString, "AFINANDO CUERDA-2");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 17, 13, 0);
 
-		sprintf((char *)bufferString, "NOTA: B3");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 8, 16, 2);
-		break;
+	resolucion_FFT = frec_corregida/fftSize;	// Resolución de la transformada -> Distancia entre cada intervalo de frecuencia
+}
+
+
+/*
+ * Enciende (TIMER_ON) o apaga (TIMER_OFF) el parpadeo de la opción actual del menú.
+ * Encenderlo cuando ya está encendido no reinicia el periodo, como con el timer de hardware.
+ */
+void parpadeoMenu(uint8_t newState){
+
+	if(newState == TIMER_ON){
+		if(!swtimer_IsActive(blinkString)){
+			blinkString = swtimer_Start(1000, SWTIMER_PERIODIC, blinkString_Callback, NULL);
+		}
 	}
-	case G3: {
-		sprintf((char *)bufferString, "AFINANDO CUERDA-3");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 17, 13, 0);
+	else{
+		swtimer_Stop(blinkString);
+		blinkString = SWTIMER_INVALID;
+	}
+}
 
-		sprintf((char *)bufferString, "NOTA: G3");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 8, 16, 2);
-		break;
+
+/* ===== TAREAS DE FONDO ===== */
+
+/* Envía a la OLED los cambios pendientes (display_Process respeta el frameRate) */
+void tareaDisplay(Sched_Task_t *ptrTask, uint32_t events){
+	(void)ptrTask;
+	(void)events;
+	PROF_BEGIN(PROF_OLED);
+	display_Process(&oledDisplay);
+	PROF_END(PROF_OLED);
+}
+
+
+/* Ejecuta un comando por vez; si quedan caracteres, la tarea se vuelve a publicar.
+ * Durante una captura los caracteres se quedan en el buffer y terminarCaptura la
+ * vuelve a publicar.
+ */
+void tareaShell(Sched_Task_t *ptrTask, uint32_t events){
+	(void)events;
+	if(flagCapturando){
+		return;
 	}
-	case D3: {
-		sprintf((char *)bufferString, "AFINANDO CUERDA-4");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 17, 13, 0);
+	shell_Process(&tunerShell);
+	if(tunerShell.rxTail != tunerShell.rxHead){
+		sched_PostEvent(ptrTask, EVENT_SHELL_RX);
+	}
+}
 
-		sprintf((char *)bufferString, "NOTA: D3");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 8, 16, 2);
-		break;
+
+/* Envía los mensajes pendientes del log */
+void tareaLog(Sched_Task_t *ptrTask, uint32_t events){
+	(void)ptrTask;
+	(void)events;
+	PROF_BEGIN(PROF_LOG);
+	log_Process(&tunerLog);
+	PROF_END(PROF_LOG);
+}
+
+
+/* ===== COMANDOS DEL SHELL =====
+ * Sin argumento muestran el valor actual; con argumento lo cambian.
+ * Se ejecutan desde la tarea del shell, que no corre comandos mientras hay una captura
+ * en curso (flagCapturando), así que no interrumpen una conversión.
+ */
+
+/* Tamaño de la FFT (potencias de 2 hasta el tamaño del arreglo del ADC) */
+uint8_t cmdFft(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
+
+	if(argc > 2){
+		return SHELL_ERROR_ARGS;
+	}
+	if(argc == 2){
+		uint32_t newSize = 0;
+		if(!shell_ParseUint(argv[1], &newSize) ||
+		   ((newSize != 256) && (newSize != 512) && (newSize != ADC_DataSize))){
+			return SHELL_ERROR_VALUE;
+		}
+		fftSize = newSize;
+		count_ADC_Data = 0;
+		actualizarParametrosDSP();
 	}
-	case A2: {
-		sprintf((char *)bufferString, "AFINANDO CUERDA-5");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 17, 13, 0);
 
-		sprintf((char *)bufferString, "NOTA: A2");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 8, 16, 2);
-		break;
+	format_String(&ptrShell->writer, "fft = ");
+	format_Uint(&ptrShell->writer, fftSize, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " (resolucion ");
+	format_Float(&ptrShell->writer, resolucion_FFT, 3);
+	format_String(&ptrShell->writer, " Hz)\r\n");
+	return SHELL_OK;
+}
+
+
+/* Frecuencia de muestreo nominal: cambia el periodo del PWM que dispara el ADC */
+uint8_t cmdFs(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
+
+	if(argc > 2){
+		return SHELL_ERROR_ARGS;
+	}
+	if(argc == 2){
+		uint32_t newFrequency = 0;
+		if(!shell_ParseUint(argv[1], &newFrequency) || (newFrequency < 500) || (newFrequency > 10000)){
+			return SHELL_ERROR_VALUE;
+		}
+		/* El periodo es (cuentas del PWM por segundo) / fs redondeado: 1e6/fs con el HSI y prescaler 16 */
+		uint32_t ticks = relojTimerPWM() / pwmHandler.config.prescaler;
+		updateFrequency(&pwmHandler, (uint16_t)((ticks + (newFrequency / 2)) / newFrequency));
+		actualizarParametrosDSP();
 	}
-	case E2: {
-		sprintf((char *)bufferString, "AFINANDO CUERDA-6");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 17, 13, 0);
 
-		sprintf((char *)bufferString, "NOTA: E2");
-		oled_setString(&i2c_handler, bufferString, NORMAL_DISPLAY, 8, 16, 2);
-		break;
+	format_String(&ptrShell->writer, "fs = ");
+	format_Float(&ptrShell->writer, frec_muestreo, 1);
+	format_String(&ptrShell->writer, " Hz (corregida ");
+	format_Float(&ptrShell->writer, frec_corregida, 1);
+	format_String(&ptrShell->writer, " Hz)\r\n");
+	return SHELL_OK;
+}
+
+
+/* Salida del log diferido: texto en el micro, tramas binarias para Tools/log_decoder, o apagado */
+uint8_t cmdLog(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
+
+	static const char *const outputNames[] = {"off", "text", "bin"};
+
+	if(argc > 2){
+		return SHELL_ERROR_ARGS;
 	}
+	if(argc == 2){
+		uint8_t newOutput = 0;
+		while((newOutput <= LOG_OUTPUT_BINARY) && (strcmp(argv[1], outputNames[newOutput]) != 0)){
+			newOutput++;
+		}
+		if(newOutput > LOG_OUTPUT_BINARY){
+			return SHELL_ERROR_VALUE;
+		}
+		/* Lo pendiente sale todavía con la salida anterior */
+		log_Flush(&tunerLog);
+		tunerLog.output = newOutput;
 	}
+
+	format_String(&ptrShell->writer, "log = ");
+	format_String(&ptrShell->writer, outputNames[tunerLog.output]);
+	format_String(&ptrShell->writer, " (");
+	format_Uint(&ptrShell->writer, tunerLog.stats.records, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " registros, ");
+	format_Uint(&ptrShell->writer, tunerLog.stats.dropped, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " perdidos)\r\n");
+	return SHELL_OK;
 }
 
-// Función para evaluar si se aumenta o disminuye el contador
-void evaluate(void){
 
-	// Menu para seleccionar afinación manual o automática
-	if((contadorSwitch == MODO_MENU_0) && flagData){
+/* Tiempos de la interrupción del ADC: histogramas del periodo entre conversiones y de la
+ * duración del callback, y la frecuencia de muestreo que resulta del periodo promedio
+ */
+uint8_t cmdAdc(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
 
-		// Bajamos la bandera por interrupción del ENCODER
-		flagData = 0;
-		if(readData == 1){
-			// Giro en sentido horario -> contadorSensor AUMENTA
-			if(contadorMenu0 == MODO_MANUAL){
-				contadorMenu0--;
-			}
-			contadorMenu0++;
+	if(argc > 2){
+		return SHELL_ERROR_ARGS;
+	}
+	if(argc == 2){
+		if(strcmp(argv[1], "reset") != 0){
+			return SHELL_ERROR_VALUE;
 		}
-		else{
-			// Giro en sentido anti-horario -> contadorSensor DISMINUYE
-			if(contadorMenu0 == MODO_AUTOMATICO){
-				contadorMenu0++;
-			}
-			contadorMenu0--;
+		prof_HistReset(&adcPeriodo);
+		prof_HistReset(&adcDuracion);
+	}
+
+	prof_HistDump(&adcPeriodo, "periodo", &ptrShell->writer);
+	prof_HistDump(&adcDuracion, "duracion", &ptrShell->writer);
+
+	/* Frecuencia medida = ciclos por segundo / ciclos promedio entre conversiones */
+	float periodoMedio = prof_HistGetMean(&adcPeriodo);
+	if(periodoMedio > 0.0f){
+		float frecMedida = (float)prof_GetFrequency() / periodoMedio;
+		format_String(&ptrShell->writer, "fs medida = ");
+		format_Float(&ptrShell->writer, frecMedida, 1);
+		format_String(&ptrShell->writer, " Hz (nominal ");
+		format_Float(&ptrShell->writer, frec_muestreo, 1);
+		format_String(&ptrShell->writer, " Hz, error ");
+		format_Float(&ptrShell->writer, 100.0f * (1.0f - (frecMedida / frec_muestreo)), 3);
+		format_String(&ptrShell->writer, " %, en uso ");
+		format_Float(&ptrShell->writer, frec_corregida, 1);
+		format_String(&ptrShell->writer, " Hz)\r\n");
+	}
+	return SHELL_OK;
+}
+
+
+/* Calibración de la frecuencia de muestreo: sin argumentos la vuelve a medir con las
+ * capturas hechas desde el último cambio de periodo; "reset" vuelve a la nominal
+ */
+uint8_t cmdCal(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
+
+	if(argc > 2){
+		return SHELL_ERROR_ARGS;
+	}
+	if(argc == 2){
+		if(strcmp(argv[1], "reset") != 0){
+			return SHELL_ERROR_VALUE;
 		}
+		periodo_calibrado = 0;
+		escala_calibracion = 1.0f;
+		aplicarCalibracion();
+	}
+	else if(!calibrarMuestreo()){
+		format_String(&ptrShell->writer, "cal: faltan muestras (");
+		format_Uint(&ptrShell->writer, adcPeriodo.count, 0, FORMAT_PAD_SPACE);
+		format_String(&ptrShell->writer, " de ");
+		format_Uint(&ptrShell->writer, CAL_MIN_MUESTRAS, 0, FORMAT_PAD_SPACE);
+		format_String(&ptrShell->writer, "), haga una captura\r\n");
 	}
 
-	// Menu para seleccionar la cuerda a afinar
-	else if((contadorSwitch == MODO_MENU_1) && flagData){
+	format_String(&ptrShell->writer, "fs nominal ");
+	format_Float(&ptrShell->writer, frec_muestreo, 1);
+	format_String(&ptrShell->writer, " Hz, en uso ");
+	format_Float(&ptrShell->writer, frec_corregida, 2);
+	format_String(&ptrShell->writer, " Hz (escala ");
+	format_Float(&ptrShell->writer, escala_calibracion, 5);
+	if(periodo_calibrado == pwmHandler.config.periodo){
+		format_String(&ptrShell->writer, ", medida con ");
+		format_Uint(&ptrShell->writer, muestras_calibracion, 0, FORMAT_PAD_SPACE);
+		format_String(&ptrShell->writer, " muestras)\r\n");
+	}
+	else{
+		format_String(&ptrShell->writer, ", sin medir en este periodo)\r\n");
+	}
+	format_String(&ptrShell->writer, "resolucion FFT ");
+	format_Float(&ptrShell->writer, resolucion_FFT, 4);
+	format_String(&ptrShell->writer, " Hz\r\n");
+	return SHELL_OK;
+}
 
-		// Bajamos la bandera por interrupción del ENCODER
-		flagData = 0;
-		if(readData == 1){
-			// Giro en sentido horario -> contadorRes AUMENTA
-			if(contadorMenu1 == E2){
-				contadorMenu1--;
-			}
-			contadorMenu1++;
+
+/* Fuente de la frecuencia de la cuerda: la FFT o la captura de entrada, con el estado
+ * de la captura
+ */
+uint8_t cmdPitch(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
+
+	if(argc > 2){
+		return SHELL_ERROR_ARGS;
+	}
+	if(argc == 2){
+		if(strcmp(argv[1], "fft") == 0){
+			fuentePitch = FUENTE_FFT;
+		}
+		else if(strcmp(argv[1], "cap") == 0){
+			fuentePitch = FUENTE_CAPTURA;
 		}
 		else{
-			// Giro en sentido anti-horario -> contadorRes DISMINUYE
-			if(contadorMenu1 == E4){
-				contadorMenu1++;
-			}
-			contadorMenu1--;
+			return SHELL_ERROR_VALUE;
 		}
 	}
 
-	// Menu para interactuar con el afinador en modo automático
-	if((contadorSwitch == MODO_MENU_AUTOMATICO) && flagData){
+	capture_Process(&pitchCapture);
+
+	format_String(&ptrShell->writer, (fuentePitch == FUENTE_FFT) ? "fuente fft" : "fuente captura");
+	format_String(&ptrShell->writer, "; captura ");
+	format_Float(&ptrShell->writer, capture_GetFrequency(&pitchCapture), 2);
+	format_String(&ptrShell->writer, " Hz, confianza ");
+	format_Uint(&ptrShell->writer, capture_GetConfidence(&pitchCapture), 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " % (");
+	format_Uint(&ptrShell->writer, pitchCapture.stats.periods, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " periodos, ");
+	format_Uint(&ptrShell->writer, pitchCapture.stats.rejected, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " descartados, ");
+	format_Uint(&ptrShell->writer, pitchCapture.stats.overruns, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " desbordes)\r\n");
+	return SHELL_OK;
+}
 
-		// Bajamos la bandera por interrupción del ENCODER
-		flagData = 0;
-		if(readData == 1){
-			// Giro en sentido horario -> contadorSensor AUMENTA
-			if(contadorMenu2 == RESPUESTA_AUTO_NO){
-				contadorMenu2--;
-			}
-			contadorMenu2++;
+
+/* Tabla del profiler: veces, mínimo, promedio y máximo de ciclos de cada sección */
+uint8_t cmdProf(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
+
+	if(argc > 2){
+		return SHELL_ERROR_ARGS;
+	}
+	if(argc == 2){
+		if(strcmp(argv[1], "reset") != 0){
+			return SHELL_ERROR_VALUE;
 		}
-		else{
-			// Giro en sentido anti-horario -> contadorSensor DISMINUYE
-			if(contadorMenu2 == RESPUESTA_AUTO_SI){
-				contadorMenu2++;
-			}
-			contadorMenu2--;
+		prof_Reset();
+	}
+
+	prof_Dump(&ptrShell->writer);
+	return SHELL_OK;
+}
+
+
+/* Resumen de los parámetros y contadores */
+uint8_t cmdStatus(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
+
+	if(argc != 1){
+		return SHELL_ERROR_ARGS;
+	}
+
+	cmdFs(ptrShell, 1, argv);
+	cmdFft(ptrShell, 1, argv);
+	cmdTol(ptrShell, 1, argv);
+	cmdLog(ptrShell, 1, argv);
+
+	format_String(&ptrShell->writer, "shell: ");
+	format_Uint(&ptrShell->writer, ptrShell->stats.commands, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " comandos, ");
+	format_Uint(&ptrShell->writer, ptrShell->stats.errors, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " errores, ");
+	format_Uint(&ptrShell->writer, ptrShell->stats.overflows, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " desbordes\r\n");
+
+	format_String(&ptrShell->writer, "stream: ");
+	format_String(&ptrShell->writer, tunerStream.enable ? "on, " : "off, ");
+	format_Uint(&ptrShell->writer, tunerStream.stats.frames, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " tramas\r\n");
+
+	format_String(&ptrShell->writer, "sched: ");
+	format_Uint(&ptrShell->writer, sched_GetIdleCount(), 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " veces en reposo, oled ");
+	format_Uint(&ptrShell->writer, taskDisplay.runs, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, ", log ");
+	format_Uint(&ptrShell->writer, taskLog.runs, 0, FORMAT_PAD_SPACE);
+	format_String(&ptrShell->writer, " ejecuciones\r\n");
+	return SHELL_OK;
+}
+
+
+/* Tolerancia de afinación, en intervalos de la FFT (la cuerda está afinada dentro de +-tol*resolución) */
+uint8_t cmdTol(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
+
+	if(argc > 2){
+		return SHELL_ERROR_ARGS;
+	}
+	if(argc == 2){
+		float newTolerance = 0;
+		if(!shell_ParseFloat(argv[1], &newTolerance) || (newTolerance < 0.25f) || (newTolerance > 10.0f)){
+			return SHELL_ERROR_VALUE;
 		}
+		tolerancia_bins = newTolerance;
 	}
 
-} // Fin Función evaluate()
+	format_String(&ptrShell->writer, "tol = ");
+	format_Float(&ptrShell->writer, tolerancia_bins, 2);
+	format_String(&ptrShell->writer, " intervalos (");
+	format_Float(&ptrShell->writer, tolerancia_bins * resolucion_FFT, 2);
+	format_String(&ptrShell->writer, " Hz)\r\n");
+	return SHELL_OK;
+}
 
 
 /* ===== CALLBACKS ===== */
 
-/* Callback de Timer 2 (Controla el userLed) */
-void Timer2_Callback(void){
-	gpio_TooglePin(&userLed);
+/* Callback del blinky (timer por software): el contexto es el pin del LED */
+void blinkLed_Callback(void *context){
+	gpio_TooglePin((GPIO_Handler_t *)context);
 }
 
 
 /*
- * Callback de Timer 5 (Controla la visualización de la opción actual en la OLED)
+ * Callback del parpadeo del menú (timer por software). Controla la visualización
+ * de la opción actual en la OLED
  */
-void Timer5_Callback(void){
+void blinkString_Callback(void *context){
+
+	(void)context;
 
 	if(contadorSwitch == MODO_MENU_INICIAL){
 		flagMenuInicial ^= 1;
@@ -1792,17 +2378,6 @@ void Timer5_Callback(void){
 		flagMenu2 ^= 1;
 	}
 
-	/* Contador para la animación */
-	if(opAnim){
-		flagAnim ^= 1;
-		if(flagAnim){
-			countAnim++;
-			if(countAnim >= 4){
-				countAnim = 0;
-			}
-		}
-	}
-
 }
 
 
@@ -1811,44 +2386,44 @@ void Timer5_Callback(void){
  */
 void adc_CompleteCallback(void){
 
+	uint32_t inicio = prof_GetCycles();
+	PROF_HIST_MARK(&adcPeriodo, inicio);
+
 	// Guardamos el valor de la conversión correspondiente a cada sensor de la secuencia
 	ADC_Data1[count_ADC_Data] = (float32_t)adc_GetValue();
 	count_ADC_Data++;
 
-	if(count_ADC_Data > (ADC_DataSize-1)){
+	if(count_ADC_Data > (fftSize-1)){
 		stopPwmSignal(&pwmHandler);
 		flagStop = 1;
 		count_ADC_Data = 0;
 	}
-}
 
-
-/* Función callback para la interrupción del EXTI0, es decir, la interrupción
- * externa debida al switch
- * */
-void callback_ExtInt0(void){
-	flagMode = 1;	// Aplicamos un XOR a la bandera para que cambie de valor binario
-	contadorSwitch++;
-
-	if(contadorSwitch > MODO_MENU_AFINANDO){
-		contadorSwitch = MODO_MENU_0;
-	}
+	PROF_HIST_ADD(&adcDuracion, prof_GetCycles() - inicio);
 }
 
 
-/* Función callback que atiende la interrupción del EXTI8, en este caso, corresponde
- * a la interrupcón externa del encoder (CW o CCW)
- * */
-void callback_ExtInt8(void){
-	flagData = 1;
-	readData = gpio_ReadPin(&data);
-}
-
 /*
- * Callback del USART 2 debido a recepción
+ * Callback del USART 2 por recepción (llega por DMA, en bloques).
+ * Cada caracter pasa primero por el shell: las líneas que empiezan con ':' son comandos
+ * y el resto de teclas son para los menús.
  */
-void usart2_RxCallback(void){
-	usart2DataReceived = usart2_getRxData();
+void usart2_RxFrameCallback(uint8_t *data, uint16_t length){
+
+	for(uint16_t i = 0; i < length; i++){
+
+		if(shell_ReceiveChar(&tunerShell, (char)data[i])){
+			sched_PostEvent(&taskShell, EVENT_SHELL_RX);
+			continue;
+		}
+
+		/* 'b' enciende o apaga las tramas binarias sin afectar los menús */
+		if(data[i] == 'b'){
+			tunerStream.enable ^= STREAM_ENABLE;
+			continue;
+		}
+		usart2DataReceived = data[i];
+	}
 }
 
 /*
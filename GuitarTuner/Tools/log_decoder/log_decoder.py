@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+#
+# log_decoder.py
+#
+#  Created on: Dec 11, 2023
+#      Author: sgaviriav
+#
+# Decodificador (en el PC) del log diferido del GuitarTuner. Con la salida binaria
+# (tunerLog.output = LOG_OUTPUT_BINARY, o ":log bin" en la terminal) el micro sólo
+# envía el número del mensaje, el tiempo y los argumentos en crudo dentro de tramas
+# STREAM_FRAME_LOG; este programa pone el texto leyendo la misma lista de mensajes
+# con la que se compila el firmware (Drivers/Inc/log_messages.h).
+#
+# Las tramas se separan y verifican con el StreamReceiver de Tools/spectrum_receiver,
+# y las demás tramas (ADC, espectro, pitch) se ignoran.
+#
+# Uso:
+#   python3 log_decoder.py /dev/ttyACM0                    # 115200 baudios
+#   python3 log_decoder.py --file captura.bin              # captura de spectrum_receiver --save
+#   python3 log_decoder.py --export mensajes.json          # sólo escribe la tabla id -> texto
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+TOOLS_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, os.path.join(TOOLS_DIR, "spectrum_receiver"))
+from spectrum_receiver import StreamReceiver, open_source  # noqa: E402
+
+DEFAULT_MESSAGES = os.path.join(TOOLS_DIR, "..", "Drivers", "Inc", "log_messages.h")
+
+MESSAGE_PATTERN = re.compile(r'LOG_MSG\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+SPECIFIER_PATTERN = re.compile(r"%(.)")
+
+
+def load_messages(path):
+    """Lee log_messages.h: el identificador de cada mensaje es su posición en la lista"""
+    with open(path, encoding="utf-8") as header:
+        text = header.read()
+    messages = MESSAGE_PATTERN.findall(text)
+    if not messages:
+        sys.exit("No se encontraron mensajes LOG_MSG en %s" % path)
+    return messages
+
+
+def format_message(message, args):
+    """Aplica los argumentos crudos (32 bits) igual que log_write_text en el micro"""
+    remaining = list(args)
+
+    def replace(match):
+        specifier = match.group(1)
+        if specifier == "%":
+            return "%"
+        value = remaining.pop(0) if remaining else 0
+        if specifier == "d":
+            return str(struct.unpack("<i", struct.pack("<I", value))[0])
+        if specifier == "u":
+            return str(value)
+        if specifier == "x":
+            return "%x" % value
+        if specifier == "c":
+            return chr(value & 0xFF)
+        if specifier == "f":
+            return "%.2f" % struct.unpack("<f", struct.pack("<I", value))[0]
+        return "?"
+
+    return SPECIFIER_PATTERN.sub(replace, message)
+
+
+def describe(frame, messages):
+    if frame["id"] < len(messages):
+        name, message = messages[frame["id"]]
+        text = format_message(message, frame["args"])
+    else:
+        name, text = "?", "mensaje desconocido " + " ".join("0x%08X" % arg for arg in frame["args"])
+    return "%10.3f s  %-22s %s" % (frame["time"] / 1000.0, name, text)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Decodificador del log binario del GuitarTuner")
+    parser.add_argument("port", nargs="?", help="Puerto serial (por ejemplo /dev/ttyACM0 o COM3)")
+    parser.add_argument("-b", "--baudrate", type=int, default=115200)
+    parser.add_argument("--file", help="Lee una captura guardada en lugar del puerto")
+    parser.add_argument("--messages", default=DEFAULT_MESSAGES, help="Lista de mensajes (log_messages.h)")
+    parser.add_argument("--export", help="Escribe la tabla de mensajes en JSON y termina")
+    arguments = parser.parse_args()
+
+    messages = load_messages(arguments.messages)
+
+    if arguments.export:
+        with open(arguments.export, "w", encoding="utf-8") as output:
+            json.dump([{"id": index, "name": name, "format": message}
+                       for index, (name, message) in enumerate(messages)], output, ensure_ascii=False, indent=2)
+        sys.exit(0)
+
+    if not arguments.port and not arguments.file:
+        parser.error("indique un puerto, --file o --export")
+
+    source, read = open_source(arguments)
+    receiver = StreamReceiver()
+    records = 0
+
+    try:
+        while True:
+            data = read(source)
+            if not data and arguments.file:
+                break
+            for frame in receiver.feed(data):
+                if frame["type"] == "log":
+                    records += 1
+                    print(describe(frame, messages))
+    except KeyboardInterrupt:
+        pass
+
+    print("registros: %d  tramas descartadas: %d  perdidas: %d" % (records, receiver.discarded, receiver.lost))
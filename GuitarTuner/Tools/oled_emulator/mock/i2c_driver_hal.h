@@ -0,0 +1,43 @@
+/*
+ * i2c_driver_hal.h (mock para el emulador en el PC)
+ *
+ *  Created on: Dec 8, 2023
+ *      Author: sgaviriav
+ *
+ * Reemplaza al driver I2C real: cada i2c_WriteBuffer se entrega completo
+ * (dirección, byte de control y datos) al emulador de la SSD1306.
+ */
+
+#ifndef I2C_DRIVER_HAL_H_
+#define I2C_DRIVER_HAL_H_
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/* Mismos códigos de error que el driver real */
+enum
+{
+	I2C_OK = 0,
+	I2C_ERROR_BUSY,
+	I2C_ERROR_TIMEOUT_SB,
+	I2C_ERROR_TIMEOUT_ADDR,
+	I2C_ERROR_TIMEOUT_TXE,
+	I2C_ERROR_TIMEOUT_BTF,
+	I2C_ERROR_TIMEOUT_RXNE,
+	I2C_ERROR_NACK,
+	I2C_ERROR_BUS
+};
+
+struct SSD1306_Emulator;
+
+/* Handler del I2C simulado */
+typedef struct
+{
+	struct SSD1306_Emulator	*ptrEmulator;	// Pantalla que recibe las transacciones
+	uint8_t					slaveAddress;	// Dirección del esclavo
+	uint8_t					lastError;		// Resultado de la última transacción
+} I2C_Handler_t;
+
+uint8_t i2c_WriteBuffer(I2C_Handler_t *ptrHandlerI2C, uint8_t memAddress, uint8_t *data, uint16_t length);
+
+#endif /* I2C_DRIVER_HAL_H_ */
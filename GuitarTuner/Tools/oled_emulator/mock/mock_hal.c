@@ -0,0 +1,45 @@
+/*
+ * mock_hal.c
+ *
+ *  Created on: Dec 8, 2023
+ *      Author: sgaviriav
+ *
+ * Implementación en el PC de las funciones del HAL que usan los drivers de la OLED
+ */
+
+// Importando librerías necesarias
+#include <stddef.h>
+#include <stdint.h>
+#include "i2c_driver_hal.h"
+#include "systick_driver_hal.h"
+#include "ssd1306_emulator.h"
+
+/* Reloj simulado (ms) */
+static uint64_t emulatorTicks = 0;
+
+
+/*
+ * Una escritura completa del driver I2C: si la dirección es la de la pantalla,
+ * el emulador recibe el byte de control (memAddress) y los datos
+ */
+uint8_t i2c_WriteBuffer(I2C_Handler_t *ptrHandlerI2C, uint8_t memAddress, uint8_t *data, uint16_t length){
+
+	if((ptrHandlerI2C->ptrEmulator == NULL) || (ptrHandlerI2C->slaveAddress != SSD1306_I2C_ADDRESS)){
+		ptrHandlerI2C->lastError = I2C_ERROR_NACK;
+		return I2C_ERROR_NACK;
+	}
+
+	emulator_Transaction(ptrHandlerI2C->ptrEmulator, memAddress, data, length);
+	ptrHandlerI2C->lastError = I2C_OK;
+	return I2C_OK;
+}
+
+
+uint64_t systick_GetTicks(void){
+	return emulatorTicks;
+}
+
+
+void emulator_AdvanceTime_ms(uint32_t time_ms){
+	emulatorTicks += time_ms;
+}
@@ -0,0 +1,14 @@
+/*
+ * stm32f4xx.h (mock para el emulador en el PC)
+ *
+ *  Created on: Dec 8, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef STM32F4XX_H_
+#define STM32F4XX_H_
+
+/* Los drivers de la OLED sólo usan __NOP() del CMSIS */
+#define __NOP()		do{}while(0)
+
+#endif /* STM32F4XX_H_ */
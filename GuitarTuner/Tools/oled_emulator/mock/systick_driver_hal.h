@@ -0,0 +1,18 @@
+/*
+ * systick_driver_hal.h (mock para el emulador en el PC)
+ *
+ *  Created on: Dec 8, 2023
+ *      Author: sgaviriav
+ *
+ * El tiempo lo avanza el programa del emulador (emulator_AdvanceTime_ms),
+ * así los escenarios con límite de cuadros por segundo son reproducibles.
+ */
+
+#ifndef SYSTICK_DRIVER_HAL_H_
+#define SYSTICK_DRIVER_HAL_H_
+
+#include <stdint.h>
+
+uint64_t systick_GetTicks(void);
+
+#endif /* SYSTICK_DRIVER_HAL_H_ */
@@ -0,0 +1,235 @@
+/*
+ * oled_emulator.c
+ *
+ *  Created on: Dec 8, 2023
+ *      Author: sgaviriav
+ *
+ * Programa para el PC que corre los drivers de la OLED (oled, meter y display)
+ * contra el emulador de la SSD1306. Por cada pantalla del GuitarTuner imprime
+ * cuántas transacciones y bytes se enviaron por I2C, guarda una imagen PBM y la
+ * compara con lo esperado (expectedScreens): la huella de la imagen debe ser la
+ * misma y el costo en el bus no puede pasar del presupuesto. Si algo no cumple
+ * el programa termina con 1, así se puede correr en CI.
+ *
+ * Si un cambio en los drivers modifica una pantalla a propósito, se revisa la
+ * imagen PBM y se copia a la tabla la huella que imprime el programa.
+ *
+ * Compilación (desde esta carpeta; mock/ debe ir antes para reemplazar los headers del MCU):
+ *   gcc -std=c99 -Wall -Imock -I. -I../../Drivers/Inc -o oled_emulator \
+ *       oled_emulator.c ssd1306_emulator.c mock/mock_hal.c \
+ *       ../../Drivers/Src/oled_driver.c ../../Drivers/Src/meter_driver.c \
+ *       ../../Drivers/Src/display_driver.c
+ *
+ * Uso:
+ *   ./oled_emulator [carpeta_de_salida]
+ */
+
+// Importando librerías necesarias
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306_emulator.h"
+#include "i2c_driver_hal.h"
+#include "oled_driver.h"
+#include "meter_driver.h"
+#include "display_driver.h"
+
+#define SNAPSHOT_SCALE	4	// Ampliación de las imágenes PBM
+
+/* Resultado esperado de una pantalla */
+typedef struct
+{
+	const char	*name;
+	uint32_t	hash;				// emulator_Hash de la imagen
+	uint32_t	maxTransactions;	// Presupuesto del bus
+	uint32_t	maxBusBytes;
+} Screen_Expected_t;
+
+static const Screen_Expected_t expectedScreens[] = {
+		{"01_arranque",				0xAD6FCD1FUL,	4,	1069},
+		{"02_menu_inicial",			0x08FA77FFUL,	10,	219},
+		{"03_parpadeo_1s",			0x08FA77FFUL,	12,	312},
+		{"04_menu_modos",			0x54DFAAB3UL,	13,	1275},
+		{"05_afinando",				0x8F597A48UL,	21,	1587},
+		{"06_aguja_paso_pequeno",	0xB2F82B40UL,	2,	20},
+		{"07_aguja_paso_grande",	0x98CA3420UL,	2,	66},
+		{"08_afinada",				0x384FAFEBUL,	6,	144}
+};
+
+#define NUM_EXPECTED_SCREENS	(sizeof(expectedScreens) / sizeof(expectedScreens[0]))
+
+/* Pantalla y bus simulados */
+SSD1306_Emulator_t emulator = {0};
+I2C_Handler_t i2c_handler = {0};
+
+/* Drivers de la aplicación, con la misma configuración que en main.c */
+Meter_Handler_t tunerMeter = {0};
+Display_Handler_t oledDisplay = {0};
+
+/* Carpeta donde se guardan las imágenes */
+const char *outputFolder = ".";
+
+/* Pantallas que no cumplieron lo esperado */
+uint8_t failedScreens = 0;
+
+/* === Headers for private functions === */
+static void endScreen(const char *name);
+static uint8_t checkScreen(const char *name);
+static void setText(const char *text, uint8_t display_mode, uint8_t column, uint8_t page);
+
+
+int main(int argc, char *argv[]){
+
+	if(argc > 1){
+		outputFolder = argv[1];
+	}
+
+	/* Conectamos la pantalla al bus simulado */
+	emulator_Reset(&emulator);
+	i2c_handler.ptrEmulator		= &emulator;
+	i2c_handler.slaveAddress	= OLED_ADDRESS;
+
+	tunerMeter.ptrHandlerI2C	= &i2c_handler;
+	tunerMeter.startColumn		= 4;
+	tunerMeter.width			= 120;
+	tunerMeter.startPage		= 3;
+	tunerMeter.pages			= 2;
+	tunerMeter.rangeCents		= 50;
+	meter_Config(&tunerMeter);
+
+	oledDisplay.ptrHandlerI2C	= &i2c_handler;
+	oledDisplay.frameRate		= 20;
+
+	/* 1. Arranque: configuración y limpieza */
+	oled_Config(&i2c_handler);
+	oled_clearDisplay(&i2c_handler);
+	display_Config(&oledDisplay);
+	endScreen("01_arranque");
+
+	/* 2. Menú inicial (el mismo texto de main.c) */
+	setText("BIENVENIDO A", NORMAL_DISPLAY, 28, 1);
+	setText("GUITAR TUNER", NORMAL_DISPLAY, 28, 3);
+	setText("EMPEZAR", NORMAL_DISPLAY, 43, 5);
+	display_Flush(&oledDisplay);
+	endScreen("02_menu_inicial");
+
+	/* 3. Parpadeo de la opción cada 30 ms durante 1 s, con el loop corriendo cada 1 ms:
+	 * el planificador limita el envío a 20 cuadros por segundo
+	 */
+	for(uint16_t time_ms = 0; time_ms < 1000; time_ms++){
+		if((time_ms % 30) == 0){
+			setText("EMPEZAR", ((time_ms / 30) & 1) ? NORMAL_DISPLAY : INVERSE_DISPLAY, 43, 5);
+		}
+		display_Process(&oledDisplay);
+		emulator_AdvanceTime_ms(1);
+	}
+	endScreen("03_parpadeo_1s");
+
+	/* 4. Menú de modos */
+	display_Clear(&oledDisplay);
+	setText("SELECCIONE UN MODO", NORMAL_DISPLAY, 10, 1);
+	setText("AUTOMATICO", INVERSE_DISPLAY, 34, 4);
+	setText("MANUAL", NORMAL_DISPLAY, 46, 6);
+	display_Flush(&oledDisplay);
+	endScreen("04_menu_modos");
+
+	/* 5. Afinación: nota, instrucciones y el medidor dibujado completo */
+	display_Clear(&oledDisplay);
+	meter_Invalidate(&tunerMeter);
+	setText("AFINANDO CUERDA 6", NORMAL_DISPLAY, 13, 0);
+	setText("NOTA: E2", NORMAL_DISPLAY, 16, 2);
+	setText("APRIETE", NORMAL_DISPLAY, 16, 5);
+	setText("LA CLAVIJA", NORMAL_DISPLAY, 16, 6);
+	display_Flush(&oledDisplay);
+	meter_Update(&tunerMeter, -30.0f);
+	endScreen("05_afinando");
+
+	/* 6. La aguja se acerca al centro (sólo viajan las columnas que cambian) */
+	meter_Update(&tunerMeter, -27.0f);
+	endScreen("06_aguja_paso_pequeno");
+
+	meter_Update(&tunerMeter, -5.0f);
+	endScreen("07_aguja_paso_grande");
+
+	/* 7. Cuerda afinada */
+	setText("CUERDA ", NORMAL_DISPLAY, 16, 5);
+	setText("AFINADA   ", NORMAL_DISPLAY, 16, 6);
+	display_Flush(&oledDisplay);
+	meter_Update(&tunerMeter, 0.0f);
+	endScreen("08_afinada");
+
+	if(failedScreens){
+		printf("%u pantalla(s) no cumplen lo esperado\n", failedScreens);
+		return 1;
+	}
+	printf("Todas las pantallas cumplen lo esperado\n");
+	return 0;
+}
+
+
+/*
+ * Escribe un texto por el planificador, igual que main.c
+ */
+static void setText(const char *text, uint8_t display_mode, uint8_t column, uint8_t page){
+	uint8_t bufferString[64] = {0};
+	strncpy((char *)bufferString, text, sizeof(bufferString) - 1);
+	display_SetString(&oledDisplay, bufferString, display_mode, strlen(text), column, page);
+}
+
+
+/*
+ * Cierra una pantalla: imprime el costo en el bus, guarda la imagen y reinicia los contadores
+ */
+static void endScreen(const char *name){
+
+	char fileName[256] = {0};
+	snprintf(fileName, sizeof(fileName), "%s/%s.pbm", outputFolder, name);
+
+	emulator_PrintStats(&emulator, name);
+	if(emulator_DumpPBM(&emulator, fileName, SNAPSHOT_SCALE) != 0){
+		printf("No se pudo escribir %s\n", fileName);
+	}
+	if(!checkScreen(name)){
+		failedScreens++;
+	}
+	emulator_ResetStats(&emulator);
+}
+
+
+/*
+ * Compara la pantalla actual con la esperada: misma imagen, costo dentro del
+ * presupuesto y ningún comando desconocido. Retorna 0 (e imprime por qué) si falla
+ */
+static uint8_t checkScreen(const char *name){
+
+	const Screen_Expected_t *ptrExpected = NULL;
+	uint32_t hash = emulator_Hash(&emulator);
+	uint8_t ok = 1;
+
+	for(uint8_t i = 0; i < NUM_EXPECTED_SCREENS; i++){
+		if(strcmp(expectedScreens[i].name, name) == 0){
+			ptrExpected = &expectedScreens[i];
+		}
+	}
+
+	if(ptrExpected == NULL){
+		printf("%-28s FALLA: pantalla sin resultado esperado (huella 0x%08X)\n", "", hash);
+		return 0;
+	}
+	if(hash != ptrExpected->hash){
+		printf("%-28s FALLA: huella 0x%08X, se esperaba 0x%08X\n", "", hash, ptrExpected->hash);
+		ok = 0;
+	}
+	if(emulator.stats.transactions > ptrExpected->maxTransactions){
+		printf("%-28s FALLA: %u transacciones, el máximo es %u\n", "", emulator.stats.transactions, ptrExpected->maxTransactions);
+		ok = 0;
+	}
+	if(emulator.stats.busBytes > ptrExpected->maxBusBytes){
+		printf("%-28s FALLA: %u B en el bus, el máximo es %u B\n", "", emulator.stats.busBytes, ptrExpected->maxBusBytes);
+		ok = 0;
+	}
+	if(emulator.stats.unknownCommands){
+		ok = 0;
+	}
+
+	return ok;
+}
@@ -0,0 +1,322 @@
+/*
+ * ssd1306_emulator.c
+ *
+ *  Created on: Dec 8, 2023
+ *      Author: sgaviriav
+ */
+
+// Importando librerías necesarias
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306_emulator.h"
+
+/* Byte de control: Co (bit 7) y D/C# (bit 6) */
+#define CONTROL_CONTINUATION	0x80
+#define CONTROL_DATA			0x40
+
+/* === Headers for private functions === */
+static uint8_t emulator_command_arguments(uint8_t command);
+static void emulator_execute_command(SSD1306_Emulator_t *ptrEmulator);
+static void emulator_command_byte(SSD1306_Emulator_t *ptrEmulator, uint8_t value);
+static void emulator_data_byte(SSD1306_Emulator_t *ptrEmulator, uint8_t value);
+
+
+/*
+ * Deja la pantalla como después de encenderla (valores de reset del datasheet):
+ * GDDRAM en ceros, direccionamiento por páginas, ventanas completas y pantalla apagada
+ */
+void emulator_Reset(SSD1306_Emulator_t *ptrEmulator){
+	memset(ptrEmulator, 0, sizeof(SSD1306_Emulator_t));
+	ptrEmulator->addressingMode = 2;
+	ptrEmulator->columnEnd = SSD1306_WIDTH - 1;
+	ptrEmulator->pageEnd = SSD1306_PAGES - 1;
+	ptrEmulator->contrast = 0x7F;
+}
+
+
+/*
+ * Reinicia los contadores del bus (por ejemplo, al empezar a dibujar otra pantalla)
+ */
+void emulator_ResetStats(SSD1306_Emulator_t *ptrEmulator){
+	memset(&ptrEmulator->stats, 0, sizeof(SSD1306_Stats_t));
+}
+
+
+/*
+ * Procesa una transacción I2C completa: dirección (ya aceptada), byte de control y payload.
+ * Con Co = 0 todo el payload es del mismo tipo (comandos o datos); con Co = 1 cada byte
+ * viene seguido de un nuevo byte de control.
+ */
+void emulator_Transaction(SSD1306_Emulator_t *ptrEmulator, uint8_t controlByte, const uint8_t *payload, uint16_t length){
+
+	ptrEmulator->stats.transactions++;
+	ptrEmulator->stats.busBytes += 2 + length;		// Dirección + byte de control + payload
+
+	uint16_t i = 0;
+	while(i < length){
+
+		uint8_t flagData = (controlByte & CONTROL_DATA) ? 1 : 0;
+
+		if(flagData){
+			emulator_data_byte(ptrEmulator, payload[i]);
+		}
+		else{
+			emulator_command_byte(ptrEmulator, payload[i]);
+		}
+		i++;
+
+		/* Con Co = 1 el siguiente byte es otro byte de control */
+		if((controlByte & CONTROL_CONTINUATION) && (i < length)){
+			controlByte = payload[i];
+			i++;
+		}
+	}
+}
+
+
+/*
+ * Devuelve el píxel (x, y) tal como se ve en la pantalla (fila 0 arriba)
+ */
+uint8_t emulator_GetPixel(SSD1306_Emulator_t *ptrEmulator, uint8_t x, uint8_t y){
+
+	if(!ptrEmulator->displayOn || (x >= SSD1306_WIDTH) || (y >= SSD1306_HEIGHT)){
+		return 0;
+	}
+	uint8_t pixel = (ptrEmulator->gddram[y / 8][x] >> (y % 8)) & 1;
+	return pixel ^ ptrEmulator->inverse;
+}
+
+
+/*
+ * Guarda la pantalla en un archivo PBM binario (P4), ampliada 'scale' veces.
+ * Los píxeles encendidos quedan blancos sobre fondo negro, como en la OLED.
+ * Devuelve 0 si el archivo se escribió.
+ */
+int emulator_DumpPBM(SSD1306_Emulator_t *ptrEmulator, const char *fileName, uint8_t scale){
+
+	if(scale == 0){
+		scale = 1;
+	}
+
+	FILE *ptrFile = fopen(fileName, "wb");
+	if(ptrFile == NULL){
+		return -1;
+	}
+
+	uint16_t width = SSD1306_WIDTH * scale;
+	uint16_t height = SSD1306_HEIGHT * scale;
+	fprintf(ptrFile, "P4\n%u %u\n", width, height);
+
+	/* En PBM un 1 es negro: escribimos el complemento del píxel */
+	for(uint16_t row = 0; row < height; row++){
+		uint8_t byte = 0;
+		uint8_t bits = 0;
+		for(uint16_t col = 0; col < width; col++){
+			uint8_t black = !emulator_GetPixel(ptrEmulator, col / scale, row / scale);
+			byte = (byte << 1) | black;
+			bits++;
+			if(bits == 8){
+				fputc(byte, ptrFile);
+				byte = 0;
+				bits = 0;
+			}
+		}
+		if(bits){
+			fputc(byte << (8 - bits), ptrFile);
+		}
+	}
+
+	fclose(ptrFile);
+	return 0;
+}
+
+
+/*
+ * Imprime los contadores del bus de una pantalla
+ */
+void emulator_PrintStats(SSD1306_Emulator_t *ptrEmulator, const char *name){
+	printf("%-28s transacciones: %5u  comandos: %5u B  datos: %5u B  bus: %5u B\n",
+		   name, ptrEmulator->stats.transactions, ptrEmulator->stats.commandBytes,
+		   ptrEmulator->stats.dataBytes, ptrEmulator->stats.busBytes);
+	if(ptrEmulator->stats.unknownCommands){
+		printf("%-28s comandos desconocidos: %u\n", "", ptrEmulator->stats.unknownCommands);
+	}
+}
+
+
+/*
+ * Huella de la imagen (FNV-1a de 32 bits sobre la GDDRAM y el modo invertido), para
+ * comparar una pantalla con la esperada sin guardar la imagen completa
+ */
+uint32_t emulator_Hash(SSD1306_Emulator_t *ptrEmulator){
+
+	uint32_t hash = 2166136261UL;
+
+	for(uint8_t page = 0; page < SSD1306_PAGES; page++){
+		for(uint8_t column = 0; column < SSD1306_WIDTH; column++){
+			hash = (hash ^ ptrEmulator->gddram[page][column]) * 16777619UL;
+		}
+	}
+	hash = (hash ^ ptrEmulator->inverse) * 16777619UL;
+
+	return hash;
+}
+
+
+/*
+ * Número de bytes de argumentos que siguen a cada comando
+ */
+static uint8_t emulator_command_arguments(uint8_t command){
+	switch(command){
+	case 0x20:	// Modo de direccionamiento
+	case 0x81:	// Contraste
+	case 0x8D:	// Charge pump
+	case 0xA8:	// Multiplex ratio
+	case 0xD3:	// Offset
+	case 0xD5:	// Reloj
+	case 0xD9:	// Pre-carga
+	case 0xDA:	// Pines COM
+	case 0xDB:	// VCOMH
+		return 1;
+	case 0x21:	// Ventana de columnas
+	case 0x22:	// Ventana de páginas
+	case 0xA3:	// Área de scroll vertical
+		return 2;
+	case 0x29:	// Scroll vertical + horizontal
+	case 0x2A:
+		return 5;
+	case 0x26:	// Scroll horizontal
+	case 0x27:
+		return 6;
+	default:
+		return 0;
+	}
+}
+
+
+/*
+ * Recibe un byte de comando; cuando el comando tiene todos sus argumentos lo ejecuta
+ */
+static void emulator_command_byte(SSD1306_Emulator_t *ptrEmulator, uint8_t value){
+
+	ptrEmulator->stats.commandBytes++;
+
+	if(ptrEmulator->commandLength == 0){
+		ptrEmulator->commandExpected = 1 + emulator_command_arguments(value);
+	}
+	ptrEmulator->command[ptrEmulator->commandLength++] = value;
+
+	if(ptrEmulator->commandLength >= ptrEmulator->commandExpected){
+		emulator_execute_command(ptrEmulator);
+		ptrEmulator->commandLength = 0;
+	}
+}
+
+
+/*
+ * Ejecuta el comando guardado en ptrEmulator->command
+ */
+static void emulator_execute_command(SSD1306_Emulator_t *ptrEmulator){
+
+	uint8_t *cmd = ptrEmulator->command;
+
+	/* Comandos de un byte con el valor en los bits bajos */
+	if(cmd[0] <= 0x0F){
+		/* Nibble bajo de la columna (direccionamiento por páginas) */
+		ptrEmulator->column = (ptrEmulator->column & 0xF0) | (cmd[0] & 0x0F);
+		return;
+	}
+	if(cmd[0] <= 0x1F){
+		/* Nibble alto de la columna (direccionamiento por páginas) */
+		ptrEmulator->column = (ptrEmulator->column & 0x0F) | ((cmd[0] & 0x07) << 4);
+		return;
+	}
+	if((cmd[0] >= 0x40) && (cmd[0] <= 0x7F)){
+		/* Línea de inicio: no cambia la GDDRAM */
+		return;
+	}
+	if((cmd[0] >= 0xB0) && (cmd[0] <= 0xB7)){
+		/* Página (direccionamiento por páginas) */
+		ptrEmulator->page = cmd[0] & 0x07;
+		return;
+	}
+
+	switch(cmd[0]){
+	case 0x20:
+		if((cmd[1] & 0x03) != 0x03){
+			ptrEmulator->addressingMode = cmd[1] & 0x03;
+		}
+		break;
+	case 0x21:
+		ptrEmulator->columnStart = cmd[1] & 0x7F;
+		ptrEmulator->columnEnd = cmd[2] & 0x7F;
+		ptrEmulator->column = ptrEmulator->columnStart;
+		break;
+	case 0x22:
+		ptrEmulator->pageStart = cmd[1] & 0x07;
+		ptrEmulator->pageEnd = cmd[2] & 0x07;
+		ptrEmulator->page = ptrEmulator->pageStart;
+		break;
+	case 0x81:
+		ptrEmulator->contrast = cmd[1];
+		break;
+	case 0xA6:
+	case 0xA7:
+		ptrEmulator->inverse = cmd[0] & 0x01;
+		break;
+	case 0xAE:
+	case 0xAF:
+		ptrEmulator->displayOn = cmd[0] & 0x01;
+		break;
+
+	/* Comandos de hardware que no afectan la imagen de la GDDRAM
+	 * (remapeo de segmentos/COM, multiplex, reloj, charge pump, scroll...)
+	 */
+	case 0x8D: case 0xA0: case 0xA1: case 0xA3: case 0xA4: case 0xA5:
+	case 0xA8: case 0xC0: case 0xC8: case 0xD3: case 0xD5: case 0xD9:
+	case 0xDA: case 0xDB: case 0xE3: case 0x26: case 0x27: case 0x29:
+	case 0x2A: case 0x2E: case 0x2F:
+		break;
+
+	default:
+		ptrEmulator->stats.unknownCommands++;
+		break;
+	}
+}
+
+
+/*
+ * Escribe un byte en la GDDRAM y avanza los punteros según el modo de direccionamiento
+ */
+static void emulator_data_byte(SSD1306_Emulator_t *ptrEmulator, uint8_t value){
+
+	ptrEmulator->stats.dataBytes++;
+	ptrEmulator->gddram[ptrEmulator->page][ptrEmulator->column] = value;
+
+	switch(ptrEmulator->addressingMode){
+	case 0:
+		/* Horizontal: columna por columna, y al final de la ventana pasa a la siguiente página */
+		if(ptrEmulator->column >= ptrEmulator->columnEnd){
+			ptrEmulator->column = ptrEmulator->columnStart;
+			ptrEmulator->page = (ptrEmulator->page >= ptrEmulator->pageEnd) ? ptrEmulator->pageStart : (ptrEmulator->page + 1);
+		}
+		else{
+			ptrEmulator->column++;
+		}
+		break;
+	case 1:
+		/* Vertical: página por página, y al final de la ventana pasa a la siguiente columna */
+		if(ptrEmulator->page >= ptrEmulator->pageEnd){
+			ptrEmulator->page = ptrEmulator->pageStart;
+			ptrEmulator->column = (ptrEmulator->column >= ptrEmulator->columnEnd) ? ptrEmulator->columnStart : (ptrEmulator->column + 1);
+		}
+		else{
+			ptrEmulator->page++;
+		}
+		break;
+	default:
+		/* Por páginas: sólo avanza la columna, y vuelve a 0 al final de la página */
+		ptrEmulator->column = (ptrEmulator->column + 1) & 0x7F;
+		break;
+	}
+}
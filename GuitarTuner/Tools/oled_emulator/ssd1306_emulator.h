@@ -0,0 +1,72 @@
+/*
+ * ssd1306_emulator.h
+ *
+ *  Created on: Dec 8, 2023
+ *      Author: sgaviriav
+ *
+ * Emulador (en el PC) de la SSD1306 de 128x64 conectada por I2C.
+ * Interpreta el mismo flujo de bytes que generan oled_sendCommand y oled_sendData:
+ * - GDDRAM de 8 páginas x 128 columnas
+ * - Modos de direccionamiento horizontal, vertical y por páginas
+ * - Ventanas de columnas (0x21) y páginas (0x22)
+ * - Contadores de transacciones y bytes en el bus
+ * - Huella de la GDDRAM (emulator_Hash) para comparar cada pantalla con la esperada
+ */
+
+#ifndef SSD1306_EMULATOR_H_
+#define SSD1306_EMULATOR_H_
+
+#include <stdint.h>
+
+#define SSD1306_WIDTH				128
+#define SSD1306_PAGES				8
+#define SSD1306_HEIGHT				(8 * SSD1306_PAGES)
+#define SSD1306_I2C_ADDRESS			0b0111100
+#define SSD1306_MAX_COMMAND_LENGTH	7		// Comando más largo (scroll) con sus argumentos
+
+
+/* Contadores del bus (todo lo que vería un analizador lógico) */
+typedef struct
+{
+	uint32_t	transactions;		// START ... STOP
+	uint32_t	commandBytes;		// Bytes de comandos (sin el byte de control)
+	uint32_t	dataBytes;			// Bytes escritos en la GDDRAM
+	uint32_t	busBytes;			// Total en el bus: dirección + byte de control + payload
+	uint32_t	unknownCommands;	// Comandos que el emulador no reconoce
+} SSD1306_Stats_t;
+
+
+/* Estado de la pantalla */
+typedef struct SSD1306_Emulator
+{
+	uint8_t			gddram[SSD1306_PAGES][SSD1306_WIDTH];
+	uint8_t			addressingMode;		// 0 horizontal, 1 vertical, 2 páginas
+	uint8_t			columnStart;		// Ventana de columnas (0x21)
+	uint8_t			columnEnd;
+	uint8_t			pageStart;			// Ventana de páginas (0x22)
+	uint8_t			pageEnd;
+	uint8_t			column;				// Puntero de columna
+	uint8_t			page;				// Puntero de página
+	uint8_t			displayOn;
+	uint8_t			inverse;			// 0xA7 -> los píxeles se muestran invertidos
+	uint8_t			contrast;
+	uint8_t			command[SSD1306_MAX_COMMAND_LENGTH];	// Comando en curso (puede quedar partido entre transacciones)
+	uint8_t			commandLength;
+	uint8_t			commandExpected;
+	SSD1306_Stats_t	stats;
+} SSD1306_Emulator_t;
+
+
+void emulator_Reset(SSD1306_Emulator_t *ptrEmulator);
+void emulator_ResetStats(SSD1306_Emulator_t *ptrEmulator);
+void emulator_Transaction(SSD1306_Emulator_t *ptrEmulator, uint8_t controlByte, const uint8_t *payload, uint16_t length);
+uint8_t emulator_GetPixel(SSD1306_Emulator_t *ptrEmulator, uint8_t x, uint8_t y);
+int emulator_DumpPBM(SSD1306_Emulator_t *ptrEmulator, const char *fileName, uint8_t scale);
+void emulator_PrintStats(SSD1306_Emulator_t *ptrEmulator, const char *name);
+uint32_t emulator_Hash(SSD1306_Emulator_t *ptrEmulator);
+
+/* Reloj simulado que usa el mock del SysTick */
+void emulator_AdvanceTime_ms(uint32_t time_ms);
+
+
+#endif /* SSD1306_EMULATOR_H_ */
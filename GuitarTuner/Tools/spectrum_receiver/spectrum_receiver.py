@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+#
+# spectrum_receiver.py
+#
+#  Created on: Dec 10, 2023
+#      Author: sgaviriav
+#
+# Receptor (en el PC) de las tramas binarias de stream_driver: separa las tramas
+# por el delimitador 0x00, las decodifica con COBS, verifica el CRC-16/CCITT-FALSE
+# y muestra el ADC, el espectro y el pitch (los registros del log se muestran en crudo;
+# Tools/log_decoder los convierte en texto). Las líneas de texto que el GuitarTuner
+# envía por el mismo puerto no pasan el CRC y se cuentan como descartadas.
+#
+# Requiere pyserial para leer el puerto, y matplotlib para graficar:
+#   pip install pyserial matplotlib
+#
+# Uso:
+#   python3 spectrum_receiver.py /dev/ttyACM0             # grafica en vivo (115200 baudios)
+#   python3 spectrum_receiver.py /dev/ttyACM0 --text      # sólo imprime las tramas
+#   python3 spectrum_receiver.py --file captura.bin       # lee una captura guardada
+#   python3 spectrum_receiver.py /dev/ttyACM0 --save captura.bin
+#
+# En el GuitarTuner el stream se activa y desactiva enviando 'b' por la terminal.
+
+import argparse
+import struct
+import sys
+
+FRAME_ADC = 0x01
+FRAME_SPECTRUM = 0x02
+FRAME_PITCH = 0x03
+FRAME_LOG = 0x04
+
+FORMAT_Q15 = 0
+FORMAT_F16 = 1
+
+NOTES = {0: "-", 1: "E4", 2: "B3", 3: "G3", 4: "D3", 5: "A2", 6: "E2"}
+
+
+def crc16_ccitt(data):
+    """CRC-16/CCITT-FALSE: polinomio 0x1021, inicio 0xFFFF, sin reflejar"""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """Decodifica un bloque COBS (sin el delimitador). Retorna None si está corrupto"""
+    output = bytearray()
+    position = 0
+    while position < len(data):
+        code = data[position]
+        if code == 0 or position + code > len(data) + 1:
+            return None
+        output += data[position + 1:position + code]
+        position += code
+        if code < 0xFF and position < len(data):
+            output.append(0)
+    return bytes(output)
+
+
+def parse_frame(frame):
+    """Convierte una trama verificada en un diccionario con sus datos"""
+    frame_type, sequence = frame[0], frame[1]
+    payload = frame[2:]
+
+    if frame_type == FRAME_ADC:
+        sample_rate, count = struct.unpack_from("<fH", payload, 0)
+        samples = struct.unpack_from("<%dH" % count, payload, 6)
+        return {"type": "adc", "seq": sequence, "fs": sample_rate, "samples": samples}
+
+    if frame_type == FRAME_SPECTRUM:
+        resolution, first_bin, count, data_format, scale = struct.unpack_from("<fHHBf", payload, 0)
+        if data_format == FORMAT_Q15:
+            raw = struct.unpack_from("<%dH" % count, payload, 13)
+            bins = [value * scale / 32767.0 for value in raw]
+        else:
+            bins = list(struct.unpack_from("<%de" % count, payload, 13))
+        return {"type": "spectrum", "seq": sequence, "resolution": resolution,
+                "first": first_bin, "bins": bins}
+
+    if frame_type == FRAME_PITCH:
+        frequency, cents, note, tuned = struct.unpack_from("<ffBB", payload, 0)
+        return {"type": "pitch", "seq": sequence, "frequency": frequency,
+                "cents": cents, "note": note, "tuned": tuned}
+
+    if frame_type == FRAME_LOG:
+        message_id, argc, time_ms = struct.unpack_from("<HHI", payload, 0)
+        args = struct.unpack_from("<%dI" % argc, payload, 8)
+        return {"type": "log", "seq": sequence, "id": message_id, "time": time_ms, "args": args}
+
+    return None
+
+
+class StreamReceiver:
+    """Reensambla las tramas a partir de bloques de bytes de cualquier tamaño"""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.last_sequence = {}
+        self.frames = 0
+        self.discarded = 0
+        self.lost = 0
+
+    def feed(self, data):
+        frames = []
+        self.pending += data
+        while True:
+            end = self.pending.find(b"\x00")
+            if end < 0:
+                break
+            block = bytes(self.pending[:end])
+            del self.pending[:end + 1]
+            if not block:
+                continue
+
+            frame = cobs_decode(block)
+            if frame is None or len(frame) < 4 or crc16_ccitt(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]:
+                self.discarded += 1
+                continue
+
+            parsed = None
+            try:
+                parsed = parse_frame(frame[:-2])
+            except struct.error:
+                pass
+            if parsed is None:
+                self.discarded += 1
+                continue
+
+            # Tramas perdidas según la secuencia de cada tipo
+            previous = self.last_sequence.get(parsed["type"])
+            if previous is not None:
+                self.lost += (parsed["seq"] - previous - 1) & 0xFF
+            self.last_sequence[parsed["type"]] = parsed["seq"]
+
+            self.frames += 1
+            frames.append(parsed)
+        return frames
+
+
+def describe(frame):
+    if frame["type"] == "adc":
+        samples = frame["samples"]
+        return "ADC      #%3d  fs=%.1f Hz  n=%d  min=%d  max=%d" % (
+            frame["seq"], frame["fs"], len(samples), min(samples), max(samples))
+    if frame["type"] == "spectrum":
+        bins = frame["bins"]
+        peak = max(range(len(bins)), key=bins.__getitem__)
+        return "ESPECTRO #%3d  n=%d  pico=%.2f Hz (bin %d)" % (
+            frame["seq"], len(bins), (frame["first"] + peak) * frame["resolution"], frame["first"] + peak)
+    if frame["type"] == "log":
+        return "LOG      #%3d  t=%d ms  id=%d  args=%s" % (
+            frame["seq"], frame["time"], frame["id"], " ".join("0x%08X" % arg for arg in frame["args"]))
+    return "PITCH    #%3d  f=%.2f Hz  cents=%+.1f  nota=%s%s" % (
+        frame["seq"], frame["frequency"], frame["cents"], NOTES.get(frame["note"], "?"),
+        "  AFINADA" if frame["tuned"] else "")
+
+
+def open_source(arguments):
+    if arguments.file:
+        return open(arguments.file, "rb"), (lambda source: source.read(4096))
+    try:
+        import serial
+    except ImportError:
+        sys.exit("Se necesita pyserial para leer el puerto: pip install pyserial")
+    port = serial.Serial(arguments.port, arguments.baudrate, timeout=0.05)
+    return port, (lambda source: source.read(source.in_waiting or 1))
+
+
+def run_text(receiver, source, read, capture, from_file):
+    while True:
+        data = read(source)
+        if capture:
+            capture.write(data)
+        if not data and from_file:
+            break
+        for frame in receiver.feed(data):
+            print(describe(frame))
+    print("tramas: %d  descartadas: %d  perdidas: %d" % (receiver.frames, receiver.discarded, receiver.lost))
+
+
+def run_plot(receiver, source, read, capture):
+    try:
+        import matplotlib.pyplot as plt
+        from matplotlib.animation import FuncAnimation
+    except ImportError:
+        sys.exit("Se necesita matplotlib para graficar (o use --text): pip install matplotlib")
+
+    figure, (axis_adc, axis_fft) = plt.subplots(2, 1, figsize=(10, 7))
+    line_adc, = axis_adc.plot([], [], lw=0.8)
+    line_fft, = axis_fft.plot([], [], lw=0.8)
+    marker = axis_fft.axvline(0, color="r", lw=0.8, ls="--")
+    axis_adc.set_xlabel("Tiempo [ms]")
+    axis_adc.set_ylabel("ADC")
+    axis_adc.set_ylim(0, 4096)
+    axis_fft.set_xlabel("Frecuencia [Hz]")
+    axis_fft.set_ylabel("Magnitud")
+    title = figure.suptitle("Esperando tramas...")
+
+    def update(_):
+        data = read(source)
+        if capture:
+            capture.write(data)
+        for frame in receiver.feed(data):
+            if frame["type"] == "adc":
+                samples = frame["samples"]
+                period_ms = 1000.0 / frame["fs"] if frame["fs"] else 1.0
+                line_adc.set_data([i * period_ms for i in range(len(samples))], samples)
+                axis_adc.set_xlim(0, len(samples) * period_ms)
+            elif frame["type"] == "spectrum":
+                bins = frame["bins"]
+                line_fft.set_data([(frame["first"] + i) * frame["resolution"] for i in range(len(bins))], bins)
+                axis_fft.set_xlim(frame["first"] * frame["resolution"], (frame["first"] + len(bins)) * frame["resolution"])
+                axis_fft.set_ylim(0, max(bins) * 1.1 if max(bins) > 0 else 1)
+            elif frame["type"] == "pitch":
+                marker.set_xdata([frame["frequency"], frame["frequency"]])
+                title.set_text("%.2f Hz  %+.1f cents  %s" % (frame["frequency"], frame["cents"], NOTES.get(frame["note"], "?")))
+        return line_adc, line_fft, marker, title
+
+    animation = FuncAnimation(figure, update, interval=50, cache_frame_data=False)
+    plt.show()
+    return animation
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Receptor de las tramas binarias del GuitarTuner")
+    parser.add_argument("port", nargs="?", help="Puerto serial (por ejemplo /dev/ttyACM0 o COM3)")
+    parser.add_argument("-b", "--baudrate", type=int, default=115200)
+    parser.add_argument("--file", help="Lee una captura guardada en lugar del puerto")
+    parser.add_argument("--save", help="Guarda los bytes recibidos en un archivo")
+    parser.add_argument("--text", action="store_true", help="Imprime las tramas en lugar de graficar")
+    arguments = parser.parse_args()
+
+    if not arguments.port and not arguments.file:
+        parser.error("indique un puerto o --file")
+
+    source, read = open_source(arguments)
+    capture = open(arguments.save, "wb") if arguments.save else None
+    receiver = StreamReceiver()
+
+    try:
+        if arguments.text:
+            run_text(receiver, source, read, capture, arguments.file is not None)
+        else:
+            run_plot(receiver, source, read, capture)
+    except KeyboardInterrupt:
+        print("\ntramas: %d  descartadas: %d  perdidas: %d" % (receiver.frames, receiver.discarded, receiver.lost))
+    finally:
+        if capture:
+            capture.close()
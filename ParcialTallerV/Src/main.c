@@ -19,6 +19,8 @@
 #include "adc_driver_hal.h"
 #include "systick_driver_hal.h"
 #include "pwm_driver_hal.h"
+#include "format_driver_hal.h"
+#include "sevenseg_driver_hal.h"
 
 /* ===== Definición de variables ===== */
 /* Definición de variables contadoras para cada modo
@@ -48,7 +50,6 @@ uint8_t readData = 0;
 uint8_t flagMode = 0;		// Bandera del EXTI del Switch. Se asigna 0 para indicar que se inicializa en Modo Resolución
 uint8_t flagData = 0;		// Bandera del EXTI del Encoder.
 uint8_t flagConv = 0;		// Bandera para atender interrupciones por conversión
-uint8_t flagDisplay = 0;
 uint8_t sendMsg = 0;		// Bandera para mostrar la lectura del ADC cada 2 segundos
 
 // Constantes para identificar los 3 sensores
@@ -115,12 +116,14 @@ GPIO_Handler_t segmentoPunto = {0}; // Pin
 // entre los cristales del 7-segmentos
 GPIO_Handler_t display2 = {0}; // Pin PA10
 
+// Refresco del cristal por DMA (TIM1 + DMA2), sin interrupciones
+SevenSeg_Handler_t display = {0};
+
 
 /* Definición de los Timers a utilizar para generar las interrupciones
- * del blinky y del 7 segmentos */
+ * del blinky y de los mensajes */
 Timer_Handler_t blinkTimer3 = {0};		// Timer 3 para el stateLed
 Timer_Handler_t messageTimer4 = {0};	// Timer 4 para enviar mensajes seriales cada 2 segundos
-Timer_Handler_t displayTimer5 = {0};	// Timer 5 para prender y apagar el display
 
 
 /* Definición de los EXTI para las interrupciones externas del encoder */
@@ -136,6 +139,7 @@ GPIO_Handler_t pinTx = {0};	// P -> Pin para la transmisión serial
 GPIO_Handler_t pinRx = {0};	// P -> Pin para la recepción serial
 rxDataUsart received_USARTx = {0};	// Estructura para guardar los datos según el USART utilizado
 char bufferData[64] = {0};
+Format_Writer_t msgWriter = {0};	// Mensajes con números hacia el USART2
 
 /* Configuramos el Handler del PWM */
 PWM_Handler_t pwmHandler = {0};
@@ -154,9 +158,6 @@ Systick_Handler_t systickHandler = {0};
 // Función para cargar las configuraciones de los periféricos a utilizar
 void systemConfig(void);
 
-// Función para representar un numero_x en el 7-segmentos
-void displayNumeros(uint8_t numero_x);
-
 // Función para controlar los segmentos en el modo Sensores
 void modeSensor(void);
 
@@ -187,16 +188,12 @@ int main(void)
 	// Iniciamos con todas las banderas abajo
 	flagData = 0;
 	flagConv = 0;
-	flagDisplay = 0;
 	sendMsg = 0;
 
 
 	// Cargamos la configuración de los periféricos
 	systemConfig();
 
-	// Dejamos el punto encendido
-	gpio_WritePin(&segmentoPunto, RESET);
-
 	// Empezamos a hacer conversiones
 	adc_StartContinuousConv();
 
@@ -257,12 +254,9 @@ int main(void)
 		}
 		}
 
-		// Función para mostrar en el display
-		if(flagDisplay){
-			displayNumeros(contadorModo);
-			flagDisplay = 0;
-			gpio_TooglePin(&display2);
-		}
+		// Función para mostrar en el display (con el punto encendido). Sólo cambia el buffer
+		// del DMA si cambió el modo
+		sevenseg_SetDigit(&display, 0, contadorModo, ON);
 
 		// Función para atender la conversión
 		if(flagConv){
@@ -303,14 +297,17 @@ int main(void)
 		if(sendMsg){
 			sendMsg = 0; // Bajamos la bandera de envío del mensaje serial periódico
 			if(sensor.adcData){
-				sprintf(bufferData, "Sensor1, Conversion: %u\n\r", valorADC_Sensor1);
-				usart_WriteMsg(&usart2, bufferData);
-				sprintf(bufferData, "Sensor2, Conversion: %u\n\r", valorADC_Sensor2);
-				usart_WriteMsg(&usart2, bufferData);
-				sprintf(bufferData, "Sensor3, Conversion: %u\n\r", valorADC_Sensor3);
-				usart_WriteMsg(&usart2, bufferData);
-				sprintf(bufferData, "Valor actual del Encoder %u\n\r", contadorPWM_Encoder);
-				usart_WriteMsg(&usart2, bufferData);
+				/* Escribimos los valores directamente en el USART (sin sprintf) */
+				format_InitUsart(&msgWriter, &usart2);
+				format_String(&msgWriter, "Sensor1, Conversion: ");
+				format_Uint(&msgWriter, valorADC_Sensor1, 0, FORMAT_PAD_SPACE);
+				format_String(&msgWriter, "\n\rSensor2, Conversion: ");
+				format_Uint(&msgWriter, valorADC_Sensor2, 0, FORMAT_PAD_SPACE);
+				format_String(&msgWriter, "\n\rSensor3, Conversion: ");
+				format_Uint(&msgWriter, valorADC_Sensor3, 0, FORMAT_PAD_SPACE);
+				format_String(&msgWriter, "\n\rValor actual del Encoder ");
+				format_Uint(&msgWriter, contadorPWM_Encoder, 0, FORMAT_PAD_SPACE);
+				format_String(&msgWriter, "\n\r");
 				sensor.adcData = 0;
 			}
 
@@ -460,6 +457,29 @@ void systemConfig(void){
 	gpio_WritePin(&display2, RESET); // Apagamos el Pin
 
 
+	/* ===== Configuramos el refresco del 7-segmentos ===== */
+
+	/* Segmentos (encienden con el pin en bajo) y cristal (enciende con el pin en alto) */
+	display.segmentPins[0]				= &segmentoA;
+	display.segmentPins[1]				= &segmentoB;
+	display.segmentPins[2]				= &segmentoC;
+	display.segmentPins[3]				= &segmentoD;
+	display.segmentPins[4]				= &segmentoE;
+	display.segmentPins[5]				= &segmentoF;
+	display.segmentPins[6]				= &segmentoG;
+	display.segmentPins[7]				= &segmentoPunto;
+	display.digitPins[0]				= &display2;
+	display.config.numDigits			= 1;
+	display.config.segmentActiveLevel	= GPIO_PIN_RESET;
+	display.config.digitActiveLevel		= GPIO_PIN_SET;
+	display.config.phaseFrequency		= 1000;
+
+	/* Cargamos la configuración y lo encendemos */
+	sevenseg_Config(&display);
+	sevenseg_SetDigit(&display, 0, contadorModo, ON);
+	sevenseg_Start(&display);
+
+
 	/* ===== Configuramos los pines RX y TX para la transmisión serial ===== */
 
 	/* Configurando los pines para el puerto serial mediante USART2
@@ -521,14 +541,6 @@ void systemConfig(void){
 	messageTimer4.TIMx_Config.TIMx_mode					= TIMER_UP_COUNTER;	// El Timer cuenta ascendente
 	messageTimer4.TIMx_Config.TIMx_InterruptEnable		= TIMER_INT_ENABLE;	// Se activa la interrupción
 
-	/* Configuración para el TIMER2 que muestra el display */
-	/* Configurando el TIMER4 para mostrar un mensaje cada 2 segundos */
-	displayTimer5.pTIMx									= TIM5;
-	displayTimer5.TIMx_Config.TIMx_Prescaler			= 16000;	// Genera incrementos de 1 ms
-	displayTimer5.TIMx_Config.TIMx_Period				= 8;		// Para un intervalo de 2s
-	displayTimer5.TIMx_Config.TIMx_mode					= TIMER_UP_COUNTER;	// El Timer cuenta ascendente
-	displayTimer5.TIMx_Config.TIMx_InterruptEnable		= TIMER_INT_ENABLE;	// Se activa la interrupción
-
 	/* Cargamos y encendemos los Timer */
 	timer_Config(&blinkTimer3);
 	timer_SetState(&blinkTimer3, TIMER_ON);
@@ -536,9 +548,6 @@ void systemConfig(void){
 	timer_Config(&messageTimer4);
 	timer_SetState(&messageTimer4, TIMER_ON);
 
-	timer_Config(&displayTimer5);
-	timer_SetState(&displayTimer5, TIMER_ON);
-
 
 	/* ===== Configurando el puerto serial USART2 ===== */
 
@@ -640,17 +649,17 @@ void modeSensor(void){
 	switch(contadorSensor){
 	case SENSOR1:{
 		// Mostramos el número 1
-		displayNumeros(SENSOR1);
+		sevenseg_SetDigit(&display, 0, SENSOR1, ON);
 		break;
 	}
 	case SENSOR2:{
 		// Mostramos el número 2
-		displayNumeros(SENSOR2);
+		sevenseg_SetDigit(&display, 0, SENSOR2, ON);
 		break;
 	}
 	case SENSOR3:{
 		// Mostramos el número 3
-		displayNumeros(SENSOR3);
+		sevenseg_SetDigit(&display, 0, SENSOR3, ON);
 		break;
 	}
 	default:{
@@ -674,131 +683,6 @@ void configSensor(ADC_Config_t sensorHandler, uint8_t canal){
 } // Fin función configSensor()
 
 
-// Función para encender los leds del 7-segmentos, para representar el numero_x
-void displayNumeros(uint8_t numero_x){
-
-	// Hacemos un switch para cada numero del 0-9
-	switch(numero_x){
-	case 0:{
-		// El led se enciende cuando el voltaje dado por el pin sea bajo
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, SET);
-		break;
-	}
-
-	case 1:{
-		gpio_WritePin(&segmentoA, SET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, SET);
-		break;
-	}
-
-	case 2:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, SET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 3:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 4:{
-		gpio_WritePin(&segmentoA, SET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 5:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, SET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 6:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, SET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 7:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, SET);
-		break;
-	}
-
-	case 8:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 9:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	default:{
-		__NOP();
-		break;
-	}
-	}
-
-}
-
-
 // Función para evaluar si se aumenta o disminuye el contador del Duty Cycle del PWM, para el caso del Encoder
 void evaluateEncoder(void){
 	if(readData == 1){
@@ -869,10 +753,6 @@ void Timer4_Callback(void){
 	sendMsg = 1;
 }
 
-void Timer5_Callback(void){
-	flagDisplay = 1;
-}
-
 
 /* Función que atiende la interrupción debibo a la finalización de una
  * conversión ADC
@@ -0,0 +1,116 @@
+/*
+ * capture_driver_hal.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef CAPTURE_DRIVER_HAL_H_
+#define CAPTURE_DRIVER_HAL_H_
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "dma_driver_hal.h"
+
+/*
+ * Medición de frecuencia por captura de entrada: un canal del TIM2 o TIM5 (contadores
+ * de 32 bits, sin desbordes que manejar) guarda el valor del contador en cada flanco
+ * de la señal, y el DMA copia esos tiempos a un buffer circular sin interrupciones.
+ * La señal debe llegar ya cuadrada (comparador o Schmitt trigger a la salida del micrófono).
+ *
+ * capture_Process se llama desde el main: toma los tiempos nuevos (la posición del DMA
+ * sale de NDTR), calcula los periodos, descarta los que están fuera del rango de
+ * frecuencias, y suaviza con una mediana de CAPTURE_MEDIAN_SIZE periodos seguida de
+ * un IIR. La confianza (0 - 100) sale de la dispersión de la ventana de la mediana, y
+ * es 0 si la ventana no está llena o si la señal dejó de llegar.
+ *
+ * Streams de DMA1 de cada canal (RM0383, Tabla 27):
+ * - TIM5: CH1 Stream2, CH2 Stream4, CH3 Stream0, CH4 Stream1 (canal 6)
+ * - TIM2: CH1 Stream5, CH2 Stream6, CH3 Stream1, CH4 Stream7 (canal 3)
+ * TIM2_CH1 y TIM2_CH2 comparten stream con el DMA del USART2, así que no se pueden usar juntos.
+ */
+
+#define CAPTURE_BUFFER_SIZE		64		// Tiempos en el buffer circular del DMA
+#define CAPTURE_MEDIAN_SIZE		5		// Periodos en la ventana de la mediana (impar)
+#define CAPTURE_TIMEOUT_PERIODS	4		// Sin flancos durante estos periodos máximos -> sin señal
+
+enum
+{
+	CAPTURE_CHANNEL_1 = 0,
+	CAPTURE_CHANNEL_2,
+	CAPTURE_CHANNEL_3,
+	CAPTURE_CHANNEL_4
+};
+
+/* Flanco que se captura */
+enum
+{
+	CAPTURE_EDGE_RISING = 0,
+	CAPTURE_EDGE_FALLING
+};
+
+/* Captura cada 1, 2, 4 u 8 flancos (ICxPSC), para señales rápidas */
+enum
+{
+	CAPTURE_DIV_1 = 0,
+	CAPTURE_DIV_2,
+	CAPTURE_DIV_4,
+	CAPTURE_DIV_8
+};
+
+/* Configuración de la captura */
+typedef struct
+{
+	uint8_t		channel;		// CAPTURE_CHANNEL_x
+	uint8_t		edge;			// CAPTURE_EDGE_xx
+	uint8_t		edgeDivider;	// CAPTURE_DIV_x
+	uint8_t		filter;			// Filtro digital de la entrada (ICxF, 0 - 15)
+	uint16_t	prescaler;		// División del reloj del timer (1 -> máxima resolución)
+	float		minFrequency;	// Rango válido (Hz): los periodos por fuera se descartan
+	float		maxFrequency;
+	float		alpha;			// Peso de cada mediana en el IIR (0 - 1, 1 -> sin suavizado)
+	float		maxSpread;		// Dispersión de la ventana ((max - min) / mediana) con confianza 0
+} Capture_Config_t;
+
+/* Contadores de la captura */
+typedef struct
+{
+	uint32_t	periods;		// Periodos aceptados
+	uint32_t	rejected;		// Periodos fuera del rango
+	uint32_t	overruns;		// Veces que el DMA pudo dar la vuelta al buffer sin que se leyera
+} Capture_Stats_t;
+
+/* Handler de la captura */
+typedef struct
+{
+	TIM_TypeDef			*ptrTIMx;			// TIM2 o TIM5
+	Capture_Config_t	config;
+	Capture_Stats_t		stats;
+	DMA_Handler_t		dma;				// Stream del canal (lo llena capture_Config)
+	uint32_t			timestamps[CAPTURE_BUFFER_SIZE];
+	uint16_t			readPosition;		// Siguiente tiempo por leer
+	uint32_t			lastTimestamp;
+	uint8_t				flagLast;			// 1 -> lastTimestamp es válido
+	uint32_t			lastProcess;		// Contador en el último capture_Process
+	uint32_t			window[CAPTURE_MEDIAN_SIZE];
+	uint8_t				windowCount;
+	uint8_t				windowIndex;
+	float				filteredPeriod;		// Salida del IIR (cuentas del timer)
+	uint32_t			timerFrequency;		// Cuentas por segundo del contador
+	uint32_t			minPeriod;			// Rango válido en cuentas (lo calcula capture_Config)
+	uint32_t			maxPeriod;
+	uint8_t				confidence;			// 0 - 100, de la última ventana
+} Capture_Handler_t;
+
+
+/* Funciones públicas de la captura */
+void capture_Config(Capture_Handler_t *ptrCapture);
+void capture_Start(Capture_Handler_t *ptrCapture);
+void capture_Stop(Capture_Handler_t *ptrCapture);
+void capture_Restart(Capture_Handler_t *ptrCapture);
+void capture_Process(Capture_Handler_t *ptrCapture);
+uint8_t capture_GetConfidence(Capture_Handler_t *ptrCapture);
+float capture_GetFrequency(Capture_Handler_t *ptrCapture);
+
+
+#endif /* CAPTURE_DRIVER_HAL_H_ */
@@ -0,0 +1,104 @@
+/*
+ * dma_driver_hal.h
+ *
+ *  Created on: Dec 9, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef DMA_DRIVER_HAL_H_
+#define DMA_DRIVER_HAL_H_
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/*
+ * Driver básico para los streams de DMA1 y DMA2.
+ * El driver sólo configura y controla los streams; el IRQHandler de cada stream
+ * lo define el driver que lo usa (por ejemplo, el USART para sus streams de TX y RX),
+ * porque cada periférico tiene un stream y canal fijos según la tabla de mapeo
+ * del reference manual (Tablas 27 y 28).
+ */
+
+/* Dirección de la transferencia */
+enum
+{
+	DMA_DIR_PERIPH_TO_MEM = 0,
+	DMA_DIR_MEM_TO_PERIPH,
+	DMA_DIR_MEM_TO_MEM
+};
+
+/* Modo de la transferencia */
+enum
+{
+	DMA_MODE_NORMAL = 0,
+	DMA_MODE_CIRCULAR
+};
+
+/* Tamaño de cada dato (igual en memoria y periférico) */
+enum
+{
+	DMA_DATASIZE_8BIT = 0,
+	DMA_DATASIZE_16BIT,
+	DMA_DATASIZE_32BIT
+};
+
+/* Prioridad del stream frente a los demás del mismo DMA */
+enum
+{
+	DMA_PRIORITY_LOW = 0,
+	DMA_PRIORITY_MEDIUM,
+	DMA_PRIORITY_HIGH,
+	DMA_PRIORITY_VERY_HIGH
+};
+
+enum
+{
+	DMA_INTERRUPT_DISABLE = 0,
+	DMA_INTERRUPT_ENABLE
+};
+
+/* Banderas de cada stream (ya desplazadas a la posición 0) */
+#define DMA_FLAG_FE		0x01	// FIFO error
+#define DMA_FLAG_DME	0x04	// Direct mode error
+#define DMA_FLAG_TE		0x08	// Transfer error
+#define DMA_FLAG_HT		0x10	// Half transfer
+#define DMA_FLAG_TC		0x20	// Transfer complete
+#define DMA_FLAG_ALL	(DMA_FLAG_FE | DMA_FLAG_DME | DMA_FLAG_TE | DMA_FLAG_HT | DMA_FLAG_TC)
+
+
+/* Configuración del stream */
+typedef struct
+{
+	uint8_t		channel;		// Canal (0 - 7) que conecta el periférico con el stream
+	uint8_t		direction;		// DMA_DIR_xx
+	uint8_t		mode;			// Normal o circular
+	uint8_t		dataSize;		// Tamaño de cada dato
+	uint8_t		memIncrement;	// 1 -> la dirección de memoria avanza con cada dato
+	uint8_t		priority;		// DMA_PRIORITY_xx
+	uint8_t		enableIntTC;	// Interrupción al completar la transferencia
+	uint8_t		enableIntHT;	// Interrupción a la mitad de la transferencia
+	uint8_t		enableIntTE;	// Interrupción por error de transferencia
+} DMA_Config_t;
+
+
+/* Handler de un stream */
+typedef struct
+{
+	DMA_TypeDef			*ptrDMAx;		// DMA1 o DMA2
+	DMA_Stream_TypeDef	*ptrStream;		// DMAx_StreamY
+	uint8_t				stream;			// Número del stream (0 - 7)
+	DMA_Config_t		config;
+} DMA_Handler_t;
+
+
+/* Funciones públicas del driver */
+void dma_Config(DMA_Handler_t *ptrDmaHandler);
+void dma_Start(DMA_Handler_t *ptrDmaHandler, volatile void *peripheralAddress, void *memoryAddress, uint16_t length);
+void dma_Stop(DMA_Handler_t *ptrDmaHandler);
+uint8_t dma_IsEnabled(DMA_Handler_t *ptrDmaHandler);
+uint16_t dma_GetRemaining(DMA_Handler_t *ptrDmaHandler);
+uint8_t dma_GetFlags(DMA_Handler_t *ptrDmaHandler);
+void dma_ClearFlags(DMA_Handler_t *ptrDmaHandler, uint8_t flags);
+
+
+#endif /* DMA_DRIVER_HAL_H_ */
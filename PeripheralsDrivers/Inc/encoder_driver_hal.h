@@ -0,0 +1,68 @@
+/*
+ * encoder_driver_hal.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef ENCODER_DRIVER_HAL_H_
+#define ENCODER_DRIVER_HAL_H_
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/*
+ * Encoder rotatorio decodificado por hardware: el timer en modo encoder (SMCR SMS = 011)
+ * cuenta los flancos de los dos canales (CLK en CH1 y DT en CH2) hacia arriba o hacia
+ * abajo según el sentido de giro, sin interrupciones. encoder_GetDelta lee el contador
+ * y retorna los pasos (detents) desde el último llamado; las cuentas que no completan
+ * un paso quedan guardadas para el siguiente.
+ *
+ * Timers con modo encoder: TIM1 a TIM5. El contador se usa de 16 bits en todos, así que
+ * encoder_GetDelta se debe llamar antes de 32767 cuentas (de sobra para un encoder a mano).
+ *
+ * encoder_GetDeltaAccel multiplica los pasos cuando el giro es rápido (velocidad mayor
+ * que accelThreshold pasos/s), para recorrer listas largas. La velocidad se mide con los
+ * ms del SysTick entre llamados.
+ */
+
+#define ENCODER_VELOCITY_TIMEOUT	200		// ms sin pasos para considerar que el encoder se detuvo
+
+/* Sentido de la cuenta */
+enum
+{
+	ENCODER_DIRECTION_NORMAL = 0,
+	ENCODER_DIRECTION_INVERTED		// Invierte TI1 (CC1P): horario cuenta hacia abajo
+};
+
+/* Configuración del encoder */
+typedef struct
+{
+	uint8_t		filter;				// Filtro digital de las dos entradas (ICxF, 0 - 15)
+	uint8_t		direction;			// ENCODER_DIRECTION_xx
+	uint8_t		countsPerStep;		// Cuentas por paso (4 en la mayoría de encoders con detent)
+	uint16_t	accelThreshold;		// Pasos/s desde los que se acelera (0 -> sin aceleración)
+	uint8_t		accelMultiplier;	// Pasos que vale cada paso con el giro rápido
+} Encoder_Config_t;
+
+/* Handler del encoder */
+typedef struct
+{
+	TIM_TypeDef			*ptrTIMx;		// TIM1 - TIM5 (CH1 y CH2 en función alternativa)
+	Encoder_Config_t	config;
+	uint16_t			lastCount;		// Contador en la última lectura
+	int16_t				residual;		// Cuentas que todavía no completan un paso
+	float				velocity;		// Pasos/s (filtrada)
+	uint32_t			lastStepTick;	// ms del último paso
+} Encoder_Handler_t;
+
+
+/* Funciones públicas del encoder */
+void encoder_Config(Encoder_Handler_t *ptrEncoder);
+void encoder_Reset(Encoder_Handler_t *ptrEncoder);
+int16_t encoder_GetDelta(Encoder_Handler_t *ptrEncoder);
+int16_t encoder_GetDeltaAccel(Encoder_Handler_t *ptrEncoder);
+float encoder_GetVelocity(Encoder_Handler_t *ptrEncoder);
+
+
+#endif /* ENCODER_DRIVER_HAL_H_ */
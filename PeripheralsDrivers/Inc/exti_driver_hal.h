@@ -11,20 +11,38 @@
 #include "stm32f4xx.h"
 #include "gpio_driver_hal.h"
 
+/*
+ * Cada línea EXTI (0 - 15, una por número de pin) tiene una entrada en una tabla con su
+ * callback y un contexto. Si la línea no tiene callback registrado se llama el
+ * callback_ExtIntX de siempre (weak, sobre-escrito en el main).
+ *
+ * Los handlers de los vectores compartidos (9_5 y 15_10) atienden en una sola entrada
+ * todas las líneas pendientes, recorriendo la máscara de PR de la menor a la mayor.
+ */
+
 enum
 {
 	EXTERNAL_INTERRUPT_FALLING_EDGE	= 0,
-	EXTERNAL_INTERRUPT_RISING_EDGE
+	EXTERNAL_INTERRUPT_RISING_EDGE,
+	EXTERNAL_INTERRUPT_BOTH_EDGES
 };
 
+#define EXTI_LINES		16
+
+/* Callback de una línea: recibe el contexto con que se registró */
+typedef void (*EXTI_Callback_t)(void *context);
+
 typedef struct
 {
-	GPIO_Handler_t *pGPIOHandler;	// Handler del pin GPIO que lanzara la interrupción
+	GPIO_Handler_t	*pGPIOHandler;	// Handler del pin GPIO que lanzara la interrupción
 	uint8_t			edgeType;		// Se selecciona si se desea un tipo de flanco subiendo o bajando
+	EXTI_Callback_t	callback;		// Opcional: NULL -> callback_ExtIntX
+	void			*context;		// Lo que recibe callback
 }EXTI_Config_t;
 
 /* Se definen las funciones públicas del Driver del EXTI */
 void exti_Config(EXTI_Config_t *extiConfig);
+void exti_SetCallback(uint8_t line, EXTI_Callback_t callback, void *context);
 void callback_ExtInt0(void);
 void callback_ExtInt1(void);
 void callback_ExtInt2(void);
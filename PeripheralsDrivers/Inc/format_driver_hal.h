@@ -0,0 +1,93 @@
+/*
+ * format_driver_hal.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef FORMAT_DRIVER_HAL_H_
+#define FORMAT_DRIVER_HAL_H_
+
+#include <stdint.h>
+#include "usart_driver_hal.h"
+
+/*
+ * Formateo de texto sin sprintf: cada tipo de dato tiene su propia función, así el
+ * compilador revisa los tipos (no hay lista variable de argumentos ni cadena de formato),
+ * no se usa el heap y no se enlaza el printf de newlib con soporte de float.
+ * format_Float y format_Fixed escriben lo mismo que printf("%.*f") con el valor exacto:
+ * los empates se redondean al par y un negativo que redondea a cero conserva el signo.
+ *
+ * El texto se escribe con un Format_Writer_t, que apunta a un buffer del usuario
+ * (siempre queda terminado en '\0' y se trunca si no cabe) o directamente al USART
+ * (al buffer circular de transmisión, si está activo):
+ *
+ *   Format_Writer_t writer;
+ *   format_InitUsart(&writer, &commSerial);
+ *   format_String(&writer, "Frecuencia: ");
+ *   format_Float(&writer, frec_prom, 2);
+ *   format_String(&writer, " Hz\r\n");
+ *
+ * format_Put escoge la función según el tipo del valor (_Generic de C11); un tipo que
+ * no está en la lista es un error de compilación. Ojo: en C un literal como 'a' es int,
+ * así que para escribir un caracter se usa format_Char o format_Put(&writer, (char)'a').
+ */
+
+#define FORMAT_MAX_DECIMALS		6		// Decimales máximos de format_Float y format_Fixed
+#define FORMAT_DEFAULT_DECIMALS	2		// Decimales que usa format_Put con los float
+
+/* Relleno a la izquierda de los números */
+enum
+{
+	FORMAT_PAD_SPACE = ' ',
+	FORMAT_PAD_ZERO = '0'
+};
+
+
+/* Destino del texto */
+typedef struct
+{
+	char			*ptrBuffer;			// Buffer del usuario (NULL -> se escribe en el USART)
+	uint16_t		size;				// Tamaño del buffer, incluido el '\0'
+	uint16_t		length;				// Caracteres escritos
+	uint8_t			flagOverflow;		// 1 -> el texto no cupo en el buffer y se truncó
+	USART_Handler_t	*ptrUsartHandler;	// USART de destino cuando no hay buffer
+} Format_Writer_t;
+
+
+/* Funciones públicas del formateo */
+void format_InitBuffer(Format_Writer_t *ptrWriter, char *buffer, uint16_t size);
+void format_InitUsart(Format_Writer_t *ptrWriter, USART_Handler_t *ptrUsartHandler);
+void format_Char(Format_Writer_t *ptrWriter, char character);
+void format_String(Format_Writer_t *ptrWriter, const char *string);
+void format_Uint(Format_Writer_t *ptrWriter, uint32_t value, uint8_t width, char pad);
+void format_Int(Format_Writer_t *ptrWriter, int32_t value, uint8_t width, char pad);
+void format_Hex(Format_Writer_t *ptrWriter, uint32_t value, uint8_t digits);
+void format_Float(Format_Writer_t *ptrWriter, float value, uint8_t decimals);
+void format_Fixed(Format_Writer_t *ptrWriter, int32_t value, uint8_t fractionBits, uint8_t decimals);
+uint16_t format_Copy(char *buffer, uint16_t size, const char *string);
+
+/* Versiones de dos argumentos que usa format_Put */
+void format_PutUint(Format_Writer_t *ptrWriter, uint32_t value);
+void format_PutInt(Format_Writer_t *ptrWriter, int32_t value);
+void format_PutFloat(Format_Writer_t *ptrWriter, float value);
+
+/* Se usan los tipos base porque uint32_t es 'unsigned long' en el ARM y 'unsigned int' en el PC */
+#define format_Put(ptrWriter, value) _Generic((value),	\
+		char *:				format_String,		\
+		const char *:		format_String,		\
+		char:				format_Char,		\
+		unsigned char:		format_PutUint,		\
+		unsigned short:		format_PutUint,		\
+		unsigned int:		format_PutUint,		\
+		unsigned long:		format_PutUint,		\
+		signed char:		format_PutInt,		\
+		short:				format_PutInt,		\
+		int:				format_PutInt,		\
+		long:				format_PutInt,		\
+		float:				format_PutFloat,	\
+		double:				format_PutFloat		\
+	)((ptrWriter), (value))
+
+
+#endif /* FORMAT_DRIVER_HAL_H_ */
@@ -152,6 +152,76 @@ typedef struct
 } GPIO_Handler_t;
 
 
+/*
+ * Escrituras de varios pines a la vez por el registro BSRR: los 16 bits bajos encienden
+ * y los 16 altos apagan, así un solo store cambia todos los pines de un puerto al mismo
+ * tiempo (sin estados intermedios) y sin leer ODR, por lo que también es seguro desde
+ * una interrupción.
+ *
+ * Un grupo de pines (por ejemplo, los segmentos A-G de un display) puede estar repartido
+ * en varios puertos: gpio_GroupConfig calcula la máscara de cada puerto, gpio_GroupEncode
+ * convierte un valor (bit i -> pins[i]) en una palabra BSRR por puerto, y gpio_GroupWrite
+ * la escribe (un store por puerto). Las palabras de los valores que se repiten (los dígitos)
+ * se calculan una vez en una tabla.
+ */
+#define GPIO_GROUP_MAX_PINS		16
+#define GPIO_GROUP_MAX_PORTS	3
+
+/* Grupo de pines que se escriben juntos */
+typedef struct
+{
+	GPIO_Handler_t	*pins[GPIO_GROUP_MAX_PINS];		// El bit i del valor va al pin pins[i]
+	uint8_t			numPins;
+	uint8_t			numPorts;						// Los calcula gpio_GroupConfig
+	GPIO_TypeDef	*ports[GPIO_GROUP_MAX_PORTS];
+	uint16_t		portMasks[GPIO_GROUP_MAX_PORTS];
+} GPIO_PinGroup_t;
+
+/* Valor de un grupo ya convertido: una palabra BSRR por puerto */
+typedef struct
+{
+	uint32_t bsrr[GPIO_GROUP_MAX_PORTS];
+} GPIO_GroupWord_t;
+
+
+/*
+ * Configuración de la tarjeta desde una tabla: cada pin se declara ya inicializado
+ * (GPIO_PIN_INIT y sus variantes) y una tabla constante (en flash) reúne las direcciones
+ * de todos los pines del programa. gpio_ConfigBoard recorre la tabla una vez, arma la
+ * máscara y el valor de cada registro por puerto, y luego escribe cada registro de cada
+ * puerto una sola vez (en lugar de seis read-modify-write por pin).
+ * gpio_CheckBoard sólo lee la tabla (no toca registros), así la misma tabla se puede
+ * revisar en el PC antes de cargarla a la tarjeta (Tarea3/Tools/board_check).
+ *
+ *   GPIO_Handler_t stateLed = GPIO_OUTPUT_INIT(GPIOA, PIN_5);
+ *   GPIO_Handler_t *const pinesTarjeta[] = {&stateLed, ...};
+ *   const GPIO_Board_t tarjeta = GPIO_BOARD_INIT(pinesTarjeta);
+ *   ...
+ *   gpio_ConfigBoard(&tarjeta);
+ */
+#define GPIO_BOARD_MAX_PORTS	8		// GPIOA - GPIOH (posición en el bus AHB1)
+
+/* Inicializadores de un pin (para declarar los handlers ya configurados) */
+#define GPIO_PIN_INIT(port, pin, mode, otype, speed, pupd, af)	\
+	{ .pGPIOx = (port),											\
+	  .pinConfig = { .GPIO_PinNumber = (pin), .GPIO_PinMode = (mode), .GPIO_PinOutputSpeed = (speed),	\
+					 .GPIO_PinPuPdControl = (pupd), .GPIO_PinOutputType = (otype), .GPIO_PinAltFunMode = (af) } }
+
+#define GPIO_OUTPUT_INIT(port, pin)			GPIO_PIN_INIT(port, pin, GPIO_MODE_OUT, GPIO_OTYPE_PUSHPULL, GPIO_OSPEED_MEDIUM, GPIO_PUPDR_NOTHING, AF0)
+#define GPIO_INPUT_INIT(port, pin, pupd)	GPIO_PIN_INIT(port, pin, GPIO_MODE_IN, GPIO_OTYPE_PUSHPULL, GPIO_OSPEED_LOW, pupd, AF0)
+#define GPIO_ANALOG_INIT(port, pin)			GPIO_PIN_INIT(port, pin, GPIO_MODE_ANALOG, GPIO_OTYPE_PUSHPULL, GPIO_OSPEED_LOW, GPIO_PUPDR_NOTHING, AF0)
+#define GPIO_ALTFN_INIT(port, pin, af, speed)	GPIO_PIN_INIT(port, pin, GPIO_MODE_ALTFN, GPIO_OTYPE_PUSHPULL, speed, GPIO_PUPDR_NOTHING, af)
+
+/* Tabla de los pines de la tarjeta */
+typedef struct
+{
+	GPIO_Handler_t *const	*pins;		// Arreglo constante de los handlers
+	uint8_t					numPins;
+} GPIO_Board_t;
+
+#define GPIO_BOARD_INIT(table)	{ .pins = (table), .numPins = (uint8_t)(sizeof(table) / sizeof((table)[0])) }
+
+
 /* For testing assert parameters - checking basic configurations */
 #define IS_GPIO_PIN_ACTION(ACTION)	(((ACTION) == GPIO_PIN_RESET) || ((ACTION) == GPIO_PIN_SET))
 
@@ -179,6 +249,12 @@ void gpio_Config (GPIO_Handler_t *pGPIOHandler);
 void gpio_WritePin (GPIO_Handler_t *pPinHandler, uint8_t newState);
 void gpio_TooglePin (GPIO_Handler_t *pPinHandler);
 uint32_t gpio_ReadPin (GPIO_Handler_t *pPinHandler);
+void gpio_WritePort (GPIO_TypeDef *pGPIOx, uint16_t mask, uint16_t value);
+uint8_t gpio_GroupConfig (GPIO_PinGroup_t *pGroup);
+void gpio_GroupEncode (GPIO_PinGroup_t *pGroup, uint32_t value, GPIO_GroupWord_t *pWord);
+void gpio_GroupWrite (GPIO_PinGroup_t *pGroup, GPIO_GroupWord_t *pWord);
+uint8_t gpio_CheckBoard (const GPIO_Board_t *pBoard);
+uint8_t gpio_ConfigBoard (const GPIO_Board_t *pBoard);
 uint8_t clock_mask(uint8_t segundo, uint8_t bit);
 
 
@@ -9,6 +9,7 @@
 #define I2C_DRIVER_HAL_H_
 
 #include "stm32f4xx.h"
+#include "gpio_driver_hal.h"
 
 /* Definición para leer o escribir con el I2C */
 enum
@@ -18,18 +19,6 @@ enum
 };
 
 
-/* Definición de constantes para la señal de reloj
- * que utilizará el periférico I2C
- * */
-enum
-{
-	MAIN_CLOCK_4_MHz_FOR_I2C	= 4,
-	MAIN_CLOCK_16_MHz_FOR_I2C	= 16,
-	MAIN_CLOCK_20_MHz_FOR_I2C	= 20
-
-};
-
-
 /* Constantes para los dos modos de operación del I2C */
 enum
 {
@@ -38,23 +27,54 @@ enum
 };
 
 
-/* Velocidades del periférico según el modo de opercación */
-enum
-{
-	I2C_MODE_SM_SPEED_100KHz	= 80,
-	I2C_MODE_SM_SPEED_400KHz	= 14
-};
+/* Velocidades del bus según el modo de operación. CR2.FREQ, CCR y TRISE se calculan
+ * en i2c_Config con el reloj del APB1 (pll_GetPclk1), así sirven con el HSI o con el PLL
+ */
+#define I2C_MODE_SM_SPEED_Hz		100000UL
+#define I2C_MODE_FM_SPEED_Hz		400000UL
+
+/* Máximo tiempo del flanco de subida según el modo de operación (I2C-bus specification) */
+#define I2C_MAX_RISE_TIME_SM_ns		1000UL
+#define I2C_MAX_RISE_TIME_FM_ns		300UL
 
 
-/* Valores para el máximo tiempo del flanco de subida según
- * el modo de operación del I2C
+/* Códigos de error que devuelven las funciones del I2C.
+ * Ninguna espera del driver es infinita: si la bandera esperada no se
+ * levanta antes del timeout, la función devuelve el error correspondiente.
  */
 enum
 {
-	I2C_MAX_RISE_TIME_SM	= 17,
-	I2C_MAX_RISE_TIME_FM	= 5
+	I2C_OK = 0,
+	I2C_ERROR_BUSY,			// La línea sigue ocupada (SDA o SCL sostenidas en bajo)
+	I2C_ERROR_TIMEOUT_SB,	// No se generó la condición de "start"
+	I2C_ERROR_TIMEOUT_ADDR,	// El esclavo no respondió a su dirección
+	I2C_ERROR_TIMEOUT_TXE,	// No se vació el registro DR
+	I2C_ERROR_TIMEOUT_BTF,	// No se terminó de transmitir el byte
+	I2C_ERROR_TIMEOUT_RXNE,	// No llegó el byte esperado
+	I2C_ERROR_NACK,			// El esclavo respondió con NACK (bandera AF)
+	I2C_ERROR_BUS			// Error de bus o pérdida de arbitraje (BERR, ARLO)
 };
 
+/* Tiempo máximo de espera por defecto para cada bandera, y número de
+ * reintentos de una transacción completa antes de reportar el error
+ */
+#define I2C_DEFAULT_TIMEOUT_us		1000
+#define I2C_MAX_RETRIES				2
+#define I2C_RECOVERY_CLOCK_PULSES	9
+
+/* Contadores para conocer la salud del bus */
+typedef struct
+{
+	uint32_t	transactions;		// Transacciones completas solicitadas
+	uint32_t	errors;				// Transacciones que fallaron aún después de los reintentos
+	uint32_t	timeouts;			// Esperas que excedieron el timeout
+	uint32_t	nacks;				// NACK recibidos
+	uint32_t	retries;			// Reintentos realizados
+	uint32_t	recoveries;			// Recuperaciones del bus ejecutadas
+	uint32_t	lastRecoveryCycles;	// Duración (ciclos de CPU) de la última recuperación
+	uint32_t	maxRecoveryCycles;	// Duración máxima (ciclos de CPU) de una recuperación
+} I2C_Stats_t;
+
 
 /* Definición del Handler del I2C */
 typedef struct
@@ -63,24 +83,36 @@ typedef struct
 	uint8_t			slaveAddress;
 	uint8_t			modeI2C;
 	uint8_t			dataI2C;
+	uint16_t		timeout_us;		// Timeout de cada espera (0 -> I2C_DEFAULT_TIMEOUT_us)
+	GPIO_Handler_t	*ptrPinSCL;		// Pines del bus, necesarios para la recuperación (opcionales)
+	GPIO_Handler_t	*ptrPinSDA;
+	uint8_t			lastError;		// Último código de error registrado
+	uint32_t		cyclesPerUs;	// Ciclos del DWT (HCLK) por microsegundo (lo calcula i2c_Config)
+	uint32_t		timeoutCycles;	// Timeout convertido a ciclos del DWT (lo calcula i2c_Config)
+	I2C_Stats_t		stats;			// Contadores de reintentos, errores y recuperaciones
 } I2C_Handler_t;
 
 
-/* Definición de las funciones públicas */
+/* Definición de las funciones públicas.
+ * Todas devuelven I2C_OK o un código de error, excepto las funciones de
+ * lectura, que devuelven el dato y dejan el código en lastError.
+ */
 void i2c_Config(I2C_Handler_t *ptrHandlerI2C);
-void i2c_StartTransaction(I2C_Handler_t *ptrHandlerI2C);
-void i2c_ReStartTransaction(I2C_Handler_t *ptrHandlerI2C);
-void i2c_SendSlaveAddressRW(I2C_Handler_t *ptrHandlerI2C, uint8_t slaveAddress, uint8_t readOrWrite);
-void i2c_SendMemoryAddress(I2C_Handler_t *ptrHandlerI2C, uint8_t memAddress);
-void i2c_SendDataByte(I2C_Handler_t *ptrHandlerI2C, uint8_t dataToWrite);
+uint8_t i2c_StartTransaction(I2C_Handler_t *ptrHandlerI2C);
+uint8_t i2c_ReStartTransaction(I2C_Handler_t *ptrHandlerI2C);
+uint8_t i2c_SendSlaveAddressRW(I2C_Handler_t *ptrHandlerI2C, uint8_t slaveAddress, uint8_t readOrWrite);
+uint8_t i2c_SendMemoryAddress(I2C_Handler_t *ptrHandlerI2C, uint8_t memAddress);
+uint8_t i2c_SendDataByte(I2C_Handler_t *ptrHandlerI2C, uint8_t dataToWrite);
 uint8_t i2c_ReadDataByte(I2C_Handler_t *ptrHandlerI2C);
 void i2c_StopTransaction(I2C_Handler_t *ptrHandlerI2C);
 void i2c_SendAck(I2C_Handler_t *ptrHandlerI2C);
 void i2c_SendNoAck(I2C_Handler_t *ptrHandlerI2C);
+uint8_t i2c_RecoverBus(I2C_Handler_t *ptrHandlerI2C);
 
 /* Funciones públicas de lectura y escritura mediante I2C */
 uint8_t i2c_ReadSingleRegister(I2C_Handler_t *ptrHandlerI2C, uint8_t regToRead);
-void i2c_WriteSingleRegister(I2C_Handler_t *ptrHandlerI2C, uint8_t regToRead, uint8_t newValue);
+uint8_t i2c_WriteSingleRegister(I2C_Handler_t *ptrHandlerI2C, uint8_t regToRead, uint8_t newValue);
+uint8_t i2c_WriteBuffer(I2C_Handler_t *ptrHandlerI2C, uint8_t memAddress, uint8_t *data, uint16_t length);
 
 
 #endif /* I2C_DRIVER_HAL_H_ */
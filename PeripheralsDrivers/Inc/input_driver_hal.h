@@ -0,0 +1,114 @@
+/*
+ * input_driver_hal.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef INPUT_DRIVER_HAL_H_
+#define INPUT_DRIVER_HAL_H_
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "gpio_driver_hal.h"
+#include "encoder_driver_hal.h"
+
+/*
+ * Entradas de la interfaz (pulsadores y encoder) convertidas en eventos.
+ *
+ * Un timer por software lee los pulsadores cada 'samplePeriod' ms (sin EXTI): un
+ * contador por pulsador sube con cada muestra activa y baja con cada inactiva, y el
+ * estado sólo cambia cuando llega a 0 o a INPUT_DEBOUNCE_SAMPLES, así los rebotes
+ * nunca generan más de un evento. Con el estado limpio se detectan:
+ * - INPUT_EVENT_PRESS / INPUT_EVENT_RELEASE en cada cambio (value = ms presionado).
+ * - INPUT_EVENT_LONG_PRESS cuando se mantiene longPressTime ms (ese pulso ya no da CLICK).
+ * - INPUT_EVENT_CLICK al soltar, o doubleClickTime ms después si puede llegar un segundo
+ *   click (doubleClickTime = 0 -> sin doble click y sin esa espera).
+ * - INPUT_EVENT_DOUBLE_CLICK con dos clicks seguidos.
+ * Si hay encoder, en la misma muestra se leen sus pasos (encoder_GetDeltaAccel) y se
+ * publica INPUT_EVENT_ROTATE con los pasos en value.
+ *
+ * Los eventos van a una cola circular de un productor (el callback del timer, dentro del
+ * SysTick) y un consumidor (el main, con input_GetEvent). Cada lado sólo escribe su
+ * índice, así que no hace falta desactivar interrupciones. Si la cola se llena, los
+ * eventos nuevos se descartan y se cuentan en overflows.
+ *
+ *   Input_Button_t botones[1] = {0};
+ *   botones[0].pGPIOHandler = &sw;
+ *   botones[0].config.activeLevel = GPIO_PIN_SET;
+ *   menuInput.ptrButtons = botones;
+ *   menuInput.numButtons = 1;
+ *   input_Config(&menuInput);
+ *   ...
+ *   Input_Event_t evento;
+ *   while(input_GetEvent(&menuInput, &evento)){ ... }
+ */
+
+#define INPUT_QUEUE_SIZE		16		// Eventos en la cola (potencia de 2, máximo 128)
+#define INPUT_DEBOUNCE_SAMPLES	4		// Muestras iguales seguidas para aceptar un cambio
+#define INPUT_SOURCE_ENCODER	0xFF	// Fuente de los eventos del encoder
+
+/* Tipos de evento */
+enum
+{
+	INPUT_EVENT_PRESS = 0,
+	INPUT_EVENT_RELEASE,
+	INPUT_EVENT_CLICK,
+	INPUT_EVENT_DOUBLE_CLICK,
+	INPUT_EVENT_LONG_PRESS,
+	INPUT_EVENT_ROTATE
+};
+
+/* Evento de la cola */
+typedef struct
+{
+	uint8_t		type;		// INPUT_EVENT_xx
+	uint8_t		source;		// Índice del pulsador, o INPUT_SOURCE_ENCODER
+	int16_t		value;		// Pasos (ROTATE) o ms presionado (RELEASE)
+	uint32_t	tick;		// ms del SysTick en que ocurrió
+} Input_Event_t;
+
+/* Configuración de un pulsador */
+typedef struct
+{
+	uint8_t		activeLevel;		// Nivel del pin con el pulsador presionado (GPIO_PIN_xx)
+	uint16_t	longPressTime;		// ms para INPUT_EVENT_LONG_PRESS (0 -> sin pulsación larga)
+	uint16_t	doubleClickTime;	// ms máximos entre los clicks de un doble click (0 -> sin doble click)
+} Input_ButtonConfig_t;
+
+/* Pulsador (el pin lo configura el programa como entrada) */
+typedef struct
+{
+	GPIO_Handler_t			*pGPIOHandler;
+	Input_ButtonConfig_t	config;
+	uint8_t					integrator;		// 0 - INPUT_DEBOUNCE_SAMPLES
+	uint8_t					pressed;		// Estado sin rebotes
+	uint8_t					clicks;			// Clicks esperando un posible doble click
+	uint8_t					flagLong;		// 1 -> este pulso ya dio LONG_PRESS
+	uint32_t				pressTick;
+	uint32_t				releaseTick;
+} Input_Button_t;
+
+/* Handler de las entradas */
+typedef struct
+{
+	Input_Button_t		*ptrButtons;		// Arreglo de pulsadores
+	uint8_t				numButtons;
+	Encoder_Handler_t	*ptrEncoder;		// Opcional (NULL -> sin encoder)
+	uint8_t				samplePeriod;		// ms entre muestras (0 -> 5 ms)
+	Input_Event_t		events[INPUT_QUEUE_SIZE];
+	volatile uint8_t	head;				// Lo escribe sólo el productor
+	volatile uint8_t	tail;				// Lo escribe sólo el consumidor
+	uint32_t			overflows;			// Eventos descartados con la cola llena
+	uint16_t			timerId;
+} Input_Handler_t;
+
+
+/* Funciones públicas de las entradas */
+void input_Config(Input_Handler_t *ptrInput);
+uint8_t input_GetEvent(Input_Handler_t *ptrInput, Input_Event_t *ptrEvent);
+uint8_t input_GetPending(Input_Handler_t *ptrInput);
+void input_Flush(Input_Handler_t *ptrInput);
+
+
+#endif /* INPUT_DRIVER_HAL_H_ */
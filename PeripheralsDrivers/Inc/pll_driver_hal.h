@@ -8,14 +8,24 @@
 #ifndef PLL_DRIVER_HAL_H_
 #define PLL_DRIVER_HAL_H_
 
-
+#include <stdint.h>
 
 #define MAIN_CLOCK
 
+/* Frecuencias de los osciladores (Hz) */
+#define PLL_HSI_FREQUENCY	16000000	// Oscilador interno
+#define PLL_HSE_FREQUENCY	8000000		// MCO del ST-LINK en la Nucleo (HSE bypass)
+
 /* Headers de las funciones publicas del PLL */
 void pll_Config_100MHz(void);
 void pll_Config_MCO1(uint8_t prescalerMCO, uint8_t channelMCO);
 uint8_t pll_Get_MainClock(void);
 
+/* Frecuencias actuales, leídas de la configuración del RCC (Hz) */
+uint32_t pll_GetSysClock(void);
+uint32_t pll_GetHclk(void);
+uint32_t pll_GetPclk1(void);		// Bus APB1 (USART2, I2C, TIM2-5)
+uint32_t pll_GetPclk2(void);		// Bus APB2 (USART1, USART6, ADC, TIM1, TIM9-11)
+
 
 #endif /* PLL_DRIVER_HAL_H_ */
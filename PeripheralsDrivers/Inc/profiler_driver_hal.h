@@ -0,0 +1,192 @@
+/*
+ * profiler_driver_hal.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef PROFILER_DRIVER_HAL_H_
+#define PROFILER_DRIVER_HAL_H_
+
+#include <stdint.h>
+#include "format_driver_hal.h"
+
+/*
+ * Medición de tiempos por secciones con el contador de ciclos del Cortex-M4 (DWT->CYCCNT):
+ *
+ *   PROF_BEGIN(PROF_FFT);
+ *   procesamientoFFT(ADC_Data1);
+ *   PROF_END(PROF_FFT);
+ *
+ * Cada sección guarda veces, mínimo, máximo y total de ciclos en una tabla estática, y
+ * prof_Dump escribe la tabla (con el promedio en ciclos y en us) en un Format_Writer_t.
+ * A cada medición se le resta el costo de PROF_BEGIN/PROF_END, que prof_Init mide al arrancar.
+ *
+ * Los identificadores los define el programa (0 a PROF_MAX_SCOPES - 1), junto con una
+ * tabla de nombres que recibe prof_Init. Una misma sección no se debe medir a la vez
+ * desde el main y desde una interrupción, ni de forma recursiva.
+ *
+ * En el PC (para los programas de Tools) los mismos macros usan rdtsc en x86, o
+ * clock_gettime (1 "ciclo" = 1 ns) en otras arquitecturas. prof_GetFrequency da los
+ * ciclos por segundo de cada caso, así el promedio en us se puede comparar.
+ *
+ * Para eventos periódicos (por ejemplo, la interrupción del ADC) hay además histogramas:
+ * PROF_HIST_MARK guarda el intervalo desde el evento anterior (el jitter del periodo) y
+ * PROF_HIST_ADD guarda cualquier medición (por ejemplo, la duración de la interrupción).
+ * Cada histograma tiene PROF_HIST_BINS bins de binWidth ciclos desde base; los extremos
+ * acumulan lo que queda por fuera. Los intervalos mayores que limit (pausas de la
+ * captura) se cuentan aparte y no entran en las estadísticas.
+ *
+ * Con PROF_ENABLE = 0 los macros no generan código.
+ */
+
+#ifndef PROF_ENABLE
+#define PROF_ENABLE			1
+#endif
+
+#define PROF_MAX_SCOPES		16
+
+/* Estadísticas de una sección */
+typedef struct
+{
+	uint32_t	start;		// Ciclo en que empezó la medición actual
+	uint32_t	count;
+	uint32_t	min;
+	uint32_t	max;
+	uint64_t	total;
+} Prof_Scope_t;
+
+/* Histograma de mediciones (o de intervalos entre eventos) */
+#define PROF_HIST_BINS		16
+
+typedef struct
+{
+	uint32_t	base;		// Inicio del primer bin (ciclos)
+	uint32_t	binWidth;	// Ancho de cada bin (ciclos)
+	uint32_t	limit;		// Intervalos mayores se cuentan como pausas (0 -> sin límite)
+	uint32_t	last;		// Ciclo del evento anterior (PROF_HIST_MARK)
+	uint8_t		flagLast;	// 1 -> last es válido
+	uint32_t	count;
+	uint32_t	min;
+	uint32_t	max;
+	uint64_t	total;
+	uint32_t	gaps;		// Intervalos descartados por ser mayores que limit
+	uint32_t	bins[PROF_HIST_BINS];
+} Prof_Histogram_t;
+
+/* Tabla de las secciones (la usan los macros en línea, para que medir cueste poco) */
+extern Prof_Scope_t profScopes[PROF_MAX_SCOPES];
+extern uint32_t profOverhead;
+
+
+/* Funciones públicas del profiler */
+void prof_Init(const char *const *names, uint8_t count);
+void prof_Reset(void);
+void prof_Dump(Format_Writer_t *ptrWriter);
+uint32_t prof_GetFrequency(void);
+
+/* Funciones de los histogramas */
+void prof_HistConfig(Prof_Histogram_t *ptrHist, uint32_t base, uint32_t binWidth, uint32_t limit);
+void prof_HistReset(Prof_Histogram_t *ptrHist);
+float prof_HistGetMean(Prof_Histogram_t *ptrHist);
+void prof_HistDump(Prof_Histogram_t *ptrHist, const char *name, Format_Writer_t *ptrWriter);
+
+
+/* Contador de ciclos de cada plataforma */
+#if defined(__arm__)
+#include "stm32f4xx.h"
+
+static inline uint32_t prof_GetCycles(void){
+	return DWT->CYCCNT;
+}
+
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+
+static inline uint32_t prof_GetCycles(void){
+	return (uint32_t)__rdtsc();
+}
+
+#else
+#include <time.h>
+
+static inline uint32_t prof_GetCycles(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+#endif
+
+
+/* Guarda una medición (la resta de 32 bits funciona aunque el contador dé la vuelta) */
+static inline void prof_Record(uint8_t id, uint32_t end){
+
+	Prof_Scope_t *ptrScope = &profScopes[id];
+	uint32_t cycles = end - ptrScope->start;
+
+	cycles = (cycles > profOverhead) ? (cycles - profOverhead) : 0;
+	if((ptrScope->count == 0) || (cycles < ptrScope->min)){
+		ptrScope->min = cycles;
+	}
+	if(cycles > ptrScope->max){
+		ptrScope->max = cycles;
+	}
+	ptrScope->total += cycles;
+	ptrScope->count++;
+}
+
+/* Guarda un valor en el histograma */
+static inline void prof_HistAdd(Prof_Histogram_t *ptrHist, uint32_t value){
+
+	uint32_t bin = 0;
+
+	if(value >= ptrHist->base){
+		bin = (value - ptrHist->base) / ptrHist->binWidth;
+		if(bin >= PROF_HIST_BINS){
+			bin = PROF_HIST_BINS - 1;
+		}
+	}
+	ptrHist->bins[bin]++;
+
+	if((ptrHist->count == 0) || (value < ptrHist->min)){
+		ptrHist->min = value;
+	}
+	if(value > ptrHist->max){
+		ptrHist->max = value;
+	}
+	ptrHist->total += value;
+	ptrHist->count++;
+}
+
+/* Guarda el intervalo desde el evento anterior (el primer evento sólo toma la referencia) */
+static inline void prof_HistMark(Prof_Histogram_t *ptrHist, uint32_t now){
+
+	uint32_t interval = now - ptrHist->last;
+	uint8_t flagLast = ptrHist->flagLast;
+
+	ptrHist->last = now;
+	ptrHist->flagLast = 1;
+	if(!flagLast){
+		return;
+	}
+	if((ptrHist->limit != 0) && (interval > ptrHist->limit)){
+		ptrHist->gaps++;
+		return;
+	}
+	prof_HistAdd(ptrHist, interval);
+}
+
+#if PROF_ENABLE
+#define PROF_BEGIN(id)				(profScopes[(id)].start = prof_GetCycles())
+#define PROF_END(id)				prof_Record((id), prof_GetCycles())
+#define PROF_HIST_MARK(hist, now)	prof_HistMark((hist), (now))
+#define PROF_HIST_ADD(hist, value)	prof_HistAdd((hist), (value))
+#else
+#define PROF_BEGIN(id)				((void)0)
+#define PROF_END(id)				((void)0)
+#define PROF_HIST_MARK(hist, now)	((void)0)
+#define PROF_HIST_ADD(hist, value)	((void)0)
+#endif
+
+
+#endif /* PROFILER_DRIVER_HAL_H_ */
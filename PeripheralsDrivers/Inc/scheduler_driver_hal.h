@@ -0,0 +1,81 @@
+/*
+ * scheduler_driver_hal.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef SCHEDULER_DRIVER_HAL_H_
+#define SCHEDULER_DRIVER_HAL_H_
+
+#include <stdint.h>
+
+/*
+ * Planificador cooperativo: cada tarea es una función que se ejecuta completa
+ * (run-to-completion) cuando tiene eventos pendientes, y retorna sin esperar.
+ *
+ * - Los eventos son bits de 32: las interrupciones los publican con sched_PostEvent
+ *   (sólo hacen un OR, así el callback queda corto) y la tarea los recibe todos juntos.
+ * - SCHED_EVENT_TIMER llega cuando vence el tiempo de la tarea: cada 'period' ms si la
+ *   tarea es periódica, o una vez después de sched_WakeAfter.
+ * - Entre las tareas listas se ejecuta primero la de mayor prioridad. Después de cada
+ *   tarea se vuelve a escoger, así una tarea de alta prioridad espera como máximo a que
+ *   termine la tarea que se está ejecutando.
+ * - Si ninguna tarea tiene trabajo, el procesador duerme (WFI) hasta la siguiente
+ *   interrupción; el SysTick lo despierta cada ms para revisar los tiempos.
+ *
+ * Los tiempos se cuentan con el SysTick (1 ms), que debe estar configurado con su interrupción.
+ *
+ *   Sched_Task_t taskDisplay = {0};
+ *   taskDisplay.function = tareaDisplay;
+ *   taskDisplay.priority = SCHED_PRIORITY_LOW;
+ *   taskDisplay.period   = 10;
+ *   sched_AddTask(&taskDisplay);
+ *   ...
+ *   sched_Run();	// No retorna
+ */
+
+#define SCHED_EVENT_TIMER	(1UL << 31)		// Venció el tiempo de la tarea (los bits 0 - 30 son del usuario)
+
+/* Prioridades (la mayor se ejecuta primero) */
+enum
+{
+	SCHED_PRIORITY_IDLE = 0,
+	SCHED_PRIORITY_LOW,
+	SCHED_PRIORITY_NORMAL,
+	SCHED_PRIORITY_HIGH
+};
+
+typedef struct Sched_Task_s Sched_Task_t;
+
+/* Función de una tarea: recibe los eventos que se acumularon desde la última ejecución */
+typedef void (*Sched_Function_t)(Sched_Task_t *ptrTask, uint32_t events);
+
+/* Handler de una tarea */
+struct Sched_Task_s
+{
+	Sched_Function_t	function;
+	void				*context;		// Dato libre para la tarea
+	uint8_t				priority;		// SCHED_PRIORITY_xx
+	uint32_t			period;			// ms entre ejecuciones (0 -> sólo eventos y sched_WakeAfter)
+	uint32_t			runs;			// Veces que se ha ejecutado
+	volatile uint32_t	events;			// Eventos pendientes (los escribe sched_PostEvent)
+	uint32_t			wakeTick;		// Tick en el que se publica SCHED_EVENT_TIMER
+	uint8_t				flagWake;		// 1 -> wakeTick está activo
+	Sched_Task_t		*next;			// Lista de tareas, ordenada por prioridad
+};
+
+
+/* Funciones públicas del planificador */
+void sched_AddTask(Sched_Task_t *ptrTask);
+void sched_PostEvent(Sched_Task_t *ptrTask, uint32_t events);
+void sched_WakeAfter(Sched_Task_t *ptrTask, uint32_t delay_ms);
+uint8_t sched_RunOnce(void);
+void sched_Run(void);
+void sched_Idle(void);
+void sched_Yield(void);
+void sched_Delay_ms(uint32_t wait_time_ms);
+uint32_t sched_GetIdleCount(void);
+
+
+#endif /* SCHEDULER_DRIVER_HAL_H_ */
@@ -0,0 +1,83 @@
+/*
+ * sevenseg_driver_hal.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef SEVENSEG_DRIVER_HAL_H_
+#define SEVENSEG_DRIVER_HAL_H_
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "gpio_driver_hal.h"
+#include "dma_driver_hal.h"
+
+/*
+ * Multiplexado de displays 7 segmentos por DMA, sin interrupciones ni uso del procesador.
+ *
+ * Cada fase del multiplexado (un dígito encendido) se guarda como una palabra BSRR por
+ * puerto: los segmentos del dígito y los pines de selección (el de la fase encendido y
+ * los demás apagados). En cada periodo del TIM1 un stream circular del DMA2 copia la
+ * palabra de la fase siguiente en GPIOx->BSRR de su puerto. Cambiar lo que se muestra es
+ * sólo recalcular las palabras de un dígito (sevenseg_SetPattern / sevenseg_SetDigit).
+ *
+ * El TIM1 es el único timer del F411 con peticiones en el DMA2, y sólo el DMA2 llega a
+ * los GPIO (bus AHB1). Cada puerto usado (hasta 3) necesita su propio stream, y los tres
+ * eventos del periodo van en este orden, separados por un ciclo del timer:
+ *   CC1 (CNT = ARR - 1) -> DMA2 Stream3, CC4 (CNT = ARR) -> DMA2 Stream4, UP -> DMA2 Stream5
+ * (todos en el canal 6). Los puertos con pines de selección reciben los últimos eventos, así
+ * los segmentos ya cambiaron cuando se enciende el dígito nuevo.
+ * Los streams 3, 4 y 5 no chocan con los del USART1 (2 y 7) ni del USART6 (1 y 6).
+ *
+ * Los pines los configura el programa como salidas. El patrón de un dígito tiene un bit por
+ * segmento (SEVENSEG_SEG_x, 1 -> encendido) sin importar si el display es de ánodo o cátodo
+ * común: eso lo dice segmentActiveLevel.
+ */
+
+#define SEVENSEG_MAX_DIGITS		4
+#define SEVENSEG_MAX_LANES		GPIO_GROUP_MAX_PORTS	// Puertos (uno por stream)
+#define SEVENSEG_SEGMENTS		8						// A - G y punto
+
+/* Bits del patrón de un dígito */
+#define SEVENSEG_SEG_A		0x01
+#define SEVENSEG_SEG_B		0x02
+#define SEVENSEG_SEG_C		0x04
+#define SEVENSEG_SEG_D		0x08
+#define SEVENSEG_SEG_E		0x10
+#define SEVENSEG_SEG_F		0x20
+#define SEVENSEG_SEG_G		0x40
+#define SEVENSEG_SEG_DP		0x80
+
+/* Configuración de los displays */
+typedef struct
+{
+	uint8_t		numDigits;				// Dígitos multiplexados (1 - SEVENSEG_MAX_DIGITS)
+	uint8_t		segmentActiveLevel;		// Nivel que enciende un segmento (GPIO_PIN_RESET en ánodo común)
+	uint8_t		digitActiveLevel;		// Nivel que enciende un dígito
+	uint16_t	phaseFrequency;			// Fases por segundo (cada dígito se refresca a phaseFrequency / numDigits)
+} SevenSeg_Config_t;
+
+/* Handler de los displays */
+typedef struct
+{
+	GPIO_Handler_t		*segmentPins[SEVENSEG_SEGMENTS];	// A - G y punto (NULL -> sin punto)
+	GPIO_Handler_t		*digitPins[SEVENSEG_MAX_DIGITS];	// Selección de cada dígito
+	SevenSeg_Config_t	config;
+	GPIO_PinGroup_t		group;								// Segmentos y selección (lo arma sevenseg_Config)
+	uint8_t				numSegments;						// 7 u 8
+	DMA_Handler_t		dma[SEVENSEG_MAX_LANES];			// Un stream por puerto del grupo
+	uint32_t			phases[SEVENSEG_MAX_LANES][SEVENSEG_MAX_DIGITS];	// Palabras BSRR de cada fase
+	uint8_t				patterns[SEVENSEG_MAX_DIGITS];		// Patrón actual de cada dígito
+} SevenSeg_Handler_t;
+
+
+/* Funciones públicas de los displays */
+uint8_t sevenseg_Config(SevenSeg_Handler_t *ptrDisplay);
+void sevenseg_Start(SevenSeg_Handler_t *ptrDisplay);
+void sevenseg_Stop(SevenSeg_Handler_t *ptrDisplay);
+void sevenseg_SetPattern(SevenSeg_Handler_t *ptrDisplay, uint8_t digit, uint8_t pattern);
+void sevenseg_SetDigit(SevenSeg_Handler_t *ptrDisplay, uint8_t digit, uint8_t value, uint8_t dot);
+
+
+#endif /* SEVENSEG_DRIVER_HAL_H_ */
@@ -0,0 +1,101 @@
+/*
+ * shell_driver_hal.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef SHELL_DRIVER_HAL_H_
+#define SHELL_DRIVER_HAL_H_
+
+#include <stdint.h>
+#include "usart_driver_hal.h"
+#include "format_driver_hal.h"
+
+/*
+ * Intérprete de comandos por líneas sobre el USART.
+ *
+ * - shell_ReceiveChar se llama desde el callback de recepción (interrupción) y sólo
+ *   guarda el caracter en un buffer circular.
+ * - shell_Process se llama desde el loop principal: arma la línea, la separa en
+ *   palabras sobre el mismo buffer (cambia los espacios por '\0', sin copiar) y
+ *   ejecuta el comando. Nunca espera, así que no detiene la adquisición.
+ *
+ * La tabla de comandos es const (queda en la flash) y debe estar ordenada
+ * alfabéticamente por nombre, porque el comando se busca con búsqueda binaria.
+ * shell_Config revisa el orden; si la tabla no está ordenada se usa búsqueda lineal.
+ *
+ * Si startChar es distinto de 0, sólo las líneas que empiezan con ese caracter son
+ * del shell y el resto de caracteres se deja para el programa (por ejemplo, los
+ * menús de una sola tecla). Con startChar = 0 todo lo recibido es del shell.
+ *
+ *   :fs 4000\r   -> ejecuta el comando "fs" con argv = {"fs", "4000"}
+ */
+
+#define SHELL_RX_BUFFER_SIZE	128		// Potencia de 2
+#define SHELL_RX_BUFFER_MASK	(SHELL_RX_BUFFER_SIZE - 1)
+#define SHELL_LINE_SIZE			64		// Caracteres máximos de una línea, incluido el '\0'
+#define SHELL_MAX_ARGS			6		// Palabras máximas de una línea (comando incluido)
+
+/* Resultado de un comando */
+enum
+{
+	SHELL_OK = 0,
+	SHELL_ERROR_ARGS,		// Faltan argumentos o sobran
+	SHELL_ERROR_VALUE		// El valor no es válido
+};
+
+typedef struct Shell_Handler_s Shell_Handler_t;
+
+/* Función de un comando: argv[0] es el nombre del comando */
+typedef uint8_t (*Shell_Function_t)(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+
+/* Entrada de la tabla de comandos */
+typedef struct
+{
+	const char			*name;
+	Shell_Function_t	function;
+	const char			*help;		// Texto corto que imprime shell_CommandHelp
+} Shell_Command_t;
+
+/* Contadores del shell */
+typedef struct
+{
+	uint32_t	commands;		// Comandos ejecutados
+	uint32_t	errors;			// Comandos desconocidos o que retornaron error
+	uint32_t	overflows;		// Caracteres perdidos (buffer circular lleno) o líneas demasiado largas (lo suman la interrupción y shell_Process)
+} Shell_Stats_t;
+
+/* Handler del shell */
+struct Shell_Handler_s
+{
+	USART_Handler_t			*ptrUsartHandler;	// USART por donde salen las respuestas
+	const Shell_Command_t	*ptrCommands;		// Tabla de comandos (ordenada por nombre)
+	uint8_t					numCommands;
+	char					startChar;			// Caracter que inicia una línea del shell (0 -> todas)
+	Format_Writer_t			writer;				// Writer de las respuestas (lo prepara shell_Config)
+	Shell_Stats_t			stats;
+	uint8_t					flagSorted;			// 1 -> la tabla está ordenada (búsqueda binaria)
+	volatile uint8_t		rxState;			// Estado de la recepción cuando se usa startChar
+	uint8_t					rxBuffer[SHELL_RX_BUFFER_SIZE];
+	volatile uint16_t		rxHead;				// Siguiente posición a escribir (interrupción)
+	volatile uint16_t		rxTail;				// Siguiente posición a leer (main)
+	char					line[SHELL_LINE_SIZE];
+	uint8_t					lineLength;
+	uint8_t					flagDiscard;		// 1 -> la línea actual no cupo y se descarta hasta el fin de línea
+};
+
+
+/* Funciones públicas del shell */
+void shell_Config(Shell_Handler_t *ptrShell);
+uint8_t shell_ReceiveChar(Shell_Handler_t *ptrShell, char character);
+void shell_Process(Shell_Handler_t *ptrShell);
+const Shell_Command_t *shell_FindCommand(Shell_Handler_t *ptrShell, const char *name);
+uint8_t shell_CommandHelp(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]);
+
+/* Conversión de los argumentos (retornan 0 si el texto no es un número válido) */
+uint8_t shell_ParseUint(const char *text, uint32_t *ptrValue);
+uint8_t shell_ParseFloat(const char *text, float *ptrValue);
+
+
+#endif /* SHELL_DRIVER_HAL_H_ */
@@ -0,0 +1,59 @@
+/*
+ * swtimer_driver_hal.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef SWTIMER_DRIVER_HAL_H_
+#define SWTIMER_DRIVER_HAL_H_
+
+#include <stdint.h>
+
+/*
+ * Timers por software sobre el SysTick (1 tick = 1 ms): muchas tareas periódicas
+ * (blinky, parpadeo de los menús, multiplexado de displays) comparten la interrupción
+ * del SysTick, y los timers de hardware quedan libres para el PWM y el disparo del ADC.
+ *
+ * Los timers se guardan en una rueda jerárquica de tres niveles:
+ *   nivel 0: 256 ranuras de 1 tick      (vencen en menos de 256 ms)
+ *   nivel 1:  64 ranuras de 256 ticks   (menos de 16.4 s)
+ *   nivel 2:  64 ranuras de 16384 ticks (hasta SWTIMER_MAX_PERIOD, unos 17 minutos)
+ * Agregar o quitar un timer es O(1) (listas doblemente enlazadas por índices), y cada
+ * tick sólo revisa la ranura actual del nivel 0. Cada 256 ticks la ranura que llega del
+ * nivel 1 se reparte en el nivel 0 (y cada 16384 ticks la del nivel 2 en el nivel 1).
+ *
+ * Los callbacks se ejecutan dentro de la interrupción del SysTick, igual que los
+ * callbacks de los timers de hardware: deben ser cortos (levantar una bandera, cambiar
+ * un pin). Desde un callback se puede arrancar o detener cualquier timer, incluido él mismo.
+ *
+ *   uint16_t ledTimer = swtimer_Start(500, SWTIMER_PERIODIC, blinkLed, &userLed);
+ *   ...
+ *   swtimer_Stop(ledTimer);
+ */
+
+#define SWTIMER_MAX_TIMERS		16			// Timers activos al mismo tiempo (máximo 255)
+#define SWTIMER_MAX_PERIOD		((1UL << 20) - 1)	// Periodo máximo en ticks (los mayores se recortan)
+#define SWTIMER_INVALID			0xFFFF		// swtimer_Start no tiene espacio, o el timer no existe
+
+enum
+{
+	SWTIMER_PERIODIC = 0,
+	SWTIMER_ONE_SHOT
+};
+
+/* Función que se llama cuando vence el timer, con el contexto que se pasó a swtimer_Start */
+typedef void (*SwTimer_Callback_t)(void *context);
+
+
+/* Funciones públicas de los timers por software */
+uint16_t swtimer_Start(uint32_t period, uint8_t oneShot, SwTimer_Callback_t callback, void *context);
+void swtimer_Stop(uint16_t timerId);
+uint8_t swtimer_IsActive(uint16_t timerId);
+uint8_t swtimer_GetActiveCount(void);
+
+/* La llama SysTick_Handler en cada tick */
+void swtimer_Tick(void);
+
+
+#endif /* SWTIMER_DRIVER_HAL_H_ */
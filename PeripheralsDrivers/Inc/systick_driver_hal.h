@@ -54,9 +54,13 @@ typedef struct
 /* Funciones públicas del driver */
 void systick_Config(Systick_Handler_t *pSystickHandler);
 void systick_SetState(Systick_Handler_t *pSystickHandler, uint8_t newState);
-uint64_t systick_GetTicks();
+uint64_t systick_GetTicks(void);
+uint32_t systick_GetTicks32(void);
 void systick_Delay_ms(uint32_t wait_time_ms);
 
+/* Contador de ciclos del Cortex-M4 (DWT->CYCCNT), compartido por el profiler y el I2C */
+void systick_EnableCycleCounter(void);
+
 /* Esta función debe ser sobre-escrita en el main para que el sistema funcione */
 void systick_Callback(void);
 
@@ -10,6 +10,7 @@
 
 #include <stdio.h>
 #include "stm32f4xx.h"
+#include "dma_driver_hal.h"
 
 
 enum
@@ -28,12 +29,63 @@ enum
 	USART_TX_INTERRUP_ENABLE
 };
 
+/* Política cuando el buffer circular de transmisión está lleno */
+enum{
+	USART_TX_POLICY_DROP = 0,	// Se descartan los bytes que no caben (nunca bloquea)
+	USART_TX_POLICY_BLOCK,		// Espera a que la interrupción libere espacio
+	USART_TX_POLICY_OVERWRITE	// Se descartan los bytes más viejos que aún no se han enviado
+};
+
+/* Uso del DMA en el USART.
+ * Streams fijos (RM0383, Tablas 27 y 28), cuyos IRQHandler define este driver:
+ * - USART1: TX DMA2 Stream7 canal 4, RX DMA2 Stream2 canal 4
+ * - USART2: TX DMA1 Stream6 canal 4, RX DMA1 Stream5 canal 4
+ * - USART6: TX DMA2 Stream6 canal 5, RX DMA2 Stream1 canal 5
+ */
+enum{
+	USART_DMA_DISABLE = 0,
+	USART_DMA_TX,		// El buffer circular de transmisión se vacía por DMA
+	USART_DMA_RX,		// Recepción circular en receptionBuffer, entregada por tramas (línea IDLE)
+	USART_DMA_RXTX
+};
+
+/* Tamaño del buffer de recepción por DMA (receptionBuffer) */
+#define USART_RX_BUFFER_SIZE	64
+
+/* Tamaño del buffer circular de recepción que llena la interrupción (debe ser potencia de 2) */
+#define USART_RX_RING_SIZE		256
+#define USART_RX_RING_MASK		(USART_RX_RING_SIZE - 1)
+
+/* Tamaño del buffer circular de transmisión (debe ser potencia de 2) */
+#define USART_TX_BUFFER_SIZE	256
+#define USART_TX_BUFFER_MASK	(USART_TX_BUFFER_SIZE - 1)
+
+/* Velocidades disponibles. El BRR se calcula con el reloj real del bus (pll_GetPclkX),
+ * así que siguen siendo correctas al cambiar el reloj. Con el HSI (16 MHz) se llega
+ * hasta 2 Mbaud y 921600 queda con +2.1 % de error; 3, 4 y 6 Mbaud necesitan el PLL
+ * (ver la tabla de error en Tools/usart_baudrate).
+ */
 enum{
 	USART_BAUDRATE_9600 = 0,
 	USART_BAUDRATE_19200,
 	USART_BAUDRATE_115200,
 	USART_BAUDRATE_230400,
-	USART_BAUDRATE_921600
+	USART_BAUDRATE_921600,
+	USART_BAUDRATE_460800,
+	USART_BAUDRATE_1M,
+	USART_BAUDRATE_2M,
+	USART_BAUDRATE_3M,
+	USART_BAUDRATE_4M,
+	USART_BAUDRATE_6M
+};
+
+/* Sobremuestreo de la recepción (bit OVER8 del CR1).
+ * Con 8 se llega al doble de velocidad (PCLK/8) a costa de tolerar menos error de reloj.
+ * Si la velocidad pedida no se alcanza con 16, el driver pasa a 8 automáticamente.
+ */
+enum{
+	USART_OVERSAMPLING_16 = 0,
+	USART_OVERSAMPLING_8
 };
 
 enum{
@@ -69,7 +121,10 @@ typedef struct
 	uint8_t parity;
 	uint8_t stopbits;
 	uint8_t	enableIntRX;
-	uint8_t	enableIntTX;
+	uint8_t	enableIntTX;	// USART_TX_INTERRUP_ENABLE -> la transmisión se hace por interrupción (buffer circular)
+	uint8_t	txPolicy;		// Qué hacer cuando el buffer de transmisión se llena
+	uint8_t	enableDMA;		// USART_DMA_xx
+	uint8_t	oversampling;	// USART_OVERSAMPLING_xx
 }USART_Config_t;
 
 /*
@@ -80,15 +135,41 @@ typedef struct
  * - Elemento que indica cuantos datos se recibieron
  * - Buffer de transmision de datos
  * - Elemento que indica cuantos datos se deben enviar.
+ * - Buffer circular de transmisión por interrupción (un productor: el main,
+ *   un consumidor: la interrupción TXE). txHead sólo lo escribe el main y
+ *   txTail sólo la interrupción, por lo que no se necesitan bloqueos.
+ * - Streams de DMA de transmisión y recepción (si se usan)
+ * - Buffer circular de recepción: lo llena la interrupción (RXNE o DMA) y lo vacía
+ *   el main con usart_Read, así no se pierden datos en ráfagas aunque el main tarde.
+ *   Igual que en transmisión, rxHead sólo lo escribe la interrupción y rxTail el main.
+ * - Contadores de errores de recepción (overrun, framing, ruido y paridad)
  */
 typedef struct
 {
-	USART_TypeDef	*ptrUSARTx;
-	USART_Config_t	USART_Config;
-	uint8_t			receptionBuffer[64];
-	uint8_t			dataInputSize;
-	uint8_t			transmisionBuffer[64];
-	uint8_t			dataOutputSize;
+	USART_TypeDef		*ptrUSARTx;
+	USART_Config_t		USART_Config;
+	uint8_t				receptionBuffer[USART_RX_BUFFER_SIZE];
+	uint8_t				dataInputSize;
+	uint8_t				transmisionBuffer[64];
+	uint8_t				dataOutputSize;
+	uint8_t				txRing[USART_TX_BUFFER_SIZE];
+	volatile uint16_t	txHead;			// Siguiente posición a escribir (main)
+	volatile uint16_t	txTail;			// Siguiente byte a enviar (interrupción)
+	uint16_t			txHighWater;	// Máxima ocupación que ha tenido el buffer
+	uint32_t			txDropped;		// Bytes descartados por el buffer lleno
+	DMA_Handler_t		dmaTx;			// Stream que vacía el buffer circular (USART_DMA_TX)
+	volatile uint16_t	txDmaLength;	// Bytes de la transferencia en curso (0 -> DMA libre)
+	DMA_Handler_t		dmaRx;			// Stream de recepción circular (USART_DMA_RX)
+	uint16_t			rxDmaIndex;		// Posición de receptionBuffer hasta donde ya se entregaron datos
+	uint32_t			rxFrames;		// Tramas (o partes de trama) entregadas por DMA
+	uint8_t				rxRing[USART_RX_RING_SIZE];
+	volatile uint16_t	rxHead;			// Siguiente posición a escribir (interrupción)
+	volatile uint16_t	rxTail;			// Siguiente byte a leer (main)
+	volatile uint32_t	rxDropped;		// Bytes descartados por el buffer de recepción lleno
+	volatile uint32_t	rxOverruns;		// ORE: llegó un byte antes de leer el anterior
+	volatile uint32_t	rxFramingErrors;// FE: no llegó el bit de parada (baudrate distinto o ruido)
+	volatile uint32_t	rxNoiseErrors;	// NE: ruido en la línea durante el muestreo
+	volatile uint32_t	rxParityErrors;	// PE: paridad incorrecta (sólo con paridad activa)
 }USART_Handler_t;
 
 
@@ -107,6 +188,13 @@ typedef struct
 void usart_Config(USART_Handler_t *ptrUsartHandler);
 int  usart_WriteChar(USART_Handler_t *ptrUsartHandler, char dataToSend );
 void usart_WriteMsg(USART_Handler_t *ptrUsartHandler, char *msgToSend );
+uint16_t usart_WriteBuffer(USART_Handler_t *ptrUsartHandler, uint8_t *data, uint16_t length);
+uint16_t usart_TxPending(USART_Handler_t *ptrUsartHandler);
+uint16_t usart_Read(USART_Handler_t *ptrUsartHandler, uint8_t *buffer, uint16_t maxLength);
+uint16_t usart_RxAvailable(USART_Handler_t *ptrUsartHandler);
+uint32_t usart_GetPclk(USART_Handler_t *ptrUsartHandler);
+uint32_t usart_GetBaudrate(USART_Handler_t *ptrUsartHandler);
+uint16_t usart_ComputeBRR(uint32_t pclk, uint32_t baudrate, uint8_t oversampling);
 uint8_t usart1_getRxData(void);
 uint8_t usart2_getRxData(void);
 uint8_t usart6_getRxData(void);
@@ -114,6 +202,14 @@ void usart1_RxCallback(void);
 void usart2_RxCallback(void);
 void usart6_RxCallback(void);
 
+/* Con USART_DMA_RX los datos llegan por tramas, sin copiar: 'data' apunta dentro de
+ * receptionBuffer y es válido hasta que el DMA dé la vuelta al buffer. Una trama que
+ * cruza el final del buffer llega en dos llamados.
+ */
+void usart1_RxFrameCallback(uint8_t *data, uint16_t length);
+void usart2_RxFrameCallback(uint8_t *data, uint16_t length);
+void usart6_RxFrameCallback(uint8_t *data, uint16_t length);
+
 
 #endif /* USART_DRIVER_HAL_H_ */
 
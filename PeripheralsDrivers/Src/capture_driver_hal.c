@@ -0,0 +1,352 @@
+/*
+ * capture_driver_hal.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "capture_driver_hal.h"
+#include "pll_driver_hal.h"
+
+/* === Headers for private functions === */
+static void capture_enable_clock_peripheral(Capture_Handler_t *ptrCapture);
+static uint8_t capture_set_dma_stream(Capture_Handler_t *ptrCapture);
+static void capture_config_channel(Capture_Handler_t *ptrCapture);
+static uint32_t capture_get_timer_clock(void);
+static uint16_t capture_get_write_position(Capture_Handler_t *ptrCapture);
+static void capture_add_period(Capture_Handler_t *ptrCapture, uint32_t period);
+static uint32_t capture_median(Capture_Handler_t *ptrCapture, uint32_t *ptrMin, uint32_t *ptrMax);
+
+
+/*
+ * Configura el timer en captura de entrada y el stream del DMA (quedan apagados
+ * hasta llamar capture_Start). Los pines los configura el programa (función alternativa).
+ */
+void capture_Config(Capture_Handler_t *ptrCapture){
+
+	/* 1. Sólo TIM2 y TIM5, con un stream de DMA conocido para el canal */
+	if(!capture_set_dma_stream(ptrCapture)){
+		return;
+	}
+	capture_enable_clock_peripheral(ptrCapture);
+
+	/* 2. Contador libre de 32 bits: la resta de dos tiempos da el periodo aunque dé la vuelta */
+	if(ptrCapture->config.prescaler == 0){
+		ptrCapture->config.prescaler = 1;
+	}
+	ptrCapture->ptrTIMx->CR1 = 0;
+	ptrCapture->ptrTIMx->PSC = ptrCapture->config.prescaler - 1;
+	ptrCapture->ptrTIMx->ARR = 0xFFFFFFFF;
+
+	/* 3. Canal en captura, con su flanco, divisor y filtro, y petición de DMA en cada captura */
+	capture_config_channel(ptrCapture);
+
+	/* 4. Cargamos el prescaler (UG) y limpiamos las banderas que eso deja */
+	ptrCapture->ptrTIMx->EGR = TIM_EGR_UG;
+	ptrCapture->ptrTIMx->SR = 0;
+
+	/* 5. Rango válido en cuentas del timer (cada tiempo guardado abarca 2^edgeDivider periodos) */
+	ptrCapture->timerFrequency = capture_get_timer_clock() / ptrCapture->config.prescaler;
+	float countsPerCapture = (float)ptrCapture->timerFrequency * (float)(1u << ptrCapture->config.edgeDivider);
+	ptrCapture->minPeriod = (uint32_t)(countsPerCapture / ptrCapture->config.maxFrequency);
+	ptrCapture->maxPeriod = (uint32_t)(countsPerCapture / ptrCapture->config.minFrequency);
+
+	/* 6. DMA: CCRx -> buffer circular, palabras de 32 bits, sin interrupciones */
+	ptrCapture->dma.config.direction		= DMA_DIR_PERIPH_TO_MEM;
+	ptrCapture->dma.config.mode				= DMA_MODE_CIRCULAR;
+	ptrCapture->dma.config.dataSize			= DMA_DATASIZE_32BIT;
+	ptrCapture->dma.config.memIncrement		= 1;
+	ptrCapture->dma.config.priority			= DMA_PRIORITY_HIGH;
+	ptrCapture->dma.config.enableIntTC		= DMA_INTERRUPT_DISABLE;
+	ptrCapture->dma.config.enableIntHT		= DMA_INTERRUPT_DISABLE;
+	ptrCapture->dma.config.enableIntTE		= DMA_INTERRUPT_DISABLE;
+	dma_Config(&ptrCapture->dma);
+
+	ptrCapture->stats.periods = 0;
+	ptrCapture->stats.rejected = 0;
+	ptrCapture->stats.overruns = 0;
+}
+
+
+/*
+ * Enciende el DMA y el contador: desde aquí cada flanco queda guardado en el buffer
+ */
+void capture_Start(Capture_Handler_t *ptrCapture){
+
+	volatile uint32_t *ptrCCR = &ptrCapture->ptrTIMx->CCR1 + ptrCapture->config.channel;
+
+	dma_Start(&ptrCapture->dma, ptrCCR, ptrCapture->timestamps, CAPTURE_BUFFER_SIZE);
+	ptrCapture->ptrTIMx->CR1 |= TIM_CR1_CEN;
+	capture_Restart(ptrCapture);
+}
+
+
+/*
+ * Apaga el contador y el DMA
+ */
+void capture_Stop(Capture_Handler_t *ptrCapture){
+	ptrCapture->ptrTIMx->CR1 &= ~TIM_CR1_CEN;
+	dma_Stop(&ptrCapture->dma);
+	ptrCapture->confidence = 0;
+}
+
+
+/*
+ * Descarta los tiempos pendientes y el estado de los filtros, para empezar una medición
+ * nueva (por ejemplo, al cambiar de cuerda o después de una pausa larga del main)
+ */
+void capture_Restart(Capture_Handler_t *ptrCapture){
+	ptrCapture->readPosition = capture_get_write_position(ptrCapture);
+	ptrCapture->flagLast = 0;
+	ptrCapture->windowCount = 0;
+	ptrCapture->windowIndex = 0;
+	ptrCapture->filteredPeriod = 0.0f;
+	ptrCapture->confidence = 0;
+	ptrCapture->lastProcess = ptrCapture->ptrTIMx->CNT;
+}
+
+
+/*
+ * Toma los tiempos que llegaron desde el último llamado y actualiza el periodo filtrado.
+ * Se debe llamar antes de que el DMA llene el buffer (CAPTURE_BUFFER_SIZE capturas).
+ */
+void capture_Process(Capture_Handler_t *ptrCapture){
+
+	uint32_t now = ptrCapture->ptrTIMx->CNT;
+
+	/* 1. Si pasó tiempo suficiente para que el DMA diera la vuelta (a la frecuencia máxima),
+	 *    no se sabe qué tiempos son nuevos: se empieza de cero
+	 */
+	if((now - ptrCapture->lastProcess) >= ((CAPTURE_BUFFER_SIZE - 1) * ptrCapture->minPeriod)){
+		ptrCapture->stats.overruns++;
+		capture_Restart(ptrCapture);
+		return;
+	}
+	ptrCapture->lastProcess = now;
+
+	/* 2. Periodos entre los tiempos nuevos */
+	uint16_t writePosition = capture_get_write_position(ptrCapture);
+
+	while(ptrCapture->readPosition != writePosition){
+
+		uint32_t timestamp = ptrCapture->timestamps[ptrCapture->readPosition];
+		ptrCapture->readPosition = (ptrCapture->readPosition + 1) % CAPTURE_BUFFER_SIZE;
+
+		if(!ptrCapture->flagLast){
+			ptrCapture->lastTimestamp = timestamp;
+			ptrCapture->flagLast = 1;
+			continue;
+		}
+
+		uint32_t period = timestamp - ptrCapture->lastTimestamp;
+
+		/* Un flanco demasiado cercano es ruido: se ignora sin mover la referencia, así
+		 * el siguiente periodo se mide desde el flanco bueno
+		 */
+		if(period < ptrCapture->minPeriod){
+			ptrCapture->stats.rejected++;
+			continue;
+		}
+		ptrCapture->lastTimestamp = timestamp;
+
+		/* Uno demasiado largo (flancos perdidos o silencio) sólo mueve la referencia */
+		if(period > ptrCapture->maxPeriod){
+			ptrCapture->stats.rejected++;
+			continue;
+		}
+
+		ptrCapture->stats.periods++;
+		capture_add_period(ptrCapture, period);
+	}
+}
+
+
+/*
+ * Confianza de la medición (0 - 100): 0 si la ventana no está llena o si la señal dejó
+ * de llegar, y si no, menor mientras más dispersos estén los periodos de la ventana
+ */
+uint8_t capture_GetConfidence(Capture_Handler_t *ptrCapture){
+
+	if(ptrCapture->windowCount < CAPTURE_MEDIAN_SIZE){
+		return 0;
+	}
+	if((ptrCapture->ptrTIMx->CNT - ptrCapture->lastTimestamp) > (CAPTURE_TIMEOUT_PERIODS * ptrCapture->maxPeriod)){
+		return 0;
+	}
+	return ptrCapture->confidence;
+}
+
+
+/*
+ * Frecuencia filtrada en Hz (0 si la confianza es 0)
+ */
+float capture_GetFrequency(Capture_Handler_t *ptrCapture){
+
+	if((capture_GetConfidence(ptrCapture) == 0) || (ptrCapture->filteredPeriod <= 0.0f)){
+		return 0.0f;
+	}
+	return ((float)ptrCapture->timerFrequency * (float)(1u << ptrCapture->config.edgeDivider)) / ptrCapture->filteredPeriod;
+}
+
+
+/*
+ * Activa la señal de reloj del timer (los dos están en el APB1)
+ */
+static void capture_enable_clock_peripheral(Capture_Handler_t *ptrCapture){
+	if(ptrCapture->ptrTIMx == TIM2){
+		RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+	}
+	else if(ptrCapture->ptrTIMx == TIM5){
+		RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
+	}
+	else{
+		__NOP();
+	}
+}
+
+
+/*
+ * Stream y canal del DMA1 que atiende las capturas del canal (ver capture_driver_hal.h).
+ * Retorna 0 si el timer no es TIM2 ni TIM5.
+ */
+static uint8_t capture_set_dma_stream(Capture_Handler_t *ptrCapture){
+
+	static const uint8_t tim5Streams[4] = {2, 4, 0, 1};
+	static const uint8_t tim2Streams[4] = {5, 6, 1, 7};
+
+	uint8_t channel = ptrCapture->config.channel & 0x03;
+
+	if(ptrCapture->ptrTIMx == TIM5){
+		ptrCapture->dma.stream = tim5Streams[channel];
+		ptrCapture->dma.config.channel = 6;
+	}
+	else if(ptrCapture->ptrTIMx == TIM2){
+		ptrCapture->dma.stream = tim2Streams[channel];
+		ptrCapture->dma.config.channel = 3;
+	}
+	else{
+		return 0;
+	}
+
+	ptrCapture->dma.ptrDMAx = DMA1;
+	ptrCapture->dma.ptrStream = DMA1_Stream0 + ptrCapture->dma.stream;	// Los streams están seguidos en memoria
+	return 1;
+}
+
+
+/*
+ * CCxS = 01 (ICx en TIx), divisor y filtro en el CCMR, flanco en el CCER, y CCxDE
+ */
+static void capture_config_channel(Capture_Handler_t *ptrCapture){
+
+	uint8_t channel = ptrCapture->config.channel & 0x03;
+	uint8_t shiftCCMR = (channel & 0x01) * 8;
+	uint8_t shiftCCER = channel * 4;
+	volatile uint32_t *ptrCCMR = (channel < 2) ? &ptrCapture->ptrTIMx->CCMR1 : &ptrCapture->ptrTIMx->CCMR2;
+
+	uint32_t auxCCMR = (1UL << TIM_CCMR1_CC1S_Pos) |
+					   ((uint32_t)(ptrCapture->config.edgeDivider & 0x03) << TIM_CCMR1_IC1PSC_Pos) |
+					   ((uint32_t)(ptrCapture->config.filter & 0x0F) << TIM_CCMR1_IC1F_Pos);
+
+	/* 1. El canal debe estar apagado (CCxE = 0) para cambiar CCxS */
+	ptrCapture->ptrTIMx->CCER &= ~(0x0FUL << shiftCCER);
+
+	*ptrCCMR &= ~(0xFFUL << shiftCCMR);
+	*ptrCCMR |= auxCCMR << shiftCCMR;
+
+	/* 2. Flanco: CCxP = 1 -> bajada (CCxNP queda en 0) */
+	uint32_t auxCCER = TIM_CCER_CC1E;
+	if(ptrCapture->config.edge == CAPTURE_EDGE_FALLING){
+		auxCCER |= TIM_CCER_CC1P;
+	}
+	ptrCapture->ptrTIMx->CCER |= auxCCER << shiftCCER;
+
+	/* 3. Cada captura pide una transferencia al DMA */
+	ptrCapture->ptrTIMx->DIER |= (TIM_DIER_CC1DE << channel);
+}
+
+
+/*
+ * Reloj de los timers del APB1: el doble del PCLK1 si el APB1 está dividido
+ */
+static uint32_t capture_get_timer_clock(void){
+
+	uint32_t pclk1 = pll_GetPclk1();
+
+	if(pclk1 != pll_GetHclk()){
+		return 2 * pclk1;
+	}
+	return pclk1;
+}
+
+
+/*
+ * Posición del buffer que el DMA va a escribir a continuación
+ */
+static uint16_t capture_get_write_position(Capture_Handler_t *ptrCapture){
+	return (uint16_t)((CAPTURE_BUFFER_SIZE - dma_GetRemaining(&ptrCapture->dma)) % CAPTURE_BUFFER_SIZE);
+}
+
+
+/*
+ * Guarda el periodo en la ventana y, con la ventana llena, pasa la mediana por el IIR
+ * y actualiza la confianza
+ */
+static void capture_add_period(Capture_Handler_t *ptrCapture, uint32_t period){
+
+	/* 1. Ventana circular de los últimos periodos */
+	ptrCapture->window[ptrCapture->windowIndex] = period;
+	ptrCapture->windowIndex = (ptrCapture->windowIndex + 1) % CAPTURE_MEDIAN_SIZE;
+	if(ptrCapture->windowCount < CAPTURE_MEDIAN_SIZE){
+		ptrCapture->windowCount++;
+		if(ptrCapture->windowCount < CAPTURE_MEDIAN_SIZE){
+			return;
+		}
+	}
+
+	/* 2. La mediana quita los periodos sueltos (armónicos, rebotes) y el IIR suaviza */
+	uint32_t min = 0;
+	uint32_t max = 0;
+	float median = (float)capture_median(ptrCapture, &min, &max);
+
+	if(ptrCapture->filteredPeriod <= 0.0f){
+		ptrCapture->filteredPeriod = median;
+	}
+	else{
+		ptrCapture->filteredPeriod += ptrCapture->config.alpha * (median - ptrCapture->filteredPeriod);
+	}
+
+	/* 3. Confianza: 100 con todos los periodos iguales, 0 con la dispersión máxima o más */
+	float spread = (float)(max - min) / median;
+	if((ptrCapture->config.maxSpread <= 0.0f) || (spread >= ptrCapture->config.maxSpread)){
+		ptrCapture->confidence = 0;
+	}
+	else{
+		ptrCapture->confidence = (uint8_t)(100.0f * (1.0f - (spread / ptrCapture->config.maxSpread)));
+	}
+}
+
+
+/*
+ * Mediana de la ventana (ordenada por inserción sobre una copia), con su mínimo y máximo
+ */
+static uint32_t capture_median(Capture_Handler_t *ptrCapture, uint32_t *ptrMin, uint32_t *ptrMax){
+
+	uint32_t sorted[CAPTURE_MEDIAN_SIZE];
+
+	for(uint8_t i = 0; i < CAPTURE_MEDIAN_SIZE; i++){
+		uint32_t value = ptrCapture->window[i];
+		int8_t j = (int8_t)i - 1;
+		while((j >= 0) && (sorted[j] > value)){
+			sorted[j + 1] = sorted[j];
+			j--;
+		}
+		sorted[j + 1] = value;
+	}
+
+	*ptrMin = sorted[0];
+	*ptrMax = sorted[CAPTURE_MEDIAN_SIZE - 1];
+	return sorted[CAPTURE_MEDIAN_SIZE / 2];
+}
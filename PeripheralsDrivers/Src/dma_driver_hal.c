@@ -0,0 +1,189 @@
+/*
+ * dma_driver_hal.c
+ *
+ *  Created on: Dec 9, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "dma_driver_hal.h"
+
+/* Posición de las banderas de cada stream dentro de LISR/HISR (streams 0-3 y 4-7) */
+static const uint8_t dmaFlagOffset[4] = {0, 6, 16, 22};
+
+/* === Headers for private functions === */
+static void dma_enable_clock_peripheral(DMA_Handler_t *ptrDmaHandler);
+static void dma_config_interrupt(DMA_Handler_t *ptrDmaHandler);
+static IRQn_Type dma_get_irq(DMA_Handler_t *ptrDmaHandler);
+
+
+/*
+ * Configura el stream (queda apagado hasta llamar dma_Start)
+ */
+void dma_Config(DMA_Handler_t *ptrDmaHandler){
+
+	/* 1. Activamos la señal de reloj del DMA */
+	dma_enable_clock_peripheral(ptrDmaHandler);
+
+	/* 2. El stream debe estar apagado para poder configurarlo */
+	dma_Stop(ptrDmaHandler);
+
+	/* 3. Canal, dirección, modo, tamaño de los datos y prioridad */
+	uint32_t auxCR = 0;
+	auxCR |= ((uint32_t)(ptrDmaHandler->config.channel & 0x07) << DMA_SxCR_CHSEL_Pos);
+	auxCR |= ((uint32_t)(ptrDmaHandler->config.priority & 0x03) << DMA_SxCR_PL_Pos);
+	auxCR |= ((uint32_t)(ptrDmaHandler->config.dataSize & 0x03) << DMA_SxCR_MSIZE_Pos);
+	auxCR |= ((uint32_t)(ptrDmaHandler->config.dataSize & 0x03) << DMA_SxCR_PSIZE_Pos);
+	auxCR |= ((uint32_t)(ptrDmaHandler->config.direction & 0x03) << DMA_SxCR_DIR_Pos);
+
+	if(ptrDmaHandler->config.memIncrement){
+		auxCR |= DMA_SxCR_MINC;
+	}
+	if(ptrDmaHandler->config.mode == DMA_MODE_CIRCULAR){
+		auxCR |= DMA_SxCR_CIRC;
+	}
+
+	/* 4. Interrupciones del stream */
+	if(ptrDmaHandler->config.enableIntTC == DMA_INTERRUPT_ENABLE){
+		auxCR |= DMA_SxCR_TCIE;
+	}
+	if(ptrDmaHandler->config.enableIntHT == DMA_INTERRUPT_ENABLE){
+		auxCR |= DMA_SxCR_HTIE;
+	}
+	if(ptrDmaHandler->config.enableIntTE == DMA_INTERRUPT_ENABLE){
+		auxCR |= DMA_SxCR_TEIE;
+	}
+
+	ptrDmaHandler->ptrStream->CR = auxCR;
+
+	/* 5. Modo directo (sin FIFO) */
+	ptrDmaHandler->ptrStream->FCR = 0;
+
+	/* 6. Limpiamos las banderas y matriculamos la interrupción en el NVIC */
+	dma_ClearFlags(ptrDmaHandler, DMA_FLAG_ALL);
+	dma_config_interrupt(ptrDmaHandler);
+}
+
+
+/*
+ * Carga las direcciones y la cantidad de datos, y enciende el stream
+ */
+void dma_Start(DMA_Handler_t *ptrDmaHandler, volatile void *peripheralAddress, void *memoryAddress, uint16_t length){
+
+	/* 1. Apagamos el stream (si está corriendo) y limpiamos las banderas */
+	dma_Stop(ptrDmaHandler);
+	dma_ClearFlags(ptrDmaHandler, DMA_FLAG_ALL);
+
+	/* 2. Direcciones y número de datos */
+	ptrDmaHandler->ptrStream->PAR = (uint32_t)peripheralAddress;
+	ptrDmaHandler->ptrStream->M0AR = (uint32_t)memoryAddress;
+	ptrDmaHandler->ptrStream->NDTR = length;
+
+	/* 3. Encendemos el stream */
+	ptrDmaHandler->ptrStream->CR |= DMA_SxCR_EN;
+}
+
+
+/*
+ * Apaga el stream y espera a que el hardware lo confirme
+ */
+void dma_Stop(DMA_Handler_t *ptrDmaHandler){
+	ptrDmaHandler->ptrStream->CR &= ~DMA_SxCR_EN;
+	while(ptrDmaHandler->ptrStream->CR & DMA_SxCR_EN){
+		__NOP();
+	}
+}
+
+
+/*
+ * Indica si el stream sigue encendido (en modo normal se apaga solo al terminar)
+ */
+uint8_t dma_IsEnabled(DMA_Handler_t *ptrDmaHandler){
+	return (ptrDmaHandler->ptrStream->CR & DMA_SxCR_EN) ? 1 : 0;
+}
+
+
+/*
+ * Datos que faltan por transferir (NDTR)
+ */
+uint16_t dma_GetRemaining(DMA_Handler_t *ptrDmaHandler){
+	return (uint16_t)ptrDmaHandler->ptrStream->NDTR;
+}
+
+
+/*
+ * Lee las banderas del stream (DMA_FLAG_xx)
+ */
+uint8_t dma_GetFlags(DMA_Handler_t *ptrDmaHandler){
+	uint32_t auxISR = (ptrDmaHandler->stream < 4) ? ptrDmaHandler->ptrDMAx->LISR : ptrDmaHandler->ptrDMAx->HISR;
+	return (auxISR >> dmaFlagOffset[ptrDmaHandler->stream & 0x03]) & DMA_FLAG_ALL;
+}
+
+
+/*
+ * Limpia las banderas indicadas (escribiendo 1 en LIFCR/HIFCR)
+ */
+void dma_ClearFlags(DMA_Handler_t *ptrDmaHandler, uint8_t flags){
+	uint32_t auxMask = (uint32_t)(flags & DMA_FLAG_ALL) << dmaFlagOffset[ptrDmaHandler->stream & 0x03];
+	if(ptrDmaHandler->stream < 4){
+		ptrDmaHandler->ptrDMAx->LIFCR = auxMask;
+	}
+	else{
+		ptrDmaHandler->ptrDMAx->HIFCR = auxMask;
+	}
+}
+
+
+/*
+ * Activa la señal de reloj del DMA1 o DMA2 (bus AHB1)
+ */
+static void dma_enable_clock_peripheral(DMA_Handler_t *ptrDmaHandler){
+	if(ptrDmaHandler->ptrDMAx == DMA1){
+		RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+	}
+	else if(ptrDmaHandler->ptrDMAx == DMA2){
+		RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+	}
+	else{
+		__NOP();
+	}
+}
+
+
+/*
+ * Matricula la interrupción del stream en el NVIC si se usa alguna interrupción.
+ * Usa la misma prioridad que los USART, para que el stream y el periférico
+ * que atiende no se interrumpan entre sí.
+ */
+static void dma_config_interrupt(DMA_Handler_t *ptrDmaHandler){
+
+	IRQn_Type auxIRQ = dma_get_irq(ptrDmaHandler);
+
+	if((ptrDmaHandler->config.enableIntTC == DMA_INTERRUPT_ENABLE) ||
+	   (ptrDmaHandler->config.enableIntHT == DMA_INTERRUPT_ENABLE) ||
+	   (ptrDmaHandler->config.enableIntTE == DMA_INTERRUPT_ENABLE)){
+		__NVIC_EnableIRQ(auxIRQ);
+		__NVIC_SetPriority(auxIRQ, 2);
+	}
+	else{
+		__NVIC_DisableIRQ(auxIRQ);
+	}
+}
+
+
+/*
+ * Número de interrupción de cada stream
+ */
+static IRQn_Type dma_get_irq(DMA_Handler_t *ptrDmaHandler){
+
+	static const IRQn_Type dma1Irq[8] = {DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+										 DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn};
+	static const IRQn_Type dma2Irq[8] = {DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+										 DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn};
+
+	if(ptrDmaHandler->ptrDMAx == DMA1){
+		return dma1Irq[ptrDmaHandler->stream & 0x07];
+	}
+	return dma2Irq[ptrDmaHandler->stream & 0x07];
+}
@@ -0,0 +1,159 @@
+/*
+ * encoder_driver_hal.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "systick_driver_hal.h"
+#include "encoder_driver_hal.h"
+
+/* === Headers for private functions === */
+static void encoder_enable_clock_peripheral(Encoder_Handler_t *ptrEncoder);
+
+
+/*
+ * Configura el timer en modo encoder y lo enciende. Los pines (CH1 y CH2 del timer)
+ * los configura el programa en función alternativa.
+ */
+void encoder_Config(Encoder_Handler_t *ptrEncoder){
+
+	/* 1. Activamos la señal de reloj del timer y lo apagamos para configurarlo */
+	encoder_enable_clock_peripheral(ptrEncoder);
+	ptrEncoder->ptrTIMx->CR1 = 0;
+
+	if(ptrEncoder->config.countsPerStep == 0){
+		ptrEncoder->config.countsPerStep = 1;
+	}
+
+	/* 2. CC1S = 01 y CC2S = 01 (TI1 y TI2 como entradas), con el mismo filtro en los dos */
+	uint32_t filter = ptrEncoder->config.filter & 0x0F;
+	ptrEncoder->ptrTIMx->CCER = 0;
+	ptrEncoder->ptrTIMx->CCMR1 = (1UL << TIM_CCMR1_CC1S_Pos) | (filter << TIM_CCMR1_IC1F_Pos) |
+								 (1UL << TIM_CCMR1_CC2S_Pos) | (filter << TIM_CCMR1_IC2F_Pos);
+
+	/* 3. Sentido: invertir TI1 cambia el sentido de la cuenta */
+	if(ptrEncoder->config.direction == ENCODER_DIRECTION_INVERTED){
+		ptrEncoder->ptrTIMx->CCER |= TIM_CCER_CC1P;
+	}
+
+	/* 4. SMS = 011: cuenta en los flancos de TI1 y TI2 (x4), sin prescaler, 16 bits */
+	ptrEncoder->ptrTIMx->SMCR = (0x3UL << TIM_SMCR_SMS_Pos);
+	ptrEncoder->ptrTIMx->PSC = 0;
+	ptrEncoder->ptrTIMx->ARR = 0xFFFF;
+	ptrEncoder->ptrTIMx->CNT = 0;
+
+	/* 5. Encendemos el contador: desde aquí cada paso se cuenta sin usar el procesador */
+	ptrEncoder->ptrTIMx->CR1 |= TIM_CR1_CEN;
+
+	ptrEncoder->lastCount = 0;
+	ptrEncoder->residual = 0;
+	ptrEncoder->velocity = 0.0f;
+	ptrEncoder->lastStepTick = systick_GetTicks32();
+}
+
+
+/*
+ * Descarta los pasos pendientes (por ejemplo, al entrar a un menú)
+ */
+void encoder_Reset(Encoder_Handler_t *ptrEncoder){
+	ptrEncoder->lastCount = (uint16_t)ptrEncoder->ptrTIMx->CNT;
+	ptrEncoder->residual = 0;
+	ptrEncoder->velocity = 0.0f;
+}
+
+
+/*
+ * Pasos desde el último llamado: positivos en un sentido y negativos en el otro
+ */
+int16_t encoder_GetDelta(Encoder_Handler_t *ptrEncoder){
+
+	/* 1. La resta de 16 bits con signo funciona aunque el contador dé la vuelta */
+	uint16_t count = (uint16_t)ptrEncoder->ptrTIMx->CNT;
+	int16_t counts = (int16_t)(uint16_t)(count - ptrEncoder->lastCount);
+	ptrEncoder->lastCount = count;
+
+	/* 2. Pasos completos; el resto queda para la siguiente lectura */
+	int16_t total = ptrEncoder->residual + counts;
+	int16_t steps = total / (int16_t)ptrEncoder->config.countsPerStep;
+	ptrEncoder->residual = total - (steps * (int16_t)ptrEncoder->config.countsPerStep);
+
+	return steps;
+}
+
+
+/*
+ * Como encoder_GetDelta, pero con el giro rápido cada paso vale accelMultiplier pasos
+ */
+int16_t encoder_GetDeltaAccel(Encoder_Handler_t *ptrEncoder){
+
+	int16_t steps = encoder_GetDelta(ptrEncoder);
+	uint32_t now = systick_GetTicks32();
+	uint32_t elapsed = now - ptrEncoder->lastStepTick;
+
+	if(steps == 0){
+		if(elapsed > ENCODER_VELOCITY_TIMEOUT){
+			ptrEncoder->velocity = 0.0f;
+		}
+		return 0;
+	}
+
+	/* 1. Velocidad: promedio entre la anterior y la de este intervalo (el primer paso
+	 *    después de una pausa cuenta como giro lento)
+	 */
+	if(elapsed > ENCODER_VELOCITY_TIMEOUT){
+		ptrEncoder->velocity = 0.0f;
+	}
+	else{
+		uint16_t absSteps = (steps < 0) ? (uint16_t)(-steps) : (uint16_t)steps;
+		float instant = (1000.0f * (float)absSteps) / (float)((elapsed == 0) ? 1 : elapsed);
+		ptrEncoder->velocity = 0.5f * (ptrEncoder->velocity + instant);
+	}
+	ptrEncoder->lastStepTick = now;
+
+	/* 2. Aceleración */
+	if((ptrEncoder->config.accelThreshold != 0) && (ptrEncoder->config.accelMultiplier > 1) &&
+	   (ptrEncoder->velocity >= (float)ptrEncoder->config.accelThreshold)){
+		steps *= (int16_t)ptrEncoder->config.accelMultiplier;
+	}
+	return steps;
+}
+
+
+/*
+ * Velocidad de giro en pasos/s (la actualiza encoder_GetDeltaAccel)
+ */
+float encoder_GetVelocity(Encoder_Handler_t *ptrEncoder){
+
+	if((systick_GetTicks32() - ptrEncoder->lastStepTick) > ENCODER_VELOCITY_TIMEOUT){
+		return 0.0f;
+	}
+	return ptrEncoder->velocity;
+}
+
+
+/*
+ * Activa la señal de reloj del timer
+ */
+static void encoder_enable_clock_peripheral(Encoder_Handler_t *ptrEncoder){
+	if(ptrEncoder->ptrTIMx == TIM1){
+		RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
+	}
+	else if(ptrEncoder->ptrTIMx == TIM2){
+		RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+	}
+	else if(ptrEncoder->ptrTIMx == TIM3){
+		RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+	}
+	else if(ptrEncoder->ptrTIMx == TIM4){
+		RCC->APB1ENR |= RCC_APB1ENR_TIM4EN;
+	}
+	else if(ptrEncoder->ptrTIMx == TIM5){
+		RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
+	}
+	else{
+		__NOP();
+	}
+}
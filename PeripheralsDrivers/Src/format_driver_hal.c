@@ -0,0 +1,363 @@
+/*
+ * format_driver_hal.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include "format_driver_hal.h"
+
+#define FORMAT_NUMBER_LENGTH	12		// Dígitos de un uint32_t en decimal, con signo y relleno
+
+/* Potencias de 10 para los decimales */
+static const uint32_t formatPowers10[FORMAT_MAX_DECIMALS + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+static const char formatHexDigits[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+										 '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+/* === Headers for private functions === */
+static void format_write(Format_Writer_t *ptrWriter, const char *data, uint16_t length);
+static uint8_t format_digits(char *ptrEnd, uint32_t value);
+static void format_number(Format_Writer_t *ptrWriter, uint32_t value, uint8_t negative, uint8_t width, char pad);
+static void format_fraction(Format_Writer_t *ptrWriter, uint32_t fraction, uint8_t decimals);
+static void format_binary(Format_Writer_t *ptrWriter, uint32_t integer, uint64_t remainder, uint8_t shift,
+						  uint8_t negative, uint8_t decimals);
+
+
+/*
+ * Prepara el writer para escribir en un buffer del usuario
+ */
+void format_InitBuffer(Format_Writer_t *ptrWriter, char *buffer, uint16_t size){
+	ptrWriter->ptrBuffer = buffer;
+	ptrWriter->size = size;
+	ptrWriter->length = 0;
+	ptrWriter->flagOverflow = 0;
+	ptrWriter->ptrUsartHandler = 0;
+
+	if(size){
+		buffer[0] = '\0';
+	}
+}
+
+
+/*
+ * Prepara el writer para escribir directamente en el USART
+ */
+void format_InitUsart(Format_Writer_t *ptrWriter, USART_Handler_t *ptrUsartHandler){
+	ptrWriter->ptrBuffer = 0;
+	ptrWriter->size = 0;
+	ptrWriter->length = 0;
+	ptrWriter->flagOverflow = 0;
+	ptrWriter->ptrUsartHandler = ptrUsartHandler;
+}
+
+
+void format_Char(Format_Writer_t *ptrWriter, char character){
+	format_write(ptrWriter, &character, 1);
+}
+
+
+void format_String(Format_Writer_t *ptrWriter, const char *string){
+	uint16_t length = 0;
+	while(string[length] != '\0'){
+		length++;
+	}
+	format_write(ptrWriter, string, length);
+}
+
+
+/*
+ * Entero sin signo, con un ancho mínimo relleno con espacios o ceros
+ */
+void format_Uint(Format_Writer_t *ptrWriter, uint32_t value, uint8_t width, char pad){
+	format_number(ptrWriter, value, 0, width, pad);
+}
+
+
+/*
+ * Entero con signo, con un ancho mínimo (el signo cuenta dentro del ancho)
+ */
+void format_Int(Format_Writer_t *ptrWriter, int32_t value, uint8_t width, char pad){
+	if(value < 0){
+		/* Se niega en unsigned para que INT32_MIN no se desborde */
+		format_number(ptrWriter, 0u - (uint32_t)value, 1, width, pad);
+	}
+	else{
+		format_number(ptrWriter, (uint32_t)value, 0, width, pad);
+	}
+}
+
+
+/*
+ * Hexadecimal en mayúsculas con 'digits' dígitos (1 - 8), sin el prefijo 0x
+ */
+void format_Hex(Format_Writer_t *ptrWriter, uint32_t value, uint8_t digits){
+
+	char auxText[8];
+
+	if(digits == 0){
+		digits = 1;
+	}
+	if(digits > 8){
+		digits = 8;
+	}
+
+	for(uint8_t i = 0; i < digits; i++){
+		auxText[digits - 1 - i] = formatHexDigits[value & 0x0F];
+		value >>= 4;
+	}
+	format_write(ptrWriter, auxText, digits);
+}
+
+
+/*
+ * Número en punto flotante con 'decimals' decimales (0 - 6), igual que printf("%.*f"):
+ * se redondea el valor exacto del float (los empates van al par) y un negativo que
+ * redondea a cero conserva el signo ("-0.00"). No usa la FPU ni divisiones de 64 bits;
+ * los valores que no caben en 32 bits se escriben como "ovf".
+ */
+void format_Float(Format_Writer_t *ptrWriter, float value, uint8_t decimals){
+
+	if(decimals > FORMAT_MAX_DECIMALS){
+		decimals = FORMAT_MAX_DECIMALS;
+	}
+
+	/* 1. Casos especiales */
+	if(value != value){
+		format_write(ptrWriter, "nan", 3);
+		return;
+	}
+
+	union
+	{
+		float		value;
+		uint32_t	bits;
+	} auxFloat = {.value = value};
+
+	uint8_t negative = (uint8_t)(auxFloat.bits >> 31);	// También en -0.0f, como printf
+	if(negative){
+		value = -value;
+	}
+
+	if(value >= 4294967296.0f){	// 2^32 (el float anterior, 4294967040, todavía cabe)
+		format_write(ptrWriter, negative ? "-ovf" : "ovf", negative ? 4 : 3);
+		return;
+	}
+
+	/* 2. El float es exactamente mantissa * 2^exponent (24 bits de mantisa) */
+	uint32_t exponentBits = (auxFloat.bits >> 23) & 0xFF;
+	uint64_t mantissa = auxFloat.bits & 0x7FFFFF;
+	int16_t exponent = -149;				// Subnormal
+	if(exponentBits){
+		mantissa |= 0x800000;
+		exponent = (int16_t)exponentBits - 150;
+	}
+
+	/* 3. Parte entera y parte decimal en binario (remainder / 2^shift) */
+	if(exponent >= 0){
+		format_binary(ptrWriter, (uint32_t)(mantissa << exponent), 0, 0, negative, decimals);
+	}
+	else if(exponent > -64){
+		uint8_t shift = (uint8_t)(-exponent);
+		format_binary(ptrWriter, (uint32_t)(mantissa >> shift), mantissa & ((1ull << shift) - 1), shift, negative, decimals);
+	}
+	else{
+		// Menor que 2^-40: con 6 decimales ya es cero (y no puede ser un empate)
+		format_binary(ptrWriter, 0, 0, 0, negative, decimals);
+	}
+}
+
+
+/*
+ * Número en punto fijo (con signo, 'fractionBits' bits de parte decimal, por ejemplo
+ * 15 para q15 o 16 para q16.16) con 'decimals' decimales. No usa la FPU.
+ */
+void format_Fixed(Format_Writer_t *ptrWriter, int32_t value, uint8_t fractionBits, uint8_t decimals){
+
+	if(decimals > FORMAT_MAX_DECIMALS){
+		decimals = FORMAT_MAX_DECIMALS;
+	}
+	if(fractionBits > 31){
+		fractionBits = 31;
+	}
+
+	/* 1. Trabajamos con el valor absoluto */
+	uint8_t negative = (value < 0) ? 1 : 0;
+	uint32_t magnitude = negative ? (0u - (uint32_t)value) : (uint32_t)value;
+
+	/* 2. Parte entera y parte decimal, redondeadas como en format_Float */
+	uint32_t mask = (fractionBits == 0) ? 0 : ((1u << fractionBits) - 1);
+	format_binary(ptrWriter, magnitude >> fractionBits, magnitude & mask, fractionBits, negative, decimals);
+}
+
+
+/*
+ * Copia un texto en un buffer (truncando si no cabe) y retorna su longitud.
+ * Reemplaza a sprintf(buffer, "texto") cuando no hay nada que formatear.
+ */
+uint16_t format_Copy(char *buffer, uint16_t size, const char *string){
+
+	if(size == 0){
+		return 0;
+	}
+
+	uint16_t length = 0;
+	while((string[length] != '\0') && (length < (size - 1))){
+		buffer[length] = string[length];
+		length++;
+	}
+	buffer[length] = '\0';
+	return length;
+}
+
+
+void format_PutUint(Format_Writer_t *ptrWriter, uint32_t value){
+	format_number(ptrWriter, value, 0, 0, FORMAT_PAD_SPACE);
+}
+
+void format_PutInt(Format_Writer_t *ptrWriter, int32_t value){
+	format_Int(ptrWriter, value, 0, FORMAT_PAD_SPACE);
+}
+
+void format_PutFloat(Format_Writer_t *ptrWriter, float value){
+	format_Float(ptrWriter, value, FORMAT_DEFAULT_DECIMALS);
+}
+
+
+/*
+ * Escribe los caracteres en el destino del writer
+ */
+static void format_write(Format_Writer_t *ptrWriter, const char *data, uint16_t length){
+
+	/* 1. Directo al USART */
+	if(ptrWriter->ptrBuffer == 0){
+		if(ptrWriter->ptrUsartHandler != 0){
+			ptrWriter->length += usart_WriteBuffer(ptrWriter->ptrUsartHandler, (uint8_t *)data, length);
+		}
+		return;
+	}
+
+	/* 2. Al buffer, dejando espacio para el '\0' */
+	if(ptrWriter->size == 0){
+		ptrWriter->flagOverflow = 1;
+		return;
+	}
+
+	uint16_t space = ptrWriter->size - 1 - ptrWriter->length;
+	if(length > space){
+		length = space;
+		ptrWriter->flagOverflow = 1;
+	}
+
+	for(uint16_t i = 0; i < length; i++){
+		ptrWriter->ptrBuffer[ptrWriter->length + i] = data[i];
+	}
+	ptrWriter->length += length;
+	ptrWriter->ptrBuffer[ptrWriter->length] = '\0';
+}
+
+
+/*
+ * Escribe los dígitos decimales de 'value' hacia atrás, terminando en ptrEnd,
+ * y retorna cuántos dígitos escribió
+ */
+static uint8_t format_digits(char *ptrEnd, uint32_t value){
+	uint8_t count = 0;
+	do{
+		*(--ptrEnd) = '0' + (value % 10);
+		value /= 10;
+		count++;
+	} while(value);
+	return count;
+}
+
+
+/*
+ * Escribe un entero con su signo y el relleno hasta completar 'width'
+ */
+static void format_number(Format_Writer_t *ptrWriter, uint32_t value, uint8_t negative, uint8_t width, char pad){
+
+	char auxText[FORMAT_NUMBER_LENGTH];
+	char *ptrEnd = &auxText[FORMAT_NUMBER_LENGTH];
+
+	uint8_t length = format_digits(ptrEnd, value);
+	char *ptrStart = ptrEnd - length;
+
+	if(width > (FORMAT_NUMBER_LENGTH - 1)){
+		width = FORMAT_NUMBER_LENGTH - 1;
+	}
+
+	/* Con ceros el signo va antes del relleno (-0042); con espacios, después (  -42) */
+	if(negative && (pad == FORMAT_PAD_ZERO)){
+		format_write(ptrWriter, "-", 1);
+		if(width){
+			width--;
+		}
+	}
+	else if(negative){
+		*(--ptrStart) = '-';
+		length++;
+	}
+
+	while(length < width){
+		*(--ptrStart) = pad;
+		length++;
+	}
+
+	format_write(ptrWriter, ptrStart, length);
+}
+
+
+/*
+ * Escribe el punto y los decimales, con los ceros a la izquierda que hagan falta
+ */
+static void format_fraction(Format_Writer_t *ptrWriter, uint32_t fraction, uint8_t decimals){
+
+	if(decimals == 0){
+		return;
+	}
+
+	char auxText[FORMAT_MAX_DECIMALS + 1];
+	auxText[0] = '.';
+	for(uint8_t i = decimals; i > 0; i--){
+		auxText[i] = '0' + (fraction % 10);
+		fraction /= 10;
+	}
+	format_write(ptrWriter, auxText, decimals + 1);
+}
+
+
+/*
+ * Escribe integer + remainder / 2^shift (shift < 64, remainder < 2^32) con 'decimals'
+ * decimales. El redondeo es el de printf: al más cercano y, en un empate exacto, al
+ * dígito par. El signo se escribe aunque el valor redondee a cero.
+ */
+static void format_binary(Format_Writer_t *ptrWriter, uint32_t integer, uint64_t remainder, uint8_t shift,
+						  uint8_t negative, uint8_t decimals){
+
+	uint32_t fraction = 0;
+
+	if(shift){
+		/* remainder * 10^6 < 2^52: cabe en 64 bits */
+		uint64_t scaled = remainder * formatPowers10[decimals];
+		uint64_t rest = scaled & ((1ull << shift) - 1);
+		uint64_t half = 1ull << (shift - 1);
+		fraction = (uint32_t)(scaled >> shift);
+
+		/* El último dígito escrito es el de la fracción, o el de la parte entera sin decimales */
+		uint32_t lastDigit = decimals ? fraction : integer;
+		if((rest > half) || ((rest == half) && (lastDigit & 1))){
+			fraction++;
+		}
+
+		/* El redondeo puede llegar a la siguiente unidad (por ejemplo 1.996 con 2 decimales) */
+		if(fraction >= formatPowers10[decimals]){
+			fraction -= formatPowers10[decimals];
+			integer++;
+		}
+	}
+
+	format_number(ptrWriter, integer, negative, 0, FORMAT_PAD_SPACE);
+	format_fraction(ptrWriter, fraction, decimals);
+}
@@ -17,6 +17,21 @@ static void gpio_config_output_speed(GPIO_Handler_t *pGPIOHandler);
 static void gpio_config_pullup_pulldown(GPIO_Handler_t *pGPIOHandler);
 static void gpio_config_alternate_function(GPIO_Handler_t *pGPIOHandler);
 
+/* Máscaras y valores de los registros de un puerto, acumulados desde la tabla de la tarjeta */
+typedef struct
+{
+	uint16_t	pins;			// Pines del puerto que aparecen en la tabla
+	uint16_t	otyper;
+	uint32_t	mask2;			// Dos bits por pin (MODER, OSPEEDR y PUPDR)
+	uint32_t	moder;
+	uint32_t	ospeedr;
+	uint32_t	pupdr;
+	uint32_t	afrMask[2];
+	uint32_t	afr[2];
+} GPIO_BoardPort_t;
+
+static uint8_t gpio_board_accumulate(const GPIO_Board_t *pBoard, GPIO_BoardPort_t *pPorts);
+
 /*
  * Para cualquier periférico, hay varios pasos que siempre se deben
  * seguir en un orden estricto para poder que el sistema permita configurar
@@ -270,19 +285,105 @@ void gpio_WritePin(GPIO_Handler_t *pPinHandler, uint8_t newState){	// Función p
 	/* Verificamos si la acción que deseamos realizar es permitida */
 	assert_param(IS_GPIO_PIN_ACTION(newState));
 
-	/* Limpiams la posición que deseamos */
+	/* BSRR se escribe directamente (sin |=): los bits en 0 no cambian nada, así que
+	 * no hace falta leerlo y la escritura es atómica
+	 */
 	if(newState == SET){
 		//Trabajando con la parte baja del registro
-		pPinHandler->pGPIOx->BSRR |= (SET << pPinHandler->pinConfig.GPIO_PinNumber);
+		pPinHandler->pGPIOx->BSRR = (SET << pPinHandler->pinConfig.GPIO_PinNumber);
 	}
 	else{
 		//Trabajando con la parte alta del registro
-		pPinHandler->pGPIOx->BSRR |= (SET << (pPinHandler->pinConfig.GPIO_PinNumber + 16));
+		pPinHandler->pGPIOx->BSRR = (SET << (pPinHandler->pinConfig.GPIO_PinNumber + 16));
 	}
 
 }
 
 
+/*
+ * Escribe los pines de 'mask' de un puerto con un solo store en BSRR:
+ * los que tienen 1 en 'value' se encienden y los que tienen 0 se apagan
+ */
+void gpio_WritePort(GPIO_TypeDef *pGPIOx, uint16_t mask, uint16_t value){	// Función pública
+	pGPIOx->BSRR = ((uint32_t)(~value & mask) << 16) | (uint32_t)(value & mask);
+}
+
+
+/*
+ * Calcula los puertos del grupo y la máscara de pines de cada uno.
+ * Retorna 0 si el grupo usa más de GPIO_GROUP_MAX_PORTS puertos (o demasiados pines)
+ */
+uint8_t gpio_GroupConfig(GPIO_PinGroup_t *pGroup){	// Función pública
+
+	pGroup->numPorts = 0;
+
+	if(pGroup->numPins > GPIO_GROUP_MAX_PINS){
+		return 0;
+	}
+
+	for(uint8_t i = 0; i < pGroup->numPins; i++){
+
+		GPIO_TypeDef *pGPIOx = pGroup->pins[i]->pGPIOx;
+		uint8_t port = 0;
+
+		// Buscamos el puerto del pin entre los que ya tiene el grupo
+		while((port < pGroup->numPorts) && (pGroup->ports[port] != pGPIOx)){
+			port++;
+		}
+
+		if(port == pGroup->numPorts){
+			if(pGroup->numPorts == GPIO_GROUP_MAX_PORTS){
+				pGroup->numPorts = 0;
+				return 0;
+			}
+			pGroup->ports[port] = pGPIOx;
+			pGroup->portMasks[port] = 0;
+			pGroup->numPorts++;
+		}
+
+		pGroup->portMasks[port] |= (SET << pGroup->pins[i]->pinConfig.GPIO_PinNumber);
+	}
+
+	return 1;
+}
+
+
+/*
+ * Convierte un valor del grupo (bit i -> pins[i]) en la palabra BSRR de cada puerto
+ */
+void gpio_GroupEncode(GPIO_PinGroup_t *pGroup, uint32_t value, GPIO_GroupWord_t *pWord){	// Función pública
+
+	uint16_t portValues[GPIO_GROUP_MAX_PORTS] = {0};
+
+	// 1) Llevamos cada bit del valor a la posición de su pin, en su puerto
+	for(uint8_t i = 0; i < pGroup->numPins; i++){
+		if(value & (1UL << i)){
+			for(uint8_t port = 0; port < pGroup->numPorts; port++){
+				if(pGroup->ports[port] == pGroup->pins[i]->pGPIOx){
+					portValues[port] |= (SET << pGroup->pins[i]->pinConfig.GPIO_PinNumber);
+				}
+			}
+		}
+	}
+
+	// 2) Los pines del grupo en 0 van a la parte alta (apagar), y los que están en 1 a la baja
+	for(uint8_t port = 0; port < pGroup->numPorts; port++){
+		uint16_t mask = pGroup->portMasks[port];
+		pWord->bsrr[port] = ((uint32_t)(~portValues[port] & mask) << 16) | (uint32_t)(portValues[port] & mask);
+	}
+}
+
+
+/*
+ * Escribe un valor ya convertido: un store en BSRR por puerto del grupo
+ */
+void gpio_GroupWrite(GPIO_PinGroup_t *pGroup, GPIO_GroupWord_t *pWord){	// Función pública
+	for(uint8_t port = 0; port < pGroup->numPorts; port++){
+		pGroup->ports[port]->BSRR = pWord->bsrr[port];
+	}
+}
+
+
 /*
  * Función para leer el estado de un pin específico
  */
@@ -338,6 +439,122 @@ void gpio_TooglePin(GPIO_Handler_t *pPinHandler){
 }
 
 
+/*
+ * Revisa la tabla de la tarjeta sin tocar los registros (también corre en el PC).
+ * Retorna 0 si algún pin tiene un puerto o un valor inválido, o si aparece dos veces
+ */
+uint8_t gpio_CheckBoard(const GPIO_Board_t *pBoard){	// Función pública
+
+	GPIO_BoardPort_t ports[GPIO_BOARD_MAX_PORTS] = {0};
+
+	return gpio_board_accumulate(pBoard, ports);
+}
+
+
+/*
+ * Configura todos los pines de la tabla:
+ * 1) Arma las máscaras y valores de cada puerto en una sola pasada (si la tabla no es
+ *    válida, retorna 0 sin tocar ningún registro).
+ * 2) Activa la señal de reloj de todos los puertos usados con una sola escritura.
+ * 3) Escribe cada registro de cada puerto una vez. MODER va de último, así cada pin
+ *    cambia de modo con su tipo, velocidad, resistencias y función alternativa ya cargados.
+ */
+uint8_t gpio_ConfigBoard(const GPIO_Board_t *pBoard){	// Función pública
+
+	GPIO_BoardPort_t ports[GPIO_BOARD_MAX_PORTS] = {0};
+	uint32_t clocks = 0;
+
+	// 1) Máscaras y valores de cada puerto
+	if(!gpio_board_accumulate(pBoard, ports)){
+		return 0;
+	}
+
+	// 2) El bit de cada puerto en AHB1ENR es su posición (GPIOAEN = bit 0 ... GPIOHEN = bit 7)
+	for(uint8_t port = 0; port < GPIO_BOARD_MAX_PORTS; port++){
+		if(ports[port].pins){
+			clocks |= (SET << port);
+		}
+	}
+	RCC->AHB1ENR |= clocks;
+	(void)RCC->AHB1ENR;		// La lectura asegura que el reloj ya llegó antes de escribir los puertos
+
+	// 3) Un read-modify-write por registro y por puerto
+	for(uint8_t port = 0; port < GPIO_BOARD_MAX_PORTS; port++){
+
+		GPIO_BoardPort_t *pPort = &ports[port];
+		GPIO_TypeDef *pGPIOx = (GPIO_TypeDef *)(GPIOA_BASE + (port * 0x400UL));
+
+		if(pPort->pins == 0){
+			continue;
+		}
+
+		pGPIOx->AFR[0]	= (pGPIOx->AFR[0] & ~pPort->afrMask[0]) | pPort->afr[0];
+		pGPIOx->AFR[1]	= (pGPIOx->AFR[1] & ~pPort->afrMask[1]) | pPort->afr[1];
+		pGPIOx->OTYPER	= (pGPIOx->OTYPER & ~(uint32_t)pPort->pins) | pPort->otyper;
+		pGPIOx->OSPEEDR	= (pGPIOx->OSPEEDR & ~pPort->mask2) | pPort->ospeedr;
+		pGPIOx->PUPDR	= (pGPIOx->PUPDR & ~pPort->mask2) | pPort->pupdr;
+		pGPIOx->MODER	= (pGPIOx->MODER & ~pPort->mask2) | pPort->moder;
+	}
+
+	return 1;
+}
+
+
+/*
+ * Recorre la tabla una vez y acumula, por puerto, los bits que cambia cada pin y sus
+ * valores ya desplazados (lo mismo que hacen las funciones gpio_config_xx para un pin).
+ */
+static uint8_t gpio_board_accumulate(const GPIO_Board_t *pBoard, GPIO_BoardPort_t *pPorts){	// Función privada
+
+	for(uint8_t i = 0; i < pBoard->numPins; i++){
+
+		const GPIO_Handler_t *pPin = pBoard->pins[i];
+		const GPIO_PinConfig_t *pConfig = &pPin->pinConfig;
+		uintptr_t address = (uintptr_t)pPin->pGPIOx;
+
+		// El puerto debe ser uno de los GPIO del bus AHB1 (separados 0x400)
+		if((address < GPIOA_BASE) || (((address - GPIOA_BASE) % 0x400UL) != 0)){
+			return 0;
+		}
+		uintptr_t port = (address - GPIOA_BASE) / 0x400UL;
+		if(port >= GPIO_BOARD_MAX_PORTS){
+			return 0;
+		}
+
+		// Valores de la configuración (los mismos que revisa assert_param en gpio_Config)
+		if(!IS_GPIO_PIN(pConfig->GPIO_PinNumber) || !IS_GPIO_MODE(pConfig->GPIO_PinMode) ||
+		   !IS_GPIO_OUTPUT_TYPE(pConfig->GPIO_PinOutputType) || !IS_GPIO_OSPEED(pConfig->GPIO_PinOutputSpeed) ||
+		   !IS_GPIO_PUPDR(pConfig->GPIO_PinPuPdControl) || (pConfig->GPIO_PinAltFunMode > AF15)){
+			return 0;
+		}
+
+		// Un pin no se puede configurar dos veces
+		uint8_t pin = pConfig->GPIO_PinNumber;
+		GPIO_BoardPort_t *pPort = &pPorts[port];
+		if(pPort->pins & (SET << pin)){
+			return 0;
+		}
+
+		pPort->pins		|= (SET << pin);
+		pPort->otyper	|= (pConfig->GPIO_PinOutputType << pin);
+		pPort->mask2	|= (0b11UL << (2 * pin));
+		pPort->moder	|= ((uint32_t)pConfig->GPIO_PinMode << (2 * pin));
+		pPort->ospeedr	|= ((uint32_t)pConfig->GPIO_PinOutputSpeed << (2 * pin));
+		pPort->pupdr	|= ((uint32_t)pConfig->GPIO_PinPuPdControl << (2 * pin));
+
+		// La función alternativa sólo se carga en los pines ALTFN (como en gpio_Config)
+		if(pConfig->GPIO_PinMode == GPIO_MODE_ALTFN){
+			uint8_t reg = pin / 8;
+			uint8_t position = 4 * (pin % 8);
+			pPort->afrMask[reg] |= (0b1111UL << position);
+			pPort->afr[reg]		|= ((uint32_t)pConfig->GPIO_PinAltFunMode << position);
+		}
+	}
+
+	return 1;
+}
+
+
 /* =============== CONTADOR DE SEGUNDOS BINARIO UP-DOWN ===============
  *
  * La función máscara permíte obtener el valor a escribir en cada bit del reloj,
@@ -7,6 +7,16 @@
 
 #include <stdint.h>
 #include "i2c_driver_hal.h"
+#include "gpio_driver_hal.h"
+#include "pll_driver_hal.h"
+#include "systick_driver_hal.h"
+
+/* === Headers for private functions === */
+static void i2c_wait_us(I2C_Handler_t *ptrHandlerI2C, uint32_t time_us);
+static uint8_t i2c_wait_flag(I2C_Handler_t *ptrHandlerI2C, uint32_t flag, uint8_t errorCode);
+static uint8_t i2c_check_errors(I2C_Handler_t *ptrHandlerI2C);
+static uint8_t i2c_set_error(I2C_Handler_t *ptrHandlerI2C, uint8_t errorCode);
+static void i2c_abort_transaction(I2C_Handler_t *ptrHandlerI2C, uint8_t errorCode);
 
 /*
  * Recordar que se debe coonfigurar los pines parael I2C (SDA y SCL),
@@ -37,12 +47,15 @@ void i2c_Config(I2C_Handler_t *ptrHandlerI2C){
 	__NOP();
 	ptrHandlerI2C->ptrI2Cx->CR1 &= ~I2C_CR1_SWRST;
 
-	/* 3. Indicamos cuál es la velocidad del reloj principal, que es la señal
+	/* 3. Indicamos cuál es la velocidad del reloj del APB1, que es la señal
 	 * utilizada por el periférico para generar la señal de reloj para el
-	 * bus I2C
+	 * bus I2C (16 MHz con el HSI, 50 MHz con pll_Config_100MHz)
 	 */
+	uint32_t pclk1 = pll_GetPclk1();
+	uint32_t pclk1_MHz = pclk1 / 1000000UL;
+
 	ptrHandlerI2C->ptrI2Cx->CR2 &= ~I2C_CR2_FREQ; //Borramos la configuración prestablecida
-	ptrHandlerI2C->ptrI2Cx->CR2 |= (MAIN_CLOCK_16_MHz_FOR_I2C << I2C_CR2_FREQ_Pos); // Ponemos la frecuencia del CPU como la que usará el periférico
+	ptrHandlerI2C->ptrI2Cx->CR2 |= (pclk1_MHz << I2C_CR2_FREQ_Pos); // Ponemos la frecuencia del APB1 como la que usará el periférico
 
 	/* 4. Configuramos el modo I2C en el que el sistema funciona.
 	 * En esta configuración se incluye también la velocidad del reloj y el tiempo
@@ -62,52 +75,229 @@ void i2c_Config(I2C_Handler_t *ptrHandlerI2C){
 		// Estamos en el modo "Standar" (SM Mode)
 		ptrHandlerI2C->ptrI2Cx->CCR &= ~I2C_CCR_FS;
 
-		// Configuramos el registro que se encarga de generar la señal de reloj
-		ptrHandlerI2C->ptrI2Cx->CCR |= (I2C_MODE_SM_SPEED_100KHz << I2C_CCR_CCR_Pos);
+		// Configuramos el registro que se encarga de generar la señal de reloj:
+		// T_high = T_low = CCR * T_pclk1 (mínimo 4)
+		uint32_t ccr = (pclk1 + (2 * I2C_MODE_SM_SPEED_Hz) - 1) / (2 * I2C_MODE_SM_SPEED_Hz);
+		if(ccr < 4){
+			ccr = 4;
+		}
+		ptrHandlerI2C->ptrI2Cx->CCR |= (ccr << I2C_CCR_CCR_Pos);
 
-		// Configuramos el registro que controla el tiempo T-Rise máximo
-		ptrHandlerI2C->ptrI2Cx->TRISE |= I2C_MAX_RISE_TIME_SM;
+		// Configuramos el registro que controla el tiempo T-Rise máximo (en ciclos del APB1, más 1)
+		ptrHandlerI2C->ptrI2Cx->TRISE |= ((pclk1_MHz * I2C_MAX_RISE_TIME_SM_ns) / 1000UL) + 1;
 	}
 	else{
 		// Estamos en el modo "Fast" (SM Mode)
 		ptrHandlerI2C->ptrI2Cx->CCR |= I2C_CCR_FS;
 
-		// Configuramos el registro que se encarga de generar la señal de reloj
-		ptrHandlerI2C->ptrI2Cx->CCR |= (I2C_MODE_SM_SPEED_400KHz << I2C_CCR_CCR_Pos);
+		// Configuramos el registro que se encarga de generar la señal de reloj:
+		// con DUTY = 0, T_high + T_low = 3 * CCR * T_pclk1 (mínimo 1)
+		uint32_t ccr = (pclk1 + (3 * I2C_MODE_FM_SPEED_Hz) - 1) / (3 * I2C_MODE_FM_SPEED_Hz);
+		if(ccr < 1){
+			ccr = 1;
+		}
+		ptrHandlerI2C->ptrI2Cx->CCR |= (ccr << I2C_CCR_CCR_Pos);
+
+		// Configuramos el registro que controla el tiempo T-Rise máximo (en ciclos del APB1, más 1)
+		ptrHandlerI2C->ptrI2Cx->TRISE |= ((pclk1_MHz * I2C_MAX_RISE_TIME_FM_ns) / 1000UL) + 1;
+	}
 
-		// Configuramos el registro que controla el tiempo T-Rise máximo
-		ptrHandlerI2C->ptrI2Cx->TRISE |= I2C_MAX_RISE_TIME_FM;
+	/* 5. Calculamos el timeout de cada espera en ciclos del contador DWT, que cuenta
+	 * con el HCLK (16 MHz con el HSI, 100 MHz con el PLL)
+	 */
+	systick_EnableCycleCounter();
+	if(ptrHandlerI2C->timeout_us == 0){
+		ptrHandlerI2C->timeout_us = I2C_DEFAULT_TIMEOUT_us;
+	}
+	ptrHandlerI2C->cyclesPerUs = pll_GetHclk() / 1000000UL;
+	if(ptrHandlerI2C->cyclesPerUs == 0){
+		ptrHandlerI2C->cyclesPerUs = 1;
 	}
+	ptrHandlerI2C->timeoutCycles = ptrHandlerI2C->timeout_us * ptrHandlerI2C->cyclesPerUs;
+	ptrHandlerI2C->lastError = I2C_OK;
 
-	/* 5. Activamos el módulo I2C */
+	/* 6. Activamos el módulo I2C */
 	ptrHandlerI2C->ptrI2Cx->CR1 |= I2C_CR1_PE;
 
 
 } // Fin de la configuración del I2C
 
 
+/*
+ * Pausa corta (microsegundos) usada al generar los pulsos de la recuperación del bus
+ */
+static void i2c_wait_us(I2C_Handler_t *ptrHandlerI2C, uint32_t time_us){
+	uint32_t startCycles = DWT->CYCCNT;
+	while((DWT->CYCCNT - startCycles) < (time_us * ptrHandlerI2C->cyclesPerUs)){
+		__NOP();
+	}
+}
+
+
+/*
+ * Guarda el código de error en el handler y actualiza los contadores
+ */
+static uint8_t i2c_set_error(I2C_Handler_t *ptrHandlerI2C, uint8_t errorCode){
+	ptrHandlerI2C->lastError = errorCode;
+
+	if(errorCode == I2C_ERROR_NACK){
+		ptrHandlerI2C->stats.nacks++;
+	}
+	else if(errorCode != I2C_OK && errorCode != I2C_ERROR_BUS){
+		ptrHandlerI2C->stats.timeouts++;
+	}
+	return errorCode;
+}
+
+
+/*
+ * Revisa las banderas de error del SR1. Si el esclavo no respondió (AF) o
+ * hubo error de bus, se limpian las banderas y se devuelve el error.
+ */
+static uint8_t i2c_check_errors(I2C_Handler_t *ptrHandlerI2C){
+	uint32_t statusSR1 = ptrHandlerI2C->ptrI2Cx->SR1;
+
+	if(statusSR1 & I2C_SR1_AF){
+		ptrHandlerI2C->ptrI2Cx->SR1 &= ~I2C_SR1_AF;
+		return I2C_ERROR_NACK;
+	}
+	if(statusSR1 & (I2C_SR1_BERR | I2C_SR1_ARLO)){
+		ptrHandlerI2C->ptrI2Cx->SR1 &= ~(I2C_SR1_BERR | I2C_SR1_ARLO);
+		return I2C_ERROR_BUS;
+	}
+	return I2C_OK;
+}
+
+
+/*
+ * Espera a que se levante una bandera del SR1, con un tiempo máximo.
+ * Si se excede el timeout o aparece un error, devuelve el código del error.
+ */
+static uint8_t i2c_wait_flag(I2C_Handler_t *ptrHandlerI2C, uint32_t flag, uint8_t errorCode){
+	uint32_t startCycles = DWT->CYCCNT;
+	uint8_t auxError = I2C_OK;
+
+	while(!(ptrHandlerI2C->ptrI2Cx->SR1 & flag)){
+		auxError = i2c_check_errors(ptrHandlerI2C);
+		if(auxError != I2C_OK){
+			return i2c_set_error(ptrHandlerI2C, auxError);
+		}
+		if((DWT->CYCCNT - startCycles) > ptrHandlerI2C->timeoutCycles){
+			return i2c_set_error(ptrHandlerI2C, errorCode);
+		}
+	}
+	return I2C_OK;
+}
+
+
+/*
+ * Termina una transacción fallida: genera el "stop" y, si el error no fue
+ * un simple NACK (el bus quedó bloqueado), ejecuta la recuperación del bus
+ */
+static void i2c_abort_transaction(I2C_Handler_t *ptrHandlerI2C, uint8_t errorCode){
+	i2c_StopTransaction(ptrHandlerI2C);
+
+	if(errorCode != I2C_ERROR_NACK){
+		i2c_RecoverBus(ptrHandlerI2C);
+	}
+}
+
+
+/*
+ * Recuperación del bus: cuando un esclavo se queda sosteniendo SDA en bajo,
+ * se generan hasta 9 pulsos de SCL "a mano" (pines como GPIO) para que
+ * termine de enviar su byte, se genera una condición de "stop" y se
+ * reinicia el periférico. Si el handler no tiene los pines, sólo se
+ * reinicia el periférico.
+ */
+uint8_t i2c_RecoverBus(I2C_Handler_t *ptrHandlerI2C){
+
+	uint32_t startCycles = DWT->CYCCNT;
+	uint32_t elapsedCycles = 0;
+
+	/* 1. Apagamos el periférico para poder manejar los pines directamente */
+	ptrHandlerI2C->ptrI2Cx->CR1 &= ~I2C_CR1_PE;
+
+	if((ptrHandlerI2C->ptrPinSCL != 0) && (ptrHandlerI2C->ptrPinSDA != 0)){
+
+		/* 2. SCL como salida open-drain y SDA como entrada */
+		uint8_t auxModeSCL = ptrHandlerI2C->ptrPinSCL->pinConfig.GPIO_PinMode;
+		uint8_t auxModeSDA = ptrHandlerI2C->ptrPinSDA->pinConfig.GPIO_PinMode;
+
+		ptrHandlerI2C->ptrPinSCL->pinConfig.GPIO_PinMode = GPIO_MODE_OUT;
+		gpio_Config(ptrHandlerI2C->ptrPinSCL);
+		gpio_WritePin(ptrHandlerI2C->ptrPinSCL, SET);
+
+		ptrHandlerI2C->ptrPinSDA->pinConfig.GPIO_PinMode = GPIO_MODE_IN;
+		gpio_Config(ptrHandlerI2C->ptrPinSDA);
+
+		/* 3. Pulsos de reloj (100 kHz) hasta que el esclavo libere SDA */
+		for(uint8_t i = 0; (i < I2C_RECOVERY_CLOCK_PULSES) && !gpio_ReadPin(ptrHandlerI2C->ptrPinSDA); i++){
+			gpio_WritePin(ptrHandlerI2C->ptrPinSCL, RESET);
+			i2c_wait_us(ptrHandlerI2C, 5);
+			gpio_WritePin(ptrHandlerI2C->ptrPinSCL, SET);
+			i2c_wait_us(ptrHandlerI2C, 5);
+		}
+
+		/* 4. Condición de "stop": SDA pasa de bajo a alto mientras SCL está en alto */
+		ptrHandlerI2C->ptrPinSDA->pinConfig.GPIO_PinMode = GPIO_MODE_OUT;
+		gpio_Config(ptrHandlerI2C->ptrPinSDA);
+		gpio_WritePin(ptrHandlerI2C->ptrPinSCL, RESET);
+		gpio_WritePin(ptrHandlerI2C->ptrPinSDA, RESET);
+		i2c_wait_us(ptrHandlerI2C, 5);
+		gpio_WritePin(ptrHandlerI2C->ptrPinSCL, SET);
+		i2c_wait_us(ptrHandlerI2C, 5);
+		gpio_WritePin(ptrHandlerI2C->ptrPinSDA, SET);
+		i2c_wait_us(ptrHandlerI2C, 5);
+
+		/* 5. Devolvemos los pines a su función alternativa */
+		ptrHandlerI2C->ptrPinSCL->pinConfig.GPIO_PinMode = auxModeSCL;
+		ptrHandlerI2C->ptrPinSDA->pinConfig.GPIO_PinMode = auxModeSDA;
+		gpio_Config(ptrHandlerI2C->ptrPinSCL);
+		gpio_Config(ptrHandlerI2C->ptrPinSDA);
+	}
+
+	/* 6. Reiniciamos y volvemos a cargar la configuración del periférico */
+	i2c_Config(ptrHandlerI2C);
+
+	/* 7. Actualizamos los contadores de la recuperación */
+	elapsedCycles = DWT->CYCCNT - startCycles;
+	ptrHandlerI2C->stats.recoveries++;
+	ptrHandlerI2C->stats.lastRecoveryCycles = elapsedCycles;
+	if(elapsedCycles > ptrHandlerI2C->stats.maxRecoveryCycles){
+		ptrHandlerI2C->stats.maxRecoveryCycles = elapsedCycles;
+	}
+
+	if(ptrHandlerI2C->ptrI2Cx->SR2 & I2C_SR2_BUSY){
+		return i2c_set_error(ptrHandlerI2C, I2C_ERROR_BUSY);
+	}
+	return I2C_OK;
+
+} // Fin de la función i2c_RecoverBus
+
+
 /*
  * Función para iniciar la transmisión del I2C
  */
-void i2c_StartTransaction(I2C_Handler_t *ptrHandlerI2C){
+uint8_t i2c_StartTransaction(I2C_Handler_t *ptrHandlerI2C){
+
+	uint32_t startCycles = DWT->CYCCNT;
 
 	/* Solución a aparente problema al enciar al dirección del esclavo */
 	ptrHandlerI2C->ptrI2Cx->CR1 &= ~I2C_CR1_STOP;
 
 	/* 1. Verificamos que la línea no está ocupada - bit "Busy" del reg CR2 */
-	while(ptrHandlerI2C->ptrI2Cx->SR2 & I2C_SR2_BUSY){	// El ciclo se mantiene hasta que esté desocupada
-		__NOP();
+	while(ptrHandlerI2C->ptrI2Cx->SR2 & I2C_SR2_BUSY){	// El ciclo se mantiene hasta que esté desocupada o se acabe el tiempo
+		if((DWT->CYCCNT - startCycles) > ptrHandlerI2C->timeoutCycles){
+			return i2c_set_error(ptrHandlerI2C, I2C_ERROR_BUSY);
+		}
 	}
 
 	/* 2. Generamos la señal "start" */
 	ptrHandlerI2C->ptrI2Cx->CR1 |= I2C_CR1_START;
 
-	/* 2a. Esperamos a que la bandera del evento "start" se levante.
-	 * Mientras esperamos, el valor de SB es 0, entonces la negación (!) es 1.
-	 */
-	while(!(ptrHandlerI2C->ptrI2Cx->SR1 & I2C_SR1_SB)){
-		__NOP();
-	}
+	/* 2a. Esperamos a que la bandera del evento "start" se levante */
+	return i2c_wait_flag(ptrHandlerI2C, I2C_SR1_SB, I2C_ERROR_TIMEOUT_SB);
 
 } // Fin función i2c_StartTransaction
 
@@ -115,15 +305,13 @@ void i2c_StartTransaction(I2C_Handler_t *ptrHandlerI2C){
 /*
  * Función para empezar de nuevo la transacción
  */
-void i2c_ReStartTransaction(I2C_Handler_t *ptrHandlerI2C){
+uint8_t i2c_ReStartTransaction(I2C_Handler_t *ptrHandlerI2C){
 
 	/* 1. Generamos la señal de "start" */
 	ptrHandlerI2C->ptrI2Cx->CR1 |= I2C_CR1_START;
 
 	/* 2. Esperamos que se levante la bandera del evento "start" */
-	while(!(ptrHandlerI2C->ptrI2Cx->SR1 & I2C_SR1_SB)){
-		__NOP();
-	}
+	return i2c_wait_flag(ptrHandlerI2C, I2C_SR1_SB, I2C_ERROR_TIMEOUT_SB);
 
 } // Fin de la función i2c_ReStartTransaction
 
@@ -161,13 +349,14 @@ void i2c_SendNoAck(I2C_Handler_t *ptrHandlerI2C){
  * comunicar, y se indica si queremos Leer o Escribir en el dispositivo
  * con el que nos comunicamos a través del I2C.
  */
-void i2c_SendSlaveAddressRW(I2C_Handler_t *ptrHandlerI2C, uint8_t slaveAddress, uint8_t readOrWrite){
+uint8_t i2c_SendSlaveAddressRW(I2C_Handler_t *ptrHandlerI2C, uint8_t slaveAddress, uint8_t readOrWrite){
 
 	/* 0. Definimos una variable auxiliar para leer los
 	 * registros para la secuencia de la bandera del ADDR
 	 */
 	uint8_t auxByte = 0;
 	(void) auxByte;
+	uint8_t auxError = I2C_OK;
 
 	/* 1. Enviamos la dirección del Slave. En el bit menos significativo ponemos
 	 * el valor Lectura (1) o Escritura (0)
@@ -176,10 +365,12 @@ void i2c_SendSlaveAddressRW(I2C_Handler_t *ptrHandlerI2C, uint8_t slaveAddress,
 
 	/* 1a. Esperamos hasta que la bandera del evento ADDR se levante
 	 * (esto nos indica que la dirección fue enviada satisfactoriamente,
-	 * junto con el bit de Lectura o Escritura)
+	 * junto con el bit de Lectura o Escritura). Si el esclavo responde con
+	 * NACK, se levanta la bandera AF y la función devuelve el error.
 	 */
-	while(!(ptrHandlerI2C->ptrI2Cx->SR1 & I2C_SR1_ADDR)){
-		__NOP();
+	auxError = i2c_wait_flag(ptrHandlerI2C, I2C_SR1_ADDR, I2C_ERROR_TIMEOUT_ADDR);
+	if(auxError != I2C_OK){
+		return auxError;
 	}
 
 	/* 2. Debemos limpiar la bandera de la recepción de ACK del ADDR, para
@@ -188,112 +379,190 @@ void i2c_SendSlaveAddressRW(I2C_Handler_t *ptrHandlerI2C, uint8_t slaveAddress,
 	auxByte = ptrHandlerI2C->ptrI2Cx->SR1;
 	auxByte = ptrHandlerI2C->ptrI2Cx->SR2;
 
+	return I2C_OK;
+
 } // Fin del i2c_SendSlaveAddressRW
 
 
 /*
  * Función para enviar la dirección de memoria
  */
-void i2c_SendMemoryAddress(I2C_Handler_t *ptrHandlerI2C, uint8_t memAddress){
+uint8_t i2c_SendMemoryAddress(I2C_Handler_t *ptrHandlerI2C, uint8_t memAddress){
 	/* Enviamos la dirección de memoria que deseamos leer */
 	ptrHandlerI2C->ptrI2Cx->DR = memAddress;
 
 	/* Esperamos hasta que el byte sea transmitido */
-	while(!(ptrHandlerI2C->ptrI2Cx->SR1 & I2C_SR1_TXE)){
-		__NOP();
-	}
+	return i2c_wait_flag(ptrHandlerI2C, I2C_SR1_TXE, I2C_ERROR_TIMEOUT_TXE);
 }
 
 
 /*
  * Función para enviar un solo Byte al dispositivo Slave
  */
-void i2c_SendDataByte(I2C_Handler_t *ptrHandlerI2C, uint8_t dataToWrite){
+uint8_t i2c_SendDataByte(I2C_Handler_t *ptrHandlerI2C, uint8_t dataToWrite){
 	/* Cargamos el valor que deseamos escribir */
 	ptrHandlerI2C->ptrI2Cx->DR = dataToWrite;
 
 	/* Esperamos hasta que el byte sea transmitido */
-	while(!(ptrHandlerI2C->ptrI2Cx->SR1 & I2C_SR1_BTF)){
-		__NOP();
-	}
+	return i2c_wait_flag(ptrHandlerI2C, I2C_SR1_BTF, I2C_ERROR_TIMEOUT_BTF);
 }
 
 
 /*
- * Función para leer el byte recibido
+ * Función para leer el byte recibido.
+ * Devuelve el dato y deja en lastError el resultado de esta lectura: I2C_OK si el
+ * byte llegó, o el error del timeout (en ese caso el dato es 0). Así un error viejo
+ * no se confunde con el de esta lectura.
  */
 uint8_t i2c_ReadDataByte(I2C_Handler_t *ptrHandlerI2C){
 	/* Esperamos hasat que el byte entrante sea recibido */
-	while(!(ptrHandlerI2C->ptrI2Cx->SR1 & I2C_SR1_RXNE)){
-		__NOP();
+	if(i2c_wait_flag(ptrHandlerI2C, I2C_SR1_RXNE, I2C_ERROR_TIMEOUT_RXNE) != I2C_OK){
+		ptrHandlerI2C->dataI2C = 0;
+		return 0;
 	}
 
 	/* Devolvemos como salida de la función lo almacenado en el DR */
 	ptrHandlerI2C->dataI2C = ptrHandlerI2C->ptrI2Cx->DR;
+	ptrHandlerI2C->lastError = I2C_OK;
 	return ptrHandlerI2C->dataI2C;
 
 }
 
 
 /*
- * Función para leer un registro específico del dispositivo Slave
+ * Función para leer un registro específico del dispositivo Slave.
+ * Si la transacción falla se reintenta (recuperando el bus si es necesario);
+ * el resultado final queda en lastError.
  */
 uint8_t i2c_ReadSingleRegister(I2C_Handler_t *ptrHandlerI2C, uint8_t regToRead){
 
 	/* 0. Creamos una variable auxiliar para recibir el dato que leemos */
 	uint8_t auxRead = 0;
+	uint8_t auxError = I2C_OK;
+
+	ptrHandlerI2C->stats.transactions++;
+
+	for(uint8_t attempt = 0; attempt <= I2C_MAX_RETRIES; attempt++){
+
+		if(attempt > 0){
+			ptrHandlerI2C->stats.retries++;
+		}
+
+		/* 1. Generamos la condición de "Start" */
+		auxError = i2c_StartTransaction(ptrHandlerI2C);
+
+		/* 2. Enviamos la dirección del esclavo y la indicación de ESCRIBIR */
+		if(auxError == I2C_OK){
+			auxError = i2c_SendSlaveAddressRW(ptrHandlerI2C, ptrHandlerI2C->slaveAddress, I2C_WRITE_DATA);
+		}
+
+		/* 3. Enviamos la dirección de memoria que deseamos leer */
+		if(auxError == I2C_OK){
+			auxError = i2c_SendMemoryAddress(ptrHandlerI2C, regToRead);
+		}
+
+		/* 4. Creamos una condición de "Re-Start" */
+		if(auxError == I2C_OK){
+			auxError = i2c_ReStartTransaction(ptrHandlerI2C);
+		}
+
+		/* 5. Enviamos la dirección del esclavo y la indicación de LEER */
+		if(auxError == I2C_OK){
+			auxError = i2c_SendSlaveAddressRW(ptrHandlerI2C, ptrHandlerI2C->slaveAddress, I2C_READ_DATA);
+		}
+
+		/* 6. Leemos el dato que envia el esclavo */
+		if(auxError == I2C_OK){
+			auxRead = i2c_ReadDataByte(ptrHandlerI2C);
+			auxError = ptrHandlerI2C->lastError;	// Resultado de esta lectura (ReadDataByte siempre lo escribe)
+		}
+
+		if(auxError == I2C_OK){
+			/* 7. Generamos la condición de NoACK, para que el Master no responda y el slave
+			 * solo envíe 1 byte.
+			 */
+			i2c_SendNoAck(ptrHandlerI2C);
+
+			/* 8. Generamos la condición Stop, para que el slave se detenga después de 1 byte */
+			i2c_StopTransaction(ptrHandlerI2C);
+			break;
+		}
+
+		/* La transacción falló: liberamos el bus antes de reintentar */
+		i2c_abort_transaction(ptrHandlerI2C, auxError);
+	}
+
+	if(auxError != I2C_OK){
+		ptrHandlerI2C->stats.errors++;
+	}
+	ptrHandlerI2C->lastError = auxError;
 
-	/* 1. Generamos la condición de "Start" */
-	i2c_StartTransaction(ptrHandlerI2C);
+	/* 9. La función devuelve el dato enviado por el slave */
+	return auxRead;
 
-	/* 2. Enviamos la dirección del esclavo y la indicación de ESCRIBIR */
-	i2c_SendSlaveAddressRW(ptrHandlerI2C, ptrHandlerI2C->slaveAddress, I2C_WRITE_DATA);
+} // Fin de i2c_ReadSingleRegister
 
-	/* 3. Enviamos la dirección de memoria que deseamos leer */
-	i2c_SendMemoryAddress(ptrHandlerI2C, regToRead);
 
-	/* 4. Creamos una condición de "Re-Start" */
-	i2c_ReStartTransaction(ptrHandlerI2C);
+/*
+ * Función para escribir en un registro del dispositivo Slave
+ */
+uint8_t i2c_WriteSingleRegister(I2C_Handler_t *ptrHandlerI2C, uint8_t regToRead, uint8_t newValue){
+	return i2c_WriteBuffer(ptrHandlerI2C, regToRead, &newValue, 1);
 
-	/* 5. Enviamos la dirección del esclavo y la indicación de LEER */
-	i2c_SendSlaveAddressRW(ptrHandlerI2C, ptrHandlerI2C->slaveAddress, I2C_READ_DATA);
+} // Fin de i2c_WriteSingleRegister
 
-	/* 6. Leemos el dato que envia el esclavo */
-	auxRead = i2c_ReadDataByte(ptrHandlerI2C);
 
-	/* 7. Generamos la condición de NoACK, para que el Master no responda y el slave
-	 * solo envíe 1 byte.
-	 */
-	i2c_SendNoAck(ptrHandlerI2C);
+/*
+ * Función para escribir varios bytes seguidos a partir de una dirección de memoria
+ * (o byte de control) del Slave, en una sola transacción.
+ * Si la transacción falla se reintenta hasta I2C_MAX_RETRIES veces, recuperando
+ * el bus cuando queda bloqueado. Devuelve I2C_OK o el último error.
+ */
+uint8_t i2c_WriteBuffer(I2C_Handler_t *ptrHandlerI2C, uint8_t memAddress, uint8_t *data, uint16_t length){
 
-	/* 8. Generamos la condición Stop, para que el slave se detenga después de 1 byte */
-	i2c_StopTransaction(ptrHandlerI2C);
+	uint8_t auxError = I2C_OK;
 
-	/* 9. La función devuelve el dato enviado por el slave */
-	return auxRead;
+	ptrHandlerI2C->stats.transactions++;
 
-} // Fin de i2c_ReadSingleRegister
+	for(uint8_t attempt = 0; attempt <= I2C_MAX_RETRIES; attempt++){
 
+		if(attempt > 0){
+			ptrHandlerI2C->stats.retries++;
+		}
 
-/*
- * Función para escribir en un registro del dispositivo Slave
- */
-void i2c_WriteSingleRegister(I2C_Handler_t *ptrHandlerI2C, uint8_t regToRead, uint8_t newValue){
+		/* 1. Generamos la condición de "Start" */
+		auxError = i2c_StartTransaction(ptrHandlerI2C);
 
-	/* 1. Generamos la condición de "Start" */
-	i2c_StartTransaction(ptrHandlerI2C);
+		/* 2. Enviamos la dirección del esclavo y la indicación de ESCRIBIR */
+		if(auxError == I2C_OK){
+			auxError = i2c_SendSlaveAddressRW(ptrHandlerI2C, ptrHandlerI2C->slaveAddress, I2C_WRITE_DATA);
+		}
 
-	/* 2. Enviamos la dirección del esclavo y la indicación de ESCRIBIR */
-	i2c_SendSlaveAddressRW(ptrHandlerI2C, ptrHandlerI2C->slaveAddress, I2C_WRITE_DATA);
+		/* 3. Enviamos la dirección de memoria que deseamos escribir */
+		if(auxError == I2C_OK){
+			auxError = i2c_SendMemoryAddress(ptrHandlerI2C, memAddress);
+		}
 
-	/* 3. Enviamos la dirección de memoria que deseamos escribir */
-	i2c_SendMemoryAddress(ptrHandlerI2C, regToRead);
+		/* 4. Enviamos los valores que deseamos escribir */
+		for(uint16_t i = 0; (i < length) && (auxError == I2C_OK); i++){
+			auxError = i2c_SendDataByte(ptrHandlerI2C, data[i]);
+		}
 
-	/* 4. Enviamos el valor que deseamos escribir en el registro seleccionado */
-	i2c_SendDataByte(ptrHandlerI2C, newValue);
+		if(auxError == I2C_OK){
+			/* 5. Generamos la condición Stop */
+			i2c_StopTransaction(ptrHandlerI2C);
+			break;
+		}
 
-	/* 5. Generamos la condición Stop, para que el slave se detenga después de 1 byte */
-	i2c_StopTransaction(ptrHandlerI2C);
+		/* La transacción falló: liberamos el bus antes de reintentar */
+		i2c_abort_transaction(ptrHandlerI2C, auxError);
+	}
 
+	if(auxError != I2C_OK){
+		ptrHandlerI2C->stats.errors++;
+	}
+	ptrHandlerI2C->lastError = auxError;
 
-} // Fin de i2c_WriteSingleRegister
+	return auxError;
+
+} // Fin de i2c_WriteBuffer
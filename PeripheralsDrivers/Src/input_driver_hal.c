@@ -0,0 +1,214 @@
+/*
+ * input_driver_hal.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "stm32f4xx.h"
+#include "systick_driver_hal.h"
+#include "swtimer_driver_hal.h"
+#include "input_driver_hal.h"
+
+#define INPUT_QUEUE_MASK		(INPUT_QUEUE_SIZE - 1)
+#define INPUT_DEFAULT_PERIOD	5		// ms entre muestras si no se indica samplePeriod
+
+/* === Headers for private functions === */
+static void input_sample_callback(void *context);
+static void input_update_button(Input_Handler_t *ptrInput, uint8_t index, uint32_t now);
+static uint8_t input_read_button(Input_Button_t *ptrButton);
+static void input_post(Input_Handler_t *ptrInput, uint8_t type, uint8_t source, int16_t value, uint32_t now);
+
+
+/*
+ * Toma el estado actual de los pulsadores (sin eventos) y arranca el timer del muestreo.
+ * El encoder, si lo hay, ya debe estar configurado. Se llama una sola vez.
+ */
+void input_Config(Input_Handler_t *ptrInput){
+
+	/* 1. Periodo del muestreo */
+	if(ptrInput->samplePeriod == 0){
+		ptrInput->samplePeriod = INPUT_DEFAULT_PERIOD;
+	}
+
+	/* 2. Un pulsador presionado al arrancar no debe dar un PRESS */
+	for(uint8_t i = 0; i < ptrInput->numButtons; i++){
+		Input_Button_t *ptrButton = &ptrInput->ptrButtons[i];
+		ptrButton->pressed = input_read_button(ptrButton);
+		ptrButton->integrator = ptrButton->pressed ? INPUT_DEBOUNCE_SAMPLES : 0;
+		ptrButton->clicks = 0;
+		ptrButton->flagLong = 1;	// Tampoco un LONG_PRESS si sigue presionado
+	}
+
+	if(ptrInput->ptrEncoder != NULL){
+		encoder_Reset(ptrInput->ptrEncoder);
+	}
+
+	/* 3. Cola vacía */
+	ptrInput->head = 0;
+	ptrInput->tail = 0;
+	ptrInput->overflows = 0;
+
+	/* 4. Muestreo periódico sobre el SysTick */
+	ptrInput->timerId = swtimer_Start(ptrInput->samplePeriod, SWTIMER_PERIODIC, input_sample_callback, ptrInput);
+}
+
+
+/*
+ * Saca el evento más viejo de la cola. Retorna 0 si no hay eventos.
+ * Sólo se llama desde un único consumidor (el main).
+ */
+uint8_t input_GetEvent(Input_Handler_t *ptrInput, Input_Event_t *ptrEvent){
+
+	uint8_t tail = ptrInput->tail;
+
+	if(tail == ptrInput->head){
+		return 0;
+	}
+
+	*ptrEvent = ptrInput->events[tail & INPUT_QUEUE_MASK];
+
+	/* El evento se copia antes de liberar su posición para el productor */
+	__DMB();
+	ptrInput->tail = tail + 1;
+
+	return 1;
+}
+
+
+/*
+ * Eventos esperando en la cola
+ */
+uint8_t input_GetPending(Input_Handler_t *ptrInput){
+	return (uint8_t)(ptrInput->head - ptrInput->tail);
+}
+
+
+/*
+ * Descarta los eventos pendientes (por ejemplo, los que llegaron durante una medición)
+ */
+void input_Flush(Input_Handler_t *ptrInput){
+	ptrInput->tail = ptrInput->head;
+}
+
+
+/*
+ * Callback del timer por software (dentro del SysTick): actualiza los pulsadores y lee el encoder
+ */
+static void input_sample_callback(void *context){
+
+	Input_Handler_t *ptrInput = (Input_Handler_t *)context;
+	uint32_t now = systick_GetTicks32();
+
+	for(uint8_t i = 0; i < ptrInput->numButtons; i++){
+		input_update_button(ptrInput, i, now);
+	}
+
+	if(ptrInput->ptrEncoder != NULL){
+		int16_t steps = encoder_GetDeltaAccel(ptrInput->ptrEncoder);
+		if(steps != 0){
+			input_post(ptrInput, INPUT_EVENT_ROTATE, INPUT_SOURCE_ENCODER, steps, now);
+		}
+	}
+}
+
+
+/*
+ * Antirrebote y detección de clicks de un pulsador:
+ * 1. El contador se mueve una unidad hacia la muestra y el estado cambia sólo en los extremos.
+ * 2. Con el estado limpio se publican PRESS, RELEASE, LONG_PRESS, CLICK y DOUBLE_CLICK.
+ */
+static void input_update_button(Input_Handler_t *ptrInput, uint8_t index, uint32_t now){
+
+	Input_Button_t *ptrButton = &ptrInput->ptrButtons[index];
+
+	/* 1. Contador de muestras */
+	if(input_read_button(ptrButton)){
+		if(ptrButton->integrator < INPUT_DEBOUNCE_SAMPLES){
+			ptrButton->integrator++;
+		}
+	}
+	else if(ptrButton->integrator > 0){
+		ptrButton->integrator--;
+	}
+
+	/* 2. Cambios de estado */
+	if(!ptrButton->pressed && (ptrButton->integrator == INPUT_DEBOUNCE_SAMPLES)){
+		ptrButton->pressed = 1;
+		ptrButton->flagLong = 0;
+		ptrButton->pressTick = now;
+		input_post(ptrInput, INPUT_EVENT_PRESS, index, 0, now);
+	}
+	else if(ptrButton->pressed && (ptrButton->integrator == 0)){
+		ptrButton->pressed = 0;
+
+		uint32_t held = now - ptrButton->pressTick;
+		input_post(ptrInput, INPUT_EVENT_RELEASE, index, (held > INT16_MAX) ? INT16_MAX : (int16_t)held, now);
+
+		/* Un pulso largo (o uno que ya estaba presionado al arrancar) no cuenta como click */
+		if(ptrButton->flagLong){
+			ptrButton->clicks = 0;
+		}
+		else if(ptrButton->config.doubleClickTime == 0){
+			input_post(ptrInput, INPUT_EVENT_CLICK, index, 0, now);
+		}
+		else if(ptrButton->clicks == 1){
+			ptrButton->clicks = 0;
+			input_post(ptrInput, INPUT_EVENT_DOUBLE_CLICK, index, 0, now);
+		}
+		else{
+			ptrButton->clicks = 1;
+			ptrButton->releaseTick = now;
+		}
+	}
+
+	/* 3. Pulsación larga mientras se mantiene */
+	if(ptrButton->pressed && !ptrButton->flagLong && (ptrButton->config.longPressTime != 0) &&
+	   ((now - ptrButton->pressTick) >= ptrButton->config.longPressTime)){
+		ptrButton->flagLong = 1;
+		ptrButton->clicks = 0;
+		input_post(ptrInput, INPUT_EVENT_LONG_PRESS, index, 0, now);
+	}
+
+	/* 4. No llegó el segundo click a tiempo: era un click sencillo */
+	if(!ptrButton->pressed && (ptrButton->clicks == 1) &&
+	   ((now - ptrButton->releaseTick) >= ptrButton->config.doubleClickTime)){
+		ptrButton->clicks = 0;
+		input_post(ptrInput, INPUT_EVENT_CLICK, index, 0, now);
+	}
+}
+
+
+/*
+ * 1 si el pulsador está presionado (en la muestra actual, con rebotes)
+ */
+static uint8_t input_read_button(Input_Button_t *ptrButton){
+	uint8_t level = gpio_ReadPin(ptrButton->pGPIOHandler) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+	return (level == ptrButton->config.activeLevel);
+}
+
+
+/*
+ * Agrega un evento a la cola (sólo desde el productor). Con la cola llena se descarta.
+ */
+static void input_post(Input_Handler_t *ptrInput, uint8_t type, uint8_t source, int16_t value, uint32_t now){
+
+	uint8_t head = ptrInput->head;
+
+	if((uint8_t)(head - ptrInput->tail) >= INPUT_QUEUE_SIZE){
+		ptrInput->overflows++;
+		return;
+	}
+
+	Input_Event_t *ptrEvent = &ptrInput->events[head & INPUT_QUEUE_MASK];
+	ptrEvent->type = type;
+	ptrEvent->source = source;
+	ptrEvent->value = value;
+	ptrEvent->tick = now;
+
+	/* El evento queda escrito antes de que el consumidor vea el nuevo head */
+	__DMB();
+	ptrInput->head = head + 1;
+}
@@ -9,3 +9,144 @@
 #include "stm32f4xx.h"
 #include "pll_driver_hal.h"
 
+/* Divisores del AHB (HPRE = 8 - 15) y de los APB (PPRE = 4 - 7) */
+static const uint16_t ahbPrescaler[8] = {2, 4, 8, 16, 64, 128, 256, 512};
+static const uint8_t apbPrescaler[4] = {2, 4, 8, 16};
+
+
+/*
+ * Configura el PLL para un reloj del sistema de 100 MHz a partir del HSI:
+ * 16 MHz / M(8) * N(100) / P(2) = 100 MHz, con el VCO en 200 MHz.
+ * El APB1 queda en 50 MHz (su máximo) y el APB2 en 100 MHz.
+ */
+void pll_Config_100MHz(void){
+
+	/* 1. Regulador en escala 1 (necesario para más de 84 MHz) */
+	RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+	PWR->CR |= PWR_CR_VOS;
+
+	/* 2. 3 wait states en la flash para 100 MHz a 3.3 V (RM0383, Tabla 5), con caché y prefetch */
+	FLASH->ACR = FLASH_ACR_LATENCY_3WS | FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN;
+	while((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_ACR_LATENCY_3WS){
+		__NOP();
+	}
+
+	/* 3. El PLL debe estar apagado para configurarlo. Si ya era el reloj del sistema
+	 * (la función se llama otra vez), primero se pasa al HSI: el PLL no se puede
+	 * apagar mientras alimenta al SYSCLK */
+	RCC->CR |= RCC_CR_HSION;
+	while(!(RCC->CR & RCC_CR_HSIRDY)){
+		__NOP();
+	}
+	RCC->CFGR &= ~RCC_CFGR_SW;
+	while((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_HSI){
+		__NOP();
+	}
+	RCC->CR &= ~RCC_CR_PLLON;
+	while(RCC->CR & RCC_CR_PLLRDY){
+		__NOP();
+	}
+
+	/* 4. Fuente HSI, M = 8, N = 100, P = 2 (PLLP = 0b00), Q = 4 */
+	RCC->PLLCFGR = (8 << RCC_PLLCFGR_PLLM_Pos) |
+				   (100 << RCC_PLLCFGR_PLLN_Pos) |
+				   (0 << RCC_PLLCFGR_PLLP_Pos) |
+				   (4 << RCC_PLLCFGR_PLLQ_Pos);
+
+	/* 5. Encendemos el PLL y esperamos a que se enganche */
+	RCC->CR |= RCC_CR_PLLON;
+	while(!(RCC->CR & RCC_CR_PLLRDY)){
+		__NOP();
+	}
+
+	/* 6. Divisores de los buses: AHB /1, APB1 /2, APB2 /1 */
+	RCC->CFGR &= ~(RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2);
+	RCC->CFGR |= RCC_CFGR_PPRE1_DIV2;
+
+	/* 7. El PLL pasa a ser el reloj del sistema */
+	RCC->CFGR &= ~RCC_CFGR_SW;
+	RCC->CFGR |= RCC_CFGR_SW_PLL;
+	while((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL){
+		__NOP();
+	}
+}
+
+
+/*
+ * Reloj del sistema en MHz
+ */
+uint8_t pll_Get_MainClock(void){
+	return (uint8_t)(pll_GetSysClock() / 1000000);
+}
+
+
+/*
+ * Reloj del sistema (SYSCLK) según la fuente seleccionada (SWS) y la configuración del PLL
+ */
+uint32_t pll_GetSysClock(void){
+
+	switch(RCC->CFGR & RCC_CFGR_SWS){
+	case RCC_CFGR_SWS_HSE:
+		return PLL_HSE_FREQUENCY;
+
+	case RCC_CFGR_SWS_PLL:
+	{
+		uint32_t auxPLLCFGR = RCC->PLLCFGR;
+		uint32_t source = (auxPLLCFGR & RCC_PLLCFGR_PLLSRC) ? PLL_HSE_FREQUENCY : PLL_HSI_FREQUENCY;
+		uint32_t pllM = (auxPLLCFGR & RCC_PLLCFGR_PLLM) >> RCC_PLLCFGR_PLLM_Pos;
+		uint32_t pllN = (auxPLLCFGR & RCC_PLLCFGR_PLLN) >> RCC_PLLCFGR_PLLN_Pos;
+		uint32_t pllP = ((((auxPLLCFGR & RCC_PLLCFGR_PLLP) >> RCC_PLLCFGR_PLLP_Pos) + 1) * 2);
+
+		if(pllM == 0){
+			return PLL_HSI_FREQUENCY;
+		}
+		/* Dividimos primero por M: la entrada del VCO es entera (1 - 2 MHz) en las configuraciones usuales */
+		return ((source / pllM) * pllN) / pllP;
+	}
+
+	default:
+		return PLL_HSI_FREQUENCY;
+	}
+}
+
+
+/*
+ * Reloj del bus AHB (HCLK), que también alimenta al Cortex y al SysTick
+ */
+uint32_t pll_GetHclk(void){
+	uint32_t hpre = (RCC->CFGR & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos;
+	uint32_t sysClock = pll_GetSysClock();
+
+	if(hpre < 8){
+		return sysClock;
+	}
+	return sysClock / ahbPrescaler[hpre - 8];
+}
+
+
+/*
+ * Reloj del bus APB1
+ */
+uint32_t pll_GetPclk1(void){
+	uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+	uint32_t hclk = pll_GetHclk();
+
+	if(ppre1 < 4){
+		return hclk;
+	}
+	return hclk / apbPrescaler[ppre1 - 4];
+}
+
+
+/*
+ * Reloj del bus APB2
+ */
+uint32_t pll_GetPclk2(void){
+	uint32_t ppre2 = (RCC->CFGR & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos;
+	uint32_t hclk = pll_GetHclk();
+
+	if(ppre2 < 4){
+		return hclk;
+	}
+	return hclk / apbPrescaler[ppre2 - 4];
+}
@@ -0,0 +1,302 @@
+/*
+ * profiler_driver_hal.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "profiler_driver_hal.h"
+
+#if defined(__arm__)
+#include "pll_driver_hal.h"
+#include "systick_driver_hal.h"
+#else
+#include <time.h>
+#endif
+
+#define PROF_CALIBRATION_RUNS	16
+#define PROF_HIST_BAR			32		// Caracteres de la barra del bin más lleno
+
+Prof_Scope_t profScopes[PROF_MAX_SCOPES];
+uint32_t profOverhead = 0;
+
+static const char *const *profNames = NULL;
+static uint8_t profCount = 0;
+static uint32_t profFrequency = 0;
+
+/* === Headers for private functions === */
+static uint32_t prof_measure_frequency(void);
+static void prof_write_bar(Format_Writer_t *ptrWriter, uint32_t value, uint32_t maxValue);
+
+
+/*
+ * Enciende el contador de ciclos, mide el costo de PROF_BEGIN/PROF_END y guarda la
+ * tabla de nombres de las secciones (names[id])
+ */
+void prof_Init(const char *const *names, uint8_t count){
+
+	/* 1. En el Cortex-M4 se enciende el contador de ciclos del DWT. No se pone en 0 (otros
+	 * drivers lo pueden estar usando): las mediciones son restas, que aguantan la vuelta */
+#if defined(__arm__)
+	systick_EnableCycleCounter();
+#endif
+
+	profNames = names;
+	profCount = (count > PROF_MAX_SCOPES) ? PROF_MAX_SCOPES : count;
+	profFrequency = prof_measure_frequency();
+
+	/* 2. Costo de una medición vacía (el menor de varios intentos) */
+	profOverhead = 0;
+	uint32_t overhead = 0xFFFFFFFF;
+	for(uint8_t i = 0; i < PROF_CALIBRATION_RUNS; i++){
+		profScopes[0].count = 0;
+		profScopes[0].max = 0;
+		PROF_BEGIN(0);
+		PROF_END(0);
+		if(profScopes[0].min < overhead){
+			overhead = profScopes[0].min;
+		}
+	}
+	profOverhead = overhead;
+
+	prof_Reset();
+}
+
+
+/*
+ * Borra las estadísticas de todas las secciones
+ */
+void prof_Reset(void){
+	for(uint8_t i = 0; i < PROF_MAX_SCOPES; i++){
+		profScopes[i].count = 0;
+		profScopes[i].min = 0;
+		profScopes[i].max = 0;
+		profScopes[i].total = 0;
+	}
+}
+
+
+/*
+ * Escribe la tabla de las secciones que tienen mediciones:
+ *   nombre  veces  min  promedio  max (ciclos)  promedio (us)
+ */
+void prof_Dump(Format_Writer_t *ptrWriter){
+
+	float cyclesPerUs = (float)profFrequency / 1000000.0f;
+
+	format_String(ptrWriter, "seccion         veces        min   promedio        max   prom(us)\r\n");
+
+	for(uint8_t i = 0; i < profCount; i++){
+
+		Prof_Scope_t *ptrScope = &profScopes[i];
+		if(ptrScope->count == 0){
+			continue;
+		}
+		uint32_t mean = (uint32_t)(ptrScope->total / ptrScope->count);
+
+		/* El nombre se rellena a 12 caracteres */
+		const char *name = (profNames != NULL) ? profNames[i] : "?";
+		uint8_t length = 0;
+		while(name[length] != '\0'){
+			length++;
+		}
+		format_String(ptrWriter, name);
+		for(; length < 12; length++){
+			format_Char(ptrWriter, ' ');
+		}
+
+		format_Uint(ptrWriter, ptrScope->count, 9, FORMAT_PAD_SPACE);
+		format_Uint(ptrWriter, ptrScope->min, 11, FORMAT_PAD_SPACE);
+		format_Uint(ptrWriter, mean, 11, FORMAT_PAD_SPACE);
+		format_Uint(ptrWriter, ptrScope->max, 11, FORMAT_PAD_SPACE);
+		format_Char(ptrWriter, ' ');
+		format_Float(ptrWriter, (cyclesPerUs > 0.0f) ? ((float)mean / cyclesPerUs) : 0.0f, 2);
+		format_String(ptrWriter, "\r\n");
+	}
+
+	format_String(ptrWriter, "(");
+	format_Uint(ptrWriter, profFrequency, 0, FORMAT_PAD_SPACE);
+	format_String(ptrWriter, " ciclos/s, costo de medir ");
+	format_Uint(ptrWriter, profOverhead, 0, FORMAT_PAD_SPACE);
+	format_String(ptrWriter, " ciclos)\r\n");
+}
+
+
+/*
+ * Ciclos por segundo del contador que usan los macros
+ */
+uint32_t prof_GetFrequency(void){
+	return profFrequency;
+}
+
+
+/*
+ * Prepara un histograma: bins de binWidth ciclos a partir de base. Los intervalos
+ * mayores que limit se cuentan como pausas (0 -> sin límite).
+ */
+void prof_HistConfig(Prof_Histogram_t *ptrHist, uint32_t base, uint32_t binWidth, uint32_t limit){
+
+	ptrHist->base = base;
+	ptrHist->binWidth = (binWidth == 0) ? 1 : binWidth;
+	ptrHist->limit = limit;
+	prof_HistReset(ptrHist);
+}
+
+
+/*
+ * Borra las mediciones. El histograma se puede estar llenando desde una interrupción,
+ * así que se borra con las interrupciones apagadas
+ */
+void prof_HistReset(Prof_Histogram_t *ptrHist){
+
+#if defined(__arm__)
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+#endif
+
+	ptrHist->flagLast = 0;
+	ptrHist->count = 0;
+	ptrHist->min = 0;
+	ptrHist->max = 0;
+	ptrHist->total = 0;
+	ptrHist->gaps = 0;
+	for(uint8_t i = 0; i < PROF_HIST_BINS; i++){
+		ptrHist->bins[i] = 0;
+	}
+
+#if defined(__arm__)
+	__set_PRIMASK(primask);
+#endif
+}
+
+
+/*
+ * Promedio de las mediciones en ciclos (0 si no hay)
+ */
+float prof_HistGetMean(Prof_Histogram_t *ptrHist){
+
+	if(ptrHist->count == 0){
+		return 0.0f;
+	}
+	return (float)ptrHist->total / (float)ptrHist->count;
+}
+
+
+/*
+ * Escribe el resumen y los bins del histograma:
+ *   nombre: veces, min, promedio, max (ciclos), pausas
+ *   desde  hasta  veces  barra
+ */
+void prof_HistDump(Prof_Histogram_t *ptrHist, const char *name, Format_Writer_t *ptrWriter){
+
+	/* 1. Copia, para que la interrupción no cambie los valores mientras se escriben */
+	Prof_Histogram_t copy;
+#if defined(__arm__)
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+#endif
+	copy = *ptrHist;
+#if defined(__arm__)
+	__set_PRIMASK(primask);
+#endif
+
+	/* 2. Resumen */
+	format_String(ptrWriter, name);
+	format_String(ptrWriter, ": ");
+	format_Uint(ptrWriter, copy.count, 0, FORMAT_PAD_SPACE);
+	format_String(ptrWriter, " veces, min ");
+	format_Uint(ptrWriter, copy.min, 0, FORMAT_PAD_SPACE);
+	format_String(ptrWriter, ", prom ");
+	format_Float(ptrWriter, prof_HistGetMean(&copy), 1);
+	format_String(ptrWriter, ", max ");
+	format_Uint(ptrWriter, copy.max, 0, FORMAT_PAD_SPACE);
+	format_String(ptrWriter, " ciclos");
+	if(copy.gaps){
+		format_String(ptrWriter, ", ");
+		format_Uint(ptrWriter, copy.gaps, 0, FORMAT_PAD_SPACE);
+		format_String(ptrWriter, " pausas");
+	}
+	format_String(ptrWriter, "\r\n");
+
+	if(copy.count == 0){
+		return;
+	}
+
+	/* 3. Bins (el primero incluye lo que queda por debajo y el último lo que queda por encima) */
+	uint32_t maxBin = 0;
+	for(uint8_t i = 0; i < PROF_HIST_BINS; i++){
+		if(copy.bins[i] > maxBin){
+			maxBin = copy.bins[i];
+		}
+	}
+
+	for(uint8_t i = 0; i < PROF_HIST_BINS; i++){
+		uint32_t from = copy.base + (i * copy.binWidth);
+
+		if(i == 0){
+			format_String(ptrWriter, "          <");
+		}
+		else{
+			format_Uint(ptrWriter, from, 11, FORMAT_PAD_SPACE);
+		}
+		if(i == (PROF_HIST_BINS - 1)){
+			format_String(ptrWriter, "          >");
+		}
+		else{
+			format_Uint(ptrWriter, from + copy.binWidth, 11, FORMAT_PAD_SPACE);
+		}
+		format_Uint(ptrWriter, copy.bins[i], 10, FORMAT_PAD_SPACE);
+		prof_write_bar(ptrWriter, copy.bins[i], maxBin);
+		format_String(ptrWriter, "\r\n");
+	}
+}
+
+
+/*
+ * En el micro el DWT cuenta ciclos del HCLK. En el PC, rdtsc cuenta a una frecuencia
+ * fija que se mide contra clock_gettime, y clock_gettime cuenta ns.
+ */
+static uint32_t prof_measure_frequency(void){
+
+#if defined(__arm__)
+	return pll_GetHclk();
+
+#elif defined(__x86_64__) || defined(__i386__)
+	struct timespec start, now;
+	uint64_t elapsed_ns = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	uint64_t startCycles = __rdtsc();
+	while(elapsed_ns < 20000000ULL){
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		elapsed_ns = (uint64_t)(now.tv_sec - start.tv_sec) * 1000000000ULL + (uint64_t)(now.tv_nsec - start.tv_nsec);
+	}
+	uint64_t cycles = __rdtsc() - startCycles;
+
+	return (uint32_t)((cycles * 1000000000ULL) / elapsed_ns);
+
+#else
+	return 1000000000UL;
+#endif
+}
+
+
+/*
+ * Barra proporcional al bin más lleno (al menos un caracter si el bin tiene algo)
+ */
+static void prof_write_bar(Format_Writer_t *ptrWriter, uint32_t value, uint32_t maxValue){
+
+	if((value == 0) || (maxValue == 0)){
+		return;
+	}
+	format_Char(ptrWriter, ' ');
+	uint32_t length = (uint32_t)(((uint64_t)value * PROF_HIST_BAR) / maxValue);
+	if(length == 0){
+		length = 1;
+	}
+	while(length--){
+		format_Char(ptrWriter, '#');
+	}
+}
@@ -0,0 +1,223 @@
+/*
+ * scheduler_driver_hal.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "stm32f4xx.h"
+#include "systick_driver_hal.h"
+#include "scheduler_driver_hal.h"
+
+static Sched_Task_t *taskList = NULL;		// Ordenada de mayor a menor prioridad
+static Sched_Task_t *runningTask = NULL;	// Tarea que se está ejecutando (las tareas no son reentrantes)
+static uint32_t idleCount = 0;
+
+/* === Headers for private functions === */
+static void sched_check_timers(uint32_t now);
+static uint8_t sched_has_work(uint32_t now);
+
+
+/*
+ * Agrega una tarea al planificador (después de las que tienen su misma prioridad).
+ * Las tareas periódicas se ejecutan por primera vez un periodo después.
+ */
+void sched_AddTask(Sched_Task_t *ptrTask){
+
+	/* 1. Una tarea no se puede agregar dos veces */
+	for(Sched_Task_t *ptrAux = taskList; ptrAux != NULL; ptrAux = ptrAux->next){
+		if(ptrAux == ptrTask){
+			return;
+		}
+	}
+
+	ptrTask->runs = 0;
+	ptrTask->events = 0;
+	ptrTask->flagWake = 0;
+	if(ptrTask->period){
+		ptrTask->wakeTick = systick_GetTicks32() + ptrTask->period;
+		ptrTask->flagWake = 1;
+	}
+
+	/* 2. Buscamos su lugar según la prioridad */
+	Sched_Task_t **ptrLink = &taskList;
+	while((*ptrLink != NULL) && ((*ptrLink)->priority >= ptrTask->priority)){
+		ptrLink = &(*ptrLink)->next;
+	}
+	ptrTask->next = *ptrLink;
+	*ptrLink = ptrTask;
+}
+
+
+/*
+ * Publica eventos para una tarea. Se puede llamar desde las interrupciones.
+ */
+void sched_PostEvent(Sched_Task_t *ptrTask, uint32_t events){
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	ptrTask->events |= events;
+	__set_PRIMASK(primask);
+}
+
+
+/*
+ * La tarea recibe SCHED_EVENT_TIMER dentro de delay_ms (una sola vez; en una tarea
+ * periódica cambia el momento de la siguiente ejecución). Sólo desde el main o las tareas.
+ */
+void sched_WakeAfter(Sched_Task_t *ptrTask, uint32_t delay_ms){
+	ptrTask->wakeTick = systick_GetTicks32() + delay_ms;
+	ptrTask->flagWake = 1;
+}
+
+
+/*
+ * Ejecuta la tarea lista de mayor prioridad, si hay alguna.
+ * Retorna 1 si ejecutó una tarea, y 0 si no había trabajo.
+ */
+uint8_t sched_RunOnce(void){
+
+	/* 0. Desde una tarea (por ejemplo un sched_Delay_ms dentro de ella) no se ejecutan otras */
+	if(runningTask != NULL){
+		return 0;
+	}
+
+	/* 1. Publicamos los tiempos que vencieron */
+	sched_check_timers(systick_GetTicks32());
+
+	/* 2. La primera tarea con eventos es la de mayor prioridad (la lista está ordenada) */
+	Sched_Task_t *ptrTask = taskList;
+	while((ptrTask != NULL) && (ptrTask->events == 0)){
+		ptrTask = ptrTask->next;
+	}
+	if(ptrTask == NULL){
+		return 0;
+	}
+
+	/* 3. Tomamos sus eventos (una interrupción puede publicar más mientras se ejecuta) */
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint32_t events = ptrTask->events;
+	ptrTask->events = 0;
+	__set_PRIMASK(primask);
+
+	/* 4. La ejecutamos completa */
+	runningTask = ptrTask;
+	ptrTask->runs++;
+	ptrTask->function(ptrTask, events);
+	runningTask = NULL;
+
+	return 1;
+}
+
+
+/*
+ * Loop del planificador: ejecuta las tareas y duerme cuando no hay trabajo. No retorna.
+ */
+void sched_Run(void){
+	while(1){
+		sched_Yield();
+	}
+}
+
+
+/*
+ * Duerme hasta la siguiente interrupción si ninguna tarea tiene trabajo.
+ * Se revisa con las interrupciones apagadas: si una interrupción publica un evento
+ * justo después de la revisión, queda pendiente y WFI retorna de inmediato
+ * (WFI despierta con una interrupción pendiente aunque PRIMASK esté activo).
+ */
+void sched_Idle(void){
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if(!sched_has_work(systick_GetTicks32())){
+		idleCount++;
+		__WFI();
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+/*
+ * Ejecuta una tarea o, si no hay trabajo, duerme. Para los loops que esperan una
+ * bandera de una interrupción: while(!flagStop){ sched_Yield(); }
+ */
+void sched_Yield(void){
+	if(!sched_RunOnce()){
+		sched_Idle();
+	}
+}
+
+
+/*
+ * Espera sin detener las tareas: mientras pasa el tiempo se siguen ejecutando (y el
+ * procesador duerme cuando no hay trabajo). Desde una tarea sólo espera, sin ejecutar otras.
+ */
+void sched_Delay_ms(uint32_t wait_time_ms){
+
+	uint32_t startTick = systick_GetTicks32();
+
+	while((systick_GetTicks32() - startTick) < wait_time_ms){
+		sched_Yield();
+	}
+}
+
+
+/*
+ * Veces que el procesador se fue a dormir (para estimar el tiempo libre)
+ */
+uint32_t sched_GetIdleCount(void){
+	return idleCount;
+}
+
+
+/*
+ * Publica SCHED_EVENT_TIMER en las tareas cuyo tiempo ya pasó. Los tiempos se comparan
+ * con la resta, así funcionan aunque el contador de 32 bits dé la vuelta.
+ */
+static void sched_check_timers(uint32_t now){
+
+	for(Sched_Task_t *ptrTask = taskList; ptrTask != NULL; ptrTask = ptrTask->next){
+
+		if(!ptrTask->flagWake || ((int32_t)(now - ptrTask->wakeTick) < 0)){
+			continue;
+		}
+
+		if(ptrTask->period){
+			/* El siguiente periodo se cuenta desde el anterior; si la tarea se atrasó más
+			 * de un periodo, no se acumulan ejecuciones: se cuenta desde ahora
+			 */
+			ptrTask->wakeTick += ptrTask->period;
+			if((int32_t)(now - ptrTask->wakeTick) >= 0){
+				ptrTask->wakeTick = now + ptrTask->period;
+			}
+		}
+		else{
+			ptrTask->flagWake = 0;
+		}
+
+		sched_PostEvent(ptrTask, SCHED_EVENT_TIMER);
+	}
+}
+
+
+/*
+ * Revisa si alguna tarea tiene eventos o un tiempo vencido
+ */
+static uint8_t sched_has_work(uint32_t now){
+
+	for(Sched_Task_t *ptrTask = taskList; ptrTask != NULL; ptrTask = ptrTask->next){
+		if(ptrTask->events){
+			return 1;
+		}
+		if(ptrTask->flagWake && ((int32_t)(now - ptrTask->wakeTick) >= 0)){
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,329 @@
+/*
+ * sevenseg_driver_hal.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "stm32f4xx.h"
+#include "pll_driver_hal.h"
+#include "sevenseg_driver_hal.h"
+
+#define SEVENSEG_DMA_CHANNEL	6		// TIM1 en el DMA2 (Tabla 28 del reference manual)
+
+/* Streams del DMA2 de cada evento del TIM1, en el orden en que ocurren dentro del periodo */
+static DMA_Stream_TypeDef *const sevensegStreams[SEVENSEG_MAX_LANES] = {DMA2_Stream3, DMA2_Stream4, DMA2_Stream5};
+static const uint8_t sevensegStreamNumbers[SEVENSEG_MAX_LANES] = {3, 4, 5};
+static const uint32_t sevensegRequests[SEVENSEG_MAX_LANES] = {TIM_DIER_CC1DE, TIM_DIER_CC4DE, TIM_DIER_UDE};
+
+/* Segmentos de cada símbolo hexadecimal (0 - F) */
+static const uint8_t sevensegHexPatterns[16] = {
+		0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07,
+		0x7F, 0x67, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71
+};
+
+/* === Headers for private functions === */
+static uint8_t sevenseg_build_group(SevenSeg_Handler_t *ptrDisplay);
+static void sevenseg_order_lanes(SevenSeg_Handler_t *ptrDisplay);
+static void sevenseg_config_dma(SevenSeg_Handler_t *ptrDisplay);
+static void sevenseg_config_timer(SevenSeg_Handler_t *ptrDisplay);
+static void sevenseg_encode_phase(SevenSeg_Handler_t *ptrDisplay, uint8_t digit);
+static uint8_t sevenseg_first_lane(SevenSeg_Handler_t *ptrDisplay);
+static uint32_t sevenseg_get_timer_clock(void);
+
+
+/*
+ * Arma el grupo de pines, calcula las fases (todos los dígitos apagados) y configura el
+ * TIM1 y los streams del DMA2. No enciende nada hasta sevenseg_Start.
+ * Retorna 0 si la configuración no es válida (dígitos, o pines en más de 3 puertos).
+ */
+uint8_t sevenseg_Config(SevenSeg_Handler_t *ptrDisplay){
+
+	/* 1. Validamos la configuración */
+	if((ptrDisplay->config.numDigits == 0) || (ptrDisplay->config.numDigits > SEVENSEG_MAX_DIGITS)){
+		return 0;
+	}
+	if(ptrDisplay->config.phaseFrequency == 0){
+		return 0;
+	}
+
+	/* 2. Grupo de pines (segmentos y selección) y un stream por cada puerto */
+	if(!sevenseg_build_group(ptrDisplay)){
+		return 0;
+	}
+	sevenseg_order_lanes(ptrDisplay);
+
+	/* 3. Fases con todos los dígitos en blanco */
+	for(uint8_t digit = 0; digit < ptrDisplay->config.numDigits; digit++){
+		ptrDisplay->patterns[digit] = 0;
+		sevenseg_encode_phase(ptrDisplay, digit);
+	}
+
+	/* 4. Streams y timer */
+	sevenseg_config_dma(ptrDisplay);
+	sevenseg_config_timer(ptrDisplay);
+
+	return 1;
+}
+
+
+/*
+ * Enciende el multiplexado: desde aquí el DMA refresca los displays sin usar el procesador
+ */
+void sevenseg_Start(SevenSeg_Handler_t *ptrDisplay){
+
+	uint8_t first = sevenseg_first_lane(ptrDisplay);
+	uint32_t requests = 0;
+
+	/* 1. Cada stream empieza en la fase 0, así todos van en la misma fase */
+	for(uint8_t lane = 0; lane < ptrDisplay->group.numPorts; lane++){
+		dma_Start(&ptrDisplay->dma[lane], &ptrDisplay->group.ports[lane]->BSRR,
+				  ptrDisplay->phases[lane], ptrDisplay->config.numDigits);
+		requests |= sevensegRequests[first + lane];
+	}
+
+	/* 2. Peticiones de DMA de los eventos usados y encendemos el timer desde cero */
+	TIM1->CR1 &= ~TIM_CR1_CEN;
+	TIM1->CNT = 0;
+	TIM1->SR = 0;
+	TIM1->DIER = requests;
+	TIM1->CR1 |= TIM_CR1_CEN;
+}
+
+
+/*
+ * Detiene el multiplexado y deja todos los dígitos apagados
+ */
+void sevenseg_Stop(SevenSeg_Handler_t *ptrDisplay){
+
+	/* 1. Sin peticiones nuevas y streams apagados */
+	TIM1->CR1 &= ~TIM_CR1_CEN;
+	TIM1->DIER = 0;
+
+	for(uint8_t lane = 0; lane < ptrDisplay->group.numPorts; lane++){
+		dma_Stop(&ptrDisplay->dma[lane]);
+	}
+
+	/* 2. Apagamos los dígitos */
+	uint8_t offLevel = (ptrDisplay->config.digitActiveLevel == GPIO_PIN_SET) ? GPIO_PIN_RESET : GPIO_PIN_SET;
+	for(uint8_t digit = 0; digit < ptrDisplay->config.numDigits; digit++){
+		gpio_WritePin(ptrDisplay->digitPins[digit], offLevel);
+	}
+}
+
+
+/*
+ * Cambia los segmentos de un dígito (SEVENSEG_SEG_x). Sólo se recalcula su fase, y si el
+ * patrón no cambió no se toca el buffer, así se puede llamar en cada vuelta del main.
+ */
+void sevenseg_SetPattern(SevenSeg_Handler_t *ptrDisplay, uint8_t digit, uint8_t pattern){
+
+	if(digit >= ptrDisplay->config.numDigits){
+		return;
+	}
+	if(ptrDisplay->patterns[digit] == pattern){
+		return;
+	}
+
+	ptrDisplay->patterns[digit] = pattern;
+	sevenseg_encode_phase(ptrDisplay, digit);
+}
+
+
+/*
+ * Muestra un símbolo hexadecimal (0 - F) en un dígito, con o sin punto.
+ * Un valor mayor a 0xF deja el dígito en blanco (sólo el punto, si se pide).
+ */
+void sevenseg_SetDigit(SevenSeg_Handler_t *ptrDisplay, uint8_t digit, uint8_t value, uint8_t dot){
+
+	uint8_t pattern = (value < 16) ? sevensegHexPatterns[value] : 0;
+
+	if(dot){
+		pattern |= SEVENSEG_SEG_DP;
+	}
+	sevenseg_SetPattern(ptrDisplay, digit, pattern);
+}
+
+
+/*
+ * Carga el grupo: primero los segmentos (A - G y el punto, si lo hay) y luego los pines
+ * de selección, así el bit i del valor de una fase es el pin i del grupo.
+ */
+static uint8_t sevenseg_build_group(SevenSeg_Handler_t *ptrDisplay){
+
+	uint8_t numPins = 0;
+
+	ptrDisplay->numSegments = (ptrDisplay->segmentPins[SEVENSEG_SEGMENTS - 1] != NULL) ? SEVENSEG_SEGMENTS : (SEVENSEG_SEGMENTS - 1);
+
+	for(uint8_t i = 0; i < ptrDisplay->numSegments; i++){
+		if(ptrDisplay->segmentPins[i] == NULL){
+			return 0;
+		}
+		ptrDisplay->group.pins[numPins++] = ptrDisplay->segmentPins[i];
+	}
+
+	for(uint8_t i = 0; i < ptrDisplay->config.numDigits; i++){
+		if(ptrDisplay->digitPins[i] == NULL){
+			return 0;
+		}
+		ptrDisplay->group.pins[numPins++] = ptrDisplay->digitPins[i];
+	}
+
+	ptrDisplay->group.numPins = numPins;
+	return gpio_GroupConfig(&ptrDisplay->group);
+}
+
+
+/*
+ * Ordena los puertos del grupo: los que tienen pines de selección van al final, para que
+ * su stream sea el de los últimos eventos del periodo (el dígito nuevo se enciende cuando
+ * los segmentos ya cambiaron). gpio_GroupEncode busca cada pin por su puerto, así que el
+ * orden no cambia las palabras.
+ */
+static void sevenseg_order_lanes(SevenSeg_Handler_t *ptrDisplay){
+
+	GPIO_PinGroup_t *ptrGroup = &ptrDisplay->group;
+	uint8_t next = 0;
+
+	for(uint8_t pass = 0; pass < 2; pass++){
+		for(uint8_t port = next; port < ptrGroup->numPorts; port++){
+
+			uint8_t hasDigits = 0;
+			for(uint8_t i = 0; i < ptrDisplay->config.numDigits; i++){
+				if(ptrDisplay->digitPins[i]->pGPIOx == ptrGroup->ports[port]){
+					hasDigits = 1;
+				}
+			}
+
+			// Primera pasada: puertos sin selección. Segunda: el resto
+			if(hasDigits == pass){
+				GPIO_TypeDef *auxPort = ptrGroup->ports[next];
+				uint16_t auxMask = ptrGroup->portMasks[next];
+				ptrGroup->ports[next] = ptrGroup->ports[port];
+				ptrGroup->portMasks[next] = ptrGroup->portMasks[port];
+				ptrGroup->ports[port] = auxPort;
+				ptrGroup->portMasks[port] = auxMask;
+				next++;
+			}
+		}
+	}
+}
+
+
+/*
+ * Un stream circular por puerto: cada petición del timer copia la palabra de la fase
+ * siguiente en el BSRR. Sin interrupciones.
+ */
+static void sevenseg_config_dma(SevenSeg_Handler_t *ptrDisplay){
+
+	uint8_t first = sevenseg_first_lane(ptrDisplay);
+
+	for(uint8_t lane = 0; lane < ptrDisplay->group.numPorts; lane++){
+
+		DMA_Handler_t *ptrDma = &ptrDisplay->dma[lane];
+
+		ptrDma->ptrDMAx = DMA2;
+		ptrDma->ptrStream = sevensegStreams[first + lane];
+		ptrDma->stream = sevensegStreamNumbers[first + lane];
+		ptrDma->config.channel = SEVENSEG_DMA_CHANNEL;
+		ptrDma->config.direction = DMA_DIR_MEM_TO_PERIPH;
+		ptrDma->config.mode = DMA_MODE_CIRCULAR;
+		ptrDma->config.dataSize = DMA_DATASIZE_32BIT;
+		ptrDma->config.memIncrement = 1;
+		ptrDma->config.priority = DMA_PRIORITY_HIGH;
+		ptrDma->config.enableIntTC = DMA_INTERRUPT_DISABLE;
+		ptrDma->config.enableIntHT = DMA_INTERRUPT_DISABLE;
+		ptrDma->config.enableIntTE = DMA_INTERRUPT_DISABLE;
+
+		dma_Config(ptrDma);
+	}
+}
+
+
+/*
+ * TIM1 con un periodo por fase. Los canales 1 y 4 quedan en output compare "frozen" (sin
+ * pines) y sólo sirven para pedir DMA un ciclo (CCR1 = ARR - 1) y justo (CCR4 = ARR) antes
+ * del update, así los tres eventos de un periodo ocurren juntos y en orden.
+ */
+static void sevenseg_config_timer(SevenSeg_Handler_t *ptrDisplay){
+
+	/* 1. Activamos la señal de reloj del timer y lo apagamos para configurarlo */
+	RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
+	TIM1->CR1 = 0;
+	TIM1->CR2 = 0;
+	TIM1->DIER = 0;
+	TIM1->CCMR1 = 0;
+	TIM1->CCMR2 = 0;
+	TIM1->CCER = 0;
+
+	/* 2. Ciclos por fase, con el prescaler mínimo que deja el periodo en 16 bits */
+	uint32_t ticks = sevenseg_get_timer_clock() / ptrDisplay->config.phaseFrequency;
+	uint32_t prescaler = (ticks / 0x10000UL) + 1;
+	uint32_t period = ticks / prescaler;
+
+	if(period < 3){
+		period = 3;
+	}
+
+	TIM1->PSC = prescaler - 1;
+	TIM1->ARR = period - 1;
+	TIM1->CCR1 = period - 2;
+	TIM1->CCR4 = period - 1;
+	TIM1->RCR = 0;
+
+	/* 3. Cargamos el prescaler (UG) sin dejar pendiente la bandera */
+	TIM1->EGR = TIM_EGR_UG;
+	TIM1->SR = 0;
+}
+
+
+/*
+ * Recalcula las palabras BSRR de la fase de un dígito: sus segmentos (invertidos si se
+ * encienden con 0) y la selección con sólo ese dígito encendido.
+ */
+static void sevenseg_encode_phase(SevenSeg_Handler_t *ptrDisplay, uint8_t digit){
+
+	uint32_t segmentMask = (1UL << ptrDisplay->numSegments) - 1;
+	uint32_t digitMask = (1UL << ptrDisplay->config.numDigits) - 1;
+	uint32_t segments = ptrDisplay->patterns[digit];
+	uint32_t select = 1UL << digit;
+	GPIO_GroupWord_t word;
+
+	if(ptrDisplay->config.segmentActiveLevel == GPIO_PIN_RESET){
+		segments = ~segments;
+	}
+	if(ptrDisplay->config.digitActiveLevel == GPIO_PIN_RESET){
+		select = ~select;
+	}
+
+	gpio_GroupEncode(&ptrDisplay->group, (segments & segmentMask) | ((select & digitMask) << ptrDisplay->numSegments), &word);
+
+	/* Cada palabra es un store de 32 bits, así el DMA nunca lee una a medias */
+	for(uint8_t lane = 0; lane < ptrDisplay->group.numPorts; lane++){
+		ptrDisplay->phases[lane][digit] = word.bsrr[lane];
+	}
+}
+
+
+/*
+ * Evento del primer stream: con menos de 3 puertos se usan los últimos eventos
+ */
+static uint8_t sevenseg_first_lane(SevenSeg_Handler_t *ptrDisplay){
+	return SEVENSEG_MAX_LANES - ptrDisplay->group.numPorts;
+}
+
+
+/*
+ * Reloj de los timers del APB2: el doble del PCLK2 si el APB2 está dividido
+ */
+static uint32_t sevenseg_get_timer_clock(void){
+
+	uint32_t pclk2 = pll_GetPclk2();
+
+	if(pclk2 != pll_GetHclk()){
+		return 2 * pclk2;
+	}
+	return pclk2;
+}
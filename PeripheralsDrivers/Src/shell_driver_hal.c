@@ -0,0 +1,369 @@
+/*
+ * shell_driver_hal.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "shell_driver_hal.h"
+
+/* Estado de la recepción cuando se usa startChar */
+enum
+{
+	SHELL_RX_IDLE = 0,		// Los caracteres son del programa
+	SHELL_RX_LINE,			// Se está recibiendo una línea del shell
+	SHELL_RX_END_CR			// La línea terminó en '\r': un '\n' justo después también es del shell
+};
+
+/* === Headers for private functions === */
+static void shell_rx_push(Shell_Handler_t *ptrShell, char character);
+static void shell_execute(Shell_Handler_t *ptrShell);
+static uint8_t shell_is_space(char character);
+
+
+/*
+ * Prepara el shell: limpia los buffers, prepara el writer de las respuestas y
+ * revisa que la tabla de comandos esté ordenada
+ */
+void shell_Config(Shell_Handler_t *ptrShell){
+
+	/* 1. Buffers y contadores desde cero */
+	ptrShell->rxHead = 0;
+	ptrShell->rxTail = 0;
+	ptrShell->lineLength = 0;
+	ptrShell->flagDiscard = 0;
+	ptrShell->rxState = SHELL_RX_IDLE;
+	ptrShell->stats.commands = 0;
+	ptrShell->stats.errors = 0;
+	ptrShell->stats.overflows = 0;
+
+	/* 2. Las respuestas van directo al USART */
+	format_InitUsart(&ptrShell->writer, ptrShell->ptrUsartHandler);
+
+	/* 3. La búsqueda binaria necesita los nombres en orden estrictamente creciente */
+	ptrShell->flagSorted = 1;
+	for(uint8_t i = 1; i < ptrShell->numCommands; i++){
+		if(strcmp(ptrShell->ptrCommands[i - 1].name, ptrShell->ptrCommands[i].name) >= 0){
+			ptrShell->flagSorted = 0;
+			format_String(&ptrShell->writer, "shell: la tabla de comandos no esta ordenada\r\n");
+			break;
+		}
+	}
+}
+
+
+/*
+ * Recibe un caracter desde la interrupción del USART.
+ * Retorna 1 si el caracter es del shell, o 0 si es del programa (sólo con startChar).
+ */
+uint8_t shell_ReceiveChar(Shell_Handler_t *ptrShell, char character){
+
+	/* 1. Sin caracter de inicio todo es del shell */
+	if(ptrShell->startChar == 0){
+		shell_rx_push(ptrShell, character);
+		return 1;
+	}
+
+	/* 2. Fuera de una línea, sólo el caracter de inicio (y el '\n' de un "\r\n") es del shell */
+	if(ptrShell->rxState != SHELL_RX_LINE){
+		if((ptrShell->rxState == SHELL_RX_END_CR) && (character == '\n')){
+			ptrShell->rxState = SHELL_RX_IDLE;
+			return 1;
+		}
+		ptrShell->rxState = SHELL_RX_IDLE;
+
+		if(character == ptrShell->startChar){
+			ptrShell->rxState = SHELL_RX_LINE;
+			return 1;
+		}
+		return 0;
+	}
+
+	/* 3. Dentro de la línea, hasta el fin de línea */
+	if(character == '\r'){
+		ptrShell->rxState = SHELL_RX_END_CR;
+	}
+	else if(character == '\n'){
+		ptrShell->rxState = SHELL_RX_IDLE;
+	}
+	shell_rx_push(ptrShell, character);
+	return 1;
+}
+
+
+/*
+ * Se llama en el loop principal: arma la línea con lo que haya llegado y ejecuta
+ * como máximo un comando por llamado, para no demorar el resto del loop
+ */
+void shell_Process(Shell_Handler_t *ptrShell){
+
+	uint16_t tail = ptrShell->rxTail;
+
+	while(tail != ptrShell->rxHead){
+
+		char character = (char)ptrShell->rxBuffer[tail];
+		tail = (tail + 1) & SHELL_RX_BUFFER_MASK;
+
+		/* 1. Fin de línea: se ejecuta el comando (las líneas vacías se ignoran) */
+		if((character == '\r') || (character == '\n')){
+			if(ptrShell->flagDiscard){
+				ptrShell->flagDiscard = 0;
+				ptrShell->lineLength = 0;
+				format_String(&ptrShell->writer, "shell: linea demasiado larga\r\n");
+				continue;
+			}
+			if(ptrShell->lineLength == 0){
+				continue;
+			}
+
+			ptrShell->line[ptrShell->lineLength] = '\0';
+			ptrShell->rxTail = tail;
+			shell_execute(ptrShell);
+			ptrShell->lineLength = 0;
+			return;
+		}
+
+		/* 2. Borrar (backspace o DEL, según la terminal) */
+		if((character == '\b') || (character == 0x7F)){
+			if(ptrShell->lineLength){
+				ptrShell->lineLength--;
+			}
+			continue;
+		}
+
+		/* 3. Caracter normal: si no cabe, se descarta la línea completa */
+		if(ptrShell->flagDiscard){
+			continue;
+		}
+		if(ptrShell->lineLength >= (SHELL_LINE_SIZE - 1)){
+			ptrShell->flagDiscard = 1;
+
+			/* La interrupción también suma desbordes (shell_rx_push), así que el
+			 * incremento no se puede partir a la mitad */
+			uint32_t primask = __get_PRIMASK();
+			__disable_irq();
+			ptrShell->stats.overflows++;
+			__set_PRIMASK(primask);
+			continue;
+		}
+		ptrShell->line[ptrShell->lineLength++] = character;
+	}
+
+	ptrShell->rxTail = tail;
+}
+
+
+/*
+ * Busca un comando por nombre: búsqueda binaria si la tabla está ordenada,
+ * o lineal si no. Retorna NULL si no existe.
+ */
+const Shell_Command_t *shell_FindCommand(Shell_Handler_t *ptrShell, const char *name){
+
+	if(!ptrShell->flagSorted){
+		for(uint8_t i = 0; i < ptrShell->numCommands; i++){
+			if(strcmp(name, ptrShell->ptrCommands[i].name) == 0){
+				return &ptrShell->ptrCommands[i];
+			}
+		}
+		return NULL;
+	}
+
+	int16_t low = 0;
+	int16_t high = (int16_t)ptrShell->numCommands - 1;
+
+	while(low <= high){
+		int16_t middle = (low + high) / 2;
+		int compare = strcmp(name, ptrShell->ptrCommands[middle].name);
+
+		if(compare == 0){
+			return &ptrShell->ptrCommands[middle];
+		}
+		else if(compare < 0){
+			high = middle - 1;
+		}
+		else{
+			low = middle + 1;
+		}
+	}
+	return NULL;
+}
+
+
+/*
+ * Comando "help": lista los comandos de la tabla. Se agrega a la tabla del programa
+ * como cualquier otro comando.
+ */
+uint8_t shell_CommandHelp(Shell_Handler_t *ptrShell, uint8_t argc, char *argv[]){
+
+	(void)argc;
+	(void)argv;
+
+	for(uint8_t i = 0; i < ptrShell->numCommands; i++){
+		format_String(&ptrShell->writer, ptrShell->ptrCommands[i].name);
+		if(ptrShell->ptrCommands[i].help != NULL){
+			format_String(&ptrShell->writer, " - ");
+			format_String(&ptrShell->writer, ptrShell->ptrCommands[i].help);
+		}
+		format_String(&ptrShell->writer, "\r\n");
+	}
+	return SHELL_OK;
+}
+
+
+/*
+ * Entero sin signo en decimal
+ */
+uint8_t shell_ParseUint(const char *text, uint32_t *ptrValue){
+
+	uint32_t value = 0;
+
+	if((text == NULL) || (*text == '\0')){
+		return 0;
+	}
+
+	while(*text != '\0'){
+		if((*text < '0') || (*text > '9')){
+			return 0;
+		}
+		uint32_t digit = (uint32_t)(*text - '0');
+		if(value > ((0xFFFFFFFFu - digit) / 10)){
+			return 0;	// No cabe en 32 bits
+		}
+		value = (value * 10) + digit;
+		text++;
+	}
+
+	*ptrValue = value;
+	return 1;
+}
+
+
+/*
+ * Número con signo y decimales opcionales (por ejemplo -1.25), sin exponente
+ */
+uint8_t shell_ParseFloat(const char *text, float *ptrValue){
+
+	float value = 0.0f;
+	float scale = 1.0f;
+	uint8_t negative = 0;
+	uint8_t digits = 0;
+	uint8_t decimals = 0;
+
+	if(text == NULL){
+		return 0;
+	}
+
+	if((*text == '-') || (*text == '+')){
+		negative = (*text == '-');
+		text++;
+	}
+
+	while(*text != '\0'){
+		if((*text >= '0') && (*text <= '9')){
+			if(decimals){
+				scale *= 0.1f;
+				value += (float)(*text - '0') * scale;
+			}
+			else{
+				value = (value * 10.0f) + (float)(*text - '0');
+			}
+			digits++;
+		}
+		else if((*text == '.') && !decimals){
+			decimals = 1;
+		}
+		else{
+			return 0;
+		}
+		text++;
+	}
+
+	if(digits == 0){
+		return 0;
+	}
+
+	*ptrValue = negative ? -value : value;
+	return 1;
+}
+
+
+/*
+ * Guarda un caracter en el buffer circular (un productor: la interrupción)
+ */
+static void shell_rx_push(Shell_Handler_t *ptrShell, char character){
+
+	uint16_t next = (ptrShell->rxHead + 1) & SHELL_RX_BUFFER_MASK;
+
+	if(next == ptrShell->rxTail){
+		ptrShell->stats.overflows++;
+		return;
+	}
+	ptrShell->rxBuffer[ptrShell->rxHead] = (uint8_t)character;
+	ptrShell->rxHead = next;
+}
+
+
+/*
+ * Separa la línea en palabras sobre el mismo buffer y ejecuta el comando
+ */
+static void shell_execute(Shell_Handler_t *ptrShell){
+
+	char *argv[SHELL_MAX_ARGS];
+	uint8_t argc = 0;
+	char *ptrChar = ptrShell->line;
+
+	/* 1. Cada palabra termina en el primer espacio, que se cambia por '\0' */
+	while(*ptrChar != '\0'){
+		while(shell_is_space(*ptrChar)){
+			*ptrChar++ = '\0';
+		}
+		if(*ptrChar == '\0'){
+			break;
+		}
+		if(argc == SHELL_MAX_ARGS){
+			format_String(&ptrShell->writer, "shell: demasiados argumentos\r\n");
+			ptrShell->stats.errors++;
+			return;
+		}
+		argv[argc++] = ptrChar;
+		while((*ptrChar != '\0') && !shell_is_space(*ptrChar)){
+			ptrChar++;
+		}
+	}
+
+	if(argc == 0){
+		return;
+	}
+
+	/* 2. Buscamos el comando */
+	const Shell_Command_t *ptrCommand = shell_FindCommand(ptrShell, argv[0]);
+	if(ptrCommand == NULL){
+		format_String(&ptrShell->writer, "shell: comando desconocido '");
+		format_String(&ptrShell->writer, argv[0]);
+		format_String(&ptrShell->writer, "' (help lista los comandos)\r\n");
+		ptrShell->stats.errors++;
+		return;
+	}
+
+	/* 3. Lo ejecutamos */
+	ptrShell->stats.commands++;
+	switch(ptrCommand->function(ptrShell, argc, argv)){
+	case SHELL_OK:
+		break;
+	case SHELL_ERROR_ARGS:
+		format_String(&ptrShell->writer, "shell: argumentos incorrectos\r\n");
+		ptrShell->stats.errors++;
+		break;
+	default:
+		format_String(&ptrShell->writer, "shell: valor no valido\r\n");
+		ptrShell->stats.errors++;
+		break;
+	}
+}
+
+
+static uint8_t shell_is_space(char character){
+	return (character == ' ') || (character == '\t');
+}
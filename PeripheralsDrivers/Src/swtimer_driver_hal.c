@@ -0,0 +1,318 @@
+/*
+ * swtimer_driver_hal.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "stm32f4xx.h"
+#include "swtimer_driver_hal.h"
+
+/* Ranuras de cada nivel de la rueda */
+#define SWTIMER_L0_BITS		8
+#define SWTIMER_L1_BITS		6
+#define SWTIMER_L2_BITS		6
+#define SWTIMER_L0_SLOTS	(1 << SWTIMER_L0_BITS)
+#define SWTIMER_L1_SLOTS	(1 << SWTIMER_L1_BITS)
+#define SWTIMER_L2_SLOTS	(1 << SWTIMER_L2_BITS)
+#define SWTIMER_L1_SHIFT	SWTIMER_L0_BITS
+#define SWTIMER_L2_SHIFT	(SWTIMER_L0_BITS + SWTIMER_L1_BITS)
+
+/* Las ranuras de los tres niveles van seguidas en un solo arreglo */
+#define SWTIMER_L1_OFFSET	SWTIMER_L0_SLOTS
+#define SWTIMER_L2_OFFSET	(SWTIMER_L0_SLOTS + SWTIMER_L1_SLOTS)
+#define SWTIMER_SLOTS		(SWTIMER_L0_SLOTS + SWTIMER_L1_SLOTS + SWTIMER_L2_SLOTS)
+
+#define SWTIMER_NONE		0xFF	// Fin de una lista
+
+/* Timer de la rueda */
+typedef struct
+{
+	uint32_t			expires;	// Tick en el que vence
+	uint32_t			period;
+	SwTimer_Callback_t	callback;
+	void				*context;
+	uint16_t			slot;		// Ranura en la que está
+	uint8_t				next;
+	uint8_t				prev;
+	uint8_t				generation;	// Cambia cada vez que el timer se libera (invalida los id viejos)
+	uint8_t				oneShot;
+	uint8_t				active;
+} SwTimer_t;
+
+static SwTimer_t timers[SWTIMER_MAX_TIMERS];
+static uint8_t wheel[SWTIMER_SLOTS];
+static uint8_t freeList = SWTIMER_NONE;
+static uint8_t flagInit = 0;
+static uint8_t activeCount = 0;
+static uint32_t wheelTime = 0;		// Último tick procesado
+
+/* === Headers for private functions === */
+static void swtimer_init(void);
+static void swtimer_link(uint8_t index);
+static void swtimer_unlink(uint8_t index);
+static void swtimer_free(uint8_t index);
+static void swtimer_cascade(uint16_t slot);
+static int16_t swtimer_get_index(uint16_t timerId);
+
+
+/*
+ * Arranca un timer que vence cada 'period' ticks (o una sola vez con SWTIMER_ONE_SHOT).
+ * Retorna el id del timer, o SWTIMER_INVALID si no hay timers libres o falta el callback.
+ * El id de un timer de una sola vez deja de ser válido cuando vence.
+ */
+uint16_t swtimer_Start(uint32_t period, uint8_t oneShot, SwTimer_Callback_t callback, void *context){
+
+	if(callback == NULL){
+		return SWTIMER_INVALID;
+	}
+
+	/* 1. Un periodo de 0 vencería en el tick actual, que ya pasó */
+	if(period == 0){
+		period = 1;
+	}
+	if(period > SWTIMER_MAX_PERIOD){
+		period = SWTIMER_MAX_PERIOD;
+	}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if(!flagInit){
+		swtimer_init();
+	}
+
+	/* 2. Tomamos un timer libre */
+	uint8_t index = freeList;
+	if(index == SWTIMER_NONE){
+		__set_PRIMASK(primask);
+		return SWTIMER_INVALID;
+	}
+	freeList = timers[index].next;
+
+	/* 3. Lo cargamos y lo ponemos en la rueda */
+	timers[index].expires = wheelTime + period;
+	timers[index].period = period;
+	timers[index].callback = callback;
+	timers[index].context = context;
+	timers[index].oneShot = (oneShot == SWTIMER_ONE_SHOT);
+	timers[index].active = 1;
+	swtimer_link(index);
+	activeCount++;
+
+	uint16_t timerId = ((uint16_t)timers[index].generation << 8) | index;
+
+	__set_PRIMASK(primask);
+	return timerId;
+}
+
+
+/*
+ * Detiene un timer. Un id que ya no es válido se ignora.
+ */
+void swtimer_Stop(uint16_t timerId){
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	int16_t index = swtimer_get_index(timerId);
+	if(index >= 0){
+		swtimer_unlink((uint8_t)index);
+		swtimer_free((uint8_t)index);
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+/*
+ * Retorna 1 si el timer sigue activo
+ */
+uint8_t swtimer_IsActive(uint16_t timerId){
+	return swtimer_get_index(timerId) >= 0;
+}
+
+
+/*
+ * Timers activos (para revisar que SWTIMER_MAX_TIMERS alcanza)
+ */
+uint8_t swtimer_GetActiveCount(void){
+	return activeCount;
+}
+
+
+/*
+ * Avanza la rueda un tick y ejecuta los timers que vencen en este tick
+ */
+void swtimer_Tick(void){
+
+	if(!flagInit){
+		wheelTime++;
+		return;
+	}
+
+	wheelTime++;
+	uint8_t slot = wheelTime & (SWTIMER_L0_SLOTS - 1);
+
+	/* 1. Al dar la vuelta el nivel 0, bajamos la siguiente ranura del nivel 1 (y antes la del nivel 2) */
+	if(slot == 0){
+		uint8_t slotL1 = (wheelTime >> SWTIMER_L1_SHIFT) & (SWTIMER_L1_SLOTS - 1);
+		if(slotL1 == 0){
+			swtimer_cascade(SWTIMER_L2_OFFSET + ((wheelTime >> SWTIMER_L2_SHIFT) & (SWTIMER_L2_SLOTS - 1)));
+		}
+		swtimer_cascade(SWTIMER_L1_OFFSET + slotL1);
+	}
+
+	/* 2. Ejecutamos los timers de la ranura actual, sacándolos uno por uno de la lista,
+	 *    así un callback puede detener o arrancar otros timers sin dañar el recorrido
+	 */
+	while(1){
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+
+		uint8_t index = wheel[slot];
+		if(index == SWTIMER_NONE){
+			__set_PRIMASK(primask);
+			break;
+		}
+
+		SwTimer_Callback_t callback = timers[index].callback;
+		void *context = timers[index].context;
+
+		swtimer_unlink(index);
+		if(timers[index].oneShot){
+			swtimer_free(index);
+		}
+		else{
+			/* El siguiente vencimiento se cuenta desde el anterior, así el periodo no se corre */
+			timers[index].expires += timers[index].period;
+			swtimer_link(index);
+		}
+
+		__set_PRIMASK(primask);
+
+		callback(context);
+	}
+}
+
+
+/*
+ * Deja todos los timers en la lista de libres y la rueda vacía
+ */
+static void swtimer_init(void){
+
+	for(uint16_t i = 0; i < SWTIMER_SLOTS; i++){
+		wheel[i] = SWTIMER_NONE;
+	}
+	for(uint8_t i = 0; i < SWTIMER_MAX_TIMERS; i++){
+		timers[i].active = 0;
+		timers[i].next = (i + 1 < SWTIMER_MAX_TIMERS) ? (i + 1) : SWTIMER_NONE;
+	}
+	freeList = 0;
+	activeCount = 0;
+	flagInit = 1;
+}
+
+
+/*
+ * Pone el timer en la ranura que le corresponde según lo que falta para que venza
+ */
+static void swtimer_link(uint8_t index){
+
+	SwTimer_t *ptrTimer = &timers[index];
+	uint32_t delta = ptrTimer->expires - wheelTime;
+	uint16_t slot;
+
+	if(delta < SWTIMER_L0_SLOTS){
+		slot = ptrTimer->expires & (SWTIMER_L0_SLOTS - 1);
+	}
+	else if(delta < (1UL << SWTIMER_L2_SHIFT)){
+		slot = SWTIMER_L1_OFFSET + ((ptrTimer->expires >> SWTIMER_L1_SHIFT) & (SWTIMER_L1_SLOTS - 1));
+	}
+	else{
+		if(delta > SWTIMER_MAX_PERIOD){
+			ptrTimer->expires = wheelTime + SWTIMER_MAX_PERIOD;
+		}
+		slot = SWTIMER_L2_OFFSET + ((ptrTimer->expires >> SWTIMER_L2_SHIFT) & (SWTIMER_L2_SLOTS - 1));
+	}
+
+	/* Se agrega al inicio de la lista de la ranura */
+	ptrTimer->slot = slot;
+	ptrTimer->prev = SWTIMER_NONE;
+	ptrTimer->next = wheel[slot];
+	if(wheel[slot] != SWTIMER_NONE){
+		timers[wheel[slot]].prev = index;
+	}
+	wheel[slot] = index;
+}
+
+
+/*
+ * Saca el timer de la lista de su ranura
+ */
+static void swtimer_unlink(uint8_t index){
+
+	SwTimer_t *ptrTimer = &timers[index];
+
+	if(ptrTimer->prev != SWTIMER_NONE){
+		timers[ptrTimer->prev].next = ptrTimer->next;
+	}
+	else{
+		wheel[ptrTimer->slot] = ptrTimer->next;
+	}
+	if(ptrTimer->next != SWTIMER_NONE){
+		timers[ptrTimer->next].prev = ptrTimer->prev;
+	}
+}
+
+
+/*
+ * Devuelve el timer a la lista de libres (el timer ya debe estar fuera de la rueda)
+ */
+static void swtimer_free(uint8_t index){
+	timers[index].active = 0;
+	timers[index].generation++;
+	timers[index].next = freeList;
+	freeList = index;
+	activeCount--;
+}
+
+
+/*
+ * Reparte los timers de una ranura de un nivel superior en los niveles de abajo
+ */
+static void swtimer_cascade(uint16_t slot){
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	uint8_t index = wheel[slot];
+	wheel[slot] = SWTIMER_NONE;
+
+	while(index != SWTIMER_NONE){
+		uint8_t next = timers[index].next;
+		swtimer_link(index);
+		index = next;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+/*
+ * Convierte un id en el índice del timer, o -1 si el id no es de un timer activo
+ */
+static int16_t swtimer_get_index(uint16_t timerId){
+
+	uint8_t index = timerId & 0xFF;
+
+	if((timerId == SWTIMER_INVALID) || (index >= SWTIMER_MAX_TIMERS) || !flagInit){
+		return -1;
+	}
+	if(!timers[index].active || (timers[index].generation != (timerId >> 8))){
+		return -1;
+	}
+	return index;
+}
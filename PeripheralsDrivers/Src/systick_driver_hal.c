@@ -7,10 +7,11 @@
 #include <stdint.h>
 #include "stm32f4xx.h"
 #include "systick_driver_hal.h"
+#include "swtimer_driver_hal.h"
 
 
-static uint32_t countTicks = 0;
-static uint32_t startTick = 0; // Para la función de Delay
+/* Lo modifica la interrupción: volatile, y se lee con systick_GetTicks (64 bits no se leen de una vez en el Cortex-M4) */
+static volatile uint64_t countTicks = 0;
 
 /*
  * Cabeceras de las funciones privadas
@@ -92,10 +93,48 @@ void systick_SetState(Systick_Handler_t *pSystickHandler, uint8_t newState){
 
 
 /*
- * Devuelve la cantidad de Ticks (cuenta los ticks, o del tiempo según el Reload d)
+ * Devuelve la cantidad de Ticks (cuenta los ticks, o del tiempo según el Reload d).
+ * El contador es de 64 bits y el Cortex-M4 lo lee en dos instrucciones: si el SysTick
+ * interrumpe entre las dos y la parte baja da la vuelta, la lectura queda mal por 2^32.
+ * Se lee con las interrupciones apagadas (y se restaura el estado anterior, así también
+ * se puede llamar desde otra interrupción).
  */
 uint64_t systick_GetTicks(void){
-	return countTicks;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint64_t ticks = countTicks;
+	__set_PRIMASK(primask);
+
+	return ticks;
+}
+
+
+/*
+ * Parte baja del contador de ticks: se lee en una sola instrucción, así que no necesita
+ * apagar las interrupciones. Da la vuelta cada 49.7 días; para comparar tiempos se usa la
+ * resta (ahora - inicio), que funciona aunque haya dado la vuelta.
+ */
+uint32_t systick_GetTicks32(void){
+	return (uint32_t)countTicks;
+}
+
+
+/*
+ * Enciende el contador de ciclos del Cortex-M4 (DWT->CYCCNT), que cuenta con el HCLK.
+ * Lo usan varios drivers a la vez (el profiler, los timeouts del I2C), así que si ya
+ * está corriendo no se toca: poner CYCCNT en 0 dañaría las mediciones en curso. Quien
+ * lo use debe medir con la resta (ahora - inicio), que funciona aunque dé la vuelta.
+ */
+void systick_EnableCycleCounter(void){
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)){
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+	__set_PRIMASK(primask);
 }
 
 
@@ -131,22 +170,17 @@ static void systick_config_interrupt(Systick_Handler_t *pSystickHandler){
  */
 void systick_Delay_ms(uint32_t wait_time_ms){
 
-	// Obtenemos el Tick actual del contador
-	startTick = systick_GetTicks();
-
-	// Obtiene el valor de tiempo para comparar inicialmente
-	countTicks = systick_GetTicks();
+	// Obtenemos el Tick actual del contador (sin escribir countTicks, que es de la interrupción)
+	uint32_t startTick = systick_GetTicks32();
 
-	/* Comparamos el valor de cada actualización, con el valor de referencia
-	 * startTick + wait_time_ms, para que entre en un ciclo hasta que pase
-	 * el intervalo de tiempo deseado
+	/* Comparamos el tiempo transcurrido con wait_time_ms, hasta que pase el intervalo
+	 * de tiempo deseado. Mientras tanto el procesador duerme (WFI) hasta la siguiente
+	 * interrupción, que como máximo es el SysTick del siguiente ms
 	 */
-	while(countTicks < (startTick + (uint64_t)wait_time_ms)){
-		// Guardamos el valor de la cuenta actual
-		countTicks = systick_GetTicks();
+	while((systick_GetTicks32() - startTick) < wait_time_ms){
+		__WFI();
 	}
 
-
 } // Fin systick_Delay_ms()
 
 
@@ -167,6 +201,9 @@ void SysTick_Handler(void){
 		/* Cada que se de una interrupción, aumentamos en 1 el contador de ticks */
 		countTicks++;
 
+		/* Avanzamos la rueda de los timers por software */
+		swtimer_Tick();
+
 		/* Llamamos a la función que se debe encargar de hacer algo con esta interrupción */
 		systick_Callback();
 	}
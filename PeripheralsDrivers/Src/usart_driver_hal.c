@@ -6,11 +6,25 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include "stm32f4xx.h"
 #include "usart_driver_hal.h"
+#include "pll_driver_hal.h"
 
 rxDataUsart auxRxData = {0}; // Arreglo que guarda los valores de los datos recibidos en cada interrupción de los 3 USART
 
+/* Handler de cada USART, para que las interrupciones (TX, IDLE y DMA) encuentren sus buffers */
+static USART_Handler_t *ptrHandlerUsart1 = NULL;
+static USART_Handler_t *ptrHandlerUsart2 = NULL;
+static USART_Handler_t *ptrHandlerUsart6 = NULL;
+
+/* Banderas de error de recepción del SR: se bajan leyendo SR y luego DR */
+#define USART_SR_RX_ERRORS	(USART_SR_ORE | USART_SR_FE | USART_SR_NE | USART_SR_PE)
+
+/* Velocidad (bps) de cada opción USART_BAUDRATE_xx, en el orden del enum */
+static const uint32_t usartBaudrates[] = {9600, 19200, 115200, 230400, 921600, 460800,
+										  1000000, 2000000, 3000000, 4000000, 6000000};
+
 /* === Headers for private functions === */
 static void usart_enable_clock_peripheral(USART_Handler_t *ptrUsartHandler);
 static void usart_config_parity(USART_Handler_t *ptrUsartHandler);
@@ -20,6 +34,16 @@ static void usart_config_baudrate(USART_Handler_t *ptrUsartHandler);
 static void usart_config_mode(USART_Handler_t *ptrUsartHandler);
 static void usart_config_interrupt(USART_Handler_t *ptrUsartHandler);
 static void usart_enable_peripheral(USART_Handler_t *ptrUsartHandler);
+static void usart_register_handler(USART_Handler_t *ptrUsartHandler);
+static void usart_tx_interrupt(USART_Handler_t *ptrUsartHandler);
+static uint8_t usart_uses_tx_ring(USART_Handler_t *ptrUsartHandler);
+static void usart_tx_start(USART_Handler_t *ptrUsartHandler);
+static void usart_config_dma(USART_Handler_t *ptrUsartHandler);
+static void usart_tx_dma_interrupt(USART_Handler_t *ptrUsartHandler);
+static void usart_rx_dma_process(USART_Handler_t *ptrUsartHandler);
+static void usart_rx_deliver(USART_Handler_t *ptrUsartHandler, uint8_t *data, uint16_t length);
+static void usart_rx_push(USART_Handler_t *ptrUsartHandler, uint8_t data);
+static void usart_rx_errors(USART_Handler_t *ptrUsartHandler, uint32_t statusRegister);
 
 
 
@@ -68,8 +92,12 @@ void usart_Config(USART_Handler_t *ptrUsartHandler){
 	usart_config_mode(ptrUsartHandler);
 
 	// 2.8 Verificamos la configuración de las interrupciones
+	usart_register_handler(ptrUsartHandler);
 	usart_config_interrupt(ptrUsartHandler);
 
+	// 2.9 Configuramos los streams de DMA (si se usan)
+	usart_config_dma(ptrUsartHandler);
+
 	// 2.7 Activamos el modulo serial.
 	usart_enable_peripheral(ptrUsartHandler);
 
@@ -194,58 +222,100 @@ static void usart_config_stopbits(USART_Handler_t *ptrUsartHandler){
 }
 
 /**
- * Ver tabla de valores (Tabla 75), Frec = 16MHz, overr = 0;
- *
  * Aquí configuramos el baudrate del USART.
  * El baudrate es la tasa de bits/s de transmisión y recepción entre los
  * dispositivos que se comunican a través del USART (Particularmente a una
  * señal de reloj del microcontrolador)
+ *
+ * Antes el BRR salía de la tabla 75 del manual (reloj fijo de 16 MHz); ahora se
+ * calcula con el reloj real del bus, así sigue siendo correcto con el PLL:
+ *   USARTDIV = fPCLK / (8 * (2 - OVER8) * baudrate)
+ * Ejemplo a 16 MHz, 115200 y OVER8 = 0: USARTDIV = 8.68 -> Mantiza = 8, fraction = 11 -> 0x008B
  */
 static void usart_config_baudrate(USART_Handler_t *ptrUsartHandler){
-	// Caso para configurar cuando se trabaja con el Cristal Interno
-	switch(ptrUsartHandler->USART_Config.baudrate){
-		case USART_BAUDRATE_9600:
-		{
-		// El valor a cargar es 104.1875 -> Mantiza = 104,fraction = 0.1875
-		// Mantiza = 104 = 0x0680, fraction = 16 * 0.1875 = 3 = 0x0003
-		// Valor a cargar 0x0683
-		// Configurando el Baudrate generator para una velocidad de 9600bps
-			ptrUsartHandler->ptrUSARTx->BRR = 0x0683;
-			break;
-		}
-		case USART_BAUDRATE_19200:
-		{
-		// El valor a cargar es 52.0625 -> Mantiza = 52,fraction = 0.0625
-		// Mantiza = 52 => 0x0340, fraction = 16 * 0.0625 = 1 => 0x0001
-		// Valor a cargar 0x0341
-		// Configurando el Baudrate generator para una velocidad de 19200bps
-			ptrUsartHandler->ptrUSARTx->BRR = 0x0341;
-			break;
-		}
-		case USART_BAUDRATE_115200:
-		{
-		// El valor a cargar es 8.6875 -> Mantiza = 8,fraction = 0.6875
-		// Mantiza = 8 => 0x0080 , fraction = 16 * 0.6875 = 11 => 0x000B
-		// Valor a cargar 0x008B
-		// Configurando el Baudrate generator para una velocidad de 115200bps
-			ptrUsartHandler->ptrUSARTx->BRR = 0x008B;
-			break;
-		}
-		case USART_BAUDRATE_230400:
-		{
-		// El valor a cargar es 4.3125 -> Mantiza = 4,fraction = 0.3125
-		// Mantiza = 4 => 0x0040, fraction = 16 * 0.3125 = 5 => 0x0005
-		// Valor a cargar 0x0045
-		// Configurando el Baudrate generator para una velocidad de 230400bps
-			ptrUsartHandler->ptrUSARTx->BRR = 0x0045;
-			break;
-		}
 
-		default:
-			// Configurando el Baudrate generator para una velocidad de 115200bps
-			ptrUsartHandler->ptrUSARTx->BRR = 0x008B;
-			break;
+	uint32_t pclk = usart_GetPclk(ptrUsartHandler);
+	uint8_t baudrateIndex = ptrUsartHandler->USART_Config.baudrate;
+
+	/* 1. Velocidad pedida (una opción desconocida queda en 115200bps, como antes) */
+	if(baudrateIndex >= (sizeof(usartBaudrates) / sizeof(usartBaudrates[0]))){
+		baudrateIndex = USART_BAUDRATE_115200;
+	}
+	uint32_t baudrate = usartBaudrates[baudrateIndex];
+
+	/* 2. Si con sobremuestreo de 16 no se alcanza la velocidad (USARTDIV < 1), usamos 8 */
+	if((baudrate * 16) > pclk){
+		ptrUsartHandler->USART_Config.oversampling = USART_OVERSAMPLING_8;
+	}
+
+	if(ptrUsartHandler->USART_Config.oversampling == USART_OVERSAMPLING_8){
+		ptrUsartHandler->ptrUSARTx->CR1 |= USART_CR1_OVER8;
+	}
+	else{
+		ptrUsartHandler->ptrUSARTx->CR1 &= ~USART_CR1_OVER8;
+	}
+
+	/* 3. Mantiza y fracción */
+	ptrUsartHandler->ptrUSARTx->BRR = usart_ComputeBRR(pclk, baudrate, ptrUsartHandler->USART_Config.oversampling);
+}
+
+
+/*
+ * Calcula el valor del BRR (mantiza en los bits 15:4, fracción en los bits 3:0)
+ * redondeando al valor más cercano.
+ * - OVER8 = 0: el BRR es fPCLK / baudrate en dieciseisavos, directamente.
+ * - OVER8 = 1: la fracción es de 3 bits (octavos) y el bit 3 debe quedar en 0.
+ * Retorna 0 si la velocidad no se puede alcanzar con ese reloj (USARTDIV < 1).
+ */
+uint16_t usart_ComputeBRR(uint32_t pclk, uint32_t baudrate, uint8_t oversampling){
+
+	if(baudrate == 0){
+		return 0;
+	}
+
+	if(oversampling == USART_OVERSAMPLING_8){
+		/* USARTDIV en octavos: 8 * fPCLK / (8 * baudrate) */
+		uint32_t div8 = (pclk + (baudrate / 2)) / baudrate;
+		if((div8 < 8) || (div8 > 0xFFFF)){
+			return 0;
 		}
+		return (uint16_t)(((div8 >> 3) << 4) | (div8 & 0x07));
+	}
+
+	/* USARTDIV en dieciseisavos: 16 * fPCLK / (16 * baudrate) */
+	uint32_t div16 = (pclk + (baudrate / 2)) / baudrate;
+	if((div16 < 16) || (div16 > 0xFFFF)){
+		return 0;
+	}
+	return (uint16_t)div16;
+}
+
+
+/*
+ * Reloj del bus al que pertenece el USART: APB2 para USART1 y USART6, APB1 para USART2
+ */
+uint32_t usart_GetPclk(USART_Handler_t *ptrUsartHandler){
+	if(ptrUsartHandler->ptrUSARTx == USART2){
+		return pll_GetPclk1();
+	}
+	return pll_GetPclk2();
+}
+
+
+/*
+ * Velocidad que realmente se obtiene con el BRR cargado y el reloj actual
+ * (útil para ver el error frente a la velocidad pedida)
+ */
+uint32_t usart_GetBaudrate(USART_Handler_t *ptrUsartHandler){
+
+	uint32_t brr = ptrUsartHandler->ptrUSARTx->BRR & 0xFFFF;
+	uint32_t pclk = usart_GetPclk(ptrUsartHandler);
+
+	if(ptrUsartHandler->ptrUSARTx->CR1 & USART_CR1_OVER8){
+		uint32_t div8 = ((brr >> 4) << 3) | (brr & 0x07);
+		return (div8 == 0) ? 0 : (pclk + (div8 / 2)) / div8;
+	}
+	return (brr == 0) ? 0 : (pclk + (brr / 2)) / brr;
 }
 
 /**
@@ -295,14 +365,51 @@ static void usart_config_mode(USART_Handler_t *ptrUsartHandler){
 
 /**
  * Esta función configura las interrupciones debidas a la recepción de datos
- * cuando el USART está configurado en modo de recepción (RX)
+ * cuando el USART está configurado en modo de recepción (RX), y deja lista la
+ * interrupción de transmisión (TXE) si se usa el buffer circular.
+ * La TXE sólo se enciende cuando hay datos por enviar (usart_WriteBuffer).
  */
 static void usart_config_interrupt(USART_Handler_t *ptrUsartHandler){
-	// 2.8a Interrupción por recepción
-		if(ptrUsartHandler->USART_Config.enableIntRX == USART_RX_INTERRUP_ENABLE){
+	// 2.8a Interrupción por recepción (con DMA la reemplaza la interrupción IDLE)
+		uint8_t flagDmaRx = (ptrUsartHandler->USART_Config.enableDMA == USART_DMA_RX) ||
+							(ptrUsartHandler->USART_Config.enableDMA == USART_DMA_RXTX);
+
+		if(flagDmaRx){
+			ptrUsartHandler->ptrUSARTx->CR1 &= ~USART_CR1_RXNEIE;
+			ptrUsartHandler->ptrUSARTx->CR1 |= USART_CR1_IDLEIE;
+		}
+		else if(ptrUsartHandler->USART_Config.enableIntRX == USART_RX_INTERRUP_ENABLE){
 			// Como está activada, debemos configurar la interrupción por recepción
 			/* Debemos activar la interrupción RX en la configuración del USART */
 			ptrUsartHandler->ptrUSARTx->CR1 |= 	USART_CR1_RXNEIE;
+		}
+		else{
+			// Deshabilitamos la interrupción por recepción
+			ptrUsartHandler->ptrUSARTx->CR1 &= ~USART_CR1_RXNEIE;
+		}
+		if(!flagDmaRx){
+			ptrUsartHandler->ptrUSARTx->CR1 &= ~USART_CR1_IDLEIE;
+		}
+
+		/* El buffer circular de recepción y los contadores de error arrancan vacíos */
+		ptrUsartHandler->rxHead = 0;
+		ptrUsartHandler->rxTail = 0;
+		ptrUsartHandler->rxDropped = 0;
+		ptrUsartHandler->rxOverruns = 0;
+		ptrUsartHandler->rxFramingErrors = 0;
+		ptrUsartHandler->rxNoiseErrors = 0;
+		ptrUsartHandler->rxParityErrors = 0;
+
+	// 2.8b Interrupción por transmisión: arranca apagada y el buffer vacío
+		ptrUsartHandler->ptrUSARTx->CR1 &= ~USART_CR1_TXEIE;
+		ptrUsartHandler->txHead = 0;
+		ptrUsartHandler->txTail = 0;
+		ptrUsartHandler->txHighWater = 0;
+		ptrUsartHandler->txDropped = 0;
+
+	// 2.8c El NVIC se necesita si alguna de las interrupciones está en uso
+		if((ptrUsartHandler->USART_Config.enableIntRX == USART_RX_INTERRUP_ENABLE) ||
+		   (ptrUsartHandler->USART_Config.enableIntTX == USART_TX_INTERRUP_ENABLE) || flagDmaRx){
 
 			/* Debemos matricular la interrupción en el NVIC */
 			/* Lo debemos hacer para cada uno de las posibles opciones que tengamos (USART1, USART2, USART6) */
@@ -322,9 +429,6 @@ static void usart_config_interrupt(USART_Handler_t *ptrUsartHandler){
 			}
 		}
 		else{
-			// Deshabilitamos la interrupción por recepción
-			ptrUsartHandler->ptrUSARTx->CR1 &= ~USART_CR1_RXNEIE;
-
 			/* Debemos desmatricular la interrupción en el NVIC */
 			/* Lo debemos hacer para cada uno de las posibles opciones que tengamos (USART1, USART2, USART6) */
 			if(ptrUsartHandler->ptrUSARTx == USART1){
@@ -340,6 +444,102 @@ static void usart_config_interrupt(USART_Handler_t *ptrUsartHandler){
 }	// Fin función usart_config_interrupt
 
 
+/**
+ * Guarda el handler para que las interrupciones encuentren sus buffers
+ */
+static void usart_register_handler(USART_Handler_t *ptrUsartHandler){
+	if(ptrUsartHandler->ptrUSARTx == USART1){
+		ptrHandlerUsart1 = ptrUsartHandler;
+	}
+	else if(ptrUsartHandler->ptrUSARTx == USART2){
+		ptrHandlerUsart2 = ptrUsartHandler;
+	}
+	else if(ptrUsartHandler->ptrUSARTx == USART6){
+		ptrHandlerUsart6 = ptrUsartHandler;
+	}
+}
+
+
+/**
+ * Configura los streams de DMA según USART_Config.enableDMA:
+ * - TX: stream en modo normal, se enciende cada vez que hay datos en el buffer circular
+ * - RX: stream circular sobre receptionBuffer, con interrupciones de mitad y final
+ *   del buffer (además de la IDLE del USART) para no perder datos en ráfagas largas
+ */
+static void usart_config_dma(USART_Handler_t *ptrUsartHandler){
+
+	uint8_t flagDmaTx = (ptrUsartHandler->USART_Config.enableDMA == USART_DMA_TX) ||
+						(ptrUsartHandler->USART_Config.enableDMA == USART_DMA_RXTX);
+	uint8_t flagDmaRx = (ptrUsartHandler->USART_Config.enableDMA == USART_DMA_RX) ||
+						(ptrUsartHandler->USART_Config.enableDMA == USART_DMA_RXTX);
+
+	ptrUsartHandler->ptrUSARTx->CR3 &= ~(USART_CR3_DMAT | USART_CR3_DMAR | USART_CR3_EIE);
+	ptrUsartHandler->txDmaLength = 0;
+	ptrUsartHandler->rxDmaIndex = 0;
+	ptrUsartHandler->rxFrames = 0;
+
+	if(!flagDmaTx && !flagDmaRx){
+		return;
+	}
+
+	/* 1. Streams y canales de cada USART */
+	if(ptrUsartHandler->ptrUSARTx == USART1){
+		ptrUsartHandler->dmaTx.ptrDMAx = DMA2;	ptrUsartHandler->dmaTx.ptrStream = DMA2_Stream7;
+		ptrUsartHandler->dmaTx.stream = 7;		ptrUsartHandler->dmaTx.config.channel = 4;
+		ptrUsartHandler->dmaRx.ptrDMAx = DMA2;	ptrUsartHandler->dmaRx.ptrStream = DMA2_Stream2;
+		ptrUsartHandler->dmaRx.stream = 2;		ptrUsartHandler->dmaRx.config.channel = 4;
+	}
+	else if(ptrUsartHandler->ptrUSARTx == USART2){
+		ptrUsartHandler->dmaTx.ptrDMAx = DMA1;	ptrUsartHandler->dmaTx.ptrStream = DMA1_Stream6;
+		ptrUsartHandler->dmaTx.stream = 6;		ptrUsartHandler->dmaTx.config.channel = 4;
+		ptrUsartHandler->dmaRx.ptrDMAx = DMA1;	ptrUsartHandler->dmaRx.ptrStream = DMA1_Stream5;
+		ptrUsartHandler->dmaRx.stream = 5;		ptrUsartHandler->dmaRx.config.channel = 4;
+	}
+	else if(ptrUsartHandler->ptrUSARTx == USART6){
+		ptrUsartHandler->dmaTx.ptrDMAx = DMA2;	ptrUsartHandler->dmaTx.ptrStream = DMA2_Stream6;
+		ptrUsartHandler->dmaTx.stream = 6;		ptrUsartHandler->dmaTx.config.channel = 5;
+		ptrUsartHandler->dmaRx.ptrDMAx = DMA2;	ptrUsartHandler->dmaRx.ptrStream = DMA2_Stream1;
+		ptrUsartHandler->dmaRx.stream = 1;		ptrUsartHandler->dmaRx.config.channel = 5;
+	}
+	else{
+		return;
+	}
+
+	/* 2. Transmisión: memoria -> DR, un byte a la vez, interrupción al terminar */
+	if(flagDmaTx){
+		ptrUsartHandler->dmaTx.config.direction		= DMA_DIR_MEM_TO_PERIPH;
+		ptrUsartHandler->dmaTx.config.mode			= DMA_MODE_NORMAL;
+		ptrUsartHandler->dmaTx.config.dataSize		= DMA_DATASIZE_8BIT;
+		ptrUsartHandler->dmaTx.config.memIncrement	= 1;
+		ptrUsartHandler->dmaTx.config.priority		= DMA_PRIORITY_MEDIUM;
+		ptrUsartHandler->dmaTx.config.enableIntTC	= DMA_INTERRUPT_ENABLE;
+		ptrUsartHandler->dmaTx.config.enableIntHT	= DMA_INTERRUPT_DISABLE;
+		ptrUsartHandler->dmaTx.config.enableIntTE	= DMA_INTERRUPT_ENABLE;
+		dma_Config(&ptrUsartHandler->dmaTx);
+
+		ptrUsartHandler->ptrUSARTx->CR3 |= USART_CR3_DMAT;
+	}
+
+	/* 3. Recepción: DR -> receptionBuffer en modo circular, arranca de una vez */
+	if(flagDmaRx){
+		ptrUsartHandler->dmaRx.config.direction		= DMA_DIR_PERIPH_TO_MEM;
+		ptrUsartHandler->dmaRx.config.mode			= DMA_MODE_CIRCULAR;
+		ptrUsartHandler->dmaRx.config.dataSize		= DMA_DATASIZE_8BIT;
+		ptrUsartHandler->dmaRx.config.memIncrement	= 1;
+		ptrUsartHandler->dmaRx.config.priority		= DMA_PRIORITY_HIGH;
+		ptrUsartHandler->dmaRx.config.enableIntTC	= DMA_INTERRUPT_ENABLE;
+		ptrUsartHandler->dmaRx.config.enableIntHT	= DMA_INTERRUPT_ENABLE;
+		ptrUsartHandler->dmaRx.config.enableIntTE	= DMA_INTERRUPT_DISABLE;
+		dma_Config(&ptrUsartHandler->dmaRx);
+
+		/* Con DMA no hay interrupción RXNE, así que los errores (ORE, FE, NE) se avisan con EIE */
+		ptrUsartHandler->ptrUSARTx->CR3 |= USART_CR3_DMAR | USART_CR3_EIE;
+		dma_Start(&ptrUsartHandler->dmaRx, &ptrUsartHandler->ptrUSARTx->DR,
+				  ptrUsartHandler->receptionBuffer, USART_RX_BUFFER_SIZE);
+	}
+}
+
+
 /**
  * Configuración para activar o desactivar el USART
  */
@@ -356,9 +556,16 @@ static void usart_enable_peripheral(USART_Handler_t *ptrUsartHandler){
 
 
 /*
- * Función para escribir un solo char
+ * Función para escribir un solo char.
+ * Con el buffer circular activo, el char se encola y la función retorna de inmediato.
  */
 int usart_WriteChar(USART_Handler_t *ptrUsartHandler, char dataToSend){
+
+	if(usart_uses_tx_ring(ptrUsartHandler)){
+		usart_WriteBuffer(ptrUsartHandler, (uint8_t *)&dataToSend, 1);
+		return dataToSend;
+	}
+
 	while( !(ptrUsartHandler->ptrUSARTx->SR & USART_SR_TXE)){	// Verifica que no hayan datos actualmente en el Transmit Data Register
 		__NOP();
 	}
@@ -372,8 +579,16 @@ int usart_WriteChar(USART_Handler_t *ptrUsartHandler, char dataToSend){
 
 /*
  * Configuración para enviar un mensaje tipo String (Mensaje -> Cadena de caracteres)
+ * Con el buffer circular activo, el mensaje se copia al buffer y la función retorna
+ * sin esperar a que se transmita.
  */
 void usart_WriteMsg(USART_Handler_t *ptrUsartHandler, char *msgToSend ){
+
+	if(usart_uses_tx_ring(ptrUsartHandler)){
+		usart_WriteBuffer(ptrUsartHandler, (uint8_t *)msgToSend, strlen(msgToSend));
+		return;
+	}
+
 	while( !(ptrUsartHandler->ptrUSARTx->SR & USART_SR_TXE)){	// Verifica que no hayan datos actualmente en el Transmit Data Register
 		__NOP();
 	}
@@ -386,6 +601,314 @@ void usart_WriteMsg(USART_Handler_t *ptrUsartHandler, char *msgToSend ){
 
 }
 
+
+/*
+ * Copia 'length' bytes al buffer circular de transmisión y enciende la interrupción TXE.
+ * Si no caben, aplica la política configurada (txPolicy).
+ * Devuelve cuántos bytes de 'data' quedaron en el buffer.
+ *
+ * Sólo el main debe llamarla (un único productor). Con USART_TX_POLICY_BLOCK no se
+ * debe llamar con las interrupciones desactivadas, porque nadie liberaría espacio.
+ */
+uint16_t usart_WriteBuffer(USART_Handler_t *ptrUsartHandler, uint8_t *data, uint16_t length){
+
+	uint16_t written = 0;
+
+	/* Sin buffer circular: transmisión bloqueante byte a byte */
+	if(!usart_uses_tx_ring(ptrUsartHandler)){
+		for(written = 0; written < length; written++){
+			usart_WriteChar(ptrUsartHandler, data[written]);
+		}
+		return written;
+	}
+
+	while(written < length){
+
+		uint16_t head = ptrUsartHandler->txHead;
+		uint16_t used = (head - ptrUsartHandler->txTail) & USART_TX_BUFFER_MASK;
+		uint16_t space = USART_TX_BUFFER_MASK - used;	// Una posición siempre queda libre
+
+		/* 1. Buffer lleno: aplicamos la política */
+		if(space == 0){
+			if(ptrUsartHandler->USART_Config.txPolicy == USART_TX_POLICY_BLOCK){
+				/* Nos aseguramos de que el buffer se esté vaciando y esperamos */
+				usart_tx_start(ptrUsartHandler);
+				__NOP();
+				continue;
+			}
+			else if((ptrUsartHandler->USART_Config.txPolicy == USART_TX_POLICY_OVERWRITE) &&
+					(ptrUsartHandler->USART_Config.enableIntTX == USART_TX_INTERRUP_ENABLE) &&
+					(ptrUsartHandler->txDmaLength == 0)){
+				/* Descartamos el byte más viejo. El tail es de la interrupción, así que
+				 * la detenemos mientras lo movemos (sólo en este caso, no en el normal)
+				 */
+				ptrUsartHandler->ptrUSARTx->CR1 &= ~USART_CR1_TXEIE;
+				if(((ptrUsartHandler->txHead - ptrUsartHandler->txTail) & USART_TX_BUFFER_MASK) == USART_TX_BUFFER_MASK){
+					ptrUsartHandler->txTail = (ptrUsartHandler->txTail + 1) & USART_TX_BUFFER_MASK;
+					ptrUsartHandler->txDropped++;
+				}
+				ptrUsartHandler->ptrUSARTx->CR1 |= USART_CR1_TXEIE;
+				continue;
+			}
+			else{
+				/* USART_TX_POLICY_DROP: se pierde lo que no cupo. Con DMA, OVERWRITE también
+				 * termina aquí: los bytes más viejos ya son del stream y no se pueden descartar
+				 */
+				ptrUsartHandler->txDropped += length - written;
+				break;
+			}
+		}
+
+		/* 2. Copiamos el bloque más grande posible sin dar la vuelta al buffer */
+		uint16_t chunk = length - written;
+		if(chunk > space){
+			chunk = space;
+		}
+		if(chunk > (USART_TX_BUFFER_SIZE - head)){
+			chunk = USART_TX_BUFFER_SIZE - head;
+		}
+		memcpy(&ptrUsartHandler->txRing[head], &data[written], chunk);
+		written += chunk;
+
+		/* 3. Publicamos los datos: primero la copia, luego el nuevo head */
+		__DMB();
+		ptrUsartHandler->txHead = (head + chunk) & USART_TX_BUFFER_MASK;
+
+		/* 4. Estadística de ocupación máxima */
+		used += chunk;
+		if(used > ptrUsartHandler->txHighWater){
+			ptrUsartHandler->txHighWater = used;
+		}
+	}
+
+	/* 5. La interrupción TXE (o el DMA) envía lo que haya en el buffer */
+	usart_tx_start(ptrUsartHandler);
+
+	return written;
+}
+
+
+/*
+ * Bytes del buffer circular que aún no se han enviado
+ */
+uint16_t usart_TxPending(USART_Handler_t *ptrUsartHandler){
+	return (ptrUsartHandler->txHead - ptrUsartHandler->txTail) & USART_TX_BUFFER_MASK;
+}
+
+
+/*
+ * Copia en 'buffer' hasta maxLength bytes recibidos y retorna cuántos copió.
+ * Nunca espera: si no ha llegado nada retorna 0.
+ */
+uint16_t usart_Read(USART_Handler_t *ptrUsartHandler, uint8_t *buffer, uint16_t maxLength){
+
+	uint16_t tail = ptrUsartHandler->rxTail;
+	uint16_t head = ptrUsartHandler->rxHead;
+	uint16_t count = 0;
+
+	while((tail != head) && (count < maxLength)){
+		buffer[count++] = ptrUsartHandler->rxRing[tail];
+		tail = (tail + 1) & USART_RX_RING_MASK;
+	}
+
+	/* Liberamos el espacio sólo después de copiar los datos */
+	ptrUsartHandler->rxTail = tail;
+	return count;
+}
+
+
+/*
+ * Bytes recibidos que aún no se han leído con usart_Read
+ */
+uint16_t usart_RxAvailable(USART_Handler_t *ptrUsartHandler){
+	return (ptrUsartHandler->rxHead - ptrUsartHandler->rxTail) & USART_RX_RING_MASK;
+}
+
+
+/*
+ * El buffer circular se usa con la transmisión por interrupción o por DMA
+ */
+static uint8_t usart_uses_tx_ring(USART_Handler_t *ptrUsartHandler){
+	return (ptrUsartHandler->USART_Config.enableIntTX == USART_TX_INTERRUP_ENABLE) ||
+		   (ptrUsartHandler->USART_Config.enableDMA == USART_DMA_TX) ||
+		   (ptrUsartHandler->USART_Config.enableDMA == USART_DMA_RXTX);
+}
+
+
+/*
+ * Arranca el vaciado del buffer circular si hay datos pendientes:
+ * - Con DMA: si el stream está libre, lo enciende con el bloque contiguo más grande
+ *   desde txTail (hasta txHead o hasta el final del buffer)
+ * - Sin DMA: enciende la interrupción TXE
+ * Se llama desde el main y desde la interrupción de fin de transferencia; como el
+ * stream sólo está activo con txDmaLength != 0, las dos nunca lo arrancan a la vez.
+ */
+static void usart_tx_start(USART_Handler_t *ptrUsartHandler){
+
+	uint16_t head = ptrUsartHandler->txHead;
+	uint16_t tail = ptrUsartHandler->txTail;
+
+	if(head == tail){
+		return;
+	}
+
+	if((ptrUsartHandler->USART_Config.enableDMA == USART_DMA_TX) ||
+	   (ptrUsartHandler->USART_Config.enableDMA == USART_DMA_RXTX)){
+
+		if(ptrUsartHandler->txDmaLength != 0){
+			return;
+		}
+		uint16_t length = (head > tail) ? (head - tail) : (USART_TX_BUFFER_SIZE - tail);
+		ptrUsartHandler->txDmaLength = length;
+
+		/* Bajamos la bandera TC del USART y encendemos el stream */
+		ptrUsartHandler->ptrUSARTx->SR &= ~USART_SR_TC;
+		dma_Start(&ptrUsartHandler->dmaTx, &ptrUsartHandler->ptrUSARTx->DR, &ptrUsartHandler->txRing[tail], length);
+	}
+	else{
+		ptrUsartHandler->ptrUSARTx->CR1 |= USART_CR1_TXEIE;
+	}
+}
+
+
+/*
+ * Fin de una transferencia de DMA: libera el bloque enviado y arranca el siguiente
+ */
+static void usart_tx_dma_interrupt(USART_Handler_t *ptrUsartHandler){
+
+	uint8_t flags = dma_GetFlags(&ptrUsartHandler->dmaTx);
+	dma_ClearFlags(&ptrUsartHandler->dmaTx, flags);
+
+	if(flags & (DMA_FLAG_TC | DMA_FLAG_TE)){
+		/* Con error el bloque se da por enviado igual, para no quedar atascados */
+		ptrUsartHandler->txTail = (ptrUsartHandler->txTail + ptrUsartHandler->txDmaLength) & USART_TX_BUFFER_MASK;
+		ptrUsartHandler->txDmaLength = 0;
+		usart_tx_start(ptrUsartHandler);
+	}
+}
+
+
+/*
+ * Entrega los datos que el DMA escribió en receptionBuffer desde la última vez.
+ * Se llama con la línea IDLE (fin de trama) y a la mitad y al final del buffer.
+ * El DMA y el USART tienen la misma prioridad en el NVIC, así que nunca corre dos veces a la vez.
+ */
+static void usart_rx_dma_process(USART_Handler_t *ptrUsartHandler){
+
+	/* Posición donde el DMA escribirá el siguiente byte */
+	uint16_t position = USART_RX_BUFFER_SIZE - dma_GetRemaining(&ptrUsartHandler->dmaRx);
+	if(position >= USART_RX_BUFFER_SIZE){
+		position = 0;
+	}
+
+	if(position == ptrUsartHandler->rxDmaIndex){
+		return;
+	}
+
+	if(position > ptrUsartHandler->rxDmaIndex){
+		/* Datos contiguos */
+		usart_rx_deliver(ptrUsartHandler, &ptrUsartHandler->receptionBuffer[ptrUsartHandler->rxDmaIndex],
+						 position - ptrUsartHandler->rxDmaIndex);
+	}
+	else{
+		/* El DMA dio la vuelta: primero hasta el final del buffer y luego desde el inicio */
+		usart_rx_deliver(ptrUsartHandler, &ptrUsartHandler->receptionBuffer[ptrUsartHandler->rxDmaIndex],
+						 USART_RX_BUFFER_SIZE - ptrUsartHandler->rxDmaIndex);
+		if(position > 0){
+			usart_rx_deliver(ptrUsartHandler, ptrUsartHandler->receptionBuffer, position);
+		}
+	}
+	ptrUsartHandler->rxDmaIndex = position;
+}
+
+
+/*
+ * Entrega un bloque recibido por DMA: callback de tramas y, para los programas que
+ * leen un solo caracter, el último byte por usartX_getRxData y usartX_RxCallback
+ */
+static void usart_rx_deliver(USART_Handler_t *ptrUsartHandler, uint8_t *data, uint16_t length){
+
+	ptrUsartHandler->dataInputSize = length;
+	ptrUsartHandler->rxFrames++;
+
+	/* Los datos también quedan en el buffer circular para usart_Read */
+	for(uint16_t i = 0; i < length; i++){
+		usart_rx_push(ptrUsartHandler, data[i]);
+	}
+
+	if(ptrUsartHandler->ptrUSARTx == USART1){
+		usart1_RxFrameCallback(data, length);
+		auxRxData.rxData_USART1 = data[length - 1];
+		usart1_RxCallback();
+	}
+	else if(ptrUsartHandler->ptrUSARTx == USART2){
+		usart2_RxFrameCallback(data, length);
+		auxRxData.rxData_USART2 = data[length - 1];
+		usart2_RxCallback();
+	}
+	else if(ptrUsartHandler->ptrUSARTx == USART6){
+		usart6_RxFrameCallback(data, length);
+		auxRxData.rxData_USART6 = data[length - 1];
+		usart6_RxCallback();
+	}
+}
+
+
+/*
+ * Guarda un byte recibido en el buffer circular (sólo desde la interrupción).
+ * Si el buffer está lleno el byte se descarta y se cuenta.
+ */
+static void usart_rx_push(USART_Handler_t *ptrUsartHandler, uint8_t data){
+
+	uint16_t head = ptrUsartHandler->rxHead;
+	uint16_t next = (head + 1) & USART_RX_RING_MASK;
+
+	if(next == ptrUsartHandler->rxTail){
+		ptrUsartHandler->rxDropped++;
+		return;
+	}
+	ptrUsartHandler->rxRing[head] = data;
+	ptrUsartHandler->rxHead = next;
+}
+
+
+/*
+ * Cuenta los errores de recepción que indica el SR
+ */
+static void usart_rx_errors(USART_Handler_t *ptrUsartHandler, uint32_t statusRegister){
+	if(statusRegister & USART_SR_ORE){
+		ptrUsartHandler->rxOverruns++;
+	}
+	if(statusRegister & USART_SR_FE){
+		ptrUsartHandler->rxFramingErrors++;
+	}
+	if(statusRegister & USART_SR_NE){
+		ptrUsartHandler->rxNoiseErrors++;
+	}
+	if(statusRegister & USART_SR_PE){
+		ptrUsartHandler->rxParityErrors++;
+	}
+}
+
+
+/*
+ * Atención de la interrupción TXE: envía el siguiente byte del buffer circular,
+ * y apaga la interrupción cuando el buffer queda vacío
+ */
+static void usart_tx_interrupt(USART_Handler_t *ptrUsartHandler){
+
+	uint16_t tail = ptrUsartHandler->txTail;
+
+	if(tail != ptrUsartHandler->txHead){
+		ptrUsartHandler->ptrUSARTx->DR = ptrUsartHandler->txRing[tail];
+		ptrUsartHandler->txTail = (tail + 1) & USART_TX_BUFFER_MASK;
+	}
+	else{
+		ptrUsartHandler->ptrUSARTx->CR1 &= ~USART_CR1_TXEIE;
+	}
+}
+
+
 /*
  * Funciones para obtener el dato recibido para cada USART independiente
  */
@@ -423,26 +946,67 @@ __attribute__ ((weak)) void usart6_RxCallback(void){
 	__NOP();
 }
 
+__attribute__ ((weak)) void usart1_RxFrameCallback(uint8_t *data, uint16_t length){
+	  /* NOTE : This function should not be modified, when the callback is needed,
+	            the usart1_RxFrameCallback could be implemented in the main file
+	   */
+	__NOP();
+}
+
+__attribute__ ((weak)) void usart2_RxFrameCallback(uint8_t *data, uint16_t length){
+	  /* NOTE : This function should not be modified, when the callback is needed,
+	            the usart2_RxFrameCallback could be implemented in the main file
+	   */
+	__NOP();
+}
+
+__attribute__ ((weak)) void usart6_RxFrameCallback(uint8_t *data, uint16_t length){
+	  /* NOTE : This function should not be modified, when the callback is needed,
+	            the usart6_RxFrameCallback could be implemented in the main file
+	   */
+	__NOP();
+}
+
 
 /* Handler de la interrupción del USART
  * Acá deben estar todas las interrupciones asociadas: TX, RX, PE...
  */
 void USART1_IRQHandler(void){
-	// Evaluamos si la interrupción que se dio es por RX
-	if(USART1->SR & USART_SR_RXNE){
+	// Leemos el SR una sola vez: al leer luego el DR se bajan RXNE, IDLE y las banderas de error
+	uint32_t auxSR = USART1->SR;
+
+	// Contamos los errores de recepción (overrun, framing, ruido, paridad)
+	if((auxSR & USART_SR_RX_ERRORS) && (ptrHandlerUsart1 != NULL)){
+		usart_rx_errors(ptrHandlerUsart1, auxSR);
+	}
 
-		// Bajamos la bandera del RXNE
-		USART1->SR &= ~USART_SR_RXNE;
+	// Evaluamos si la interrupción que se dio es por RX (sin DMA)
+	if((USART1->CR1 & USART_CR1_RXNEIE) && (auxSR & USART_SR_RXNE)){
 
-		// Guardamos el dato recibido en su variable correspondiente
+		// Guardamos el dato recibido (leer el DR baja el RXNE)
 		auxRxData.rxData_USART1 = USART1->DR;
+		if(ptrHandlerUsart1 != NULL){
+			usart_rx_push(ptrHandlerUsart1, auxRxData.rxData_USART1);
+		}
 
 		// Llamamos al Callback del USART1
 		usart1_RxCallback();
 	}
-	// Evaluamos si la interrupción es por TX
-	else{
-		__NOP();
+	// Con DMA el error llega por EIE, después de que el DMA tomó el byte: el DR sólo baja la bandera
+	else if(auxSR & USART_SR_RX_ERRORS){
+		(void)USART1->DR;
+	}
+	// Evaluamos si la interrupción es por TX (sólo si está encendida)
+	if((USART1->CR1 & USART_CR1_TXEIE) && (USART1->SR & USART_SR_TXE) && (ptrHandlerUsart1 != NULL)){
+		usart_tx_interrupt(ptrHandlerUsart1);
+	}
+	// Evaluamos si la línea quedó libre (fin de una trama recibida por DMA)
+	if((USART1->CR1 & USART_CR1_IDLEIE) && (auxSR & USART_SR_IDLE)){
+		// La bandera se baja leyendo SR y luego DR
+		(void)USART1->DR;
+		if(ptrHandlerUsart1 != NULL){
+			usart_rx_dma_process(ptrHandlerUsart1);
+		}
 	}
 }
 
@@ -450,21 +1014,41 @@ void USART1_IRQHandler(void){
  * Acá deben estar todas las interrupciones asociadas: TX, RX, PE...
  */
 void USART2_IRQHandler(void){
-	// Evaluamos si la interrupción que se dio es por RX
-	if(USART2->SR & USART_SR_RXNE){
+	// Leemos el SR una sola vez: al leer luego el DR se bajan RXNE, IDLE y las banderas de error
+	uint32_t auxSR = USART2->SR;
 
-		// Bajamos la bandera del RXNE
-		USART2->SR &= ~USART_SR_RXNE;
+	// Contamos los errores de recepción (overrun, framing, ruido, paridad)
+	if((auxSR & USART_SR_RX_ERRORS) && (ptrHandlerUsart2 != NULL)){
+		usart_rx_errors(ptrHandlerUsart2, auxSR);
+	}
 
-		// Guardamos el dato recibido en su variable correspondiente
+	// Evaluamos si la interrupción que se dio es por RX (sin DMA)
+	if((USART2->CR1 & USART_CR1_RXNEIE) && (auxSR & USART_SR_RXNE)){
+
+		// Guardamos el dato recibido (leer el DR baja el RXNE)
 		auxRxData.rxData_USART2 = USART2->DR;
+		if(ptrHandlerUsart2 != NULL){
+			usart_rx_push(ptrHandlerUsart2, auxRxData.rxData_USART2);
+		}
 
 		// Llamamos al Callback del USART2
 		usart2_RxCallback();
 	}
-	// Evaluamos si la interrupción es por TX
-	else{
-		__NOP();
+	// Con DMA el error llega por EIE, después de que el DMA tomó el byte: el DR sólo baja la bandera
+	else if(auxSR & USART_SR_RX_ERRORS){
+		(void)USART2->DR;
+	}
+	// Evaluamos si la interrupción es por TX (sólo si está encendida)
+	if((USART2->CR1 & USART_CR1_TXEIE) && (USART2->SR & USART_SR_TXE) && (ptrHandlerUsart2 != NULL)){
+		usart_tx_interrupt(ptrHandlerUsart2);
+	}
+	// Evaluamos si la línea quedó libre (fin de una trama recibida por DMA)
+	if((USART2->CR1 & USART_CR1_IDLEIE) && (auxSR & USART_SR_IDLE)){
+		// La bandera se baja leyendo SR y luego DR
+		(void)USART2->DR;
+		if(ptrHandlerUsart2 != NULL){
+			usart_rx_dma_process(ptrHandlerUsart2);
+		}
 	}
 }
 
@@ -472,22 +1056,87 @@ void USART2_IRQHandler(void){
  * Acá deben estar todas las interrupciones asociadas: TX, RX, PE...
  */
 void USART6_IRQHandler(void){
-	// Evaluamos si la interrupción que se dio es por RX
-	if(USART6->SR & USART_SR_RXNE){
+	// Leemos el SR una sola vez: al leer luego el DR se bajan RXNE, IDLE y las banderas de error
+	uint32_t auxSR = USART6->SR;
+
+	// Contamos los errores de recepción (overrun, framing, ruido, paridad)
+	if((auxSR & USART_SR_RX_ERRORS) && (ptrHandlerUsart6 != NULL)){
+		usart_rx_errors(ptrHandlerUsart6, auxSR);
+	}
 
-		// Bajamos la bandera del RXNE
-		USART6->SR &= ~USART_SR_RXNE;
+	// Evaluamos si la interrupción que se dio es por RX (sin DMA)
+	if((USART6->CR1 & USART_CR1_RXNEIE) && (auxSR & USART_SR_RXNE)){
 
-		// Guardamos el dato recibido en su variable correspondiente
+		// Guardamos el dato recibido (leer el DR baja el RXNE)
 		auxRxData.rxData_USART6 = USART6->DR;
+		if(ptrHandlerUsart6 != NULL){
+			usart_rx_push(ptrHandlerUsart6, auxRxData.rxData_USART6);
+		}
 
 		// Llamamos al Callback del USART6
 		usart6_RxCallback();
 	}
-	// Evaluamos si la interrupción es por TX
-	else{
-		__NOP();
+	// Con DMA el error llega por EIE, después de que el DMA tomó el byte: el DR sólo baja la bandera
+	else if(auxSR & USART_SR_RX_ERRORS){
+		(void)USART6->DR;
+	}
+	// Evaluamos si la interrupción es por TX (sólo si está encendida)
+	if((USART6->CR1 & USART_CR1_TXEIE) && (USART6->SR & USART_SR_TXE) && (ptrHandlerUsart6 != NULL)){
+		usart_tx_interrupt(ptrHandlerUsart6);
+	}
+	// Evaluamos si la línea quedó libre (fin de una trama recibida por DMA)
+	if((USART6->CR1 & USART_CR1_IDLEIE) && (auxSR & USART_SR_IDLE)){
+		// La bandera se baja leyendo SR y luego DR
+		(void)USART6->DR;
+		if(ptrHandlerUsart6 != NULL){
+			usart_rx_dma_process(ptrHandlerUsart6);
+		}
 	}
 }
 
 
+/* Handlers de los streams de DMA de cada USART (ver usart_driver_hal.h) */
+void DMA2_Stream7_IRQHandler(void){
+	// Fin de una transmisión del USART1
+	if(ptrHandlerUsart1 != NULL){
+		usart_tx_dma_interrupt(ptrHandlerUsart1);
+	}
+}
+
+void DMA2_Stream2_IRQHandler(void){
+	// Mitad o final del buffer de recepción del USART1
+	if(ptrHandlerUsart1 != NULL){
+		dma_ClearFlags(&ptrHandlerUsart1->dmaRx, DMA_FLAG_ALL);
+		usart_rx_dma_process(ptrHandlerUsart1);
+	}
+}
+
+void DMA1_Stream6_IRQHandler(void){
+	// Fin de una transmisión del USART2
+	if(ptrHandlerUsart2 != NULL){
+		usart_tx_dma_interrupt(ptrHandlerUsart2);
+	}
+}
+
+void DMA1_Stream5_IRQHandler(void){
+	// Mitad o final del buffer de recepción del USART2
+	if(ptrHandlerUsart2 != NULL){
+		dma_ClearFlags(&ptrHandlerUsart2->dmaRx, DMA_FLAG_ALL);
+		usart_rx_dma_process(ptrHandlerUsart2);
+	}
+}
+
+void DMA2_Stream6_IRQHandler(void){
+	// Fin de una transmisión del USART6
+	if(ptrHandlerUsart6 != NULL){
+		usart_tx_dma_interrupt(ptrHandlerUsart6);
+	}
+}
+
+void DMA2_Stream1_IRQHandler(void){
+	// Mitad o final del buffer de recepción del USART6
+	if(ptrHandlerUsart6 != NULL){
+		dma_ClearFlags(&ptrHandlerUsart6->dmaRx, DMA_FLAG_ALL);
+		usart_rx_dma_process(ptrHandlerUsart6);
+	}
+}
@@ -0,0 +1,313 @@
+/*
+ * format_benchmark.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ *
+ * Programa para el PC que compara format_driver_hal contra snprintf:
+ * 1. Verifica que ambos escriban exactamente el mismo texto para una lista de valores
+ *    (incluye empates como 0.5 o -1.25, que los dos redondean al par, y negativos que
+ *    redondean a cero, que los dos escriben con signo). Con una diferencia el programa
+ *    termina con 1.
+ * 2. Mide el tiempo de los mensajes que usan las aplicaciones.
+ * 3. Mide un mensaje por llamado con los macros de profiler_driver_hal (rdtsc o
+ *    clock_gettime en el PC), con la misma tabla que escribe el comando "prof" en el micro.
+ *
+ * El tiempo en el PC sólo sirve para comparar entre sí las dos versiones; en el
+ * Cortex-M4 la diferencia es mayor, porque el printf de newlib-nano con float
+ * hace las operaciones en double por software. Con -O2 el compilador cambia
+ * sprintf(buffer, "texto") por strcpy, así que ese caso sólo mejora en el build
+ * Debug (-O0), donde sí se llama al printf completo.
+ *
+ * Compilación (desde esta carpeta). El header del USART está junto a format_driver_hal.h,
+ * así que el mock se incluye primero con -include (tiene la misma guarda y el real se salta):
+ *   gcc -std=gnu11 -O2 -Wall -include mock/usart_driver_hal.h -I../../Inc -o format_benchmark \
+ *       format_benchmark.c ../../Src/format_driver_hal.c ../../Src/profiler_driver_hal.c
+ *
+ * Uso:
+ *   ./format_benchmark [iteraciones]
+ */
+
+// Importando librerías necesarias
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "format_driver_hal.h"
+#include "profiler_driver_hal.h"
+
+#define DEFAULT_ITERATIONS	1000000
+
+/* Secciones del profiler */
+enum
+{
+	PROF_SNPRINTF = 0,
+	PROF_FORMAT,
+	PROF_SCOPES
+};
+
+static const char *const profNames[PROF_SCOPES] = {"snprintf", "format"};
+
+/* Evita que el compilador elimine el trabajo de los loops */
+volatile uint32_t checksum = 0;
+
+/* === Headers for private functions === */
+static uint32_t verifyOutputs(void);
+static uint32_t checkText(const char *name, const char *expected, const char *obtained);
+static double elapsed_ns(struct timespec start, struct timespec end, uint32_t iterations);
+
+
+/* USART simulado: guarda los últimos bytes escritos */
+uint16_t usart_WriteBuffer(USART_Handler_t *ptrUsartHandler, uint8_t *data, uint16_t length){
+	if((ptrUsartHandler->length + length) >= USART_MOCK_BUFFER_SIZE){
+		ptrUsartHandler->length = 0;
+	}
+	memcpy(&ptrUsartHandler->buffer[ptrUsartHandler->length], data, length);
+	ptrUsartHandler->length += length;
+	return length;
+}
+
+
+int main(int argc, char *argv[]){
+
+	uint32_t iterations = DEFAULT_ITERATIONS;
+	if(argc > 1){
+		iterations = strtoul(argv[1], NULL, 10);
+	}
+
+	/* 1. Verificación */
+	uint32_t errors = verifyOutputs();
+	printf("Verificación: %s (%u diferencias)\n\n", errors ? "FALLA" : "OK", errors);
+
+	/* 2. Mensajes de prueba, iguales a los de las aplicaciones */
+	char buffer[64];
+	Format_Writer_t writer;
+	struct timespec start, end;
+	double time_sprintf, time_format;
+
+	printf("%-36s %12s %12s %8s\n", "Mensaje", "snprintf", "format", "veces");
+
+	/* 2.1 "Frecuencia: %.2f Hz\r\n" */
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < iterations; i++){
+		float frequency = 82.0f + (float)(i & 0x3FF) * 0.37f;
+		checksum += snprintf(buffer, sizeof(buffer), "Frecuencia: %.2f Hz\r\n", frequency);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	time_sprintf = elapsed_ns(start, end, iterations);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < iterations; i++){
+		float frequency = 82.0f + (float)(i & 0x3FF) * 0.37f;
+		format_InitBuffer(&writer, buffer, sizeof(buffer));
+		format_String(&writer, "Frecuencia: ");
+		format_Float(&writer, frequency, 2);
+		format_String(&writer, " Hz\r\n");
+		checksum += writer.length;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	time_format = elapsed_ns(start, end, iterations);
+	printf("%-36s %9.1f ns %9.1f ns %7.1fx\n", "Frecuencia: %.2f Hz", time_sprintf, time_format, time_sprintf / time_format);
+
+	/* 2.2 "Sensor1, Conversion: %u\n\r" */
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < iterations; i++){
+		checksum += snprintf(buffer, sizeof(buffer), "Sensor1, Conversion: %u\n\r", (unsigned int)(i & 0xFFF));
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	time_sprintf = elapsed_ns(start, end, iterations);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < iterations; i++){
+		format_InitBuffer(&writer, buffer, sizeof(buffer));
+		format_String(&writer, "Sensor1, Conversion: ");
+		format_Uint(&writer, i & 0xFFF, 0, FORMAT_PAD_SPACE);
+		format_String(&writer, "\n\r");
+		checksum += writer.length;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	time_format = elapsed_ns(start, end, iterations);
+	printf("%-36s %9.1f ns %9.1f ns %7.1fx\n", "Sensor1, Conversion: %u", time_sprintf, time_format, time_sprintf / time_format);
+
+	/* 2.3 Registro en hexadecimal */
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < iterations; i++){
+		checksum += snprintf(buffer, sizeof(buffer), "SR=0x%08X\r\n", (unsigned int)(i * 2654435761u));
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	time_sprintf = elapsed_ns(start, end, iterations);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < iterations; i++){
+		format_InitBuffer(&writer, buffer, sizeof(buffer));
+		format_String(&writer, "SR=0x");
+		format_Hex(&writer, i * 2654435761u, 8);
+		format_String(&writer, "\r\n");
+		checksum += writer.length;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	time_format = elapsed_ns(start, end, iterations);
+	printf("%-36s %9.1f ns %9.1f ns %7.1fx\n", "SR=0x%08X", time_sprintf, time_format, time_sprintf / time_format);
+
+	/* 2.4 Texto sin formato (las cadenas de la OLED) */
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < iterations; i++){
+		checksum += sprintf(buffer, "AFINANDO CUERDA 6");
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	time_sprintf = elapsed_ns(start, end, iterations);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < iterations; i++){
+		checksum += format_Copy(buffer, sizeof(buffer), "AFINANDO CUERDA 6");
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	time_format = elapsed_ns(start, end, iterations);
+	printf("%-36s %9.1f ns %9.1f ns %7.1fx\n", "\"AFINANDO CUERDA 6\"", time_sprintf, time_format, time_sprintf / time_format);
+
+	/* 3. "Frecuencia: %.2f Hz" medido en cada llamado, como en el micro */
+	prof_Init(profNames, PROF_SCOPES);
+	for(uint32_t i = 0; i < iterations; i++){
+		float frequency = 82.0f + (float)(i & 0x3FF) * 0.37f;
+
+		PROF_BEGIN(PROF_SNPRINTF);
+		checksum += snprintf(buffer, sizeof(buffer), "Frecuencia: %.2f Hz\r\n", frequency);
+		PROF_END(PROF_SNPRINTF);
+
+		PROF_BEGIN(PROF_FORMAT);
+		format_InitBuffer(&writer, buffer, sizeof(buffer));
+		format_String(&writer, "Frecuencia: ");
+		format_Float(&writer, frequency, 2);
+		format_String(&writer, " Hz\r\n");
+		PROF_END(PROF_FORMAT);
+		checksum += writer.length;
+	}
+
+	char dump[512];
+	format_InitBuffer(&writer, dump, sizeof(dump));
+	prof_Dump(&writer);
+	printf("\n%s", dump);
+
+	return errors ? 1 : 0;
+}
+
+
+/*
+ * Compara format_driver_hal con snprintf para una lista de valores
+ */
+static uint32_t verifyOutputs(void){
+
+	static const int32_t intValues[] = {0, 1, -1, 9, 10, 42, -42, 4095, 65535, 2147483647, (-2147483647 - 1)};
+	static const uint32_t uintValues[] = {0, 7, 100, 4095, 123456, 4294967295u};
+	static const float floatValues[] = {0.0f, -0.0f, 0.004f, -0.004f, 0.5f, 1.5f, 2.5f, -0.5f, 1.0f, -1.25f, 0.125f,
+										0.375f, 82.41f, 110.0f, 146.83f, 196.0f, 246.94f, 329.63f, 3.3f, 1.996f, -12.5f,
+										99999.99f, 2930.2f, 1e-30f, -1e-30f, 16777216.0f, 4294967040.0f};
+	static const uint8_t widths[] = {0, 3, 6};
+
+	char expected[256];
+	char obtained[64];
+	char name[64];
+	Format_Writer_t writer;
+	uint32_t errors = 0;
+
+	for(uint8_t w = 0; w < sizeof(widths); w++){
+		for(uint8_t i = 0; i < sizeof(intValues) / sizeof(intValues[0]); i++){
+			snprintf(expected, sizeof(expected), "%*ld", widths[w], (long)intValues[i]);
+			format_InitBuffer(&writer, obtained, sizeof(obtained));
+			format_Int(&writer, intValues[i], widths[w], FORMAT_PAD_SPACE);
+			snprintf(name, sizeof(name), "Int %ld ancho %u", (long)intValues[i], widths[w]);
+			errors += checkText(name, expected, obtained);
+
+			snprintf(expected, sizeof(expected), "%0*ld", widths[w], (long)intValues[i]);
+			format_InitBuffer(&writer, obtained, sizeof(obtained));
+			format_Int(&writer, intValues[i], widths[w], FORMAT_PAD_ZERO);
+			errors += checkText(name, expected, obtained);
+		}
+		for(uint8_t i = 0; i < sizeof(uintValues) / sizeof(uintValues[0]); i++){
+			snprintf(expected, sizeof(expected), "%*lu", widths[w], (unsigned long)uintValues[i]);
+			format_InitBuffer(&writer, obtained, sizeof(obtained));
+			format_Uint(&writer, uintValues[i], widths[w], FORMAT_PAD_SPACE);
+			snprintf(name, sizeof(name), "Uint %lu ancho %u", (unsigned long)uintValues[i], widths[w]);
+			errors += checkText(name, expected, obtained);
+		}
+	}
+
+	for(uint8_t i = 0; i < sizeof(uintValues) / sizeof(uintValues[0]); i++){
+		snprintf(expected, sizeof(expected), "%08lX", (unsigned long)uintValues[i]);
+		format_InitBuffer(&writer, obtained, sizeof(obtained));
+		format_Hex(&writer, uintValues[i], 8);
+		errors += checkText("Hex", expected, obtained);
+	}
+
+	for(uint8_t decimals = 0; decimals <= 4; decimals++){
+		for(uint8_t i = 0; i < sizeof(floatValues) / sizeof(floatValues[0]); i++){
+			snprintf(expected, sizeof(expected), "%.*f", decimals, (double)floatValues[i]);
+			format_InitBuffer(&writer, obtained, sizeof(obtained));
+			format_Float(&writer, floatValues[i], decimals);
+			snprintf(name, sizeof(name), "Float %.6g con %u decimales", (double)floatValues[i], decimals);
+			errors += checkText(name, expected, obtained);
+		}
+	}
+
+	/* Punto fijo: q15 y q16.16 contra el mismo valor en double */
+	static const int32_t fixedValues[] = {0, 1, -1, 16384, -16384, 32767, 98304, -98304, 123456789, 4, -4, 8, -8};
+	for(uint8_t i = 0; i < sizeof(fixedValues) / sizeof(fixedValues[0]); i++){
+		snprintf(expected, sizeof(expected), "%.4f", (double)fixedValues[i] / 65536.0);
+		format_InitBuffer(&writer, obtained, sizeof(obtained));
+		format_Fixed(&writer, fixedValues[i], 16, 4);
+		errors += checkText("Fixed q16.16", expected, obtained);
+
+		snprintf(expected, sizeof(expected), "%.5f", (double)fixedValues[i] / 32768.0);
+		format_InitBuffer(&writer, obtained, sizeof(obtained));
+		format_Fixed(&writer, fixedValues[i], 15, 5);
+		errors += checkText("Fixed q15", expected, obtained);
+	}
+
+	/* format_Put escoge la función según el tipo */
+	format_InitBuffer(&writer, obtained, sizeof(obtained));
+	format_Put(&writer, "f=");
+	format_Put(&writer, 82.41f);
+	format_Put(&writer, (char)' ');
+	format_Put(&writer, (uint16_t)4095);
+	format_Put(&writer, (char)' ');
+	format_Put(&writer, (int8_t)-7);
+	errors += checkText("format_Put", "f=82.41 4095 -7", obtained);
+
+	/* Truncado en un buffer pequeño */
+	char small[8];
+	format_InitBuffer(&writer, small, sizeof(small));
+	format_String(&writer, "Frecuencia: ");
+	format_Float(&writer, 82.41f, 2);
+	errors += checkText("Truncado", "Frecuen", small);
+	errors += (writer.flagOverflow != 1);
+
+	/* Directo al USART */
+	USART_Handler_t usart = {0};
+	format_InitUsart(&writer, &usart);
+	format_String(&writer, "Nota: ");
+	format_Float(&writer, -3.5f, 1);
+	usart.buffer[usart.length] = '\0';
+	errors += checkText("USART", "Nota: -3.5", usart.buffer);
+
+	return errors;
+}
+
+
+/*
+ * Compara dos textos: cualquier diferencia es un error
+ */
+static uint32_t checkText(const char *name, const char *expected, const char *obtained){
+
+	if(strcmp(expected, obtained) == 0){
+		return 0;
+	}
+
+	printf("  ERROR  %-32s snprintf '%s'  format '%s'\n", name, expected, obtained);
+	return 1;
+}
+
+
+static double elapsed_ns(struct timespec start, struct timespec end, uint32_t iterations){
+	double total = (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec);
+	return total / iterations;
+}
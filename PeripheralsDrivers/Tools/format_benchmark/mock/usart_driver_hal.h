@@ -0,0 +1,26 @@
+/*
+ * usart_driver_hal.h (mock para el PC)
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ *
+ * Reemplaza el header del USART para compilar format_driver_hal.c en el PC:
+ * usart_WriteBuffer escribe en un buffer en memoria.
+ */
+
+#ifndef USART_DRIVER_HAL_H_
+#define USART_DRIVER_HAL_H_
+
+#include <stdint.h>
+
+#define USART_MOCK_BUFFER_SIZE	256
+
+typedef struct
+{
+	char		buffer[USART_MOCK_BUFFER_SIZE];
+	uint16_t	length;
+} USART_Handler_t;
+
+uint16_t usart_WriteBuffer(USART_Handler_t *ptrUsartHandler, uint8_t *data, uint16_t length);
+
+#endif /* USART_DRIVER_HAL_H_ */
@@ -0,0 +1,137 @@
+/*
+ * stm32f4xx.h (mock para el PC)
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ *
+ * Lo mínimo del header de CMSIS para compilar usart_driver_hal.c y pll_driver_hal.c
+ * en el PC: los periféricos son estructuras en memoria (definidas en usart_baudrate.c)
+ * y los bits tienen los mismos valores que en stm32f411xe.h.
+ */
+
+#ifndef __STM32F4xx_H
+#define __STM32F4xx_H
+
+#include <stdint.h>
+
+#define __IO	volatile
+
+typedef enum
+{
+	USART1_IRQn = 37,
+	USART2_IRQn = 38,
+	DMA1_Stream5_IRQn = 16,
+	DMA1_Stream6_IRQn = 17,
+	DMA2_Stream1_IRQn = 57,
+	DMA2_Stream2_IRQn = 58,
+	DMA2_Stream6_IRQn = 69,
+	DMA2_Stream7_IRQn = 70,
+	USART6_IRQn = 71
+} IRQn_Type;
+
+typedef struct { __IO uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR; } USART_TypeDef;
+typedef struct { __IO uint32_t CR, NDTR, PAR, M0AR, M1AR, FCR; } DMA_Stream_TypeDef;
+typedef struct { __IO uint32_t LISR, HISR, LIFCR, HIFCR; } DMA_TypeDef;
+typedef struct { __IO uint32_t CR, PLLCFGR, CFGR, CIR, AHB1RSTR, AHB2RSTR, RESERVED0[2], APB1RSTR, APB2RSTR,
+				 RESERVED1[2], AHB1ENR, AHB2ENR, RESERVED2[2], APB1ENR, APB2ENR; } RCC_TypeDef;
+typedef struct { __IO uint32_t ACR, KEYR, OPTKEYR, SR, CR, OPTCR; } FLASH_TypeDef;
+typedef struct { __IO uint32_t CR, CSR; } PWR_TypeDef;
+
+extern USART_TypeDef mockUSART1, mockUSART2, mockUSART6;
+extern DMA_TypeDef mockDMA;
+extern DMA_Stream_TypeDef mockDMAStream;
+extern RCC_TypeDef mockRCC;
+extern FLASH_TypeDef mockFLASH;
+extern PWR_TypeDef mockPWR;
+
+#define USART1			(&mockUSART1)
+#define USART2			(&mockUSART2)
+#define USART6			(&mockUSART6)
+#define DMA1			(&mockDMA)
+#define DMA2			(&mockDMA)
+#define DMA1_Stream5	(&mockDMAStream)
+#define DMA1_Stream6	(&mockDMAStream)
+#define DMA2_Stream1	(&mockDMAStream)
+#define DMA2_Stream2	(&mockDMAStream)
+#define DMA2_Stream6	(&mockDMAStream)
+#define DMA2_Stream7	(&mockDMAStream)
+#define RCC				(&mockRCC)
+#define FLASH			(&mockFLASH)
+#define PWR				(&mockPWR)
+
+/* Intrínsecos del Cortex y del NVIC: no hacen nada en el PC */
+#define __NOP()						do{}while(0)
+#define __DMB()						do{}while(0)
+#define __disable_irq()				do{}while(0)
+#define __enable_irq()				do{}while(0)
+#define __NVIC_EnableIRQ(irq)		((void)(irq))
+#define __NVIC_DisableIRQ(irq)		((void)(irq))
+#define __NVIC_SetPriority(irq, p)	((void)(irq), (void)(p))
+
+/* USART */
+#define USART_SR_PE				(1u << 0)
+#define USART_SR_FE				(1u << 1)
+#define USART_SR_NE				(1u << 2)
+#define USART_SR_ORE			(1u << 3)
+#define USART_SR_IDLE			(1u << 4)
+#define USART_SR_RXNE			(1u << 5)
+#define USART_SR_TC				(1u << 6)
+#define USART_SR_TXE			(1u << 7)
+#define USART_CR1_RE			(1u << 2)
+#define USART_CR1_TE			(1u << 3)
+#define USART_CR1_IDLEIE		(1u << 4)
+#define USART_CR1_RXNEIE		(1u << 5)
+#define USART_CR1_TCIE			(1u << 6)
+#define USART_CR1_TXEIE			(1u << 7)
+#define USART_CR1_PS			(1u << 9)
+#define USART_CR1_PCE			(1u << 10)
+#define USART_CR1_M				(1u << 12)
+#define USART_CR1_UE			(1u << 13)
+#define USART_CR1_OVER8			(1u << 15)
+#define USART_CR2_STOP_0		(1u << 12)
+#define USART_CR2_STOP_1		(1u << 13)
+#define USART_CR2_STOP			(USART_CR2_STOP_0 | USART_CR2_STOP_1)
+#define USART_CR3_EIE			(1u << 0)
+#define USART_CR3_DMAR			(1u << 6)
+#define USART_CR3_DMAT			(1u << 7)
+
+/* RCC */
+#define RCC_CR_HSION			(1u << 0)
+#define RCC_CR_HSIRDY			(1u << 1)
+#define RCC_CR_PLLON			(1u << 24)
+#define RCC_CR_PLLRDY			(1u << 25)
+#define RCC_PLLCFGR_PLLM_Pos	0
+#define RCC_PLLCFGR_PLLM		(0x3Fu << RCC_PLLCFGR_PLLM_Pos)
+#define RCC_PLLCFGR_PLLN_Pos	6
+#define RCC_PLLCFGR_PLLN		(0x1FFu << RCC_PLLCFGR_PLLN_Pos)
+#define RCC_PLLCFGR_PLLP_Pos	16
+#define RCC_PLLCFGR_PLLP		(0x3u << RCC_PLLCFGR_PLLP_Pos)
+#define RCC_PLLCFGR_PLLSRC		(1u << 22)
+#define RCC_PLLCFGR_PLLQ_Pos	24
+#define RCC_CFGR_SW				(0x3u << 0)
+#define RCC_CFGR_SW_PLL			(0x2u << 0)
+#define RCC_CFGR_SWS			(0x3u << 2)
+#define RCC_CFGR_SWS_HSI		(0x0u << 2)
+#define RCC_CFGR_SWS_HSE		(0x1u << 2)
+#define RCC_CFGR_SWS_PLL		(0x2u << 2)
+#define RCC_CFGR_HPRE_Pos		4
+#define RCC_CFGR_HPRE			(0xFu << RCC_CFGR_HPRE_Pos)
+#define RCC_CFGR_PPRE1_Pos		10
+#define RCC_CFGR_PPRE1			(0x7u << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE1_DIV2		(0x4u << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE2_Pos		13
+#define RCC_CFGR_PPRE2			(0x7u << RCC_CFGR_PPRE2_Pos)
+#define RCC_APB1ENR_USART2EN	(1u << 17)
+#define RCC_APB1ENR_PWREN		(1u << 28)
+#define RCC_APB2ENR_USART1EN	(1u << 4)
+#define RCC_APB2ENR_USART6EN	(1u << 5)
+
+/* FLASH y PWR */
+#define FLASH_ACR_LATENCY		(0xFu << 0)
+#define FLASH_ACR_LATENCY_3WS	(0x3u << 0)
+#define FLASH_ACR_PRFTEN		(1u << 8)
+#define FLASH_ACR_ICEN			(1u << 9)
+#define FLASH_ACR_DCEN			(1u << 10)
+#define PWR_CR_VOS				(0x3u << 14)
+
+#endif /* __STM32F4xx_H */
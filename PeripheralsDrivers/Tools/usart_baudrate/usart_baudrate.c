@@ -0,0 +1,146 @@
+/*
+ * usart_baudrate.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ *
+ * Programa para el PC que imprime la tabla de error del baudrate: compila el
+ * usart_driver_hal.c y el pll_driver_hal.c reales contra un stm32f4xx.h de mentira
+ * (los registros son estructuras en memoria), configura cada velocidad con
+ * usart_Config y calcula la velocidad que resulta del BRR que quedó cargado.
+ *
+ * Se prueban los dos relojes que usan los proyectos:
+ * - HSI sin PLL: APB1 = APB2 = 16 MHz.
+ * - PLL de pll_Config_100MHz: APB1 = 50 MHz (USART2), APB2 = 100 MHz (USART1 y USART6).
+ * En cada caso con OVER8 = 0 (el driver pasa a OVER8 = 1 si no alcanza) y con OVER8 = 1.
+ *
+ * Compilación (desde esta carpeta):
+ *   gcc -std=gnu11 -O2 -Wall -Imock -I../../Inc -o usart_baudrate \
+ *       usart_baudrate.c ../../Src/usart_driver_hal.c ../../Src/pll_driver_hal.c
+ *
+ * Uso:
+ *   ./usart_baudrate
+ */
+
+// Importando librerías necesarias
+#include <stdio.h>
+#include <string.h>
+#include "stm32f4xx.h"
+#include "usart_driver_hal.h"
+#include "pll_driver_hal.h"
+
+/* Error máximo recomendado entre los dos extremos de la comunicación (%) */
+#define MAX_ERROR_PERCENT	2.0
+
+/* Periféricos de mentira que usa el mock de stm32f4xx.h */
+USART_TypeDef mockUSART1, mockUSART2, mockUSART6;
+DMA_TypeDef mockDMA;
+DMA_Stream_TypeDef mockDMAStream;
+RCC_TypeDef mockRCC;
+FLASH_TypeDef mockFLASH;
+PWR_TypeDef mockPWR;
+
+/* Velocidades que se prueban (en el orden del enum USART_BAUDRATE_xx) */
+static const uint32_t baudrates[] = {9600, 19200, 115200, 230400, 921600, 460800,
+									 1000000, 2000000, 3000000, 4000000, 6000000};
+
+static USART_Handler_t usartTest = {0};
+
+/* === Headers for private functions === */
+static void set_clock_hsi(void);
+static void set_clock_pll_100MHz(void);
+static void print_table(const char *name, USART_TypeDef *ptrUSARTx);
+
+
+/* El USART no usa DMA en esta prueba; estas funciones sólo completan el enlace */
+void dma_Config(DMA_Handler_t *ptrDmaHandler){ (void)ptrDmaHandler; }
+void dma_Start(DMA_Handler_t *ptrDmaHandler, volatile void *peripheral, void *memory, uint16_t length){
+	(void)ptrDmaHandler; (void)peripheral; (void)memory; (void)length;
+}
+uint8_t dma_GetFlags(DMA_Handler_t *ptrDmaHandler){ (void)ptrDmaHandler; return 0; }
+void dma_ClearFlags(DMA_Handler_t *ptrDmaHandler, uint8_t flags){ (void)ptrDmaHandler; (void)flags; }
+uint16_t dma_GetRemaining(DMA_Handler_t *ptrDmaHandler){ (void)ptrDmaHandler; return 0; }
+
+
+int main(void){
+
+	set_clock_hsi();
+	printf("=== HSI, sin PLL (SYSCLK = %lu Hz) ===\n", (unsigned long)pll_GetSysClock());
+	print_table("USART2 / USART1 / USART6", USART2);
+
+	set_clock_pll_100MHz();
+	printf("\n=== PLL de pll_Config_100MHz (SYSCLK = %lu Hz) ===\n", (unsigned long)pll_GetSysClock());
+	print_table("USART2 (APB1)", USART2);
+	print_table("USART1 / USART6 (APB2)", USART1);
+
+	return 0;
+}
+
+
+/*
+ * Registros del RCC después del reset: el sistema corre con el HSI
+ */
+static void set_clock_hsi(void){
+	memset(&mockRCC, 0, sizeof(mockRCC));
+}
+
+
+/*
+ * Registros del RCC como los deja pll_Config_100MHz (la función real espera a que el
+ * PLL se enganche, así que en el PC se cargan los valores directamente)
+ */
+static void set_clock_pll_100MHz(void){
+	memset(&mockRCC, 0, sizeof(mockRCC));
+	mockRCC.PLLCFGR = (8 << RCC_PLLCFGR_PLLM_Pos) | (100 << RCC_PLLCFGR_PLLN_Pos) |
+					  (0 << RCC_PLLCFGR_PLLP_Pos) | (4 << RCC_PLLCFGR_PLLQ_Pos);
+	mockRCC.CR = RCC_CR_PLLON | RCC_CR_PLLRDY;
+	mockRCC.CFGR = RCC_CFGR_SW_PLL | RCC_CFGR_SWS_PLL | RCC_CFGR_PPRE1_DIV2;
+}
+
+
+/*
+ * Configura cada velocidad en el USART y escribe el BRR, la velocidad real y el error
+ */
+static void print_table(const char *name, USART_TypeDef *ptrUSARTx){
+
+	static const uint8_t oversampling[2] = {USART_OVERSAMPLING_16, USART_OVERSAMPLING_8};
+
+	usartTest.ptrUSARTx = ptrUSARTx;
+	printf("\n%s, PCLK = %lu Hz\n", name, (unsigned long)usart_GetPclk(&usartTest));
+	printf("  baudrate  | pedido  | OVER8 |  BRR   | real (bps)  | error %%\n");
+
+	for(uint8_t i = 0; i < (sizeof(baudrates) / sizeof(baudrates[0])); i++){
+		for(uint8_t j = 0; j < 2; j++){
+
+			/* 1. Configuración con el driver real */
+			memset(&usartTest, 0, sizeof(usartTest));
+			usartTest.ptrUSARTx = ptrUSARTx;
+			usartTest.USART_Config.mode = USART_MODE_TX;
+			usartTest.USART_Config.baudrate = i;
+			usartTest.USART_Config.datasize = USART_DATASIZE_8BIT;
+			usartTest.USART_Config.parity = USART_PARITY_NONE;
+			usartTest.USART_Config.stopbits = USART_STOPBIT_1;
+			usartTest.USART_Config.oversampling = oversampling[j];
+			usart_Config(&usartTest);
+
+			/* 2. Velocidad exacta que sale del BRR: fPCLK / (8 * (2 - OVER8) * USARTDIV) */
+			uint32_t brr = ptrUSARTx->BRR;
+			uint8_t over8 = (ptrUSARTx->CR1 & USART_CR1_OVER8) ? 1 : 0;
+			double usartDiv = (double)(brr >> 4) + ((double)(brr & 0x0F) / (over8 ? 8.0 : 16.0));
+
+			printf("  %9lu |  %s  |   %u   | 0x%04lX | ",
+				   (unsigned long)baudrates[i], (j == 0) ? "x16" : " x8", over8, (unsigned long)brr);
+
+			if(usartDiv < 1.0){
+				printf("%11s | no alcanzable\n", "-");
+				continue;
+			}
+
+			double actual = (double)usart_GetPclk(&usartTest) / (8.0 * (2 - over8) * usartDiv);
+			double error = 100.0 * (actual - (double)baudrates[i]) / (double)baudrates[i];
+
+			printf("%11.0f | %+7.3f%s\n", actual, error,
+				   ((error > MAX_ERROR_PERCENT) || (error < -MAX_ERROR_PERCENT)) ? "  <- fuera de tolerancia" : "");
+		}
+	}
+}
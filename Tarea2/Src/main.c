@@ -57,6 +57,12 @@ GPIO_Handler_t segmentoE = {0}; // Pin PC2
 GPIO_Handler_t segmentoF = {0}; // Pin PB10
 GPIO_Handler_t segmentoG = {0}; // Pin PC0
 
+// Segmentos A-G como un grupo (bit 0 -> A ... bit 6 -> G), para escribir un dígito con un
+// store en BSRR por puerto. digitosBSRR se calcula una vez al configurar los pines
+GPIO_PinGroup_t segmentos = {0};
+GPIO_GroupWord_t digitosBSRR[10] = {0};
+const uint8_t patronesDigitos[10] = {0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x67};
+
 // Pines para controlar la activación-desactivación de los transistores para alternar
 // entre los cristales del 7-segmentos
 GPIO_Handler_t cristal1 = {0}; // Pin PA4
@@ -152,6 +158,23 @@ int main(void)
 	gpio_Config(&segmentoF);
 	gpio_Config(&segmentoG);
 
+	/* Grupo de los segmentos y palabra BSRR de cada dígito. El segmento enciende con el
+	 * pin en bajo, por eso se escribe el patrón negado
+	 */
+	segmentos.pins[0] = &segmentoA;
+	segmentos.pins[1] = &segmentoB;
+	segmentos.pins[2] = &segmentoC;
+	segmentos.pins[3] = &segmentoD;
+	segmentos.pins[4] = &segmentoE;
+	segmentos.pins[5] = &segmentoF;
+	segmentos.pins[6] = &segmentoG;
+	segmentos.numPins = 7;
+	gpio_GroupConfig(&segmentos);
+
+	for(uint8_t i = 0; i < 10; i++){
+		gpio_GroupEncode(&segmentos, (uint8_t)~patronesDigitos[i], &digitosBSRR[i]);
+	}
+
 
 	/* Configuramos los pines del encoder */
 
@@ -325,123 +348,9 @@ void Timer2_Callback(void){
 // Función para encender los leds del 7-segmentos, para representar el numero_x
 void numeros(uint8_t numero_x){
 
-	// Hacemos un switch para cada numero del 0-9
-	switch(numero_x){
-	case 0:{
-		// El led se enciende cuando el voltaje dado por el pin sea bajo
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, SET);
-		break;
-	}
-
-	case 1:{
-		gpio_WritePin(&segmentoA, SET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, SET);
-		break;
-	}
-
-	case 2:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, SET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 3:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 4:{
-		gpio_WritePin(&segmentoA, SET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 5:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, SET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 6:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, SET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 7:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, SET);
-		break;
-	}
-
-	case 8:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 9:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	default:{
-		__NOP();
-		break;
-	}
+	// Todos los segmentos cambian a la vez (un store por puerto), sin estados intermedios
+	if(numero_x < 10){
+		gpio_GroupWrite(&segmentos, &digitosBSRR[numero_x]);
 	}
 
 }
@@ -0,0 +1,52 @@
+/*
+ * tarjeta.h
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef TARJETA_H_
+#define TARJETA_H_
+
+#include "gpio_driver_hal.h"
+
+/*
+ * Pines de la tarjeta de la Tarea 3 y las tablas que los reúnen. Están aparte de los
+ * programas para que Tools/board_check revise las mismas tablas en el PC (sin los demás
+ * periféricos). Los dos programas usan la misma tarjeta y sólo cambian el puerto serial:
+ * main.c usa el USART6 (tarjeta) y mainMultiChannel.c el USART2 (tarjetaMultiCanal).
+ */
+
+// Led de estado
+extern GPIO_Handler_t stateLed;
+
+// Encoder
+extern GPIO_Handler_t encoderClk;
+extern GPIO_Handler_t data;
+extern GPIO_Handler_t sw;
+
+// 7-segmentos
+extern GPIO_Handler_t segmentoA;
+extern GPIO_Handler_t segmentoB;
+extern GPIO_Handler_t segmentoC;
+extern GPIO_Handler_t segmentoD;
+extern GPIO_Handler_t segmentoE;
+extern GPIO_Handler_t segmentoF;
+extern GPIO_Handler_t segmentoG;
+extern GPIO_Handler_t segmentoPunto;
+extern GPIO_Handler_t display1;
+extern GPIO_Handler_t display2;
+
+// USART6
+extern GPIO_Handler_t pinTx;
+extern GPIO_Handler_t pinRx;
+
+// USART2
+extern GPIO_Handler_t pinTxUsart2;
+extern GPIO_Handler_t pinRxUsart2;
+
+// Tablas de todos los pines (gpio_ConfigBoard / gpio_CheckBoard)
+extern const GPIO_Board_t tarjeta;
+extern const GPIO_Board_t tarjetaMultiCanal;
+
+#endif /* TARJETA_H_ */
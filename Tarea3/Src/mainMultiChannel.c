@@ -18,6 +18,8 @@
 #include "usart_driver_hal.h"
 #include "adc_driver_hal.h"
 #include "pwm_driver_hal.h"
+#include "sevenseg_driver_hal.h"
+#include "tarjeta.h"
 
 /* ===== Definición de variables ===== */
 /* Definición de variables contadoras para cada modo
@@ -31,7 +33,6 @@ uint8_t readData = 0;
 
 /* Definición de las banderas */
 uint8_t flagMode = 0;		// Bandera del EXTI del Switch. Se asigna 0 para indicar que se inicializa en Modo Resolución
-uint8_t flagTimer2 = 0; 	// Bandera del conmutador de los display. Con esta bandera encendemos y apagamos los displays.
 uint8_t flagData = 0;		// Bandera del EXTI del Encoder.
 uint8_t flagRx = 0;			// Bandera para indicar la recepción de la transmisión serial
 uint8_t sendMsg = 0;		// Bandera para mostrar la lectura del ADC cada 2 segundos
@@ -59,6 +60,13 @@ enum
 	MODO_SENSOR
 };
 
+// Dígitos del 7-segmentos (posición en el multiplexado)
+enum
+{
+	DISPLAY_RES = 0,	// Cristal 1 (PA4) -> Resolución
+	DISPLAY_SENSOR		// Cristal 2 (PA10) -> Sensor
+};
+
 // Constantes para ON y OFF
 enum
 {
@@ -66,37 +74,24 @@ enum
 	ON
 };
 
-/* ===== Definición de los pines a utilizar ===== */
-
-// Pin para el led de estado
-GPIO_Handler_t stateLed = {0}; // Pin PA5 (led de estado)
+/* Los pines de la tarjeta y su tabla están en tarjeta.c */
 
-// Pines para el encoder
-GPIO_Handler_t encoderClk = {0}; // Pin PC8 (Canal 8 del EXTI)
-GPIO_Handler_t data = {0};	// Pin PB2
-GPIO_Handler_t sw = {0};	// Pin PA0 (Canal 0 del EXTI)
-
-// Pines para el 7-segmentos
-GPIO_Handler_t segmentoA = {0}; // Pin PB5
-GPIO_Handler_t segmentoB = {0}; // Pin PC4
-GPIO_Handler_t segmentoC = {0}; // Pin PC3
-GPIO_Handler_t segmentoD = {0}; // Pin PB0
-GPIO_Handler_t segmentoE = {0}; // Pin PC2
-GPIO_Handler_t segmentoF = {0}; // Pin PB10
-GPIO_Handler_t segmentoG = {0}; // Pin PC0
-GPIO_Handler_t segmentoPunto = {0}; // Pin
+// Segmentos de cada resolución, en el orden de RESOLUTION_xx (12, 10, 8 y 6 bits)
+const uint8_t patronesResolucion[4] = {
+		SEVENSEG_SEG_A | SEVENSEG_SEG_D | SEVENSEG_SEG_G,
+		SEVENSEG_SEG_D | SEVENSEG_SEG_G,
+		SEVENSEG_SEG_D,
+		SEVENSEG_SEG_E
+};
 
 
-// Pines para controlar la activación-desactivación de los transistores para alternar
-// entre los cristales del 7-segmentos
-GPIO_Handler_t display1 = {0}; // Pin PA4
-GPIO_Handler_t display2 = {0}; // Pin PA10
+// Multiplexado de los dos cristales por DMA (TIM1 + DMA2), sin interrupciones
+SevenSeg_Handler_t displays = {0};
 
 
 /* Definición de los Timers a utilizar para generar las interrupciones
- * del blinky y del 7 segmentos */
-Timer_Handler_t blinkTimer3 = {0};	// Timer 2 para el stateLed
-Timer_Handler_t sevenSegmentTimer2 = {0};	// Timer 3 para el 7-segmentos
+ * del blinky y de los mensajes */
+Timer_Handler_t blinkTimer3 = {0};	// Timer 3 para el stateLed
 Timer_Handler_t messageTimer4 = {0};	// Timer 4 para enviar mensajes seriales cada 2 segundos
 
 
@@ -116,8 +111,6 @@ uint8_t flagOVR = 0; // Bandera para atender la interrupción por pérdida de da
 
 /* Configuración de la comunicación serial */
 USART_Handler_t usart2 = {0}; // Configuración de la transmisión serial por USART2
-GPIO_Handler_t pinTx = {0};	// P -> Pin para la transmisión serial
-GPIO_Handler_t pinRx = {0};	// P -> Pin para la recepción serial
 rxDataUsart received_USARTx = {0};	// Estructura para guardar los datos según el USART utilizado
 char bufferData[64] = {0};
 
@@ -130,9 +123,6 @@ void systemConfig(void);
 // Función para mostrar correctamente la resolución seleccionada y el sensor seleccionado en el display
 void displayMode(void);
 
-// Función para representar un numero_x en el 7-segmentos
-void displayNumeros(uint8_t numero_x);
-
 // Función para controlar los segmentos en el modo Sensores
 void modeSensor(void);
 
@@ -160,7 +150,6 @@ int main(void)
 
 	// Iniciamos con todas las banderas abajo
 	flagMode = MODO_RESOLUCION;
-	flagTimer2 = 0;
 	flagData = 0;
 	sendMsg = 0;
 	flagRx = 0;
@@ -175,6 +164,9 @@ int main(void)
 	/* Loop forever */
 	while(1){
 
+			// Actualizamos lo que muestran los displays (sólo cambia el buffer del DMA si algo cambió)
+			displayMode();
+
 			// Atiende la interrupción recibida a través de transmisión serial
 			if(received_USARTx.rxData_USART2){ // Si no está vacía la variable que almacena los datos recibidos
 
@@ -237,72 +229,8 @@ void systemConfig(void){
 
 	/* ===== Configurando los pines que vamos a utilizar ===== */
 
-	/* Configuraciones de los pines del 7-segmentos */
-	segmentoA.pGPIOx							= GPIOB;
-	segmentoA.pinConfig.GPIO_PinNumber			= PIN_5;
-	segmentoA.pinConfig.GPIO_PinMode			= GPIO_MODE_OUT;
-	segmentoA.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	segmentoA.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	segmentoA.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	segmentoB.pGPIOx							= GPIOC;
-	segmentoB.pinConfig.GPIO_PinNumber			= PIN_4;
-	segmentoB.pinConfig.GPIO_PinMode			= GPIO_MODE_OUT;
-	segmentoB.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	segmentoB.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	segmentoB.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	segmentoC.pGPIOx							= GPIOC;
-	segmentoC.pinConfig.GPIO_PinNumber			= PIN_2;
-	segmentoC.pinConfig.GPIO_PinMode			= GPIO_MODE_OUT;
-	segmentoC.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	segmentoC.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	segmentoC.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	segmentoD.pGPIOx							= GPIOB;
-	segmentoD.pinConfig.GPIO_PinNumber			= PIN_0;
-	segmentoD.pinConfig.GPIO_PinMode			= GPIO_MODE_OUT;
-	segmentoD.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	segmentoD.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	segmentoD.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	segmentoE.pGPIOx							= GPIOC;
-	segmentoE.pinConfig.GPIO_PinNumber			= PIN_1;
-	segmentoE.pinConfig.GPIO_PinMode			= GPIO_MODE_OUT;
-	segmentoE.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	segmentoE.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	segmentoE.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	segmentoF.pGPIOx							= GPIOB;
-	segmentoF.pinConfig.GPIO_PinNumber			= PIN_10;
-	segmentoF.pinConfig.GPIO_PinMode			= GPIO_MODE_OUT;
-	segmentoF.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	segmentoF.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	segmentoF.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	segmentoG.pGPIOx							= GPIOC;
-	segmentoG.pinConfig.GPIO_PinNumber			= PIN_0;
-	segmentoG.pinConfig.GPIO_PinMode			= GPIO_MODE_OUT;
-	segmentoG.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	segmentoG.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	segmentoG.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	segmentoPunto.pGPIOx							= GPIOC;
-	segmentoPunto.pinConfig.GPIO_PinNumber			= PIN_3;
-	segmentoPunto.pinConfig.GPIO_PinMode			= GPIO_MODE_OUT;
-	segmentoPunto.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	segmentoPunto.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	segmentoPunto.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	/* Cargamos la configuración de los pines */
-	gpio_Config(&segmentoA);
-	gpio_Config(&segmentoB);
-	gpio_Config(&segmentoC);
-	gpio_Config(&segmentoD);
-	gpio_Config(&segmentoE);
-	gpio_Config(&segmentoF);
-	gpio_Config(&segmentoG);
-	gpio_Config(&segmentoPunto);
+	/* Cargamos la configuración de todos los pines de la tabla (USART2 en PA2 y PA3) */
+	gpio_ConfigBoard(&tarjetaMultiCanal);
 
 	/* Empezamos con los leds apagados */
 	gpio_WritePin(&segmentoA, RESET);
@@ -315,95 +243,37 @@ void systemConfig(void){
 	gpio_WritePin(&segmentoPunto, RESET);
 
 
-	/* ===== Configuramos los pines del Encoder ===== */
-
-	/* Pin del Encoder Clock */
-	encoderClk.pGPIOx							= GPIOC;
-	encoderClk.pinConfig.GPIO_PinNumber			= PIN_8;
-	encoderClk.pinConfig.GPIO_PinMode			= GPIO_MODE_IN;
-
-	/* Pin del Switch */
-	sw.pGPIOx							= GPIOA;
-	sw.pinConfig.GPIO_PinNumber			= PIN_0;
-	sw.pinConfig.GPIO_PinMode			= GPIO_MODE_IN;
-
-	/* Pin de la salida de datos del encoder */
-	data.pGPIOx							= GPIOB;
-	data.pinConfig.GPIO_PinNumber		= PIN_2;
-	data.pinConfig.GPIO_PinMode			= GPIO_MODE_IN;
-
-	/* Se cargan las configuraciones de los respectivos pines */
-	gpio_Config(&encoderClk);
-	gpio_Config(&sw);
-	gpio_Config(&data);
-
-
 	/* ===== Configuramos los leds de estado, modo y los pines para conmutar los cristales del 7-segmentos ====== */
 
-	/* Configurando el pin del stateLed */
-	stateLed.pGPIOx								= GPIOA;
-	stateLed.pinConfig.GPIO_PinNumber			= PIN_5;
-	stateLed.pinConfig.GPIO_PinMode				= GPIO_MODE_OUT;
-	stateLed.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	stateLed.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	stateLed.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	/* Cargamos la configuración del pin */
-	gpio_Config(&stateLed);
 	gpio_WritePin(&stateLed, SET); // El led de estado empieza encendido
 
-
-	/* Configurando el pin del cristal1 (7-segmentos) */
-	display1.pGPIOx								= GPIOA;
-	display1.pinConfig.GPIO_PinNumber			= PIN_4;
-	display1.pinConfig.GPIO_PinMode				= GPIO_MODE_OUT;
-	display1.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	display1.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	display1.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	/* Cargamos la configuración del pin */
-	gpio_Config(&display1);
-	gpio_WritePin(&display1, SET); // Encendemos el Pin
-
-	/* Configurando el pin del cristal2 (7-segmentos) */
-	display2.pGPIOx								= GPIOA;
-	display2.pinConfig.GPIO_PinNumber			= PIN_10;
-	display2.pinConfig.GPIO_PinMode				= GPIO_MODE_OUT;
-	display2.pinConfig.GPIO_PinOutputType		= GPIO_OTYPE_PUSHPULL;
-	display2.pinConfig.GPIO_PinOutputSpeed		= GPIO_OSPEED_MEDIUM;
-	display2.pinConfig.GPIO_PinPuPdControl		= GPIO_PUPDR_NOTHING;
-
-	/* Cargamos la configuración del pin */
-	gpio_Config(&display2);
-	gpio_WritePin(&display2, RESET); // Apagamos el Pin
-
-
-	/* ===== Configuramos los pines RX y TX para la transmisión serial ===== */
-
-	/* Configurando los pines para el puerto serial mediante USART2
-	 *  - Usamos el PinA11 para TX (Se conecta al blanco)
-	 */
-	pinTx.pGPIOx								= GPIOA;
-	pinTx.pinConfig.GPIO_PinNumber				= PIN_2;
-	pinTx.pinConfig.GPIO_PinMode				= GPIO_MODE_ALTFN;
-	pinTx.pinConfig.GPIO_PinAltFunMode			= AF7;
-	pinTx.pinConfig.GPIO_PinPuPdControl			= GPIO_PUPDR_NOTHING;
-	pinTx.pinConfig.GPIO_PinOutputSpeed			= GPIO_OSPEED_FAST;
-
-	/* Cargamos la configuración */
-	gpio_Config(&pinTx);
-
-
-	/* - Usamos el PinA12 para RX (Se conecta al verde) */
-	pinRx.pGPIOx								= GPIOA;
-	pinRx.pinConfig.GPIO_PinNumber				= PIN_3;
-	pinRx.pinConfig.GPIO_PinMode				= GPIO_MODE_ALTFN;
-	pinRx.pinConfig.GPIO_PinAltFunMode			= AF7;
-	pinRx.pinConfig.GPIO_PinPuPdControl			= GPIO_PUPDR_NOTHING;
-	pinRx.pinConfig.GPIO_PinOutputSpeed			= GPIO_OSPEED_FAST;
-
-	/* Cargamos la configuración */
-	gpio_Config(&pinRx);
+	/* Los cristales empiezan apagados (los enciende el multiplexado) */
+	gpio_WritePin(&display1, RESET);
+	gpio_WritePin(&display2, RESET);
+
+
+	/* ===== Configuramos el multiplexado del 7-segmentos ===== */
+
+	/* Segmentos (encienden con el pin en bajo) y cristales (encienden con el pin en alto) */
+	displays.segmentPins[0]				= &segmentoA;
+	displays.segmentPins[1]				= &segmentoB;
+	displays.segmentPins[2]				= &segmentoC;
+	displays.segmentPins[3]				= &segmentoD;
+	displays.segmentPins[4]				= &segmentoE;
+	displays.segmentPins[5]				= &segmentoF;
+	displays.segmentPins[6]				= &segmentoG;
+	displays.segmentPins[7]				= &segmentoPunto;
+	displays.digitPins[DISPLAY_RES]		= &display1;
+	displays.digitPins[DISPLAY_SENSOR]	= &display2;
+	displays.config.numDigits			= 2;
+	displays.config.segmentActiveLevel	= GPIO_PIN_RESET;
+	displays.config.digitActiveLevel	= GPIO_PIN_SET;
+	displays.config.phaseFrequency		= 1000;	// Cada cristal se refresca a 500 Hz
+
+	/* Cargamos la configuración y lo encendemos: desde aquí el DMA conmuta los cristales */
+	sevenseg_Config(&displays);
+	displayMode();
+	sevenseg_Start(&displays);
 
 
 	/* ====== Configuramos las interrupciones externas (EXTI) ===== */
@@ -432,13 +302,6 @@ void systemConfig(void){
 	blinkTimer3.TIMx_Config.TIMx_mode					= TIMER_UP_COUNTER;	// El Timer cuenta ascendente
 	blinkTimer3.TIMx_Config.TIMx_InterruptEnable		= TIMER_INT_ENABLE;	// Se activa la interrupción
 
-	/* Configurando el TIMER2 para el 7-segmentos (Timer de 32 bits) */
-	sevenSegmentTimer2.pTIMx								= TIM2;
-	sevenSegmentTimer2.TIMx_Config.TIMx_Prescaler			= 16000;	// Genera incrementos de 1 ms
-	sevenSegmentTimer2.TIMx_Config.TIMx_Period				= 8;		// Encendiendo y apagando el cristal cada 16ms, obtenemos aproximadamente 60 FPS
-	sevenSegmentTimer2.TIMx_Config.TIMx_mode				= TIMER_UP_COUNTER;	// El Timer cuenta ascendente
-	sevenSegmentTimer2.TIMx_Config.TIMx_InterruptEnable		= TIMER_INT_ENABLE;	// Se activa la interrupción
-
 	/* Configurando el TIMER4 para mostrar un mensaje cada 2 segundos */
 	messageTimer4.pTIMx									= TIM4;
 	messageTimer4.TIMx_Config.TIMx_Prescaler			= 16000;	// Genera incrementos de 1 ms
@@ -450,9 +313,6 @@ void systemConfig(void){
 	timer_Config(&blinkTimer3);
 	timer_SetState(&blinkTimer3, TIMER_ON);
 
-	timer_Config(&sevenSegmentTimer2);
-	timer_SetState(&sevenSegmentTimer2, TIMER_ON);
-
 	timer_Config(&messageTimer4);
 	timer_SetState(&messageTimer4, TIMER_ON);
 
@@ -515,36 +375,8 @@ void systemConfig(void){
  */
 void modeSensor(void){
 
-	// Encendemos el segmento del punto si está en modo Sensor
-	if(flagMode == MODO_SENSOR){
-		gpio_WritePin(&segmentoPunto, RESET);
-	}
-	else{
-		gpio_WritePin(&segmentoPunto, SET);
-	}
-
-	// Evaluamos cuál sensor está activo (seleccionado)
-	switch(contadorSensor){
-	case SENSOR1:{
-		// Mostramos el número 1
-		displayNumeros(SENSOR1);
-		break;
-	}
-	case SENSOR2:{
-		// Mostramos el número 2
-		displayNumeros(SENSOR2);
-		break;
-	}
-	case SENSOR3:{
-		// Mostramos el número 3
-		displayNumeros(SENSOR3);
-		break;
-	}
-	default:{
-		__NOP();
-		break;
-	}
-	}
+	// Mostramos el número del sensor, con el punto encendido si está en modo Sensor
+	sevenseg_SetDigit(&displays, DISPLAY_SENSOR, contadorSensor, (flagMode == MODO_SENSOR));
 
 } // Fin función modeSensor()
 
@@ -554,73 +386,15 @@ void modeSensor(void){
  */
 void modeRes(void){
 
+	// Segmentos de la resolución actual (12 bits -> A, D, G; 10 -> D, G; 8 -> D; 6 -> E)
+	uint8_t patron = (contadorRes <= RESOLUTION_6_BIT) ? patronesResolucion[contadorRes] : 0;
+
 	// Encendemos el segmento del punto si está en modo Resolución
 	if(flagMode == MODO_RESOLUCION){
-		gpio_WritePin(&segmentoPunto, RESET);
-	}
-	else{
-		gpio_WritePin(&segmentoPunto, SET);
+		patron |= SEVENSEG_SEG_DP;
 	}
 
-	// Evaluamos en qué resolución nos encontramos
-	switch(contadorRes){
-	case RESOLUTION_12_BIT:{
-
-		// Encendemos los segmentos A, D, G
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-
-		gpio_WritePin(&segmentoB, SET);
-		gpio_WritePin(&segmentoC, SET);
-		gpio_WritePin(&segmentoF, SET);
-		break;
-	}
-	case RESOLUTION_10_BIT:{
-
-		// Encendemos los segmentos D, G
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoA, SET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoG, RESET);
-
-		gpio_WritePin(&segmentoB, SET);
-		gpio_WritePin(&segmentoC, SET);
-		gpio_WritePin(&segmentoF, SET);
-		break;
-	}
-	case RESOLUTION_8_BIT:{
-
-		// Encendemos los segmentos D
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoA, SET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoG, SET);
-
-		gpio_WritePin(&segmentoB, SET);
-		gpio_WritePin(&segmentoC, SET);
-		gpio_WritePin(&segmentoF, SET);
-		break;
-	}
-	case RESOLUTION_6_BIT:{
-
-		// Encendemos los segmentos E
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoA, SET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoG, SET);
-
-		gpio_WritePin(&segmentoB, SET);
-		gpio_WritePin(&segmentoC, SET);
-		gpio_WritePin(&segmentoF, SET);
-		break;
-	}
-	default:{
-		__NOP();
-		break;
-	}
-	}
+	sevenseg_SetPattern(&displays, DISPLAY_RES, patron);
 
 } // Fin función modeRes()
 
@@ -639,84 +413,18 @@ void configSensor(ADC_Config_t sensorHandler, uint8_t canal, uint8_t resolucion)
 
 
 /*
- * Función para mostrar el modo, según el display que esté encendido
+ * Función para mostrar el modo en los dos cristales. Sólo se recalcula la fase del
+ * cristal que cambió; el DMA se encarga de encenderlos y apagarlos
  */
 void displayMode(void){
 
-
-	// Determinamos cuál display está encendido
-	if(gpio_ReadPin(&display1) == ON){
-		// Si es el display izquierdo (1), mostramos el modo Sensor
-		modeRes();
-	}
-	else{
-		// Si es el display derecho (2), mostramos el modo Resolución
-		modeSensor();
-	}
+	// Display izquierdo (1): Resolución. Display derecho (2): Sensor
+	modeRes();
+	modeSensor();
 
 } // Fin función displayMode()
 
 
-/*
- * Función para encender los leds del 7-segmentos, para representar el numero_x
- */
-void displayNumeros(uint8_t numero_x){
-
-	// Hacemos un switch para cada numero del 0-9
-	switch(numero_x){
-	case 0:{
-		// El led se enciende cuando el voltaje dado por el pin sea bajo
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, RESET);
-		gpio_WritePin(&segmentoG, SET);
-		break;
-	}
-
-	case 1:{
-		gpio_WritePin(&segmentoA, SET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, SET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, SET);
-		break;
-	}
-
-	case 2:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, SET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, RESET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-
-	case 3:{
-		gpio_WritePin(&segmentoA, RESET);
-		gpio_WritePin(&segmentoB, RESET);
-		gpio_WritePin(&segmentoC, RESET);
-		gpio_WritePin(&segmentoD, RESET);
-		gpio_WritePin(&segmentoE, SET);
-		gpio_WritePin(&segmentoF, SET);
-		gpio_WritePin(&segmentoG, RESET);
-		break;
-	}
-	default:{
-		__NOP();
-		break;
-	}
-	}
-
-} // Fin función displayNumeros()
-
-
 // Función para evaluar si se aumenta o disminuye el contador
 void evaluate(void){
 
@@ -787,17 +495,6 @@ void Timer3_Callback(void){
 }
 
 
-/* Esta función atiende la interrupción del TIMER2, la cual controla el activación
- * de los cristales del 7-segmentos a una frecuencia que simule que ambos están
- * encendidos continuamente
- * */
-void Timer2_Callback(void){
-	gpio_TooglePin(&display1);
-	displayMode();
-	gpio_TooglePin(&display2);
-}
-
-
 /* Esta función atiende la interrupción del TIMER4, la cual envía por transmisión
  * serial el último dato guardado en el dataBuffer
  */
@@ -0,0 +1,61 @@
+/*
+ * tarjeta.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#include "tarjeta.h"
+
+/* ===== Definición de los pines a utilizar ===== */
+
+// Pin para el led de estado
+GPIO_Handler_t stateLed = GPIO_OUTPUT_INIT(GPIOA, PIN_5); // Pin PA5 (led de estado)
+
+// Pines para el encoder
+GPIO_Handler_t encoderClk = GPIO_INPUT_INIT(GPIOC, PIN_8, GPIO_PUPDR_NOTHING); // Pin PC8 (Canal 8 del EXTI)
+GPIO_Handler_t data = GPIO_INPUT_INIT(GPIOB, PIN_2, GPIO_PUPDR_NOTHING);	// Pin PB2
+GPIO_Handler_t sw = GPIO_INPUT_INIT(GPIOA, PIN_0, GPIO_PUPDR_NOTHING);	// Pin PA0 (Canal 0 del EXTI)
+
+// Pines para el 7-segmentos
+GPIO_Handler_t segmentoA = GPIO_OUTPUT_INIT(GPIOB, PIN_5); // Pin PB5
+GPIO_Handler_t segmentoB = GPIO_OUTPUT_INIT(GPIOC, PIN_4); // Pin PC4
+GPIO_Handler_t segmentoC = GPIO_OUTPUT_INIT(GPIOC, PIN_2); // Pin PC2
+GPIO_Handler_t segmentoD = GPIO_OUTPUT_INIT(GPIOB, PIN_0); // Pin PB0
+GPIO_Handler_t segmentoE = GPIO_OUTPUT_INIT(GPIOC, PIN_1); // Pin PC1
+GPIO_Handler_t segmentoF = GPIO_OUTPUT_INIT(GPIOB, PIN_10); // Pin PB10
+GPIO_Handler_t segmentoG = GPIO_OUTPUT_INIT(GPIOC, PIN_0); // Pin PC0
+GPIO_Handler_t segmentoPunto = GPIO_OUTPUT_INIT(GPIOC, PIN_3); // Pin PC3
+
+// Pines para controlar la activación-desactivación de los transistores para alternar
+// entre los cristales del 7-segmentos
+GPIO_Handler_t display1 = GPIO_OUTPUT_INIT(GPIOA, PIN_4); // Pin PA4
+GPIO_Handler_t display2 = GPIO_OUTPUT_INIT(GPIOA, PIN_10); // Pin PA10
+
+// Pines de la comunicación serial por USART6
+GPIO_Handler_t pinTx = GPIO_ALTFN_INIT(GPIOA, PIN_11, AF8, GPIO_OSPEED_FAST);	// PA11 -> Pin para la transmisión serial (blanco)
+GPIO_Handler_t pinRx = GPIO_ALTFN_INIT(GPIOA, PIN_12, AF8, GPIO_OSPEED_FAST);	// PA12 -> Pin para la recepción serial (verde)
+
+// Pines de la comunicación serial por USART2 (prueba del ADC multicanal)
+GPIO_Handler_t pinTxUsart2 = GPIO_ALTFN_INIT(GPIOA, PIN_2, AF7, GPIO_OSPEED_FAST);	// PA2 -> Pin para la transmisión serial
+GPIO_Handler_t pinRxUsart2 = GPIO_ALTFN_INIT(GPIOA, PIN_3, AF7, GPIO_OSPEED_FAST);	// PA3 -> Pin para la recepción serial
+
+/* Tablas de todos los pines de la tarjeta (quedan en flash). gpio_ConfigBoard los configura
+ * en una sola pasada, y Tools/board_check las revisa en el PC con gpio_CheckBoard */
+static GPIO_Handler_t *const pinesTarjeta[] = {
+		&stateLed,
+		&encoderClk, &data, &sw,
+		&segmentoA, &segmentoB, &segmentoC, &segmentoD, &segmentoE, &segmentoF, &segmentoG, &segmentoPunto,
+		&display1, &display2,
+		&pinTx, &pinRx
+};
+const GPIO_Board_t tarjeta = GPIO_BOARD_INIT(pinesTarjeta);
+
+static GPIO_Handler_t *const pinesTarjetaMultiCanal[] = {
+		&stateLed,
+		&encoderClk, &data, &sw,
+		&segmentoA, &segmentoB, &segmentoC, &segmentoD, &segmentoE, &segmentoF, &segmentoG, &segmentoPunto,
+		&display1, &display2,
+		&pinTxUsart2, &pinRxUsart2
+};
+const GPIO_Board_t tarjetaMultiCanal = GPIO_BOARD_INIT(pinesTarjetaMultiCanal);
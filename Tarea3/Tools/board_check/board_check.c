@@ -0,0 +1,84 @@
+/*
+ * board_check.c
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ *
+ * Programa para el PC que revisa las tablas de pines de la Tarea 3 (tarjeta.c) con
+ * gpio_CheckBoard, el mismo código que usa gpio_ConfigBoard antes de escribir los
+ * registros. Además revisa tablas que deben fallar (un pin repetido, una función
+ * alternativa o un puerto inválidos), así un cambio en el driver que deje de
+ * detectarlas también se nota. Si algo no cumple el programa termina con 1.
+ *
+ * Compilación (desde esta carpeta; mock/ debe ir antes para reemplazar los headers del MCU):
+ *   gcc -std=c99 -Wall -Imock -I../../Inc -I../../../PeripheralsDrivers/Inc -o board_check \
+ *       board_check.c ../../Src/tarjeta.c ../../../PeripheralsDrivers/Src/gpio_driver_hal.c
+ *
+ * Uso:
+ *   ./board_check
+ */
+
+// Importando librerías necesarias
+#include <stdio.h>
+#include "gpio_driver_hal.h"
+#include "tarjeta.h"
+
+/* Pines que no caben en la tarjeta */
+static GPIO_Handler_t ledRepetido = GPIO_OUTPUT_INIT(GPIOA, PIN_5);					// PA5 ya es el stateLed
+static GPIO_Handler_t txAfInvalida = GPIO_ALTFN_INIT(GPIOA, PIN_9, 16, GPIO_OSPEED_FAST);	// Sólo hay AF0 - AF15
+static GPIO_Handler_t pinSinPuerto = GPIO_OUTPUT_INIT((GPIO_TypeDef *)0x40011000UL, PIN_0);	// USART1, no es un GPIO
+
+static GPIO_Handler_t *const pinesRepetidos[] = {&stateLed, &encoderClk, &ledRepetido};
+static GPIO_Handler_t *const pinesAfInvalida[] = {&stateLed, &pinTx, &txAfInvalida};
+static GPIO_Handler_t *const pinesSinPuerto[] = {&stateLed, &pinSinPuerto};
+
+static const GPIO_Board_t tarjetaRepetida = GPIO_BOARD_INIT(pinesRepetidos);
+static const GPIO_Board_t tarjetaAfInvalida = GPIO_BOARD_INIT(pinesAfInvalida);
+static const GPIO_Board_t tarjetaSinPuerto = GPIO_BOARD_INIT(pinesSinPuerto);
+
+/* Tabla a revisar y resultado esperado de gpio_CheckBoard */
+typedef struct
+{
+	const char			*name;
+	const GPIO_Board_t	*pBoard;
+	uint8_t				expected;
+} Board_Case_t;
+
+static const Board_Case_t boardCases[] = {
+		{"tarjeta",				&tarjeta,			1},
+		{"tarjeta_multicanal",	&tarjetaMultiCanal,	1},
+		{"pin_repetido",		&tarjetaRepetida,	0},
+		{"af_invalida",			&tarjetaAfInvalida,	0},
+		{"puerto_invalido",		&tarjetaSinPuerto,	0}
+};
+
+#define NUM_BOARD_CASES		(sizeof(boardCases) / sizeof(boardCases[0]))
+
+
+/*
+ * ======== FUNCIÓN PRINCIPAL DEL PROGRAMA ========
+ */
+int main(void){
+
+	unsigned failedCases = 0;
+
+	for(unsigned i = 0; i < NUM_BOARD_CASES; i++){
+
+		const Board_Case_t *pCase = &boardCases[i];
+		uint8_t result = gpio_CheckBoard(pCase->pBoard);
+
+		printf("%-20s %2u pines  %s\n", pCase->name, pCase->pBoard->numPins, result ? "válida" : "inválida");
+		if(result != pCase->expected){
+			printf("FALLA: %s debía ser %s\n", pCase->name, pCase->expected ? "válida" : "inválida");
+			failedCases++;
+		}
+	}
+
+	if(failedCases){
+		printf("%u tabla(s) no cumplen lo esperado\n", failedCases);
+		return 1;
+	}
+
+	printf("Todas las tablas cumplen lo esperado\n");
+	return 0;
+}
@@ -0,0 +1,13 @@
+/*
+ * stm32_assert.h (mock para revisar la tabla de pines en el PC)
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef STM32_ASSERT_H_
+#define STM32_ASSERT_H_
+
+#define assert_param(expr)	((void)0)
+
+#endif /* STM32_ASSERT_H_ */
@@ -0,0 +1,45 @@
+/*
+ * stm32f4xx.h (mock para revisar la tabla de pines en el PC)
+ *
+ *  Created on: Dec 11, 2023
+ *      Author: sgaviriav
+ */
+
+#ifndef STM32F4XX_H_
+#define STM32F4XX_H_
+
+#include <stdint.h>
+
+/* Sólo lo que usa gpio_driver_hal: los registros existen para compilar, pero
+ * gpio_CheckBoard nunca los toca. Las direcciones son las del F411 porque
+ * gpio_CheckBoard saca el puerto de la dirección del handler */
+typedef struct
+{
+	volatile uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2];
+} GPIO_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t AHB1ENR;
+} RCC_TypeDef;
+
+#define SET			1U
+#define __NOP()		do{}while(0)
+
+#define GPIOA_BASE	0x40020000UL
+#define GPIOA		((GPIO_TypeDef *)0x40020000UL)
+#define GPIOB		((GPIO_TypeDef *)0x40020400UL)
+#define GPIOC		((GPIO_TypeDef *)0x40020800UL)
+#define GPIOD		((GPIO_TypeDef *)0x40020C00UL)
+#define GPIOE		((GPIO_TypeDef *)0x40021000UL)
+#define GPIOH		((GPIO_TypeDef *)0x40021C00UL)
+#define RCC			((RCC_TypeDef *)0x40023830UL)
+
+#define RCC_AHB1ENR_GPIOAEN		(1UL << 0)
+#define RCC_AHB1ENR_GPIOBEN		(1UL << 1)
+#define RCC_AHB1ENR_GPIOCEN		(1UL << 2)
+#define RCC_AHB1ENR_GPIODEN		(1UL << 3)
+#define RCC_AHB1ENR_GPIOEEN		(1UL << 4)
+#define RCC_AHB1ENR_GPIOHEN		(1UL << 7)
+
+#endif /* STM32F4XX_H_ */
@@ -20,6 +20,7 @@
 #include "adc_driver_hal.h"
 #include "usart_driver_hal.h"
 #include "pwm_driver_hal.h"
+#include "format_driver_hal.h"
 
 // Definicion de los Handlers necesario
 GPIO_Handler_t userLed = {0}; //Led de estado PinA5
@@ -52,6 +53,7 @@ GPIO_Handler_t pinTx = {0};
 GPIO_Handler_t pinRx = {0};
 uint8_t usart2DataReceived = 0;
 char	bufferMsg[64] = {0};
+Format_Writer_t msgWriter = {0};	// Mensajes con números hacia el USART (sin sprintf)
 
 
 // Código de los videos del classroom
@@ -109,8 +111,15 @@ int main(void){
 	/* Loop forever*/
 	while (1){
 
+		/* Tomamos la siguiente tecla del buffer de recepción del USART.
+		 * Las que lleguen mientras se procesa una conversión quedan en cola y no se pierden
+		 */
+		if(usart2DataReceived == '\0'){
+			usart_Read(&commSerial, &usart2DataReceived, 1);
+		}
+
 		if (usart2DataReceived == 't'){
-			sprintf(bufferMsg, "¿Probando? ¡Funciona! Ouh-Yeah! \n\r");
+			format_Copy(bufferMsg, sizeof(bufferMsg), "¿Probando? ¡Funciona! Ouh-Yeah! \n\r");
 			usart_WriteMsg(&commSerial, bufferMsg);
 			usart2DataReceived = '\0';
 		}
@@ -121,10 +130,10 @@ int main(void){
 			flagLetra = usart2DataReceived;
 			startPwmSignal(&pwmHandler);
 
-			sprintf(bufferMsg, "\r\n");
+			format_Copy(bufferMsg, sizeof(bufferMsg), "\r\n");
 			usart_WriteMsg(&commSerial, bufferMsg);
 
-			sprintf(bufferMsg, "Empezando conversiones del Sensor 1 \n\r");
+			format_Copy(bufferMsg, sizeof(bufferMsg), "Empezando conversiones del Sensor 1 \n\r");
 			usart_WriteMsg(&commSerial, bufferMsg);
 			usart2DataReceived = '\0';
 		}
@@ -135,10 +144,10 @@ int main(void){
 			flagLetra = usart2DataReceived;
 			startPwmSignal(&pwmHandler);
 
-			sprintf(bufferMsg, "\r\n");
+			format_Copy(bufferMsg, sizeof(bufferMsg), "\r\n");
 			usart_WriteMsg(&commSerial, bufferMsg);
 
-			sprintf(bufferMsg, "Empezando conversiones del Sensor 2 \n\r");
+			format_Copy(bufferMsg, sizeof(bufferMsg), "Empezando conversiones del Sensor 2 \n\r");
 			usart_WriteMsg(&commSerial, bufferMsg);
 			usart2DataReceived = '\0';
 		}
@@ -149,10 +158,10 @@ int main(void){
 			flagLetra = usart2DataReceived;
 			startPwmSignal(&pwmHandler);
 
-			sprintf(bufferMsg, "\r\n");
+			format_Copy(bufferMsg, sizeof(bufferMsg), "\r\n");
 			usart_WriteMsg(&commSerial, bufferMsg);
 
-			sprintf(bufferMsg, "Empezando conversiones del Sensor 3 \n\r");
+			format_Copy(bufferMsg, sizeof(bufferMsg), "Empezando conversiones del Sensor 3 \n\r");
 			usart_WriteMsg(&commSerial, bufferMsg);
 			usart2DataReceived = '\0';
 		}
@@ -181,7 +190,7 @@ int main(void){
 			/* Denetemos las conversiones ADC */
 			stopPwmSignal(&pwmHandler);
 
-			sprintf(bufferMsg, "Terminé la conversión \n\r");
+			format_Copy(bufferMsg, sizeof(bufferMsg), "Terminé la conversión \n\r");
 			usart_WriteMsg(&commSerial, bufferMsg);
 
 			/* Procesa los datos de la señal seleccionada */
@@ -373,11 +382,12 @@ void procesamientoFFT(float32_t *array){
 	arm_min_no_idx_f32(array, ADC_DataSize, &minADC);
 
 	/* Imprimimos los resultados por transmisión serial */
-	sprintf(bufferMsg, "Valor maximo: %.2fV\r\n", ((3.3*maxADC)/4095));
-	usart_WriteMsg(&commSerial, bufferMsg);
-
-	sprintf(bufferMsg, "Valor minimo: %.2fV\r\n", ((3.3*minADC)/4095));
-	usart_WriteMsg(&commSerial, bufferMsg);
+	format_InitUsart(&msgWriter, &commSerial);
+	format_String(&msgWriter, "Valor maximo: ");
+	format_Float(&msgWriter, (3.3f*maxADC)/4095, 2);
+	format_String(&msgWriter, "V\r\nValor minimo: ");
+	format_Float(&msgWriter, (3.3f*minADC)/4095, 2);
+	format_String(&msgWriter, "V\r\n");
 
 	/* Inicializamos la funcion de la transformada */
 	statusInitFFT = arm_rfft_fast_init_f32(&config_Rfft_fast_f32, fftSize);
@@ -403,8 +413,9 @@ void procesamientoFFT(float32_t *array){
 
 	arm_max_f32(fft_magnitud, ADC_DataSize/2, &maxValue, &maxIndex);
 
-	sprintf(bufferMsg, "Frecuencia: %.2f Hz\r\n", ((maxIndex/2) * (frec_muestreo/ADC_DataSize)));
-	usart_WriteMsg(&commSerial, bufferMsg);
+	format_String(&msgWriter, "Frecuencia: ");
+	format_Float(&msgWriter, ((maxIndex/2) * (frec_muestreo/ADC_DataSize)), 2);
+	format_String(&msgWriter, " Hz\r\n");
 
 	/* Limpiamos el arreglo original */
 	for(uint16_t i = 0; i < 511; i++){
@@ -445,9 +456,6 @@ void adc_CompleteCallback(void){
 	}
 }
 
-void usart2_RxCallback(void){
-	usart2DataReceived = usart2_getRxData();
-}
 /*
  * Función assert para detectar problemas de paŕametros incorrectos
  */